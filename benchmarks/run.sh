@@ -0,0 +1,50 @@
+#!/bin/sh
+# Times each benchmark under `sparkc --run` and prints the best of N runs,
+# with the JIT and interpreted only (--no-jit), and as an executable built
+# with --emit-c when a C compiler is available.
+#
+#     benchmarks/run.sh <path to sparkc> [runs]
+#
+# Build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers. An executable
+# configured with -DSPARKC_TIME_INSTRUMENT=ON also reports instructions/s.
+set -e
+
+SPARKC=${1:?usage: run.sh <sparkc> [runs]}
+RUNS=${2:-5}
+DIR=$(cd "$(dirname "$0")" && pwd)
+
+now() { date +%s.%N; }
+
+# best <command...>: sets $best to the fastest of $RUNS runs and $output to what it printed
+best() {
+    best=
+    i=0
+    while [ "$i" -lt "$RUNS" ]; do
+        start=$(now)
+        output=$("$@")
+        end=$(now)
+        best=$(awk -v s="$start" -v e="$end" -v b="$best" 'BEGIN { t = e - s; print (b == "" || t < b) ? t : b }')
+        i=$((i + 1))
+    done
+}
+
+NATIVE=$(mktemp)
+trap 'rm -f "$NATIVE"' EXIT
+
+printf '%-12s %10s %10s %8s %10s  %s\n' benchmark best_s no_jit_s speedup emit_c_s output
+for bench in "$DIR"/*.spark; do
+    name=$(basename "$bench" .spark)
+    native=-
+    if "$SPARKC" --emit-c -o "$NATIVE" "$bench" 2>/dev/null; then
+        best "$NATIVE"
+        native=$(printf '%.3f' "$best")
+    fi
+    best "$SPARKC" --run "$bench" --no-jit
+    interpreted=$best
+    best "$SPARKC" --run "$bench"
+    speedup=$(awk -v j="$best" -v i="$interpreted" 'BEGIN { print i / j }')
+    printf '%-12s %10.3f %10.3f %7.2fx %10s  %s\n' "$name" "$best" "$interpreted" "$speedup" "$native" "$output"
+
+    # Only executables configured with SPARKC_TIME_INSTRUMENT count instructions
+    "$SPARKC" --run "$bench" --time-report 2>&1 >/dev/null | grep instructions || true
+done
@@ -8,6 +8,10 @@
 
 struct ASTNode {
     virtual ~ASTNode() = default;
+
+    // position of the token the node was built from
+    int line = 0;
+    int column = 0;
 };
 
 #endif //AST_H
@@ -0,0 +1,70 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef BUILD_CACHE_H
+#define BUILD_CACHE_H
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../diagnostics/Diagnostic.h"
+
+// What a previous run learned about one source file
+struct CacheEntry {
+    uint64_t content_hash = 0;
+    int64_t mtime = 0;  // used to skip re-hashing untouched files
+    uint64_t size = 0;
+    uint64_t token_fingerprint = 0;
+    uint64_t interface_hash = 0;
+    std::string module_name;
+    // imported module -> its interface hash when this file was checked
+    std::vector<std::pair<std::string, uint64_t>> dependencies;
+    std::vector<Diagnostic> diagnostics;
+
+    bool operator==(const CacheEntry &) const = default;
+};
+
+// On-disk database of per-file results keyed by content hash plus compiler
+// configuration. A database written by a different compiler version or with
+// different flags is ignored as a whole.
+class BuildCache {
+public:
+    static constexpr const char *DEFAULT_PATH = ".sparkc-cache";
+
+    BuildCache(std::string path, uint64_t config_hash);
+
+    // Hash of the compiler version, the command and every flag that affects results
+    static uint64_t make_config_hash(const std::string &command, const std::vector<std::string> &flags);
+
+    static uint64_t hash_content(const std::string &content);
+
+    // Missing, unreadable or stale databases leave the cache empty. Reloading a
+    // database that has not changed on disk since the last load or save keeps
+    // the entries already in memory.
+    void load();
+
+    // Writes atomically via a temporary file; returns false on I/O failure.
+    // Nothing is written if no entry changed since the last load or save.
+    bool save();
+
+    [[nodiscard]] const CacheEntry *find(const std::string &file) const;
+
+    void store(const std::string &file, CacheEntry entry);
+
+    [[nodiscard]] size_t size() const;
+
+private:
+    std::string path;
+    uint64_t config_hash;
+    std::unordered_map<std::string, CacheEntry> entries;
+    bool dirty = false;
+    std::pair<int64_t, uint64_t> disk_stamp{-1, 0}; // mtime and size of the database we last read or wrote
+};
+
+#endif //BUILD_CACHE_H
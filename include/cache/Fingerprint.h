@@ -0,0 +1,22 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#pragma once
+
+#include <cstdint>
+
+#include "../macro/TokenStream.h"
+#include "../semantic/ModuleInterface.h"
+
+// Hash of the token stream after macro expansion (types and spellings, not positions)
+uint64_t token_fingerprint(const TokenStream &tokens);
+
+// Hash of everything other modules can see: public and internal top-level
+// declarations with their types. Bodies and private names do not count.
+uint64_t interface_hash(const ModuleInterface &interface);
+
+#endif //FINGERPRINT_H
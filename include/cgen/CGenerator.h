@@ -0,0 +1,82 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef C_GENERATOR_H
+#define C_GENERATOR_H
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../ir/IR.h"
+
+// Lowers SSA IR to a self-contained C11 program with the VM's semantics.
+//
+// Every SSA value becomes a C variable of the most specific type the IR
+// proves for it: int64_t for integers, double, bool, or otherwise sp_value,
+// the tagged struct the runtime prelude defines for values whose kind is only
+// known at run time. Parameters, globals and call results are always tagged,
+// since a function that falls off its end returns null whatever its declared
+// type. Typed integer instructions compute in their <stdint.h> width and wrap
+// like the VM's; generic ones follow the value kinds through the prelude's
+// helpers. Runtime errors print the VM's message for the same source position
+// and exit with status 1.
+//
+// Phis become a second variable per phi that each predecessor assigns before
+// its jump, so blocks map one to one onto labels and gotos. Recursion depth is
+// limited to the VM's frame count; where POSIX threads exist the program runs
+// on a thread with a stack large enough for that many frames.
+class CGenerator {
+public:
+    // `source_path` is what runtime errors name as the file; throws CompileError
+    static std::string generate(const IRModule &module, const std::string &source_path);
+
+    // Compiles C source at `c_path` to the executable `output` with $CC (default
+    // `cc`) -O2 -pthread; returns the compiler's exit status, or -1 if it could not run
+    static int build_executable(const std::string &c_path, const std::string &output);
+
+private:
+    enum class Kind : uint8_t { Top, Int, Double, Bool, Value }; // Top: not yet known while inferring
+
+    explicit CGenerator(const IRModule &module);
+
+    void generate_function(const IRFunction &function, uint32_t index);
+    void infer_kinds(const IRFunction &function);
+    void find_live_values(const IRFunction &function);
+    [[nodiscard]] Kind result_kind(const IRInstruction &instruction) const;
+    void instruction(const IRInstruction &instruction);
+    void arithmetic(const IRInstruction &instruction);
+    void comparison(const IRInstruction &instruction);
+    void call(const IRInstruction &call);
+    void print(const IRInstruction &print);
+    void terminator(const IRInstruction &instruction);
+    void phi_moves(const BasicBlock &from, const BasicBlock &to, size_t occurrence, const char *indent);
+
+    [[nodiscard]] Kind kind(const IRInstruction &value) const { return kinds[value.id]; }
+    [[nodiscard]] static std::string name(const IRInstruction &value);
+    [[nodiscard]] std::string boxed(const IRInstruction &value) const;   // as an sp_value
+    [[nodiscard]] std::string as_double(const IRInstruction &value) const; // of a statically numeric value
+    std::string site(const IRInstruction &at);                            // &sp_sites[n] for its position
+    std::string literal(const IRInstruction &constant);
+
+    const IRModule &module;
+    std::ostringstream strings;   // string constants
+    std::ostringstream functions; // bodies
+    std::vector<std::string> sites;
+    std::unordered_map<std::string, size_t> site_ids;
+    size_t string_count = 0;
+
+    // State of the function being generated
+    const IRFunction *function = nullptr;
+    std::vector<Kind> kinds; // by value id
+    std::vector<bool> live;  // by value id
+    std::ostringstream body;
+};
+
+#endif //C_GENERATOR_H
@@ -7,22 +7,37 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#include "../cache/BuildCache.h"
+
 class Commands {
 public:
-    static int run(const std::vector<std::string>& args);
+    // `forward` = false never hands the command to a compile server, as the server itself must not
+    static int run(const std::vector<std::string>& args, bool forward = true);
 
 private:
+    static int dispatch(const std::vector<std::string>& args);
+
     static int run_lexer(const std::vector<std::string>& args);
     static int run_parse(const std::vector<std::string>& args);
     static int run_check(const std::vector<std::string>& args);
     static int run_run(const std::vector<std::string>& args);
+    static int run_emit_c(const std::vector<std::string>& args);
     static int run_format(const std::vector<std::string>& args);
+    static int run_serve(const std::vector<std::string>& args);
+    static int run_lsp(const std::vector<std::string>& args);
     static int run_version();
     static int run_help();
 
+    // The build cache for `path` and `config_hash`, created on first use
+    static BuildCache& resident_cache(const std::string& path, uint64_t config_hash);
+
+    // Parse a -j value into `jobs`, printing an error if it is not a positive number
+    static bool parse_jobs(const std::string& value, unsigned& jobs);
+
     // Optional: Helper for file reading in shared logic
     static std::string read_file(const std::string& path);
 
@@ -0,0 +1,125 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef CHASE_LEV_DEQUE_H
+#define CHASE_LEV_DEQUE_H
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// Lock-free work-stealing deque (Chase and Lev, with the C11 memory orders of
+// Lê et al., "Correct and Efficient Work-Stealing for Weak Memory Models").
+//
+// Only the owning thread may push() and pop(), both at the bottom, so its
+// newest work stays hot in its cache; any thread may steal() the oldest item
+// from the top. Pushing and popping without contention are plain loads and
+// stores plus one fence; only the last item is ever fought over with a CAS.
+//
+// The ring doubles when full. A thief may still be reading a ring the owner
+// has outgrown, so outgrown rings are kept until the deque is destroyed, which
+// costs at most as much memory again as the largest ring.
+template <typename T>
+class ChaseLevDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "items are copied with plain atomic loads and stores");
+
+public:
+    explicit ChaseLevDeque(size_t capacity = 256) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        rings.push_back(std::make_unique<Ring>(size));
+        ring.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque &) = delete;
+    ChaseLevDeque &operator=(const ChaseLevDeque &) = delete;
+
+    // Owner only
+    void push(T item) {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_acquire);
+        Ring *current = ring.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(current->mask)) current = grow(current, t, b);
+
+        current->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only: the newest item
+    std::optional<T> pop() {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring *current = ring.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) { // empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        std::optional<T> item = current->get(b);
+        if (t == b) {
+            // The last item: whoever moves top first gets it
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = std::nullopt;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread: the oldest item, or nothing if the deque is empty or another thread got it first
+    std::optional<T> steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return std::nullopt;
+
+        const T item = ring.load(std::memory_order_acquire)->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return item;
+    }
+
+    // A snapshot, exact only when no other thread is using the deque
+    [[nodiscard]] bool empty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Ring {
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Ring(size_t size) : mask(size - 1), slots(std::make_unique<std::atomic<T>[]>(size)) {}
+
+        T get(int64_t index) const { return slots[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed); }
+        void put(int64_t index, T item) { slots[static_cast<size_t>(index) & mask].store(item, std::memory_order_relaxed); }
+    };
+
+    Ring *grow(Ring *old, int64_t t, int64_t b) {
+        rings.push_back(std::make_unique<Ring>((old->mask + 1) * 2));
+        Ring *bigger = rings.back().get();
+        for (int64_t i = t; i < b; ++i) bigger->put(i, old->get(i));
+        ring.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    // On separate cache lines: thieves hammer top, the owner bottom
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    alignas(64) std::atomic<Ring *> ring{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings; // every ring ever used; owner only
+};
+
+#endif //CHASE_LEV_DEQUE_H
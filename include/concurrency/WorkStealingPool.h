@@ -0,0 +1,70 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size thread pool where every worker owns a deque. Workers pop their own
+// newest task first and steal the oldest task of a random victim when empty, so
+// tasks submitted from inside a task stay on the submitting thread.
+//
+// A pool with a single thread runs tasks inline on submit().
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(unsigned thread_count = default_thread_count());
+
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    void submit(Task task);
+
+    // Block until every submitted task has finished; rethrows the first task exception
+    void wait();
+
+    [[nodiscard]] unsigned size() const;
+
+    [[nodiscard]] static unsigned default_thread_count();
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool pop_local(unsigned index, Task &out);
+    bool steal(unsigned thief, Task &out);
+    void execute(Task &task);
+    void worker_loop(unsigned index);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<size_t> queued{0};   // tasks sitting in a deque
+    std::atomic<size_t> pending{0};  // tasks submitted but not finished
+    std::atomic<unsigned> next_queue{0};
+
+    std::mutex state_mutex;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    bool stopping = false;
+    std::exception_ptr first_error;
+};
+
+#endif //WORK_STEALING_POOL_H
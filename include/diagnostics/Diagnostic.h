@@ -0,0 +1,35 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef DIAGNOSTIC_H
+#define DIAGNOSTIC_H
+
+#pragma once
+
+#include <ostream>
+#include <string>
+
+enum class Severity {
+    Error,
+    Warning,
+    Note
+};
+
+// A message tied to a position in a source file
+struct Diagnostic {
+    Severity severity;
+    std::string file;
+    int line;
+    int column;
+    std::string message;
+
+    bool operator==(const Diagnostic &) const = default;
+};
+
+std::string to_string(Severity severity);
+
+// Prints `file:line:column: severity: message`
+void print_diagnostic(std::ostream &out, const Diagnostic &diagnostic);
+
+#endif //DIAGNOSTIC_H
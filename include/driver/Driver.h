@@ -0,0 +1,75 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef DRIVER_H
+#define DRIVER_H
+
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../cache/BuildCache.h"
+#include "../diagnostics/Diagnostic.h"
+#include "../macro/TokenStream.h"
+#include "../semantic/Checker.h"
+#include "../tokens/TokenType.h"
+#include "../types/Declarations.h"
+
+// Everything the front end produced for one source file
+struct SourceUnit {
+    std::string path;
+    std::string source;
+    TokenStream tokens; // after macro expansion
+    std::unique_ptr<Program> program;
+    std::unique_ptr<TypeTable> types; // owns the ids in the program's expression types
+    std::vector<Diagnostic> diagnostics;
+
+    // from `module` (or the file name) and `import`/`use` declarations
+    std::string module_name;
+    std::vector<std::string> imports;
+
+    [[nodiscard]] bool has_errors() const;
+};
+
+struct CheckOptions {
+    unsigned jobs = 1;
+    BuildCache *cache = nullptr;           // reuse results of unchanged files when set
+    std::vector<std::string> search_paths; // where imports not given as inputs are looked up
+    std::string interface_dir;             // emit and map precompiled module interfaces when set
+    bool critical_path = false;            // report the slowest chain of module dependencies
+};
+
+// Runs the front end phases over source files
+class Driver {
+public:
+    static constexpr const char *SOURCE_EXTENSION = ".spark";
+
+    static std::string read_source(const std::string &path);
+
+    // Expand directories into the source files below them; explicit files are kept as given
+    static std::vector<std::string> collect_sources(const std::vector<std::string> &inputs);
+
+    static void lex(SourceUnit &unit);
+    static void expand(SourceUnit &unit);
+    static void parse(SourceUnit &unit);
+    static void check(SourceUnit &unit, const Checker::ModuleMap &modules);
+
+    // lex + expand + parse + check an already loaded unit
+    static void run_front_end(SourceUnit &unit, const Checker::ModuleMap &modules);
+
+    // read + lex + parse + check; failures end up in the unit's diagnostics
+    static SourceUnit check_file(const std::string &path, const Checker::ModuleMap &modules = {});
+
+    // Check every file and the modules it imports, scheduling each module after
+    // its imports on `jobs` threads. Diagnostics are printed in input order.
+    // With a cache, files whose content, configuration and imported interfaces
+    // are unchanged replay their recorded diagnostics instead of being checked.
+    // Returns the number of files with errors.
+    static size_t check_files(const std::vector<std::string> &paths, const CheckOptions &options, std::ostream &out);
+};
+
+#endif //DRIVER_H
@@ -0,0 +1,67 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef FORMATTER_H
+#define FORMATTER_H
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../lexer/Lexer.h"
+
+// Canonical layout for Spark source, computed from the token stream and the
+// lexer's trivia side table. Only a brace depth, a bracket depth and the
+// previous token are tracked, and output is written as tokens arrive, so no
+// token list is built; the source itself is held in memory, and the lexer
+// keeps a copy of it, so memory still grows with the file. Token text is copied
+// from the source verbatim and comments are kept; only the whitespace between
+// tokens changes.
+class Formatter {
+public:
+    static constexpr int INDENT_WIDTH = 4;
+
+    enum class Result {
+        Unchanged,
+        Reformatted
+    };
+
+    explicit Formatter(std::ostream &out);
+
+    // Format a whole file; `source` must outlive the call
+    void format(const std::string &source);
+
+    // Format the file at `path`, rewriting it only if the output differs.
+    // With `write` false nothing is touched and only the result is reported.
+    // Throws std::runtime_error if the file cannot be read or replaced.
+    static Result format_file(const std::string &path, bool write);
+
+private:
+    int comments(const std::string &source, const std::vector<Trivia> &trivia);
+    void token(const std::string &source, const Token &token, int newlines_before);
+
+    void line_break(int newlines, int indent);
+    [[nodiscard]] bool space_between(TokenType next, std::string_view text);
+    [[nodiscard]] bool is_unary_position() const;
+    [[nodiscard]] bool ends_statement() const;
+
+    std::ostream &out;
+
+    int depth = 0;          // braces
+    int nesting = 0;        // parentheses and brackets
+    int ternaries = 0;      // `?` still waiting for their `:`
+    bool first = true;      // nothing written yet
+    bool after_unary = false;
+    bool after_comment = false;
+    bool after_line_comment = false;
+    bool ternary_colon = false;
+    bool open_comment = false; // an unterminated block comment ended the file
+    char last_char = ' ';
+    TokenType previous = TokenType::END_OF_FILE;
+};
+
+#endif //FORMATTER_H
@@ -0,0 +1,28 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef COMMON_SUBEXPRESSION_ELIMINATION_H
+#define COMMON_SUBEXPRESSION_ELIMINATION_H
+
+#pragma once
+
+#include "Dominators.h"
+#include "PassManager.h"
+
+// Dominator-based value numbering. Walking the dominator tree with a scoped
+// table of the pure instructions seen on the way down, an instruction that
+// repeats one of them (same operation, type and operands, up to commutation)
+// is replaced by the earlier result, which dominates it. Constants are shared
+// the same way. Global reads and calls are never merged, since a store or
+// call in between could change what they produce.
+class CommonSubexpressionElimination : public Pass {
+public:
+    [[nodiscard]] const char *name() const override { return "common-subexpression-elimination"; }
+    bool run(IRModule &module, PassStatistics &statistics) override;
+
+private:
+    static bool run(IRFunction &function, PassStatistics &statistics);
+};
+
+#endif //COMMON_SUBEXPRESSION_ELIMINATION_H
@@ -0,0 +1,36 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef CONSTANT_FOLDING_H
+#define CONSTANT_FOLDING_H
+
+#pragma once
+
+#include <optional>
+
+#include "PassManager.h"
+
+// Constant folding and propagation.
+//
+// Operators whose operands are all constants become constants, with exactly
+// the VM's semantics: typed integer instructions wrap to their width, generic
+// ones follow the value kinds, and anything that would fail at run time, such
+// as a division by zero, is left for the VM to report. Since a folded value is
+// used directly through SSA, folding to a fixed point propagates constants.
+// Along the way it removes phis whose operands are all the same value, applies
+// integer identities like x + 0, turns branches on constants into jumps and
+// drops the blocks that become unreachable.
+class ConstantFolding : public Pass {
+public:
+    [[nodiscard]] const char *name() const override { return "constant-folding"; }
+    bool run(IRModule &module, PassStatistics &statistics) override;
+
+    // The constant an operator produces from constant operands, if it can be computed without failing
+    static std::optional<Literal> fold(const IRInstruction &instruction, const TypeTable &types);
+
+private:
+    static bool run(IRFunction &function, const TypeTable &types, PassStatistics &statistics);
+};
+
+#endif //CONSTANT_FOLDING_H
@@ -0,0 +1,27 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef DEAD_CODE_ELIMINATION_H
+#define DEAD_CODE_ELIMINATION_H
+
+#pragma once
+
+#include "PassManager.h"
+
+// Removes instructions whose results are never used and that have no effect,
+// including cycles of phis that only feed each other, then tidies the CFG by
+// dropping unreachable blocks and merging each block into its predecessor
+// when that predecessor jumps nowhere else. Instructions that may fail at run
+// time are kept so the failure still happens.
+class DeadCodeElimination : public Pass {
+public:
+    [[nodiscard]] const char *name() const override { return "dead-code-elimination"; }
+    bool run(IRModule &module, PassStatistics &statistics) override;
+
+private:
+    static bool remove_dead(IRFunction &function, PassStatistics &statistics);
+    static bool merge_blocks(IRFunction &function, PassStatistics &statistics);
+};
+
+#endif //DEAD_CODE_ELIMINATION_H
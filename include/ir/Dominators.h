@@ -0,0 +1,47 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef DOMINATORS_H
+#define DOMINATORS_H
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "IR.h"
+
+// Dominator tree of a function's reachable blocks, computed with the
+// iterative algorithm of Cooper, Harvey and Kennedy over reverse postorder.
+// Invalidated by any change to the CFG.
+class DominatorTree {
+public:
+    explicit DominatorTree(const IRFunction &function);
+
+    // Immediate dominator; null for the entry and for unreachable blocks
+    [[nodiscard]] BasicBlock *idom(const BasicBlock *block) const;
+    [[nodiscard]] bool dominates(const BasicBlock *a, const BasicBlock *b) const;
+    [[nodiscard]] const std::vector<BasicBlock *> &children(const BasicBlock *block) const;
+
+    [[nodiscard]] const std::vector<BasicBlock *> &order() const { return rpo; } // reverse postorder
+
+private:
+    std::vector<BasicBlock *> rpo;
+    std::unordered_map<const BasicBlock *, size_t> position; // in rpo
+    std::vector<size_t> idoms;                               // by rpo position
+    std::vector<std::vector<BasicBlock *>> tree;             // children by rpo position
+};
+
+// A natural loop: the blocks that reach a back edge's tail without passing
+// through its header, which dominates them all. Loops sharing a header are merged.
+struct Loop {
+    BasicBlock *header = nullptr;
+    std::vector<BasicBlock *> blocks; // header first
+    size_t depth = 1;                 // 1 for outermost loops
+};
+
+// Every loop of the function, innermost first
+std::vector<Loop> find_loops(const DominatorTree &dominators);
+
+#endif //DOMINATORS_H
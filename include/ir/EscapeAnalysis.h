@@ -0,0 +1,30 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef ESCAPE_ANALYSIS_H
+#define ESCAPE_ANALYSIS_H
+
+#pragma once
+
+#include "PassManager.h"
+
+// Removes the heap objects behind task and coroutine handles that never escape.
+//
+// A handle escapes unless its only use is the join or await that consumes it,
+// later in the same block. If nothing between the two could observe the order
+// the callee runs in, i.e. no effects, traps or global reads, starting the
+// callee and then waiting for it is the same as calling it there: a spawn
+// becomes a call, which no longer allocates a task, and an async call becomes
+// an awaited call, whose coroutine lives on the register stack and only moves
+// to the heap if it suspends. Everything between still runs either way.
+class EscapeAnalysis : public Pass {
+public:
+    [[nodiscard]] const char *name() const override { return "escape-analysis"; }
+    bool run(IRModule &module, PassStatistics &statistics) override;
+
+private:
+    static bool run(IRFunction &function, PassStatistics &statistics);
+};
+
+#endif //ESCAPE_ANALYSIS_H
@@ -0,0 +1,171 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef IR_H
+#define IR_H
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../ast/AST.h"
+#include "../semantic/TypeTable.h"
+#include "../tokens/TokenType.h"
+
+// A checked program the back end cannot express, e.g. a call to a function
+// of another module or a function that needs more than 255 registers
+struct CompileError : std::runtime_error {
+    int line;
+    int column;
+
+    CompileError(int line, int column, const std::string &message)
+        : std::runtime_error(message), line(line), column(column) {}
+    CompileError(const ASTNode &at, const std::string &message) : CompileError(at.line, at.column, message) {}
+};
+
+enum class IROp : uint8_t {
+    Const,     // `constant`
+    Param,     // parameter number `index`
+    Phi,       // one operand per predecessor, in the block's predecessor order
+    GetGlobal, // global slot `index`
+    SetGlobal, // global slot `index` = operand 0
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    Neg,
+    Not,
+    Eq,
+    Ne,
+    Lt,
+    Le,
+    Call,   // function `index` of the module with the operands as arguments
+    Print,  // the builtin; produces nothing
+    Spawn,  // a task running function `index` with the operands as arguments; its handle
+    Thread, // the same on an OS thread of its own
+    Join,   // waits for the task operand 0 and produces its result
+    Async,     // a coroutine running async function `index` with the operands as arguments; its handle
+    AwaitCall, // awaits async function `index` with the operands as arguments, without a handle unless it suspends
+    Await,     // waits for the coroutine or event operand 0 and produces its result
+    Sleep,     // an event that fires once operand 0 milliseconds have passed
+    Readable,  // an event that fires once file descriptor operand 0 can be read without blocking
+
+    // Terminators, exactly one at the end of every block
+    Jump,   // to successors[0]
+    Branch, // to successors[0] if operand 0 is true, else successors[1]
+    Return  // operand 0, or null without one
+};
+
+const char *ir_op_name(IROp op);
+bool is_terminator(IROp op);
+
+struct BasicBlock;
+struct IRFunction;
+
+// An instruction and the SSA value it defines. Operands point straight at the
+// instructions that define them; nothing tracks the reverse direction, so
+// passes collect replacements and apply them with replace_uses().
+struct IRInstruction {
+    IROp op;
+    uint32_t id = 0;            // unique within the function
+    TypeId type = TYPE_UNKNOWN; // of the result
+    // Integer type whose typed instruction an arithmetic or comparison uses;
+    // unknown for the generic, dynamically checked one
+    TypeId operation = TYPE_UNKNOWN;
+    std::vector<IRInstruction *> operands;
+    Literal constant;
+    uint32_t index = 0;
+    BasicBlock *block = nullptr;
+    const IRFunction *origin = nullptr; // the function whose source it came from if inlined, else null
+    int line = 0;
+    int column = 0;
+
+    explicit IRInstruction(IROp op) : op(op) {}
+
+    // Has effects beyond its result: stores, calls, output and control flow
+    [[nodiscard]] bool has_side_effects() const;
+
+    // Can fail at run time, e.g. a division by a value that may be zero
+    [[nodiscard]] bool may_trap() const;
+
+    [[nodiscard]] bool is_constant() const { return op == IROp::Const; }
+};
+
+struct BasicBlock {
+    uint32_t id = 0;
+    std::vector<std::unique_ptr<IRInstruction>> instructions; // phis first, terminator last
+    std::vector<BasicBlock *> predecessors;                   // may repeat when a branch targets one block twice
+    std::vector<BasicBlock *> successors;                     // Jump: one, Branch: taken then not taken
+
+    [[nodiscard]] IRInstruction *terminator() const;
+    [[nodiscard]] size_t phi_count() const;
+
+    // Insert before the terminator, or at the end of a block still being built
+    IRInstruction *append(std::unique_ptr<IRInstruction> instruction);
+    IRInstruction *insert(size_t position, std::unique_ptr<IRInstruction> instruction);
+};
+
+struct IRFunction {
+    std::string name;
+    bool is_async = false; // its awaits suspend it rather than waiting
+    std::vector<TypeId> parameters;
+    std::vector<std::unique_ptr<BasicBlock>> blocks; // blocks[0] is the entry
+
+    BasicBlock *add_block();
+    std::unique_ptr<IRInstruction> make(IROp op, TypeId type, int line, int column);
+    [[nodiscard]] size_t instruction_count() const;
+    [[nodiscard]] uint32_t value_count() const { return next_value; } // bound on instruction ids
+
+private:
+    uint32_t next_value = 0;
+    uint32_t next_block = 0;
+};
+
+// A whole program. Running it means calling `entry`, which executes the
+// top-level statements in order and then calls `main` if the file defines one.
+struct IRModule {
+    TypeTable *types = nullptr; // owns the ids in instruction types
+    std::vector<std::unique_ptr<IRFunction>> functions;
+    std::vector<std::string> globals; // names of the global slots
+    uint32_t entry = 0;
+};
+
+// Same kind and bits: unlike ==, tells 0.0 from -0.0 and matches a NaN with itself
+bool identical_constants(const Literal &a, const Literal &b);
+
+// ===== CFG EDITING =====
+
+void add_edge(BasicBlock *from, BasicBlock *to);
+
+// Drops one `from` -> `to` edge together with the matching phi operands in `to`
+void remove_edge(BasicBlock *from, BasicBlock *to);
+
+// Makes `to` reached from `replacement` instead of `from`; phi operands keep their positions
+void replace_predecessor(BasicBlock *to, BasicBlock *from, BasicBlock *replacement);
+
+// Points every operand that is a key of `replacements` at its value, following chains
+void replace_uses(IRFunction &function, const std::unordered_map<const IRInstruction *, IRInstruction *> &replacements);
+
+std::vector<BasicBlock *> reverse_postorder(const IRFunction &function);
+
+// Removes blocks the entry cannot reach; returns how many
+size_t remove_unreachable_blocks(IRFunction &function);
+
+// Gives every edge from a block with several successors to one with several
+// predecessors a block of its own, so copies for phis have somewhere to go
+void split_critical_edges(IRFunction &function);
+
+// Empty string when the module is well formed, else a description of the first problem
+std::string verify(const IRModule &module);
+
+void print(const IRModule &module, std::ostream &out);
+
+#endif //IR_H
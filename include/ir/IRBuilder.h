@@ -0,0 +1,95 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef IR_BUILDER_H
+#define IR_BUILDER_H
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "IR.h"
+#include "../types/Declarations.h"
+#include "../types/Expressions.h"
+#include "../types/Statements.h"
+
+// Lowers a checked AST to SSA form.
+//
+// Locals never touch memory: each assignment just records the new value for
+// the variable in the current block, and a read looks in the current block
+// and then backwards through its predecessors, placing phis at joins (Braun
+// et al., "Simple and Efficient Construction of SSA Form"). A block is sealed
+// once all its predecessors are known; reads in an unsealed loop header get
+// an operandless phi that is completed when the back edge has been built.
+// Phis that turn out to be trivial are left for the optimizer.
+//
+// Top-level `let`/`var`/`const` declarations become global slots; top-level
+// statements run in order in a synthetic entry function.
+class IRBuilder {
+public:
+    // Throws CompileError; `program` must have been checked without errors
+    static IRModule build(const Program &program, TypeTable &types);
+
+private:
+    using Variable = uint32_t;
+
+    IRBuilder(IRModule &module, TypeTable &types);
+
+    void build_program(const Program &program);
+    void build_function(const FunctionDeclaration &declaration, IRFunction &function);
+    void begin_function(IRFunction &function);
+    void finish_function(const ASTNode &at);
+
+    void statement(const ASTNode &node);
+    void block(const std::vector<std::unique_ptr<Statement>> &statements);
+    void if_statement(const IfStatement &branch);
+    void while_statement(const WhileStatement &loop);
+
+    IRInstruction *expression(const Expression &expression);
+    IRInstruction *variable(const VariableExpression &variable);
+    IRInstruction *binary(const BinaryExpression &binary);
+    IRInstruction *short_circuit(const BinaryExpression &binary);
+    IRInstruction *assignment(const AssignmentExpression &assignment);
+    IRInstruction *call(const CallExpression &call);
+    IRInstruction *spawn(const SpawnExpression &spawn);
+    IRInstruction *await(const AwaitExpression &await);
+
+    // SSA construction
+    Variable declare(const std::string &name, TypeId type);
+    const Variable *find_local(const std::string &name) const;
+    void write(Variable variable, BasicBlock *block, IRInstruction *value);
+    IRInstruction *read(Variable variable, BasicBlock *block);
+    IRInstruction *read_recursive(Variable variable, BasicBlock *block);
+    IRInstruction *add_phi_operands(Variable variable, IRInstruction *phi);
+    void seal(BasicBlock *block);
+
+    IRInstruction *emit(IROp op, TypeId type, const ASTNode &at);
+    IRInstruction *constant(Literal value, TypeId type, const ASTNode &at);
+    IRInstruction *null_in(BasicBlock *block);
+    void jump(BasicBlock *target, const ASTNode &at);
+    void branch(IRInstruction *condition, BasicBlock *taken, BasicBlock *not_taken, const ASTNode &at);
+    [[nodiscard]] bool terminated() const;
+    TypeId integer_operation(TypeId left, TypeId right);
+
+    IRModule &module;
+    TypeTable &types;
+    std::unordered_map<std::string, uint32_t> function_ids;
+    std::unordered_map<std::string, uint32_t> global_ids;
+    std::vector<const FunctionDeclaration *> declarations;
+
+    // State of the function being built
+    IRFunction *function = nullptr;
+    BasicBlock *current = nullptr;
+    std::vector<std::pair<std::string, Variable>> locals; // innermost scope last
+    std::vector<TypeId> variable_types;
+    std::vector<std::unordered_map<const BasicBlock *, IRInstruction *>> definitions; // by variable
+    std::unordered_set<const BasicBlock *> sealed;
+    std::unordered_map<const BasicBlock *, std::vector<std::pair<Variable, IRInstruction *>>> incomplete_phis;
+};
+
+#endif //IR_BUILDER_H
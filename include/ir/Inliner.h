@@ -0,0 +1,36 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef INLINER_H
+#define INLINER_H
+
+#pragma once
+
+#include "PassManager.h"
+
+// Replaces calls to small functions with a copy of the callee's body.
+//
+// The cost of a call site is the number of instructions the callee would add,
+// parameters and constants aside. It is inlined when that stays within
+// CALLEE_BUDGET, raised by CONSTANT_ARGUMENT_BONUS for every constant argument,
+// since those usually let constant folding shrink the copy, and doubled for a
+// function called from nowhere else. Callees are processed before their
+// callers, so a caller sees them already inlined into. Recursive functions and
+// calls in a function that has already grown past GROWTH_LIMIT instructions
+// are left alone. Copied instructions remember the function they came from,
+// which is the one a runtime error in them names.
+class Inliner : public Pass {
+public:
+    static constexpr size_t CALLEE_BUDGET = 40;
+    static constexpr size_t CONSTANT_ARGUMENT_BONUS = 8;
+    static constexpr size_t GROWTH_LIMIT = 2000;
+
+    [[nodiscard]] const char *name() const override { return "inliner"; }
+    bool run(IRModule &module, PassStatistics &statistics) override;
+
+private:
+    static void inline_call(IRFunction &caller, IRInstruction *call, const IRFunction &callee);
+};
+
+#endif //INLINER_H
@@ -0,0 +1,32 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef LOOP_INVARIANT_CODE_MOTION_H
+#define LOOP_INVARIANT_CODE_MOTION_H
+
+#pragma once
+
+#include "Dominators.h"
+#include "PassManager.h"
+
+// Moves computations that produce the same value on every iteration out of
+// loops, innermost loops first so invariants can climb several levels.
+//
+// Hoisted code goes to the loop's preheader, the single block outside the loop
+// that jumps to its header; one is inserted when the header is entered from
+// several places. Only instructions that have no effect and cannot fail are
+// hoisted, because a loop body may run zero times. A global read is invariant
+// in a loop that neither stores to globals nor calls anything.
+class LoopInvariantCodeMotion : public Pass {
+public:
+    [[nodiscard]] const char *name() const override { return "loop-invariant-code-motion"; }
+    bool run(IRModule &module, PassStatistics &statistics) override;
+
+private:
+    static bool run(IRFunction &function, PassStatistics &statistics);
+    static BasicBlock *preheader(IRFunction &function, Loop &loop, std::vector<Loop> &loops,
+                                 PassStatistics &statistics);
+};
+
+#endif //LOOP_INVARIANT_CODE_MOTION_H
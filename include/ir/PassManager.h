@@ -0,0 +1,63 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef PASS_MANAGER_H
+#define PASS_MANAGER_H
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "IR.h"
+
+// Named counters a pass reports, e.g. how many instructions it folded
+struct PassStatistics {
+    std::vector<std::pair<std::string, uint64_t>> counters;
+
+    void add(const std::string &name, uint64_t amount = 1);
+};
+
+class Pass {
+public:
+    virtual ~Pass() = default;
+
+    [[nodiscard]] virtual const char *name() const = 0;
+
+    // Transform the module in place; returns whether anything changed
+    virtual bool run(IRModule &module, PassStatistics &statistics) = 0;
+};
+
+// Runs a pipeline of passes over a module, timing each and keeping its
+// statistics for report(). Builds with assertions verify the IR after every
+// pass and throw std::logic_error naming the pass that broke it.
+class PassManager {
+public:
+    // The pipeline `--run` uses
+    static PassManager standard();
+
+    void add(std::unique_ptr<Pass> pass);
+    void run(IRModule &module);
+
+    // One line per pass in pipeline order: time, instruction count before and after, and its counters
+    void report(std::ostream &out) const;
+
+private:
+    struct Record {
+        uint64_t nanoseconds = 0;
+        size_t before = 0;
+        size_t after = 0;
+        bool changed = false;
+        PassStatistics statistics;
+    };
+
+    std::vector<std::unique_ptr<Pass>> passes;
+    std::vector<Record> records; // parallel to `passes`
+};
+
+#endif //PASS_MANAGER_H
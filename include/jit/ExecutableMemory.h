@@ -0,0 +1,33 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef EXECUTABLE_MEMORY_H
+#define EXECUTABLE_MEMORY_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Pages of machine code, released together when it is destroyed.
+//
+// Each piece of code gets pages of its own that are writable only while it is
+// copied in and executable only afterwards, so no page is ever both.
+class ExecutableMemory {
+public:
+    ExecutableMemory() = default;
+    ExecutableMemory(const ExecutableMemory &) = delete;
+    ExecutableMemory &operator=(const ExecutableMemory &) = delete;
+    ~ExecutableMemory();
+
+    // The address of an executable copy of `code`, or null when the system refuses to map one
+    const void *install(const std::vector<uint8_t> &code);
+
+private:
+    std::vector<std::pair<void *, size_t>> regions;
+};
+
+#endif //EXECUTABLE_MEMORY_H
@@ -0,0 +1,63 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef JIT_COMPILER_H
+#define JIT_COMPILER_H
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../vm/Bytecode.h"
+#include "ExecutableMemory.h"
+
+// x86-64 only, and only with the System V calling convention
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#define SPARKC_JIT_SUPPORTED 1
+#endif
+
+// A baseline compiler from bytecode functions to x86-64 machine code.
+//
+// Each instruction becomes a fixed template working on the VM's register
+// stack in place, so native code and the interpreter can hand a frame back and
+// forth at any instruction boundary. Templates only cover the cases the
+// interpreter's fast paths cover: inline integers, doubles and bools. Every
+// other case fails a type guard and deoptimizes, returning to the interpreter
+// at the start of the instruction, which redoes it in full and reports any
+// error. Calls, returns, printing and USTR are left to the interpreter too;
+// native code exits right before them.
+//
+// The one register cache is rax: it keeps the value last written to a VM
+// register, together with what the template that wrote it proved about the
+// value's kind, so the next instruction can skip the reload and its guard.
+// Writes still go to memory at once, so an exit never has anything to flush.
+class JitCompiler {
+public:
+    // Runs the frame starting at `registers` from instruction `entry`, which
+    // must be 0, a jump target or just after a CALL, and returns the index of
+    // the instruction the interpreter must continue with, or'ed with DEOPT if
+    // a guard failed there
+    using NativeFunction = uint32_t (*)(Value *registers, Value *globals, uint32_t entry);
+
+    static constexpr uint32_t DEOPT = uint32_t{1} << 31;
+
+    // Fewest instructions native code must run from an entry before exiting
+    // to repay the switch there and back; a loop always does
+    static constexpr uint32_t MIN_SPAN = 8;
+
+    struct NativeCode {
+        NativeFunction run = nullptr;
+        std::vector<bool> entries; // per instruction: worth entering `run` there
+    };
+
+    // Native code for the function; `run` is null where the JIT is not
+    // supported or no entry would repay switching to it
+    NativeCode compile(const BytecodeFunction &function);
+
+private:
+    ExecutableMemory memory;
+};
+
+#endif //JIT_COMPILER_H
@@ -0,0 +1,105 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef X64_ASSEMBLER_H
+#define X64_ASSEMBLER_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+enum class Reg : uint8_t { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+// Condition codes in their encoding order
+enum class Cond : uint8_t { O, NO, B, AE, E, NE, BE, A, S, NS, P, NP, L, GE, LE, G };
+
+struct Label {
+    uint32_t id;
+};
+
+// Emits the handful of x86-64 instructions the JIT needs into a byte buffer.
+//
+// Operands are 64-bit unless the name says otherwise. Jumps always use 32-bit
+// displacements; they may target labels bound later, and finish() patches
+// them. Memory operands are [base + disp32], so the code is position
+// independent and can be copied anywhere.
+class X64Assembler {
+public:
+    Label new_label();
+    void bind(Label label);
+    [[nodiscard]] bool is_bound(Label label) const { return positions[label.id] >= 0; }
+    [[nodiscard]] size_t offset(Label label) const { return static_cast<size_t>(positions[label.id]); }
+    [[nodiscard]] size_t size() const { return bytes.size(); }
+
+    void mov(Reg dst, Reg src);
+    void mov(Reg dst, uint64_t imm);
+    void mov32(Reg dst, Reg src); // zero-extends
+    void load(Reg dst, Reg base, int32_t disp);
+    void store(Reg base, int32_t disp, Reg src);
+
+    void add(Reg dst, Reg src);
+    void sub(Reg dst, Reg src);
+    void imul(Reg dst, Reg src);
+    void and_(Reg dst, Reg src);
+    void or_(Reg dst, Reg src);
+    void xor_(Reg dst, Reg src);
+    void xor_(Reg dst, int8_t imm);
+    void cmp(Reg left, Reg right);
+    void cmp32(Reg left, int32_t imm);
+    void test(Reg left, Reg right);
+    void test8(Reg left, int8_t imm);
+    void neg(Reg reg);
+    void shl(Reg reg, uint8_t count);
+    void shr(Reg reg, uint8_t count);
+    void sar(Reg reg, uint8_t count);
+    void cqo();
+    void idiv(Reg divisor); // rdx:rax / divisor
+    void div(Reg divisor);
+
+    void movsx8(Reg dst, Reg src);
+    void movsx16(Reg dst, Reg src);
+    void movsx32(Reg dst, Reg src);
+    void movzx8(Reg dst, Reg src);
+    void movzx16(Reg dst, Reg src);
+    void setcc(Cond cond, Reg dst); // low byte only
+
+    void movq_to_xmm(uint8_t xmm, Reg src);
+    void movq_from_xmm(Reg dst, uint8_t xmm);
+    void addsd(uint8_t dst, uint8_t src);
+    void subsd(uint8_t dst, uint8_t src);
+    void mulsd(uint8_t dst, uint8_t src);
+    void divsd(uint8_t dst, uint8_t src);
+    void ucomisd(uint8_t left, uint8_t right);
+
+    void jmp(Label target);
+    void jmp(Reg target);
+    void jcc(Cond cond, Label target);
+    void lea(Reg dst, Label target); // rip-relative
+    void movsxd_indexed(Reg dst, Reg base, Reg index); // dst = sign-extended dword [base + index * 4]
+    void push(Reg reg);
+    void pop(Reg reg);
+    void ret();
+
+    void align(size_t alignment);
+    void emit32(uint32_t value);
+
+    // The finished code with every jump resolved; all used labels must be bound
+    std::vector<uint8_t> finish();
+
+private:
+    void emit8(uint8_t value) { bytes.push_back(value); }
+    void rex(bool wide, uint8_t reg, uint8_t index, uint8_t base, bool force = false);
+    void register_op(uint8_t opcode, Reg rm, Reg reg); // opcode /r with both operands registers
+    void sse(uint8_t prefix, uint8_t opcode, uint8_t dst, uint8_t src);
+    void rel32(Label target);
+
+    std::vector<uint8_t> bytes;
+    std::vector<int64_t> positions;                    // by label id; -1 until bound
+    std::vector<std::pair<size_t, uint32_t>> fixups; // rel32 field position, label id
+};
+
+#endif //X64_ASSEMBLER_H
@@ -5,19 +5,47 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 #include "../util/SourceContext.h"
 #include "../tokens/TokenType.h"
 
+enum class TriviaKind : uint8_t {
+    Whitespace, // a run of spaces, tabs and carriage returns
+    Newline,    // a single '\n'
+    LineComment,
+    BlockComment,
+};
+
+// Source text the lexer skips between tokens, by byte range
+struct Trivia {
+    TriviaKind kind;
+    uint32_t offset;
+    uint32_t length;
+};
+
 class Lexer {
 public:
     Lexer(std::string source, const std::string &filename);
 
+    // Record skipped whitespace and comments in a side table; off by default
+    void set_keep_trivia(bool keep);
+
+    // Trivia skipped since the last clear_trivia, in source order
+    [[nodiscard]]
+    const std::vector<Trivia> &trivia() const;
+
+    void clear_trivia();
+
     Token next_token();
 
+    // Lex the whole source; the last token is always END_OF_FILE
+    std::vector<Token> tokenize();
+
     [[nodiscard]]
     bool has_more_tokens() const;
 
@@ -57,7 +85,11 @@ private:
     [[nodiscard]]
     static TokenType keyword_or_identifier(const std::string &text);
 
+    void add_trivia(TriviaKind kind, size_t from);
+
     std::string source;
+    bool keep_trivia = false;
+    std::vector<Trivia> trivia_spans;
     size_t start = 0;
     size_t current = 0;
     SourceContext context;
@@ -0,0 +1,89 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef DOCUMENT_H
+#define DOCUMENT_H
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../tokens/TokenType.h"
+
+// Legend of the semantic token types we report, in LSP wire order
+inline constexpr std::array<const char *, 7> SEMANTIC_TOKEN_TYPES = {
+    "keyword", "type", "modifier", "variable", "string", "number", "operator",
+};
+
+// A highlighted token: byte range in the document and index into SEMANTIC_TOKEN_TYPES
+struct SemanticToken {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t type;
+};
+
+// Zero-based line and byte column
+struct TextPosition {
+    uint32_t line;
+    uint32_t character;
+};
+
+// An open editor buffer. Edits re-lex only from the token before the change
+// up to the first old token that reappears unchanged after it, and the
+// document remembers which run of tokens changed since the last result it
+// handed out, so a semantic-token delta covers just that run.
+class Document {
+public:
+    // Replacement for encoded tokens [start, start + delete_count), in LSP integers
+    struct TokenEdit {
+        uint32_t start = 0;
+        uint32_t delete_count = 0;
+        std::vector<uint32_t> data;
+    };
+
+    explicit Document(std::string text);
+
+    // Full-document synchronisation
+    void replace(std::string text);
+
+    // Replace [start, end) with `text`; positions past the end are clamped
+    void edit(TextPosition start, TextPosition end, std::string_view text);
+
+    [[nodiscard]] const std::string &text() const;
+    [[nodiscard]] const std::vector<SemanticToken> &tokens() const;
+
+    // Every token, LSP-encoded; the baseline for the next delta
+    std::vector<uint32_t> encode_all();
+
+    // What changed since the last encode_all or encode_delta
+    TokenEdit encode_delta();
+
+    // Legend index for a token, or nullopt if it is not highlighted
+    static std::optional<uint32_t> classify(TokenType type);
+
+private:
+    [[nodiscard]] uint32_t offset_of(TextPosition position) const;
+    [[nodiscard]] TextPosition position_of(uint32_t offset) const;
+
+    void index_lines();
+    void relex(uint32_t begin, uint32_t old_end, uint32_t new_end);
+    void encode(size_t first, size_t last, std::vector<uint32_t> &out) const;
+
+    std::string content;
+    std::vector<uint32_t> line_starts;
+    std::vector<SemanticToken> highlighted;
+
+    // Tokens [0, clean_head) and the last clean_tail tokens encode as they did
+    // when the previous result was sent; sent_count tokens were sent then
+    size_t clean_head = 0;
+    size_t clean_tail = 0;
+    size_t sent_count = 0;
+};
+
+#endif //DOCUMENT_H
@@ -0,0 +1,58 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef LANGUAGE_SERVER_H
+#define LANGUAGE_SERVER_H
+
+#pragma once
+
+#include <istream>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+
+#include "Document.h"
+#include "../util/Json.h"
+
+// Language Server Protocol over a byte stream (stdin/stdout for --lsp).
+// Serves semantic tokens for open documents, re-lexing incrementally on
+// each change and answering full/delta requests from the changed range.
+class LanguageServer {
+public:
+    LanguageServer(std::istream &in, std::ostream &out);
+
+    // Process messages until `exit`; returns the process exit code
+    int run();
+
+private:
+    struct OpenDocument {
+        Document document;
+        uint64_t result_id = 0; // of the last semantic tokens result, 0 if none
+    };
+
+    // Next message body, or nullopt at end of input
+    std::optional<std::string> read_message();
+    void send(const JsonValue &message);
+    void respond(const JsonValue &id, JsonValue result);
+    void respond_error(const JsonValue &id, int code, const std::string &message);
+
+    void handle(const JsonValue &message);
+    JsonValue initialize(const JsonValue &params);
+    void did_open(const JsonValue &params);
+    void did_change(const JsonValue &params);
+    JsonValue semantic_tokens_full(const JsonValue &params);
+    JsonValue semantic_tokens_delta(const JsonValue &params);
+
+    OpenDocument &document(const JsonValue &params);
+
+    std::istream &in;
+    std::ostream &out;
+    std::map<std::string, OpenDocument> documents;
+    uint64_t next_result_id = 1;
+    bool shutdown_requested = false;
+    bool exit_requested = false;
+};
+
+#endif //LANGUAGE_SERVER_H
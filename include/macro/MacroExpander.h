@@ -0,0 +1,104 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef MACRO_EXPANDER_H
+#define MACRO_EXPANDER_H
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TokenStream.h"
+#include "../diagnostics/Diagnostic.h"
+
+// Token-level macros, expanded between the lexer and the parser.
+//
+//     #macro square(x) { (x) * (x) }
+//     let area = @square(side);
+//
+//     #macro show(x) { print(x); }
+//     @show(area);
+//
+// A definition binds a name to the tokens between its braces. An invocation
+// `@name(arg, ...)` is replaced by those tokens with each parameter replaced
+// by the (already expanded) argument tokens; a macro without parameters may
+// be invoked as plain `@name`. Macros are visible from their definition to
+// the end of the file, and bodies may invoke other macros. A `;` after an
+// invocation whose expansion ends in `}` or `;` is dropped, so statement
+// macros can be written like calls.
+//
+// Hygiene: a `let`, `var` or `const` declared inside braces in a body is a
+// macro-local temporary. It is renamed to a spelling source code cannot write,
+// so it never captures or shadows names from the call site. Top-level
+// declarations in a body are left alone; generating them is the point of a
+// code-generation macro.
+//
+// Expansions are memoized by macro plus argument tokens. A repeated invocation
+// splices the cached expansion back in by reference, and bodies without locals
+// share the definition's tokens outright. Only the argument tokens are copied
+// when the call is elsewhere, so they carry its positions:
+//
+//     @show(nope);   // error at this `nope`
+//     @show(nope);   // and at this one, though the expansion is reused
+class MacroExpander {
+public:
+    static constexpr int MAX_DEPTH = 64;
+    static constexpr size_t MAX_TOKENS = size_t{1} << 20; // in any single expansion
+
+    explicit MacroExpander(std::string filename);
+
+    // Strip definitions and expand invocations; problems are appended to `diagnostics`
+    TokenStream expand(const TokenStream &tokens, std::vector<Diagnostic> &diagnostics);
+
+    [[nodiscard]] size_t cache_hits() const;
+    [[nodiscard]] size_t cache_misses() const;
+
+private:
+    struct Macro {
+        std::string name;
+        std::vector<std::string> parameters;
+        TokenRun body;
+        std::vector<std::string> locals; // hygienic temporaries declared in the body
+        bool invokes_macros = false;     // the body must be rescanned after substitution
+    };
+
+    struct Expansion {
+        size_t macro;
+        std::vector<std::vector<Token>> arguments;
+        TokenStream tokens;
+    };
+
+    // Token indices [begin, end) within a run
+    struct Span {
+        size_t begin;
+        size_t end;
+    };
+
+    TokenStream expand_run(const TokenRun &run, size_t begin, size_t end, int depth);
+    size_t define(const std::vector<Token> &run, size_t at, size_t end);
+    size_t invoke(const TokenRun &run, size_t at, size_t end, int depth, TokenStream &out);
+    TokenStream expansion_of(size_t macro, const TokenRun &run, const std::vector<Span> &arguments, const Token &site,
+                             int depth);
+    static TokenStream relocate(const Expansion &cached, const std::vector<Token> &tokens,
+                                const std::vector<Span> &arguments);
+    static TokenRun hygienic_body(const Macro &macro, size_t expansion_id);
+
+    void error(const Token &token, const std::string &message);
+
+    std::string filename;
+    std::vector<Diagnostic> *diagnostics = nullptr;
+    std::vector<Macro> macros;
+    std::unordered_map<std::string, size_t> macro_ids;
+    std::unordered_multimap<uint64_t, size_t> cache; // argument hash -> index into expansions
+    std::vector<Expansion> expansions;
+    size_t hits = 0;
+    size_t next_local_id = 0;
+    bool over_budget = false; // MAX_TOKENS already reported
+    bool too_deep = false;    // recursion limit already reported
+};
+
+#endif //MACRO_EXPANDER_H
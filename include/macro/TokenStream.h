@@ -0,0 +1,61 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef TOKEN_STREAM_H
+#define TOKEN_STREAM_H
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "../tokens/TokenType.h"
+
+// Immutable tokens shared between every stream that splices them in
+using TokenRun = std::shared_ptr<const std::vector<Token>>;
+
+// A token sequence made of slices of shared runs. Appending a slice or another
+// stream copies no tokens, so a macro expanded at many call sites costs one run
+// plus a few slice records per site. Runs are never modified once shared;
+// anything that needs different tokens builds a new run (copy-on-write).
+//
+// Indexing is fast for the forward scans the parser makes: the last slice hit
+// is remembered, so a stream must not be indexed from several threads at once.
+class TokenStream {
+public:
+    TokenStream() = default;
+    explicit TokenStream(std::vector<Token> tokens);
+
+    void append(const TokenRun &run, size_t begin, size_t end);
+    void append(const TokenStream &other);
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t slice_count() const;
+
+    const Token &operator[](size_t index) const;
+
+    // The tokens as one contiguous run; shares the existing run when there is only one
+    [[nodiscard]] TokenRun flatten() const;
+
+    // The same tokens, each moved to the position of the token `position_of`
+    // returns for it, if any. Slices with nothing to move stay shared.
+    [[nodiscard]] TokenStream relocated(const std::function<const Token *(const Token &)> &position_of) const;
+
+private:
+    struct Slice {
+        TokenRun run;
+        size_t begin;
+        size_t end;
+        size_t start; // index of the slice's first token in the stream
+    };
+
+    std::vector<Slice> slices;
+    size_t total = 0;
+    mutable size_t hint = 0;
+};
+
+#endif //TOKEN_STREAM_H
@@ -0,0 +1,68 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef INTERFACE_FILE_H
+#define INTERFACE_FILE_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "../semantic/ModuleInterface.h"
+
+// A precompiled module interface mapped read-only from disk. The file holds
+// fixed-size symbol records followed by a string pool, so opening it costs one
+// mmap and a bounds check rather than lexing and parsing the module's source.
+// Only public and internal declarations carry types; private ones keep just
+// their name so importers can still say why a name is not accessible.
+class InterfaceFile {
+public:
+    static constexpr const char *DEFAULT_DIR = ".sparkc-interfaces";
+    static constexpr const char *EXTENSION = ".spki";
+
+    // `<dir>/<module>.spki`
+    static std::string path_for(const std::string &dir, const std::string &module);
+
+    // Serialise `interface` for a source whose content and interface hash are given.
+    // Writes atomically via a temporary file; returns false on I/O failure.
+    static bool write(const std::string &path, const ModuleInterface &interface, uint64_t content_hash,
+                      uint64_t interface_hash);
+
+    // Missing, truncated or foreign files yield nullopt
+    static std::optional<InterfaceFile> open(const std::string &path);
+
+    InterfaceFile(InterfaceFile &&other) noexcept;
+    InterfaceFile &operator=(InterfaceFile &&other) noexcept;
+    InterfaceFile(const InterfaceFile &) = delete;
+    InterfaceFile &operator=(const InterfaceFile &) = delete;
+    ~InterfaceFile();
+
+    [[nodiscard]] std::string_view module() const;
+    [[nodiscard]] uint64_t content_hash() const;
+    [[nodiscard]] uint64_t interface_hash() const;
+    [[nodiscard]] size_t symbol_count() const;
+
+    // Copy the mapped records into the form the checker consumes
+    [[nodiscard]] ModuleInterface to_interface() const;
+
+private:
+    InterfaceFile(const char *data, size_t size);
+
+    struct Header;
+    struct SymbolRecord;
+    struct StringRef;
+
+    [[nodiscard]] const Header &header() const;
+    [[nodiscard]] std::string_view text(const StringRef &ref) const;
+    [[nodiscard]] bool valid() const;
+
+    const char *data = nullptr;
+    size_t size = 0;
+};
+
+#endif //INTERFACE_FILE_H
@@ -0,0 +1,88 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef MODULE_GRAPH_H
+#define MODULE_GRAPH_H
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../concurrency/WorkStealingPool.h"
+#include "../diagnostics/Diagnostic.h"
+
+struct ImportReference {
+    std::string module;
+    int line;
+    int column;
+};
+
+// The `module` / `import` / `use` prologue of a source file
+struct ModuleHeader {
+    std::string path;
+    std::string module; // declared name, or the file stem
+    std::vector<ImportReference> imports;
+    std::string error;  // set when the file could not be read
+};
+
+// Import graph over source files. Nodes are files, edges point from an importer
+// to the module it imports. Built from header scans only, so constructing it
+// never lexes past the last import of a file.
+class ModuleGraph {
+public:
+    struct CriticalPath {
+        double total_ms = 0;      // length of the longest dependency chain
+        double work_ms = 0;       // sum over every module
+        std::vector<size_t> modules; // the chain, dependencies first
+    };
+
+    // Lex just the prologue of `path`, reading more of the file only while the prologue continues
+    static ModuleHeader scan_header(const std::string &path);
+
+    // Scan the inputs, then follow imports that no input provides through the
+    // importer's directory and `search_paths` (a.b -> <dir>/a/b.spark). The
+    // inputs keep their order and come first; discovered files follow.
+    static ModuleGraph build(const std::vector<std::string> &inputs, const std::vector<std::string> &search_paths,
+                             WorkStealingPool &pool);
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] const ModuleHeader &header(size_t node) const;
+    [[nodiscard]] const std::vector<size_t> &dependencies(size_t node) const;
+
+    [[nodiscard]] bool in_cycle(size_t node) const;
+
+    // Node providing `module`, or SIZE_MAX
+    [[nodiscard]] size_t find(const std::string &module) const;
+
+    // Problems found while building: duplicate module names and import cycles
+    [[nodiscard]] const std::vector<Diagnostic> &diagnostics() const;
+
+    // Run `work` once per node after all of its dependencies have finished, with
+    // independent subgraphs in parallel. Edges inside an import cycle are
+    // ignored. Returns how long each node's work took in milliseconds.
+    std::vector<double> schedule(WorkStealingPool &pool, const std::function<void(size_t)> &work) const;
+
+    [[nodiscard]] CriticalPath critical_path(const std::vector<double> &durations) const;
+
+    void print_critical_path(std::ostream &out, const std::vector<double> &durations) const;
+
+private:
+    void add_node(ModuleHeader header);
+    void link();
+    void find_cycles();
+    [[nodiscard]] std::vector<size_t> topological_order() const;
+    [[nodiscard]] bool counts(size_t from, size_t to) const; // edge outside any cycle
+
+    std::vector<ModuleHeader> headers;
+    std::vector<std::vector<size_t>> edges;      // node -> dependencies
+    std::vector<std::vector<size_t>> dependents; // node -> importers
+    std::vector<size_t> component;               // strongly connected component per node
+    std::unordered_map<std::string, size_t> providers; // module name -> first node declaring it
+    std::vector<Diagnostic> problems;
+};
+
+#endif //MODULE_GRAPH_H
@@ -8,24 +8,38 @@
 #pragma once
 #include "../tokens/TokenType.h"
 #include "../ast/AST.h"
+#include "../macro/TokenStream.h"
+#include "../diagnostics/Diagnostic.h"
 #include <vector>
 #include <memory>
+#include <stdexcept>
 
 #include "../types/Declarations.h"
 #include "../types/Expression.h"
+#include "../types/Expressions.h"
 #include "../types/Statement.h"
 #include "../types/Statements.h"
 
+// Thrown internally on a syntax error; the parser recovers at the next statement
+struct ParseError : std::runtime_error {
+    const Token &token;
+    ParseError(const Token &token, const std::string &message) : std::runtime_error(message), token(token) {}
+};
+
 class Parser {
 public:
-    explicit Parser(const std::vector<Token> &tokens);
+    explicit Parser(const TokenStream &tokens, std::string filename = "");
+
+    std::unique_ptr<Program> parseProgram();
 
-    std::unique_ptr<Token> parseProgram();
+    [[nodiscard]] const std::vector<Diagnostic> &diagnostics() const;
 
 private:
     //input
-    const std::vector<Token> &tokens;
+    const TokenStream &tokens;
     size_t current = 0;
+    std::string filename;
+    std::vector<Diagnostic> errors;
 
     // Helpers
     bool isAtEnd() const;
@@ -33,13 +47,20 @@ private:
     const Token &previous() const;
     bool check(TokenType type) const;
     bool match(std::initializer_list<TokenType> types);
-    const Token &consume(TokenType type, const std::string *errMsg);
+    const Token &consume(TokenType type, const std::string &errMsg);
+    ParseError error(const Token &token, const std::string &message) const;
+    void report(const ParseError &err);
+    void synchronize();
 
     // Top‐level: mix of decls & stmts
     std::unique_ptr<ASTNode> parseUnit();
+    Visibility parseModifiers();
 
     // Declarations
-    std::unique_ptr<FunctionDeclaration> parseFunctionDecl();
+    std::unique_ptr<FunctionDeclaration> parseFunctionDecl(Visibility visibility);
+    std::unique_ptr<VariableDeclaration> parseVarDecl(Visibility visibility);
+    std::string parseTypeName();
+    std::string parseQualifiedName();
 
     // Statements
     std::unique_ptr<Statement> parseStatement();
@@ -0,0 +1,91 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef CHECKER_H
+#define CHECKER_H
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ConstEvaluator.h"
+#include "ModuleInterface.h"
+#include "SymbolTable.h"
+#include "TypeTable.h"
+#include "../diagnostics/Diagnostic.h"
+#include "../types/Declarations.h"
+#include "../types/Expressions.h"
+#include "../types/Statements.h"
+
+// Semantic analysis for one source file: name resolution, visibility and types.
+// Every expression's `type` is filled in with an id from `types`, and the
+// initializer of every `const` is folded to a literal by a ConstEvaluator.
+class Checker {
+public:
+    using ModuleMap = std::unordered_map<std::string, const ModuleInterface *>;
+
+    // `modules` holds the interfaces of every module this file may import
+    Checker(std::string filename, const std::string &module, const ModuleMap &modules, TypeTable &types);
+
+    void check(Program &program);
+
+    [[nodiscard]] const std::vector<Diagnostic> &diagnostics() const;
+
+private:
+    void declare_builtins();
+    void declare_imports(const Program &program);
+    void declare_functions(const Program &program);
+    void declare(const Symbol &symbol, const ASTNode &node, const std::string &name);
+
+    TypeId resolve_type(const std::string &spelling, const ASTNode &at);
+    TypeId array_type(const std::string &spelling, const ASTNode &at);
+    TypeId function_type(const std::vector<std::string> &parameter_types, const std::string &return_type,
+                         const ASTNode &at);
+
+    void check_node(ASTNode &node);
+    void check_function(FunctionDeclaration &function);
+    void check_variable(VariableDeclaration &variable);
+    void fold_constant(VariableDeclaration &constant, TypeId type);
+    void check_statement(Statement &statement);
+    void check_block(BlockStatement &block);
+    void check_condition(Expression &condition);
+    TypeId check_expression(Expression &expression);
+    TypeId check_literal(const LiteralExpression &literal, bool negated = false);
+    TypeId check_unary(UnaryExpression &unary);
+    TypeId check_binary(BinaryExpression &binary);
+    TypeId check_operator(const Token &op, Expression &left, Expression &right, const ASTNode &at);
+    TypeId check_assignment(AssignmentExpression &assignment);
+    TypeId check_call(CallExpression &call);
+    TypeId check_spawn(SpawnExpression &spawn);
+    TypeId check_await(AwaitExpression &await);
+
+    // Can `expression` (already checked) be used where `target` is expected?
+    // Unsuffixed numeric literals adopt the target type when their value fits.
+    bool coerce(Expression &expression, TypeId target);
+    void expect(Expression &expression, TypeId target, const std::string &context);
+
+    // Resolve a name use, enforcing visibility of imported symbols
+    const Symbol *resolve(const std::string &name, const ASTNode &use);
+
+    void error(const ASTNode &node, const std::string &message);
+    void note(const ASTNode &node, const std::string &message);
+
+    std::string filename;
+    NameId module_id;
+    std::string package;
+    const ModuleMap &modules;
+
+    StringInterner &names;
+    TypeTable &types;
+    SymbolTable symbols;
+    std::unique_ptr<ConstEvaluator> constants;
+    TypeId return_type = TYPE_UNKNOWN; // of the function being checked
+    bool has_unresolved_import = false;
+    std::vector<Diagnostic> errors;
+};
+
+#endif //CHECKER_H
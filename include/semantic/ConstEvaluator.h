@@ -0,0 +1,137 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef CONST_EVALUATOR_H
+#define CONST_EVALUATOR_H
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "SymbolTable.h"
+#include "TypeTable.h"
+#include "../types/Declarations.h"
+#include "../types/Expressions.h"
+#include "../types/Statements.h"
+
+// A value computed at compile time, tagged with its primitive type.
+// Integers of every width are held as int64_t (u64 as its bit pattern) and
+// floating-point values as double.
+struct ConstValue {
+    Literal value;
+    TypeId type = TYPE_UNKNOWN;
+
+    bool operator==(const ConstValue &other) const = default;
+};
+
+// Compile-time interpreter for `const` initializers and array lengths.
+//
+// It evaluates the checked AST directly and may call functions of the same
+// module, which are run by interpreting their bodies. Such a function only has
+// to be pure on the path actually taken: it may read its parameters, locals and
+// module constants and call other functions, but reading a variable, assigning
+// outside its own frame or calling a builtin stops evaluation with an error.
+// Because every function that finishes is pure in that sense, results are
+// memoized per (function, argument values) for the lifetime of the evaluator,
+// so a recursive table generator runs each distinct call once.
+//
+// Every evaluation is bounded: MAX_STEPS expressions and statements, MAX_DEPTH
+// nested calls and MAX_BYTES of string data. Going over a limit is an error in
+// the constant, never a hang or crash of the compiler.
+class ConstEvaluator {
+public:
+    static constexpr uint64_t MAX_STEPS = 10'000'000;
+    static constexpr size_t MAX_DEPTH = 256;
+    static constexpr size_t MAX_BYTES = size_t{16} << 20;
+
+    // Why an evaluation stopped, reported at `node`
+    struct Failure : std::runtime_error {
+        const ASTNode *node;
+        bool reported; // a constant this one depends on already failed with its own error
+
+        Failure(const ASTNode *node, const std::string &message, bool reported = false)
+            : std::runtime_error(message), node(node), reported(reported) {}
+    };
+
+    // Resolves a name at the point the constant is declared
+    using Lookup = std::function<const Symbol *(const std::string &name)>;
+
+    ConstEvaluator(const Program &program, TypeTable &types);
+
+    // Value of `expression`, converted to `target` unless that is unknown; throws Failure
+    ConstValue evaluate(const Expression &expression, TypeId target, const Lookup &lookup);
+
+    // Marks a constant whose initializer could not be folded, so uses of it fail quietly
+    void mark_failed(const VariableDeclaration &constant);
+
+    // A literal expression holding `value`, for baking a folded constant into the AST
+    static std::unique_ptr<LiteralExpression> to_literal(const ConstValue &value);
+
+    [[nodiscard]] size_t memo_hits() const;
+    [[nodiscard]] size_t memo_size() const;
+
+private:
+    struct Binding {
+        std::string name;
+        ConstValue value;
+        TypeId declared = TYPE_UNKNOWN;
+        bool assignable = false;
+        bool initialized = true;
+    };
+
+    struct Frame {
+        std::vector<Binding> bindings;
+        const Lookup *lookup = nullptr; // set only for the constant's own initializer
+        bool returned = false;
+        ConstValue result;
+    };
+
+    struct MemoEntry {
+        const FunctionDeclaration *function;
+        std::vector<ConstValue> arguments;
+        ConstValue result;
+    };
+
+    ConstValue eval(const Expression &expression, Frame &frame);
+    ConstValue eval_name(const VariableExpression &variable, Frame &frame);
+    ConstValue eval_unary(const UnaryExpression &unary, Frame &frame);
+    ConstValue eval_binary(const BinaryExpression &binary, Frame &frame);
+    ConstValue eval_assignment(const AssignmentExpression &assignment, Frame &frame);
+    ConstValue eval_call(const CallExpression &call, Frame &frame);
+    const FunctionDeclaration &callee(const Expression &callee, const Frame &frame);
+    ConstValue call(const FunctionDeclaration &function, std::vector<ConstValue> arguments, const ASTNode &site);
+    void exec(const ASTNode &node, Frame &frame);
+
+    ConstValue apply(const Token &op, TokenType operation, const ConstValue &left, const ConstValue &right,
+                     const ASTNode &at);
+    ConstValue convert(const ConstValue &value, TypeId target, const ASTNode &at);
+    ConstValue literal_value(const LiteralExpression &literal);
+    ConstValue constant_value(const VariableDeclaration &constant, const ASTNode &use);
+    [[nodiscard]] std::string describe(const ConstValue &value) const;
+
+    void step(const ASTNode &at);
+    void charge(size_t bytes, const ASTNode &at);
+
+    TypeTable &types;
+    std::unordered_map<std::string, const ASTNode *> globals; // functions and module-level variables
+    std::unordered_set<const VariableDeclaration *> failed;
+
+    std::unordered_multimap<uint64_t, size_t> memo_index; // argument hash -> index into memo
+    std::vector<MemoEntry> memo;
+    size_t hits = 0;
+
+    uint64_t steps = 0; // of the current evaluation
+    size_t bytes = 0;
+    size_t depth = 0;
+};
+
+#endif //CONST_EVALUATOR_H
@@ -0,0 +1,40 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef MODULE_INTERFACE_H
+#define MODULE_INTERFACE_H
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "SymbolTable.h"
+#include "TypeTable.h"
+#include "../types/Declarations.h"
+
+// A top-level declaration as seen from other modules
+struct ExportedSymbol {
+    std::string name;
+    SymbolKind kind;
+    Visibility visibility;
+    std::string type;                         // variable or return type, empty if unknown
+    std::vector<std::string> parameter_types; // functions only
+};
+
+// The top-level names a module declares, for resolving its importers
+struct ModuleInterface {
+    std::string module;
+    std::vector<ExportedSymbol> symbols;
+
+    // With the module's checked type table, primitive spellings are canonicalised
+    // ("int" -> "i64") and unannotated variables take their inferred type
+    static ModuleInterface from_program(const std::string &module, const Program &program,
+                                        const TypeTable *types = nullptr);
+};
+
+// The package a module belongs to: the first component of its dotted name
+std::string package_of(const std::string &module);
+
+#endif //MODULE_INTERFACE_H
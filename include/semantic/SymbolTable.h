@@ -0,0 +1,102 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "TypeTable.h"
+#include "../ast/AST.h"
+#include "../tokens/TokenType.h"
+#include "../util/StringInterner.h"
+#include "../visibility/Visibility.h"
+
+enum class SymbolKind {
+    Variable,  // var
+    Immutable, // let
+    Constant,  // const
+    Parameter,
+    Function,
+    Builtin
+};
+
+// The symbol kind a let / var / const declaration introduces
+inline SymbolKind symbol_kind_for(TokenType declaration_kind) {
+    switch (declaration_kind) {
+        case TokenType::LET: return SymbolKind::Immutable;
+        case TokenType::CONST: return SymbolKind::Constant;
+        default: return SymbolKind::Variable;
+    }
+}
+
+struct Symbol {
+    NameId name = INVALID_NAME;
+    SymbolKind kind = SymbolKind::Variable;
+    Visibility visibility = Visibility::Private;
+    NameId module = INVALID_NAME;          // declaring module
+    const ASTNode *declaration = nullptr;  // null for imported and builtin symbols
+    uint32_t depth = 0;                    // scope depth it was declared at
+    TypeId type = TYPE_UNKNOWN;
+
+    [[nodiscard]] bool is_assignable() const {
+        return kind == SymbolKind::Variable || kind == SymbolKind::Parameter;
+    }
+};
+
+// Lexically scoped name -> symbol map.
+//
+// Instead of one map per scope there is a single open-addressing table holding
+// the innermost binding of every name. Declaring a name records the binding it
+// shadows in an undo log, and popping a scope replays the log back to the mark
+// taken at push, so push is O(1) and pop costs one step per name declared in the
+// scope. Lookups are a single probe sequence no matter how deep the nesting.
+class SymbolTable {
+public:
+    SymbolTable();
+
+    void push_scope();
+    void pop_scope();
+
+    [[nodiscard]] uint32_t depth() const;
+
+    // Returns the symbol already declared under this name in the current scope
+    // (leaving the table unchanged), or nullptr once the symbol is declared.
+    const Symbol *declare(Symbol symbol);
+
+    // The innermost visible binding, or nullptr; valid until the next declare or pop
+    [[nodiscard]] const Symbol *lookup(NameId name) const;
+
+private:
+    static constexpr int32_t NO_SYMBOL = -1;
+
+    struct Slot {
+        NameId name = INVALID_NAME; // INVALID_NAME marks a never-used slot
+        int32_t symbol = NO_SYMBOL; // index into symbols, NO_SYMBOL when out of scope
+    };
+
+    struct UndoEntry {
+        size_t slot;
+        int32_t shadowed;
+    };
+
+    struct ScopeMark {
+        size_t undo_size;
+        size_t symbol_count;
+    };
+
+    [[nodiscard]] size_t find_slot(NameId name) const;
+    void grow();
+
+    std::vector<Slot> slots;
+    size_t used_slots = 0;
+    std::vector<Symbol> symbols;
+    std::vector<UndoEntry> undo_log;
+    std::vector<ScopeMark> scopes;
+};
+
+#endif //SYMBOL_TABLE_H
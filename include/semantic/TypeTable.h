@@ -0,0 +1,138 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef TYPE_TABLE_H
+#define TYPE_TABLE_H
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../tokens/TokenType.h"
+#include "../util/StringInterner.h"
+
+// Handle to an interned type; two handles are equal exactly when the types are
+using TypeId = uint32_t;
+
+enum class TypeKind : uint8_t {
+    Unknown, // not annotated and not inferable; accepted everywhere
+    Error,   // result of an ill-typed expression; suppresses follow-up errors
+    Void,
+    Null,
+    Bool,
+    Char,
+    String,
+    Int,     // signed or unsigned, 8 to 64 bits
+    Float,   // f8 to f64
+    Double,
+    Function,
+    Array,
+    Struct,
+    Class,
+    Interface
+};
+
+// Primitive types live at fixed ids so they can be named without a lookup
+inline constexpr TypeId TYPE_UNKNOWN = 0;
+inline constexpr TypeId TYPE_ERROR = 1;
+inline constexpr TypeId TYPE_VOID = 2;
+inline constexpr TypeId TYPE_NULL = 3;
+inline constexpr TypeId TYPE_BOOL = 4;
+inline constexpr TypeId TYPE_CHAR = 5;
+inline constexpr TypeId TYPE_STRING = 6;
+inline constexpr TypeId TYPE_I8 = 7;
+inline constexpr TypeId TYPE_I16 = 8;
+inline constexpr TypeId TYPE_I32 = 9;
+inline constexpr TypeId TYPE_I64 = 10;
+inline constexpr TypeId TYPE_U8 = 11;
+inline constexpr TypeId TYPE_U16 = 12;
+inline constexpr TypeId TYPE_U32 = 13;
+inline constexpr TypeId TYPE_U64 = 14;
+inline constexpr TypeId TYPE_F8 = 15;
+inline constexpr TypeId TYPE_F16 = 16;
+inline constexpr TypeId TYPE_F32 = 17;
+inline constexpr TypeId TYPE_F64 = 18;
+inline constexpr TypeId TYPE_DOUBLE = 19;
+
+// Arena of hash-consed types. Every structurally distinct type is stored once,
+// so equality is an integer compare. Assignability and unification results are
+// memoized in small direct-mapped caches because the checker asks the same
+// questions over and over.
+//
+// Not thread-safe: each compilation unit owns its table.
+class TypeTable {
+public:
+    TypeTable();
+
+    TypeId function(std::span<const TypeId> parameters, TypeId result);
+    TypeId array(TypeId element, uint32_t length);
+    TypeId nominal(TypeKind kind, NameId name, NameId module);
+
+    // Primitive named by a type keyword (`i32`, `int`, `string`, ...) or TYPE_ERROR
+    [[nodiscard]] static TypeId primitive(std::string_view spelling);
+
+    // Type of a literal token such as INT32_LITERAL
+    [[nodiscard]] static TypeId literal(TokenType type);
+
+    [[nodiscard]] TypeKind kind(TypeId type) const;
+    [[nodiscard]] bool is_integer(TypeId type) const;
+    [[nodiscard]] bool is_floating(TypeId type) const;
+    [[nodiscard]] bool is_numeric(TypeId type) const;
+    [[nodiscard]] bool is_signed(TypeId type) const;
+    [[nodiscard]] unsigned bit_width(TypeId type) const;
+
+    // Function and array accessors
+    [[nodiscard]] std::span<const TypeId> parameters(TypeId function) const;
+    [[nodiscard]] TypeId result(TypeId function) const;
+    [[nodiscard]] TypeId element(TypeId array) const;
+    [[nodiscard]] uint32_t length(TypeId array) const;
+
+    // Can a value of `from` be stored where `to` is expected (identity or widening)
+    bool is_assignable(TypeId from, TypeId to);
+
+    // The common type of both operands of an arithmetic or comparison operator,
+    // TYPE_ERROR when there is none
+    TypeId unify(TypeId a, TypeId b);
+
+    [[nodiscard]] std::string to_string(TypeId type) const;
+
+    [[nodiscard]] size_t size() const;
+
+private:
+    struct TypeInfo {
+        TypeKind kind;
+        uint32_t a = 0;           // Int: bits, Function: result, Array: element, nominal: name
+        uint32_t b = 0;           // Int: signed, Array: length, nominal: module
+        uint32_t child_begin = 0; // Function parameters in `children`
+        uint32_t child_count = 0;
+        uint64_t hash = 0;
+    };
+
+    struct MemoEntry {
+        uint64_t key = UINT64_MAX;
+        TypeId value = 0;
+    };
+
+    static constexpr size_t MEMO_SIZE = 512; // power of two
+
+    TypeId intern(TypeKind kind, uint32_t a, uint32_t b, std::span<const TypeId> children);
+    [[nodiscard]] bool same_shape(const TypeInfo &info, TypeKind kind, uint32_t a, uint32_t b,
+                                  std::span<const TypeId> children) const;
+    void grow_index();
+
+    bool compute_assignable(TypeId from, TypeId to) const;
+    TypeId compute_unify(TypeId a, TypeId b) const;
+
+    std::vector<TypeInfo> types;
+    std::vector<TypeId> children;
+    std::vector<TypeId> index; // open addressing over `types`, UINT32_MAX when empty
+    std::array<MemoEntry, MEMO_SIZE> assignable_memo{};
+    std::array<MemoEntry, MEMO_SIZE> unify_memo{};
+};
+
+#endif //TYPE_TABLE_H
@@ -0,0 +1,40 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef COMPILE_SERVER_H
+#define COMPILE_SERVER_H
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+// A long-lived sparkc process on a Unix domain socket. Clients send their
+// working directory and command line; the server runs the command in-process,
+// with the interner, keyword tables and build caches already warm, and streams
+// stdout/stderr back as they are written, followed by the exit status.
+//
+// Wire format (native byte order, the socket never leaves the machine):
+//   request:  u32 count, then `count` strings (cwd first, then arguments),
+//             each as u32 length + bytes
+//   response: frames of u8 channel + u32 length + bytes, channel 1 = stdout,
+//             2 = stderr, 0 = exit status (4-byte signed payload, last frame)
+class CompileServer {
+public:
+    // Commands a client forwards; anything else runs locally
+    static bool forwardable(const std::string &command);
+
+    // $XDG_RUNTIME_DIR/sparkc.sock, or /tmp/sparkc-<uid>.sock
+    static std::string default_socket_path();
+
+    // Serve requests one at a time until a client sends --shutdown
+    static int serve(const std::string &socket_path);
+
+    // Run `args` on the server at `socket_path`, copying its output to ours.
+    // Returns nullopt if no server is listening there.
+    static std::optional<int> forward(const std::string &socket_path, const std::vector<std::string> &args);
+};
+
+#endif //COMPILE_SERVER_H
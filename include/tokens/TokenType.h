@@ -210,6 +210,9 @@ struct Token {
 
     Visibility visibility = Visibility::Private;
 
+    uint32_t offset = 0; // byte range of the token in the source text
+    uint32_t length = 0;
+
     Token(TokenType type, std::string lexeme, Literal literal, int line, int column, Visibility visibility = Visibility::Private)
         : type(type), lexeme(std::move(lexeme)), literal(std::move(literal)), line(line),
           column(column), visibility(visibility) {
@@ -5,9 +5,13 @@
 #ifndef DECLARATIONS_H
 #define DECLARATIONS_H
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "../ast/AST.h"
+#include "../tokens/TokenType.h"
+#include "Expression.h"
+#include "Statement.h"
 
 struct Program : ASTNode {
     std::vector<std::unique_ptr<ASTNode>> statements;
@@ -16,8 +20,35 @@ struct Program : ASTNode {
 struct FunctionDeclaration : ASTNode {
     std::string name;
     std::vector<std::string> parameters;
+    std::vector<std::string> parameter_types; // spelled type per parameter, empty if omitted
+    std::string return_type;                  // empty if omitted
     std::vector<std::unique_ptr<ASTNode>> body;
+    Visibility visibility = Visibility::Private;
+    bool is_async = false; // `async func`: calling it starts a coroutine
     FunctionDeclaration(std::string name, std::vector<std::string> parameters) : name(std::move(name)), parameters(std::move(parameters)) {}
 };
 
+// let / var / const; a statement so it can appear inside blocks
+struct VariableDeclaration : Statement {
+    TokenType kind; // LET, VAR or CONST
+    std::string name;
+    std::string type_name; // empty if omitted
+    std::unique_ptr<Expression> initializer; // may be null
+    Visibility visibility = Visibility::Private;
+    VariableDeclaration(TokenType kind, std::string name, std::string type_name, std::unique_ptr<Expression> initializer)
+        : kind(kind), name(std::move(name)), type_name(std::move(type_name)), initializer(std::move(initializer)) {}
+};
+
+// module a.b;
+struct ModuleDeclaration : ASTNode {
+    std::string name;
+    explicit ModuleDeclaration(std::string name) : name(std::move(name)) {}
+};
+
+// import a.b; / use a.b;
+struct ImportDeclaration : ASTNode {
+    std::string module;
+    explicit ImportDeclaration(std::string module) : module(std::move(module)) {}
+};
+
 #endif //DECLARATIONS_H
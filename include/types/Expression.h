@@ -4,10 +4,13 @@
 
 #ifndef EXPRESSION_H
 #define EXPRESSION_H
+#include <cstdint>
+
 #include "../ast/AST.h"
 
 struct Expression : ASTNode {
-
+    // TypeId assigned by the checker; 0 (unknown) until then
+    uint32_t type = 0;
 };
 
 #endif //EXPRESSION_H
@@ -13,7 +13,9 @@
 
 struct LiteralExpression : Expression {
   Literal literal;
+  TokenType type = TokenType::NULL_LITERAL; // token kind the literal was lexed as
   explicit LiteralExpression(Literal literal) : literal((std::move(literal))) {}
+  LiteralExpression(Literal literal, TokenType type) : literal(std::move(literal)), type(type) {}
 };
 
 struct VariableExpression : Expression {
@@ -21,16 +23,42 @@ struct VariableExpression : Expression {
   explicit VariableExpression(std::string name) : name(std::move(name)) {}
 };
 
+struct UnaryExpression : Expression {
+  Token op;
+  std::unique_ptr<Expression> operand;
+  UnaryExpression(Token o, std::unique_ptr<Expression> operand) : op(std::move(o)), operand(std::move(operand)) {}
+};
+
 struct BinaryExpression : Expression {
   std::unique_ptr<Expression> left, right;
   Token op;
   BinaryExpression(std::unique_ptr<Expression> left, Token o, std::unique_ptr<Expression> right) : left(std::move(left)), right(std::move(right)), op(std::move(o)) {}
 };
 
+struct AssignmentExpression : Expression {
+  std::unique_ptr<Expression> target;
+  Token op; // = or a compound assignment operator
+  std::unique_ptr<Expression> value;
+  AssignmentExpression(std::unique_ptr<Expression> target, Token o, std::unique_ptr<Expression> value) : target(std::move(target)), op(std::move(o)), value(std::move(value)) {}
+};
+
 struct CallExpression : Expression {
   std::unique_ptr<Expression> callee;
   std::vector<std::unique_ptr<Expression>> arguments;
   explicit CallExpression(std::unique_ptr<Expression> c) : callee(std::move(c)) {}
 };
 
+// spawn f(...) or thread f(...): starts the call as a task and evaluates to a handle that join() waits on
+struct SpawnExpression : Expression {
+  TokenType kind; // SPAWN or THREAD
+  std::unique_ptr<CallExpression> call;
+  SpawnExpression(TokenType kind, std::unique_ptr<CallExpression> call) : kind(kind), call(std::move(call)) {}
+};
+
+// await e: the result of a coroutine or event, suspending the async function around it until there is one
+struct AwaitExpression : Expression {
+  std::unique_ptr<Expression> operand;
+  explicit AwaitExpression(std::unique_ptr<Expression> operand) : operand(std::move(operand)) {}
+};
+
 #endif //EXPRESSIONS_H
@@ -24,4 +24,18 @@ struct BlockStatement : Statement {
     std::vector<std::unique_ptr<Statement>> statements;
 };
 
+struct IfStatement : Statement {
+    std::unique_ptr<Expression> condition;
+    std::unique_ptr<Statement> then_branch;
+    std::unique_ptr<Statement> else_branch; // may be null
+    IfStatement(std::unique_ptr<Expression> condition, std::unique_ptr<Statement> then_branch, std::unique_ptr<Statement> else_branch)
+        : condition(std::move(condition)), then_branch(std::move(then_branch)), else_branch(std::move(else_branch)) {}
+};
+
+struct WhileStatement : Statement {
+    std::unique_ptr<Expression> condition;
+    std::unique_ptr<Statement> body;
+    WhileStatement(std::unique_ptr<Expression> condition, std::unique_ptr<Statement> body) : condition(std::move(condition)), body(std::move(body)) {}
+};
+
 #endif //STATEMENTS_H
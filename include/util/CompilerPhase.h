@@ -0,0 +1,41 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef COMPILER_PHASE_H
+#define COMPILER_PHASE_H
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// Coarse stages of a sparkc invocation that resource usage is attributed to
+enum class CompilerPhase {
+    Other,
+    Read,
+    Lex,
+    Expand,
+    Parse,
+    Check,
+    Optimize,
+    Run
+};
+
+inline constexpr std::size_t COMPILER_PHASE_COUNT = 8;
+
+inline std::string_view phase_to_string(CompilerPhase phase) {
+    switch (phase) {
+        case CompilerPhase::Read: return "read";
+        case CompilerPhase::Lex: return "lex";
+        case CompilerPhase::Expand: return "expand";
+        case CompilerPhase::Parse: return "parse";
+        case CompilerPhase::Check: return "check";
+        case CompilerPhase::Optimize: return "optimize";
+        case CompilerPhase::Run: return "run";
+        case CompilerPhase::Other: // fallthrough
+        default: return "other";
+    }
+}
+
+#endif //COMPILER_PHASE_H
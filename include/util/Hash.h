@@ -0,0 +1,30 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef HASH_H
+#define HASH_H
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// 64-bit FNV-1a; stable across runs and platforms so hashes can be persisted
+inline constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+inline constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+inline uint64_t fnv1a(std::string_view data, uint64_t seed = FNV_OFFSET_BASIS) {
+    uint64_t hash = seed;
+    for (const unsigned char c : data) {
+        hash ^= c;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+inline uint64_t hash_combine(uint64_t seed, uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+#endif //HASH_H
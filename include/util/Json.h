@@ -0,0 +1,75 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef JSON_H
+#define JSON_H
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+struct JsonError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// A JSON document: just enough for protocol messages and reports.
+// Objects keep insertion order and are searched linearly; they are small.
+class JsonValue {
+public:
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+    JsonValue() = default;
+    JsonValue(std::nullptr_t) {}
+    JsonValue(bool value) : value(value) {}
+    JsonValue(int value) : value(static_cast<double>(value)) {}
+    JsonValue(int64_t value) : value(static_cast<double>(value)) {}
+    JsonValue(uint64_t value) : value(static_cast<double>(value)) {}
+    JsonValue(double value) : value(value) {}
+    JsonValue(const char *value) : value(std::string(value)) {}
+    JsonValue(std::string value) : value(std::move(value)) {}
+    JsonValue(Array value) : value(std::move(value)) {}
+    JsonValue(Object value) : value(std::move(value)) {}
+
+    // Throws JsonError on malformed input
+    static JsonValue parse(std::string_view text);
+
+    [[nodiscard]] bool is_null() const { return std::holds_alternative<std::monostate>(value); }
+    [[nodiscard]] bool is_number() const { return std::holds_alternative<double>(value); }
+    [[nodiscard]] bool is_string() const { return std::holds_alternative<std::string>(value); }
+    [[nodiscard]] bool is_array() const { return std::holds_alternative<Array>(value); }
+    [[nodiscard]] bool is_object() const { return std::holds_alternative<Object>(value); }
+
+    // Typed accessors throw JsonError on a type mismatch
+    [[nodiscard]] bool as_bool() const;
+    [[nodiscard]] double as_number() const;
+    [[nodiscard]] int64_t as_int() const;
+    [[nodiscard]] const std::string &as_string() const;
+    [[nodiscard]] const Array &as_array() const;
+    [[nodiscard]] const Object &as_object() const;
+
+    // Member lookup; a missing key (or a non-object) yields null
+    [[nodiscard]] const JsonValue &operator[](std::string_view key) const;
+
+    // Append or replace a member, turning null into an object
+    JsonValue &set(std::string key, JsonValue member);
+
+    void write(std::ostream &out) const;
+    [[nodiscard]] std::string dump() const;
+
+private:
+    std::variant<std::monostate, bool, double, std::string, Array, Object> value;
+};
+
+// Write `text` as a quoted JSON string
+void write_json_string(std::ostream &out, std::string_view text);
+
+#endif //JSON_H
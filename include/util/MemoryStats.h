@@ -0,0 +1,69 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "CompilerPhase.h"
+
+// Allocation accounting per compiler phase.
+//
+// Counting only happens in builds configured with SPARKC_MEM_INSTRUMENT, which
+// replaces the global operator new/delete. In every other build the hooks below
+// are never called and report() just says so.
+class MemoryStats {
+public:
+    struct PhaseCounters {
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+        uint64_t bytes_allocated = 0;
+        int64_t live_bytes = 0;
+        int64_t peak_live_bytes = 0;
+    };
+
+    [[nodiscard]] static bool instrumented();
+
+    // Start counting afresh, e.g. for each request a compile server handles.
+    // Bytes still live stay counted, so peaks restart from what is live now.
+    static void reset();
+
+    // The phase new allocations on this thread are charged to
+    static CompilerPhase current_phase();
+    static void set_current_phase(CompilerPhase phase);
+
+    static void record_allocation(CompilerPhase phase, std::size_t size);
+    static void record_free(CompilerPhase phase, std::size_t size);
+
+    [[nodiscard]] static PhaseCounters counters(CompilerPhase phase);
+    [[nodiscard]] static int64_t peak_live_bytes();
+
+    static void report(std::ostream &out);
+};
+
+// Charges every allocation made on this thread to `phase` until destroyed
+class MemoryPhaseScope {
+public:
+    explicit MemoryPhaseScope(CompilerPhase phase)
+        : previous(MemoryStats::current_phase()) {
+        MemoryStats::set_current_phase(phase);
+    }
+
+    ~MemoryPhaseScope() {
+        MemoryStats::set_current_phase(previous);
+    }
+
+    MemoryPhaseScope(const MemoryPhaseScope &) = delete;
+    MemoryPhaseScope &operator=(const MemoryPhaseScope &) = delete;
+
+private:
+    CompilerPhase previous;
+};
+
+#endif //MEMORY_STATS_H
@@ -0,0 +1,52 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Small integer standing for an interned string; equal strings get equal ids
+using NameId = uint32_t;
+
+inline constexpr NameId INVALID_NAME = UINT32_MAX;
+
+// Thread-safe string interner. The table is split into shards with their own
+// lock so checker threads rarely contend; the shard index lives in the low
+// bits of every id, which keeps ids small enough to hash cheaply.
+class StringInterner {
+public:
+    NameId intern(std::string_view text);
+
+    // The spelling behind an id; valid for the interner's lifetime
+    [[nodiscard]] std::string_view spelling(NameId id) const;
+
+    [[nodiscard]] size_t size() const;
+
+    // Process-wide interner shared by every compilation
+    static StringInterner &global();
+
+private:
+    static constexpr unsigned SHARD_BITS = 5;
+    static constexpr unsigned SHARD_COUNT = 1u << SHARD_BITS;
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::deque<std::string> strings; // deque keeps views into it stable
+        std::unordered_map<std::string_view, NameId> ids;
+    };
+
+    std::array<Shard, SHARD_COUNT> shards;
+};
+
+#endif //STRING_INTERNER_H
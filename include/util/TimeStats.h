@@ -0,0 +1,109 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef TIME_STATS_H
+#define TIME_STATS_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "CompilerPhase.h"
+
+#ifdef SPARKC_TIME_INSTRUMENT
+#include <chrono>
+#include <ctime>
+#endif
+
+// Units of work the time report divides by phase time
+enum class Throughput {
+    Bytes,       // source bytes read
+    Tokens,      // tokens lexed
+    Nodes,       // AST nodes built
+    Instructions // bytecode instructions executed
+};
+
+inline constexpr std::size_t THROUGHPUT_COUNT = 4;
+
+// Wall and CPU time per compiler phase, plus throughput counters.
+//
+// Like MemoryStats, recording is compiled in only with SPARKC_TIME_INSTRUMENT;
+// otherwise PhaseTimer is an empty object and count() an empty inline function,
+// so the call sites cost nothing. An instrumented build still only reads the
+// clocks while a report has been requested.
+class TimeStats {
+public:
+    struct PhaseTimes {
+        uint64_t calls = 0;
+        uint64_t wall_ns = 0; // summed over threads, so it can exceed the elapsed time
+        uint64_t cpu_ns = 0;
+    };
+
+    [[nodiscard]] static bool instrumented();
+
+    // Clear all counters and start timing if instrumented
+    static void start();
+    [[nodiscard]] static bool enabled();
+
+    static void record_phase(CompilerPhase phase, uint64_t wall_ns, uint64_t cpu_ns);
+    static void record(Throughput kind, uint64_t amount);
+
+    [[nodiscard]] static PhaseTimes times(CompilerPhase phase);
+    [[nodiscard]] static uint64_t total(Throughput kind);
+
+    static void report(std::ostream &out);
+    static void report_json(std::ostream &out);
+
+    static void count(Throughput kind, uint64_t amount) {
+#ifdef SPARKC_TIME_INSTRUMENT
+        if (enabled()) record(kind, amount);
+#else
+        (void) kind;
+        (void) amount;
+#endif
+    }
+};
+
+// Charges the wall and CPU time of this thread to `phase` until destroyed
+class PhaseTimer {
+public:
+#ifdef SPARKC_TIME_INSTRUMENT
+    explicit PhaseTimer(CompilerPhase phase) : phase(phase), active(TimeStats::enabled()) {
+        if (active) {
+            wall_start = std::chrono::steady_clock::now();
+            cpu_start = thread_cpu_ns();
+        }
+    }
+
+    ~PhaseTimer() {
+        if (!active) return;
+        const auto wall = std::chrono::steady_clock::now() - wall_start;
+        TimeStats::record_phase(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(wall).count(),
+                                thread_cpu_ns() - cpu_start);
+    }
+#else
+    explicit PhaseTimer(CompilerPhase) {}
+#endif
+
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+#ifdef SPARKC_TIME_INSTRUMENT
+private:
+    static uint64_t thread_cpu_ns() {
+        timespec now{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(now.tv_nsec);
+    }
+
+    CompilerPhase phase;
+    bool active;
+    std::chrono::steady_clock::time_point wall_start;
+    uint64_t cpu_start = 0;
+#endif
+};
+
+#endif //TIME_STATS_H
@@ -0,0 +1,61 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <string_view>
+
+// Begin/end events for Chrome's trace-event format, viewable in Perfetto or
+// chrome://tracing.
+//
+// Each thread records into its own fixed-size ring buffer: a record is a
+// clock read and a few stores, the detail copied into the event's slot, with
+// no locks or shared cache lines. When a ring fills up the oldest events are
+// overwritten. stop() reads the rings once the traced work is done and writes
+// the JSON file; events recorded while it runs are left out.
+class Trace {
+public:
+    // Start recording; events go to `path` on stop()
+    static void start(const std::string &path);
+
+    // Write the trace file and stop recording; false if it could not be written
+    static bool stop();
+
+    [[nodiscard]] static bool enabled() {
+        return recording.load(std::memory_order_relaxed);
+    }
+
+    // `name` must be a string literal or otherwise outlive the trace
+    static void begin(const char *name, std::string_view detail = {});
+    static void end(const char *name);
+
+private:
+    static std::atomic<bool> recording;
+};
+
+// Records a begin event now and the matching end event when destroyed
+class TraceScope {
+public:
+    explicit TraceScope(const char *name, std::string_view detail = {})
+        : name(Trace::enabled() ? name : nullptr) {
+        if (this->name) Trace::begin(name, detail);
+    }
+
+    ~TraceScope() {
+        if (name) Trace::end(name);
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name;
+};
+
+#endif //TRACE_H
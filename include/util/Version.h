@@ -0,0 +1,12 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef VERSION_H
+#define VERSION_H
+
+#pragma once
+
+inline constexpr const char *SPARKC_VERSION = "0.1.0";
+
+#endif //VERSION_H
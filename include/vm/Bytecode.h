@@ -0,0 +1,179 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Value.h"
+
+// Instructions are 32-bit words: an 8-bit opcode and three 8-bit operands
+// A, B and C, or A and a 16-bit Bx (sBx when signed). Operands named R are
+// registers of the current frame, K entries of the function's constant pool
+// and G global slots. Jumps are relative to the next instruction.
+//
+// ADD through NEG are generic: they inspect their operands' kinds at run time
+// and treat integers as i64. Where the checker proved both operands to be
+// integers of one width, the compiler selects the typed variant for that width
+// instead (ADD_I32, DIV_U64, ...), which wraps its result to the width without
+// looking at anything else.
+//
+// An async function suspends at an AWAIT whose operand has not finished; its
+// C operand names the function's AwaitPoint, the registers to keep. AWAITCALL
+// runs an async function like CALL. If the callee finishes without suspending,
+// the AWAIT that always follows is skipped; otherwise R[A] holds the coroutine
+// the callee became and the AWAIT waits for it.
+//
+// The list is expanded into the OpCode enum, the disassembler's names and the
+// VM's dispatch table, so the three can never disagree on the order.
+#define SPARKC_OPCODES(X) \
+    X(MOVE)        /* R[A] = R[B] */                                  \
+    X(LOADK)       /* R[A] = K[Bx] */                                 \
+    X(LOADI)       /* R[A] = sBx as an integer */                     \
+    X(LOADBOOL)    /* R[A] = B != 0 */                                \
+    X(LOADNULL)    /* R[A] = null */                                  \
+    X(GETGLOBAL)   /* R[A] = G[Bx] */                                 \
+    X(SETGLOBAL)   /* G[Bx] = R[A] */                                 \
+    X(ADD)         /* R[A] = R[B] + R[C], also string concatenation */ \
+    X(SUB)         /* R[A] = R[B] - R[C] */                           \
+    X(MUL)         /* R[A] = R[B] * R[C] */                           \
+    X(DIV)         /* R[A] = R[B] / R[C] */                           \
+    X(MOD)         /* R[A] = R[B] % R[C] */                           \
+    X(EQ)          /* R[A] = R[B] == R[C] */                          \
+    X(NE)          /* R[A] = R[B] != R[C] */                          \
+    X(LT)          /* R[A] = R[B] < R[C] */                           \
+    X(LE)          /* R[A] = R[B] <= R[C] */                          \
+    X(LTU)         /* R[A] = R[B] < R[C] as u64 */                    \
+    X(LEU)         /* R[A] = R[B] <= R[C] as u64 */                   \
+    X(NEG)         /* R[A] = -R[B] */                                 \
+    X(NOT)         /* R[A] = !R[B] */                                 \
+    X(JMP)         /* pc += sBx */                                    \
+    X(JMPIF)       /* if R[A] then pc += sBx */                       \
+    X(JMPIFNOT)    /* if not R[A] then pc += sBx */                   \
+    X(CALL)        /* R[A] = function Bx(R[A], R[A+1], ...) */        \
+    X(PRINT)       /* print R[A] .. R[A+B-1] on one line */           \
+    X(RETURN)      /* return R[A] */                                  \
+    X(RETURNNULL)  /* return null */                                  \
+    X(USTR)        /* R[A] = R[B] as the decimal text of a u64 */     \
+    X(SPAWN)       /* R[A] = task running function Bx(R[A], ...) */   \
+    X(THREAD)      /* the same on an OS thread of its own */          \
+    X(JOIN)        /* R[A] = result of task R[B] once it finishes */  \
+    X(ASYNC)       /* R[A] = coroutine running function Bx(R[A], ...) */ \
+    X(AWAITCALL)   /* R[A] = function Bx(R[A], ...) or its coroutine */ \
+    X(AWAIT)       /* R[A] = result of R[B]; C is the await point */  \
+    X(SLEEP)       /* R[A] = event after R[B] milliseconds */         \
+    X(READABLE)    /* R[A] = event once fd R[B] is readable */        \
+    SPARKC_INT_OPCODES(X, I8)                                         \
+    SPARKC_INT_OPCODES(X, I16)                                        \
+    SPARKC_INT_OPCODES(X, I32)                                        \
+    SPARKC_INT_OPCODES(X, I64)                                        \
+    SPARKC_INT_OPCODES(X, U8)                                         \
+    SPARKC_INT_OPCODES(X, U16)                                        \
+    SPARKC_INT_OPCODES(X, U32)                                        \
+    SPARKC_INT_OPCODES(X, U64)
+
+// Typed integer arithmetic for one width, in the order of the generic ADD..NEG
+#define SPARKC_INT_OPCODES(X, W) \
+    X(ADD_##W) X(SUB_##W) X(MUL_##W) X(DIV_##W) X(MOD_##W) X(NEG_##W)
+
+enum class OpCode : uint8_t {
+#define SPARKC_OPCODE_ENUM(name) name,
+    SPARKC_OPCODES(SPARKC_OPCODE_ENUM)
+#undef SPARKC_OPCODE_ENUM
+};
+
+#define SPARKC_OPCODE_COUNT(name) +1
+inline constexpr size_t OPCODE_COUNT = 0 SPARKC_OPCODES(SPARKC_OPCODE_COUNT);
+#undef SPARKC_OPCODE_COUNT
+
+const char *opcode_name(OpCode op);
+
+// The typed variant of a generic ADD, SUB, MUL, DIV, MOD or NEG for an integer
+// type id (TYPE_I8 ... TYPE_U64, which are consecutive like the variants)
+OpCode typed_opcode(OpCode generic, uint32_t integer_type);
+
+// Encoding and decoding of instruction words
+struct Instruction {
+    static constexpr int MAX_REGISTERS = 255;
+    static constexpr int SBX_MIN = INT16_MIN;
+    static constexpr int SBX_MAX = INT16_MAX;
+
+    static constexpr uint32_t abc(OpCode op, uint8_t a, uint8_t b, uint8_t c) {
+        return static_cast<uint32_t>(op) | uint32_t{a} << 8 | uint32_t{b} << 16 | uint32_t{c} << 24;
+    }
+
+    static constexpr uint32_t abx(OpCode op, uint8_t a, uint16_t bx) {
+        return static_cast<uint32_t>(op) | uint32_t{a} << 8 | uint32_t{bx} << 16;
+    }
+
+    static constexpr uint32_t asbx(OpCode op, uint8_t a, int16_t sbx) {
+        return abx(op, a, static_cast<uint16_t>(sbx));
+    }
+
+    static constexpr OpCode op(uint32_t word) { return static_cast<OpCode>(word & 0xff); }
+    static constexpr uint8_t a(uint32_t word) { return static_cast<uint8_t>(word >> 8); }
+    static constexpr uint8_t b(uint32_t word) { return static_cast<uint8_t>(word >> 16); }
+    static constexpr uint8_t c(uint32_t word) { return static_cast<uint8_t>(word >> 24); }
+    static constexpr uint16_t bx(uint32_t word) { return static_cast<uint16_t>(word >> 16); }
+    static constexpr int16_t sbx(uint32_t word) { return static_cast<int16_t>(word >> 16); }
+};
+
+struct SourceLocation {
+    int line = 0;
+    int column = 0;
+    uint16_t function = 0; // whose source it is, which for inlined code is not the function running it
+};
+
+// Where an async function can suspend. Its coroutine keeps only the registers
+// still needed after the await, and puts them back when it resumes.
+struct AwaitPoint {
+    std::vector<uint8_t> saved;
+};
+
+// The registers holding live values while a frame is stopped at a safepoint,
+// where the heap may be collected: calls and the instructions that run other
+// code on top of the frame, and backward jumps. Nothing else in the frame is
+// read by the garbage collector, so dead registers may hold anything.
+struct StackMap {
+    uint32_t instruction;
+    std::vector<uint8_t> live;
+};
+
+struct BytecodeFunction {
+    std::string name;
+    uint8_t arity = 0;
+    uint8_t registers = 0; // frame size, parameters included
+    std::vector<uint32_t> code;
+    std::vector<SourceLocation> locations; // one per instruction
+    std::vector<Value> constants;
+    std::vector<StackMap> stack_maps; // by instruction, ascending
+
+    // Async functions only: the await points, by the C operand of their AWAIT,
+    // and the size of a suspended coroutine's frame, the most any of them saves
+    bool is_async = false;
+    std::vector<AwaitPoint> awaits;
+    uint8_t coroutine_frame = 0;
+};
+
+// A compiled program. Running it means calling `entry`, which executes the
+// top-level statements in order and then calls `main` if the file defines one.
+struct BytecodeModule {
+    std::vector<BytecodeFunction> functions;
+    std::vector<std::string> globals; // names of the global slots
+    uint16_t entry = 0;
+
+    // Objects the constant pools point at
+    std::vector<std::unique_ptr<Object>> objects;
+};
+
+void disassemble(const BytecodeModule &module, std::ostream &out);
+
+#endif //BYTECODE_H
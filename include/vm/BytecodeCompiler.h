@@ -0,0 +1,89 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef BYTECODE_COMPILER_H
+#define BYTECODE_COMPILER_H
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Bytecode.h"
+#include "../ir/IR.h"
+
+// Lowers SSA IR to register bytecode.
+//
+// Blocks are laid out in reverse postorder, so a jump to the next block is
+// left out. Every value gets one register for its whole life: the compiler
+// computes liveness, builds the interference graph and colors it greedily in
+// dominance order, which for SSA never needs more registers than the most
+// values live at one point. Colors are chosen to match the phi a value flows
+// into, and vice versa, so most phi copies vanish; the rest are emitted as a
+// parallel copy at the end of each predecessor, after critical edges have been
+// split so that such a block has no other successor.
+//
+// Parameters keep the registers the caller passed them in. A call copies its
+// arguments to the first registers above everything that is still live
+// afterwards, which the callee uses as its frame.
+//
+// In an async function each await is a state of the coroutine: the values live
+// across it are all that is saved when it suspends there, so a coroutine's
+// frame is as large as the largest such set rather than the whole register file.
+//
+// The same liveness gives each safepoint its stack map, so the garbage
+// collector only ever reads registers that hold values.
+class BytecodeCompiler {
+public:
+    // Splits critical edges in `module` as a side effect; throws CompileError
+    static BytecodeModule compile(IRModule &module);
+
+private:
+    BytecodeCompiler(BytecodeModule &module, const TypeTable &types);
+
+    void compile_function(IRFunction &source, BytecodeFunction &function);
+    void allocate_registers(const IRFunction &source);
+    void instruction(const IRInstruction &instruction);
+    void terminator(const IRInstruction &instruction, size_t position);
+    void call(const IRInstruction &call);
+    uint8_t await_point(const IRInstruction &at);
+    [[nodiscard]] std::vector<uint8_t> live_registers(const IRInstruction &at) const; // after `at`
+    void stack_map(size_t instruction, std::vector<uint8_t> live);
+    void spawn(const IRInstruction &spawn);
+    void print(const IRInstruction &print);
+    void parallel_move(std::vector<std::pair<uint8_t, uint8_t>> moves, uint8_t scratch, const IRInstruction &at);
+
+    [[nodiscard]] uint8_t reg(const IRInstruction &value) const { return registers[value.id]; }
+    void use_registers(int count, const IRInstruction &at);
+    uint16_t constant(const Value &value, const IRInstruction &at);
+    uint16_t string_constant(const std::string &text, const IRInstruction &at);
+    uint16_t integer_constant(int64_t value, const IRInstruction &at);
+
+    size_t emit(uint32_t word, const IRInstruction &at);
+    void emit_jump(OpCode op, uint8_t a, const BasicBlock *target, const IRInstruction &at);
+
+    BytecodeModule &module;
+    const TypeTable &types;
+
+    std::unordered_map<const IRFunction *, uint16_t> function_ids;
+
+    // State of the function being compiled
+    BytecodeFunction *function = nullptr;
+    uint16_t function_id = 0;
+    std::vector<BasicBlock *> layout;
+    std::vector<uint8_t> registers; // by value id
+    std::vector<bool> used;         // by value id: read by some instruction
+    std::vector<std::vector<bool>> live_in; // by position in the layout, by value id
+    std::vector<uint32_t> live_across; // ids of the values live after each call, await or join, one run for each
+    std::unordered_map<const IRInstruction *, std::pair<size_t, size_t>> call_live; // its run in live_across
+    int allocated = 0; // registers [0, allocated) hold values
+    std::unordered_map<const BasicBlock *, size_t> block_starts;
+    std::vector<std::pair<size_t, const BasicBlock *>> jumps; // to patch once every block has a start
+    std::unordered_map<std::string, uint16_t> constant_ids; // keyed by kind and contents
+};
+
+#endif //BYTECODE_COMPILER_H
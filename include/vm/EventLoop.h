@@ -0,0 +1,110 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Value.h"
+
+class EventLoop;
+struct CoroutineObject;
+
+// Something `await` can wait for: a coroutine, or an event such as a timer.
+// Only the loop that owns it completes it, and only its thread may await it.
+struct PromiseObject : Object {
+    EventLoop *loop;
+    Value result;
+    std::exception_ptr error; // the RuntimeError that ended a coroutine, rethrown by await
+    bool done = false;
+    bool awaited = false; // whether any await saw its outcome
+    std::vector<CoroutineObject *> waiters;
+
+    PromiseObject(ObjectKind kind, EventLoop &loop) : Object(kind), loop(&loop) {}
+};
+
+// A call of an async function that suspended, or may still. While suspended it
+// holds only what the await point it stopped at needs: the registers live
+// across that await, in a frame allocated once for the largest such set.
+struct CoroutineObject : PromiseObject {
+    uint16_t function;
+    uint8_t state = 0;                // await point it is suspended at
+    uint8_t saved = 0;                // values in `frame` while suspended
+    const uint32_t *resume = nullptr; // the instruction after that await
+    PromiseObject *awaiting = nullptr;
+    std::unique_ptr<Value[]> frame;
+
+    CoroutineObject(EventLoop &loop, uint16_t function, uint8_t frame_size)
+        : PromiseObject(ObjectKind::Coroutine, loop), function(function),
+          frame(std::make_unique<Value[]>(frame_size)) {}
+};
+
+// Single-threaded reactor for the coroutines of one VM executor.
+//
+// Completing a promise queues the coroutines awaiting it; the VM takes them
+// from next() and resumes them one at a time. Once none is ready, the loop
+// blocks in epoll_wait (poll() where epoll does not exist) until the earliest
+// timer is due or a watched file descriptor becomes readable. Timers live in a
+// heap ordered by deadline, so epoll's timeout is the only clock it needs.
+class EventLoop {
+public:
+    EventLoop() = default;
+    ~EventLoop();
+
+    EventLoop(const EventLoop &) = delete;
+    EventLoop &operator=(const EventLoop &) = delete;
+
+    // Settles `promise` and queues whoever awaits it
+    void complete(PromiseObject &promise, Value result, std::exception_ptr error = nullptr);
+
+    void add_timer(PromiseObject *timer, int64_t milliseconds);
+
+    // Completes `promise` with `fd` once it is readable; false if `fd` cannot be watched
+    bool watch_readable(PromiseObject *promise, int fd);
+
+    // The next coroutine to resume, waiting for timers and file descriptors as
+    // long as that takes; null once nothing is left that could complete
+    CoroutineObject *next();
+
+    // The error of a coroutine that failed without any await seeing it, if
+    // there is one; forgets every failure so far
+    std::exception_ptr take_unawaited_failure();
+
+    // Every object the loop holds on to, for the garbage collector
+    void visit(const std::function<void(Object *)> &visitor) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Timer {
+        Clock::time_point deadline;
+        uint64_t sequence; // ties fire in the order they were added
+        PromiseObject *promise;
+
+        bool operator>(const Timer &other) const { // for the min-heap
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    void wait();
+
+    std::deque<CoroutineObject *> ready;
+    std::vector<Timer> timers; // a heap, earliest deadline first
+    uint64_t timers_added = 0;
+    std::unordered_map<int, std::vector<PromiseObject *>> readers; // by file descriptor
+    std::vector<PromiseObject *> failures;
+    int poller = -1; // epoll instance, created on first use
+};
+
+#endif //EVENT_LOOP_H
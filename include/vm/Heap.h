@@ -0,0 +1,110 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef HEAP_H
+#define HEAP_H
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "Value.h"
+
+// What one or more heaps allocated and what their collections cost, for --gc-stats
+struct GcStats {
+    uint64_t allocated = 0; // objects
+    uint64_t allocated_bytes = 0;
+    uint64_t promoted = 0; // young objects that survived a collection
+    uint64_t freed = 0;
+    uint64_t live = 0; // objects, as of statistics()
+    uint64_t live_bytes = 0;
+    std::vector<uint64_t> minor_pauses; // nanoseconds each
+    std::vector<uint64_t> major_pauses;
+
+    void merge(const GcStats &other);
+    void report(std::ostream &out) const;
+};
+
+// Generational mark-sweep heap of one VM executor.
+//
+// New objects are young. Once they have taken NURSERY_BYTES, the next
+// safepoint collects the young generation only: it marks from the roots and
+// the remembered set, the old objects that may point at young ones, frees the
+// young objects it did not reach and promotes the rest. Only once the old
+// generation has doubled since the last full collection does a collection
+// mark and sweep both. Every executor collects its own heap on its own thread,
+// so the workers of a run collect in parallel and never wait for each other.
+//
+// Objects never move: the event loop, the scheduler and the interpreter hold
+// raw pointers to them. An object another thread may reach, because it went
+// into a global or a task handle escaped, is shared instead, along with
+// everything it points at, and kept until the heap is freed. Collections never
+// trace shared objects, so other threads may read and fill them meanwhile.
+//
+// Roots are the caller's business: collect() calls back to have it mark() the
+// registers each frame's stack map lists and everything else it holds.
+class Heap {
+public:
+    static constexpr size_t NURSERY_BYTES = size_t{256} << 10;
+    static constexpr size_t MIN_OLD_BYTES = size_t{8} << 20; // below which no full collection is needed
+
+    Heap() = default;
+    ~Heap();
+
+    Heap(const Heap &) = delete;
+    Heap &operator=(const Heap &) = delete;
+
+    template <typename T, typename... Arguments>
+    T *allocate(Arguments &&...arguments) {
+        auto object = std::make_unique<T>(std::forward<Arguments>(arguments)...);
+        adopt(object.get());
+        return object.release();
+    }
+
+    // Whether the next safepoint should collect
+    [[nodiscard]] bool collection_due() const { return young_bytes >= NURSERY_BYTES; }
+
+    // Takes over an object allocated outside any heap, e.g. a task's result
+    void adopt(Object *object);
+
+    // Keeps `value` and what it points at for the rest of the run, so other threads can use them
+    void share(const Value &value);
+
+    // Write barrier: `object` may have been made to point at a young object
+    void remember(Object &object) {
+        if (object.space == Space::Shared) return share_contents(object);
+        if (object.space == Space::Young || object.space == Space::Static || object.remembered) return;
+        object.remembered = true;
+        remembered.push_back(&object);
+    }
+
+    // `roots` must mark() everything the program can reach other than through other objects
+    void collect(const std::function<void()> &roots);
+    void mark(const Value &value) {
+        if (value.is_pointer()) mark(value.as_object());
+    }
+    void mark(Object *object);
+
+    [[nodiscard]] GcStats statistics() const;
+
+private:
+    void share_contents(Object &object);
+    void trace(Object &object);
+    void sweep(std::vector<Object *> &objects);
+
+    std::vector<Object *> young, old, shared;
+    size_t young_bytes = 0, old_bytes = 0, shared_bytes = 0;
+    size_t old_limit = MIN_OLD_BYTES;
+    std::vector<Object *> remembered;
+    std::vector<Object *> gray; // marked but not yet traced
+    bool full = false;          // whether the collection in progress is
+    GcStats stats;
+};
+
+#endif //HEAP_H
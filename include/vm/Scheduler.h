@@ -0,0 +1,111 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../concurrency/ChaseLevDeque.h"
+#include "Bytecode.h"
+#include "Heap.h"
+
+class VirtualMachine;
+
+// A call started by `spawn` or `thread`, and the handle the program joins on.
+// It belongs to the heap of the executor that spawned it, which keeps it until
+// it is done. Whichever worker runs it writes the result and error before `done`
+// is set; they are read only after.
+struct TaskObject : Object {
+    uint16_t function;
+    std::vector<Value> arguments; // released once the spawner sees it done
+    SourceLocation site;          // of the spawn, for failures to start it
+    Value result;
+    std::unique_ptr<Object> transit; // a copy of the result, until the spawner's heap adopts it
+    std::exception_ptr error;        // the RuntimeError that ended it, rethrown by join
+    std::atomic<bool> done{false};
+    std::atomic<bool> joined{false}; // whether any join saw its outcome
+
+    TaskObject(uint16_t function, std::vector<Value> arguments, SourceLocation site)
+        : Object(ObjectKind::Task), function(function), arguments(std::move(arguments)), site(site) {}
+};
+
+// M:N runtime for the tasks of one run.
+//
+// Each of `workers` threads runs bytecode on an executor of its own, a
+// VirtualMachine sharing the run's module, globals and output, and owns a
+// Chase-Lev deque. The thread that started the run is worker 0. A task spawned
+// on a worker goes to the bottom of its deque; idle workers steal from the top
+// of a random victim's. Tasks spawned anywhere else, i.e. on a `thread`, go to
+// a shared injection queue. Workers with nothing to do park until new work or
+// a completion bumps the epoch.
+//
+// Joining an unfinished task helps instead of blocking: the joining thread runs
+// other tasks on top of its own register stack until the task is done, so a
+// task costs one allocation and no stack of its own. `thread` tasks get a
+// dedicated OS thread and executor instead, for work that blocks or must not
+// share a core.
+class Scheduler {
+public:
+    // `workers` counts the calling thread; 0 means one per hardware thread
+    Scheduler(const VirtualMachine &root, unsigned workers);
+
+    // Waits for running tasks to reach their end; queued ones never start
+    ~Scheduler();
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    void spawn(TaskObject *task);
+    void start_thread(TaskObject *task);
+
+    // Runs other tasks on `self` until `task` is done
+    void join(TaskObject &task, VirtualMachine &self);
+
+    // Until every task has finished, then rethrows the first error no join saw
+    void wait_all(VirtualMachine &self);
+
+    // Instructions the other executors counted; exact once wait_all returned
+    [[nodiscard]] uint64_t instructions() const;
+    [[nodiscard]] GcStats gc_statistics() const; // likewise
+
+private:
+    TaskObject *find_task();
+    void run(TaskObject &task, VirtualMachine &executor);
+    void worker_loop(unsigned index, VirtualMachine &executor);
+    void park(uint64_t seen);
+    void wake();
+
+    const VirtualMachine &root;
+    std::vector<std::unique_ptr<ChaseLevDeque<TaskObject *>>> deques; // by worker
+    std::vector<std::unique_ptr<VirtualMachine>> executors;          // of worker threads and `thread` tasks
+    std::vector<std::thread> worker_threads;                         // 1 to N-1
+    std::vector<std::thread> dedicated;                              // of `thread` tasks
+
+    std::mutex injected_mutex;
+    std::deque<TaskObject *> injected;
+    std::atomic<size_t> injected_count{0};
+
+    std::atomic<size_t> pending{0}; // started but not done
+    std::atomic<uint64_t> epoch{0}; // bumped by every new task and completion
+    std::atomic<unsigned> sleeping{0};
+    std::atomic<bool> stopping{false};
+    std::mutex park_mutex;
+    std::condition_variable parked;
+
+    std::mutex state_mutex; // executors, dedicated threads and failures
+    std::vector<TaskObject *> failed; // their spawners keep them until the run ends
+};
+
+#endif //SCHEDULER_H
@@ -0,0 +1,168 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef VALUE_H
+#define VALUE_H
+
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+enum class ObjectKind : uint8_t {
+    String,
+    Integer, // an integer too wide to be stored inline
+    Task,      // handle of a spawned call, see TaskObject
+    Coroutine, // a call of an async function, see CoroutineObject
+    Event      // a timer or file descriptor an async function can await, see PromiseObject
+};
+
+// Which part of a Heap an object belongs to
+enum class Space : uint8_t {
+    Static, // not in any heap, e.g. a constant the module owns
+    Young,
+    Old,
+    Shared // reachable from other threads, so kept for the rest of the run
+};
+
+// Header shared by everything the VM allocates on its heap
+struct Object {
+    ObjectKind kind;
+    Space space = Space::Static;
+    bool marked = false;
+    bool remembered = false; // in its heap's remembered set
+
+    explicit Object(ObjectKind kind) : kind(kind) {}
+    virtual ~Object() = default; // owners hold them as Object
+};
+
+struct StringObject : Object {
+    std::string text;
+
+    explicit StringObject(std::string text) : Object(ObjectKind::String), text(std::move(text)) {}
+};
+
+struct IntegerObject : Object {
+    int64_t value;
+
+    explicit IntegerObject(int64_t value) : Object(ObjectKind::Integer), value(value) {}
+};
+
+enum class ValueKind : uint8_t {
+    Null,
+    Bool,
+    Int,    // every integer width, sign-extended to 64 bits; u64 keeps its bit pattern
+    Double, // every floating-point width
+    Char,
+    Object
+};
+
+// A runtime value in 64 bits, NaN-boxed.
+//
+// A double is stored as itself. Everything else lives in the payload of a
+// negative quiet NaN, which no arithmetic produces once NaNs are canonicalized
+// on the way in: the top 13 bits are set, the next 3 hold a tag and the low 48
+// bits the payload. Integers that fit in 48 bits are stored inline; wider ones
+// are boxed in an IntegerObject, which only the VM may allocate (see
+// VirtualMachine::integer). Heap pointers fit the payload on every supported
+// 64-bit target.
+//
+// Registers, globals, constant pools and object fields all hold these by value.
+class Value {
+public:
+    static constexpr int SMALL_INT_BITS = 48;
+
+    Value() : bits(NULL_BITS) {}
+
+    static Value null() { return {}; }
+    static Value boolean(bool value) { return Value(BOOL_BITS | uint64_t{value}); }
+    static Value number(double value) {
+        return Value(std::isnan(value) ? CANONICAL_NAN : std::bit_cast<uint64_t>(value));
+    }
+    static Value character(char value) { return Value(CHAR_BITS | uint64_t{static_cast<uint8_t>(value)}); }
+    static Value object(Object *value) { return Value(OBJECT_BITS | std::bit_cast<uint64_t>(value)); }
+
+    // Only for integers that fit_inline; others need an IntegerObject
+    static Value small_integer(int64_t value) { return Value(INT_BITS | (static_cast<uint64_t>(value) & PAYLOAD)); }
+    static bool fits_inline(int64_t value) { return value << (64 - SMALL_INT_BITS) >> (64 - SMALL_INT_BITS) == value; }
+
+    [[nodiscard]] ValueKind kind() const {
+        switch (tag()) {
+            case NULL_BITS: return ValueKind::Null;
+            case BOOL_BITS: return ValueKind::Bool;
+            case INT_BITS: return ValueKind::Int;
+            case CHAR_BITS: return ValueKind::Char;
+            case OBJECT_BITS: return as_object()->kind == ObjectKind::Integer ? ValueKind::Int : ValueKind::Object;
+            default: return ValueKind::Double;
+        }
+    }
+
+    [[nodiscard]] bool is_null() const { return bits == NULL_BITS; }
+    [[nodiscard]] bool is_bool() const { return tag() == BOOL_BITS; }
+    [[nodiscard]] bool is_small_int() const { return tag() == INT_BITS; }
+    [[nodiscard]] bool is_int() const { return is_small_int() || is_object_of(ObjectKind::Integer); }
+    [[nodiscard]] bool is_double() const { return (bits & BOXED) != BOXED; }
+    [[nodiscard]] bool is_number() const { return is_double() || is_int(); }
+    [[nodiscard]] bool is_char() const { return tag() == CHAR_BITS; }
+    [[nodiscard]] bool is_object() const { return tag() == OBJECT_BITS && !is_object_of(ObjectKind::Integer); }
+    [[nodiscard]] bool is_pointer() const { return tag() == OBJECT_BITS; } // any object, boxed integers included
+    [[nodiscard]] bool is_string() const { return is_object_of(ObjectKind::String); }
+    [[nodiscard]] bool is_task() const { return is_object_of(ObjectKind::Task); }
+    [[nodiscard]] bool is_awaitable() const {
+        return is_object_of(ObjectKind::Coroutine) || is_object_of(ObjectKind::Event);
+    }
+
+    [[nodiscard]] bool as_bool() const { return (bits & 1) != 0; }
+    [[nodiscard]] int64_t as_small_int() const {
+        return static_cast<int64_t>(bits << (64 - SMALL_INT_BITS)) >> (64 - SMALL_INT_BITS);
+    }
+    [[nodiscard]] int64_t as_int() const {
+        return is_small_int() ? as_small_int() : static_cast<IntegerObject *>(as_object())->value;
+    }
+    [[nodiscard]] double as_double() const { return std::bit_cast<double>(bits); }
+    [[nodiscard]] double as_number() const { return is_double() ? as_double() : static_cast<double>(as_int()); }
+    [[nodiscard]] char as_char() const { return static_cast<char>(bits & 0xff); }
+    [[nodiscard]] Object *as_object() const { return std::bit_cast<Object *>(bits & PAYLOAD); }
+    [[nodiscard]] const std::string &as_string() const { return static_cast<StringObject *>(as_object())->text; }
+
+    // The raw encoding; equal bits mean equal values for everything but doubles and boxed integers
+    [[nodiscard]] uint64_t raw() const { return bits; }
+
+private:
+    static constexpr uint64_t BOXED = 0xfff8'0000'0000'0000;
+    static constexpr uint64_t TAG = 0xffff'0000'0000'0000;
+    static constexpr uint64_t PAYLOAD = 0x0000'ffff'ffff'ffff;
+    static constexpr uint64_t CANONICAL_NAN = 0x7ff8'0000'0000'0000;
+
+    static constexpr uint64_t NULL_BITS = BOXED | uint64_t{1} << 48;
+    static constexpr uint64_t BOOL_BITS = BOXED | uint64_t{2} << 48;
+    static constexpr uint64_t INT_BITS = BOXED | uint64_t{3} << 48;
+    static constexpr uint64_t CHAR_BITS = BOXED | uint64_t{4} << 48;
+    static constexpr uint64_t OBJECT_BITS = BOXED | uint64_t{5} << 48;
+
+    explicit Value(uint64_t bits) : bits(bits) {}
+
+    [[nodiscard]] uint64_t tag() const { return bits & TAG; }
+    [[nodiscard]] bool is_object_of(ObjectKind kind) const {
+        return tag() == OBJECT_BITS && as_object()->kind == kind;
+    }
+
+    uint64_t bits;
+};
+
+static_assert(sizeof(Value) == 8 && sizeof(void *) == 8, "NaN-boxing needs 64-bit values and pointers");
+
+// Name of the value's kind for runtime error messages
+const char *kind_name(const Value &value);
+
+// How `print` shows a value
+std::string to_display(const Value &value);
+
+// Identity for objects other than strings, which compare by contents
+bool values_equal(const Value &a, const Value &b);
+
+#endif //VALUE_H
@@ -0,0 +1,207 @@
+//
+// Created on 10/19/2026.
+//
+
+#ifndef VIRTUAL_MACHINE_H
+#define VIRTUAL_MACHINE_H
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../jit/JitCompiler.h"
+#include "Bytecode.h"
+#include "EventLoop.h"
+#include "Heap.h"
+#include "Scheduler.h"
+
+// Threaded dispatch needs the labels-as-values extension; SPARKC_VM_SWITCH_DISPATCH
+// forces the portable switch loop, e.g. to compare the two
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(SPARKC_VM_SWITCH_DISPATCH)
+#define SPARKC_THREADED_DISPATCH 1
+#endif
+
+struct RuntimeError : std::runtime_error {
+    SourceLocation location;
+
+    RuntimeError(SourceLocation location, const std::string &message)
+        : std::runtime_error(message), location(location) {}
+};
+
+// Executes a BytecodeModule.
+//
+// All frames live in one fixed register stack: a call's arguments are already
+// in the caller's registers R[A].., and the callee's frame simply starts there,
+// so calling copies nothing. The callee leaves its result in its first
+// register, which is the caller's R[A].
+//
+// The dispatch loop is direct-threaded with computed goto where the compiler
+// supports it, so each handler jumps straight to the next one, and a switch
+// loop elsewhere. Generic instructions handle inline integers inline; boxed
+// integers, mixed, floating-point and string operands take an out-of-line slow
+// path. Typed integer instructions skip the kind dispatch and, below 64 bits,
+// never need to box their result.
+//
+// With the JIT enabled, execution is tiered: a function whose calls and loop
+// back edges reach JIT_THRESHOLD is compiled to native code, which then runs
+// from every call, backward jump and return into it until it exits before an
+// instruction it leaves to the interpreter. Entries that would only run a few
+// instructions natively before exiting again stay interpreted, which keeps
+// small recursive functions from paying for the switch on every call. A
+// function that deoptimizes
+// DEOPT_LIMIT times goes back to being interpreted for good.
+//
+// The first `spawn` or `thread` starts a Scheduler, whose other threads each
+// run an executor of their own: another VirtualMachine with its own registers,
+// frames, heap and tiers that shares the run's module, globals and output.
+// Globals are not synchronized; a task's stores are visible to whoever joins
+// it. The run ends once every task has.
+//
+// Async functions are stackless coroutines on the executor's EventLoop. A call
+// runs on the register stack like any other until an AWAIT finds its operand
+// unfinished; then the frame is copied into the coroutine, only the registers
+// that await point keeps, and popped. Resuming copies them back on top of
+// whatever the stack holds, so a suspended coroutine owns no stack. An await
+// outside an async function runs the loop until its operand is done instead.
+// The run also ends only once nothing is left for the loop to wait for.
+//
+// Objects live in the executor's generational Heap. Calls and loop back edges
+// are its safepoints: once the nursery is full, the next one collects, with
+// the stack maps of every frame's current instruction as the roots. Values
+// stored into globals are shared first, since other executors may read them.
+// A task belongs to the heap of the executor that spawned it, which keeps it
+// as a root until it is done and frees it once unreachable. Strings and boxed
+// integers are copied into and out of it rather than shared; anything else it
+// is passed or returns, and the task itself once its handle leaves the
+// spawning executor, is shared.
+class VirtualMachine {
+public:
+    static constexpr size_t STACK_SIZE = size_t{1} << 18; // registers shared by all frames
+    static constexpr size_t MAX_FRAMES = size_t{1} << 16;
+    static constexpr uint32_t JIT_THRESHOLD = 1000;
+    static constexpr uint32_t DEOPT_LIMIT = 100;
+    // Interpreter loops one thread may nest: tasks run while joining, coroutines
+    // started or resumed, and async functions awaited directly. Bounds its C++ stack.
+    static constexpr unsigned MAX_NESTED_RUNS = 1024;
+
+    // `workers` threads run tasks, this one included; 0 means one per hardware thread
+    explicit VirtualMachine(std::ostream &out, bool jit = true, unsigned workers = 0);
+    ~VirtualMachine(); // stops the scheduler before freeing the tasks it may still be running
+
+    // Run the module's entry function, then wait for every task; throws RuntimeError
+    void run(const BytecodeModule &module);
+
+    // Instructions executed so far; only counted in SPARKC_TIME_INSTRUMENT builds, and never in native code
+    [[nodiscard]] uint64_t instructions() const;
+
+    // Heaps of this run's executors, once it returned
+    [[nodiscard]] GcStats gc_statistics() const;
+
+private:
+    friend class Scheduler;
+
+    // What the executors of one run share, owned by the VirtualMachine it was started on
+    struct Shared {
+        std::ostream &out;
+        unsigned workers;
+        const BytecodeModule *module = nullptr;
+        std::vector<Value> globals;
+        std::mutex output;                    // held for each printed line once tasks run
+        std::unique_ptr<Scheduler> scheduler; // started by the first task
+
+        Shared(std::ostream &out, unsigned workers) : out(out), workers(workers) {}
+    };
+
+    struct Frame {
+        const BytecodeFunction *function;
+        const uint32_t *pc; // where to resume once the frame it called returns
+        Value *base;
+    };
+
+    // A function's progress through the tiers
+    struct Tier {
+        uint32_t hotness = 0;
+        uint32_t deopts = 0;
+        JitCompiler::NativeCode native;
+        bool rejected = false; // interpreted for good
+    };
+
+    // An executor for another thread of the run `shared` belongs to
+    VirtualMachine(Shared &shared, bool jit);
+    [[nodiscard]] std::unique_ptr<VirtualMachine> executor() const;
+
+    // Runs `entry` from `pc` with its frame at `base` until it returns, with the
+    // result in base[0], and then returns null. An async `entry` may instead
+    // suspend: its frame is saved into `coroutine`, allocated here if null, which
+    // is returned.
+    CoroutineObject *execute(const BytecodeFunction &entry, Value *base, const uint32_t *pc,
+                             CoroutineObject *coroutine);
+    Value *stack_top(); // above the innermost frame
+    void collect_garbage();
+
+    // Runs a task's call above the frames already on this executor
+    Value run_task(TaskObject &task);
+    void receive(TaskObject &task); // a finished task's result, if it was spawned here
+    TaskObject *start_task(uint16_t function, const Value *arguments, const uint32_t *pc, bool dedicated);
+    Value join(const Value &handle, const uint32_t *pc);
+    void print(const Value *values, int count);
+
+    // Coroutines run on this executor's event loop, nested on its stack
+    CoroutineObject *allocate_coroutine(uint16_t function);
+    CoroutineObject *start_coroutine(uint16_t function, Value *base, const uint32_t *pc);
+    CoroutineObject *await_call(const BytecodeFunction &callee, Value *base);
+    void run_coroutine(CoroutineObject &coroutine, const BytecodeFunction &function, Value *base, const uint32_t *pc);
+    CoroutineObject *suspend(CoroutineObject *coroutine, const Value *R, const uint32_t *pc, uint8_t point,
+                             PromiseObject &awaited);
+    void resume(CoroutineObject &coroutine);
+    PromiseObject &awaitable(const Value &value, const uint32_t *pc) const;
+    Value await(PromiseObject &promise, const uint32_t *pc); // where suspending is impossible
+    Value settle(PromiseObject &promise);
+    PromiseObject *event(const Value &argument, bool timer, const uint32_t *pc);
+    void drain();
+
+    // Continues the innermost frame, about to execute `pc`, in native code if
+    // its function, whose tier is `tier`, is or just became hot; returns where
+    // the interpreter resumes
+    const uint32_t *tier_up(const uint32_t *pc, Value *R, Tier &tier);
+
+    template <typename T>
+    Value typed_arithmetic(OpCode op, const Value &left, const Value &right, const uint32_t *pc);
+    template <typename T>
+    Value typed_result(int64_t value);
+    Value arithmetic(OpCode op, const Value &left, const Value &right, const uint32_t *pc);
+    bool less(OpCode op, const Value &left, const Value &right, const uint32_t *pc) const;
+    bool truthy(const Value &value, const uint32_t *pc) const;
+
+    // An integer result, boxed on the heap when it does not fit inline
+    Value integer(int64_t value) { return Value::fits_inline(value) ? Value::small_integer(value) : box_integer(value); }
+    Value box_integer(int64_t value);
+    StringObject *allocate_string(std::string text);
+
+    [[noreturn]] void operand_error(OpCode op, const Value &left, const Value &right, const uint32_t *pc) const;
+
+    // The error at the instruction before `pc` in the innermost frame
+    [[noreturn]] void fail(const uint32_t *pc, const std::string &message) const;
+
+    std::unique_ptr<Shared> owned; // null on executors of other threads
+    Shared *shared;
+    std::vector<Value> stack;
+    std::vector<Frame> frames;
+    unsigned nested_runs = 0;
+    Heap heap;
+    std::unique_ptr<JitCompiler> jit; // null when disabled
+    std::vector<Tier> tiers;          // by function
+    EventLoop loop;
+    std::vector<CoroutineObject *> running; // started or resumed further up the C++ stack
+    std::vector<TaskObject *> spawned;      // here, and not yet seen done
+    uint64_t executed = 0;
+    GcStats executor_gc; // of the other executors of the last run
+};
+
+#endif //VIRTUAL_MACHINE_H
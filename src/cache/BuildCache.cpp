@@ -0,0 +1,212 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/cache/BuildCache.h"
+#include "../../include/util/Hash.h"
+#include "../../include/util/Version.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    constexpr uint32_t CACHE_MAGIC = 0x53504b43; // "SPKC"
+    constexpr uint32_t CACHE_FORMAT = 2;
+
+    // Little helpers for the flat binary layout: fixed-width integers and
+    // length-prefixed strings, read back with bounds checks.
+    class Writer {
+    public:
+        void u32(uint32_t value) { raw(&value, sizeof value); }
+        void u64(uint64_t value) { raw(&value, sizeof value); }
+        void i32(int32_t value) { raw(&value, sizeof value); }
+        void str(const std::string &value) {
+            u32(static_cast<uint32_t>(value.size()));
+            buffer.append(value);
+        }
+
+        std::string buffer;
+
+    private:
+        void raw(const void *data, size_t size) {
+            buffer.append(static_cast<const char *>(data), size);
+        }
+    };
+
+    class Reader {
+    public:
+        explicit Reader(const std::string &data) : data(data) {}
+
+        bool u32(uint32_t &value) { return raw(&value, sizeof value); }
+        bool u64(uint64_t &value) { return raw(&value, sizeof value); }
+        bool i32(int32_t &value) { return raw(&value, sizeof value); }
+        bool str(std::string &value) {
+            uint32_t size = 0;
+            if (!u32(size) || data.size() - offset < size) return false;
+            value.assign(data, offset, size);
+            offset += size;
+            return true;
+        }
+
+    private:
+        bool raw(void *out, size_t size) {
+            if (data.size() - offset < size) return false;
+            data.copy(static_cast<char *>(out), size, offset);
+            offset += size;
+            return true;
+        }
+
+        const std::string &data;
+        size_t offset = 0;
+    };
+
+    bool read_entry(Reader &in, std::string &file, CacheEntry &entry) {
+        uint64_t mtime = 0;
+        uint32_t count = 0;
+        if (!in.str(file) || !in.u64(entry.content_hash) || !in.u64(mtime) || !in.u64(entry.size) ||
+            !in.u64(entry.token_fingerprint) || !in.u64(entry.interface_hash) || !in.str(entry.module_name)) {
+            return false;
+        }
+        entry.mtime = static_cast<int64_t>(mtime);
+
+        if (!in.u32(count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            std::pair<std::string, uint64_t> dependency;
+            if (!in.str(dependency.first) || !in.u64(dependency.second)) return false;
+            entry.dependencies.push_back(std::move(dependency));
+        }
+
+        if (!in.u32(count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            Diagnostic d{};
+            uint32_t severity = 0;
+            if (!in.u32(severity) || !in.str(d.file) || !in.i32(d.line) || !in.i32(d.column) || !in.str(d.message)) {
+                return false;
+            }
+            d.severity = static_cast<Severity>(severity);
+            entry.diagnostics.push_back(std::move(d));
+        }
+
+        return true;
+    }
+
+    std::pair<int64_t, uint64_t> stamp_of(const std::string &path) {
+        std::error_code ec;
+        const uint64_t size = std::filesystem::file_size(path, ec);
+        if (ec) return {-1, 0};
+        const auto mtime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+        return {ec ? -1 : static_cast<int64_t>(mtime), size};
+    }
+}
+
+BuildCache::BuildCache(std::string path, uint64_t config_hash)
+    : path(std::move(path)), config_hash(config_hash) {
+}
+
+uint64_t BuildCache::make_config_hash(const std::string &command, const std::vector<std::string> &flags) {
+    uint64_t hash = fnv1a(SPARKC_VERSION);
+    hash = fnv1a(command, hash_combine(hash, 0));
+    for (const auto &flag : flags) hash = fnv1a(flag, hash_combine(hash, 1));
+    return hash;
+}
+
+uint64_t BuildCache::hash_content(const std::string &content) {
+    return fnv1a(content);
+}
+
+void BuildCache::load() {
+    const auto stamp = stamp_of(path);
+    if (stamp.first >= 0 && stamp == disk_stamp && !dirty) return;
+
+    entries.clear();
+    dirty = false;
+    disk_stamp = stamp;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return;
+    const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    Reader reader(data);
+    uint32_t magic = 0, format = 0, count = 0;
+    uint64_t config = 0;
+    if (!reader.u32(magic) || magic != CACHE_MAGIC || !reader.u32(format) || format != CACHE_FORMAT ||
+        !reader.u64(config) || config != config_hash || !reader.u32(count)) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string file;
+        CacheEntry entry;
+        if (!read_entry(reader, file, entry)) {
+            entries.clear(); // truncated or corrupt: start over rather than trust half of it
+            return;
+        }
+        entries.emplace(std::move(file), std::move(entry));
+    }
+}
+
+bool BuildCache::save() {
+    if (!dirty) return true;
+
+    Writer out;
+    out.u32(CACHE_MAGIC);
+    out.u32(CACHE_FORMAT);
+    out.u64(config_hash);
+    out.u32(static_cast<uint32_t>(entries.size()));
+
+    for (const auto &[file, entry] : entries) {
+        out.str(file);
+        out.u64(entry.content_hash);
+        out.u64(static_cast<uint64_t>(entry.mtime));
+        out.u64(entry.size);
+        out.u64(entry.token_fingerprint);
+        out.u64(entry.interface_hash);
+        out.str(entry.module_name);
+
+        out.u32(static_cast<uint32_t>(entry.dependencies.size()));
+        for (const auto &[module, hash] : entry.dependencies) {
+            out.str(module);
+            out.u64(hash);
+        }
+
+        out.u32(static_cast<uint32_t>(entry.diagnostics.size()));
+        for (const auto &d : entry.diagnostics) {
+            out.u32(static_cast<uint32_t>(d.severity));
+            out.str(d.file);
+            out.i32(d.line);
+            out.i32(d.column);
+            out.str(d.message);
+        }
+    }
+
+    const std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(out.buffer.data(), static_cast<std::streamsize>(out.buffer.size()));
+        if (!file) return false;
+    }
+    if (std::rename(temp.c_str(), path.c_str()) != 0) return false;
+
+    dirty = false;
+    disk_stamp = stamp_of(path);
+    return true;
+}
+
+const CacheEntry *BuildCache::find(const std::string &file) const {
+    const auto it = entries.find(file);
+    return it != entries.end() ? &it->second : nullptr;
+}
+
+void BuildCache::store(const std::string &file, CacheEntry entry) {
+    const auto it = entries.find(file);
+    if (it != entries.end() && it->second == entry) return;
+    entries.insert_or_assign(file, std::move(entry));
+    dirty = true;
+}
+
+size_t BuildCache::size() const {
+    return entries.size();
+}
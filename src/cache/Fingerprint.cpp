@@ -0,0 +1,31 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/cache/Fingerprint.h"
+#include "../../include/util/Hash.h"
+
+uint64_t token_fingerprint(const TokenStream &tokens) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const Token &token = tokens[i];
+        hash = hash_combine(hash, static_cast<uint64_t>(token.type));
+        hash = fnv1a(token.lexeme, hash);
+    }
+    return hash;
+}
+
+uint64_t interface_hash(const ModuleInterface &interface) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    for (const auto &symbol : interface.symbols) {
+        if (symbol.visibility != Visibility::Public && symbol.visibility != Visibility::Internal) continue;
+
+        hash = hash_combine(hash, static_cast<uint64_t>(symbol.kind));
+        hash = fnv1a(to_string(symbol.visibility) + " " + symbol.name + "(", hash);
+        for (const auto &type : symbol.parameter_types) hash = fnv1a(type + ",", hash);
+        hash = fnv1a(")" + symbol.type + ";", hash);
+    }
+
+    return hash;
+}
@@ -0,0 +1,870 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/cgen/CGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+#define SPARKC_HAS_FORK 1
+#endif
+
+namespace {
+    // Everything the generated code calls. Integers of every width are kept as
+    // int64_t, sign-extended or, for u64, as their bit pattern, like VM registers.
+    constexpr const char *PRELUDE = R"(#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum { SP_NULL, SP_BOOL, SP_INT, SP_DOUBLE, SP_CHAR, SP_STRING } sp_kind;
+
+typedef struct {
+    size_t length;
+    const char *text;
+} sp_string;
+
+typedef struct {
+    sp_kind kind;
+    union {
+        bool b;
+        int64_t i;
+        double d;
+        char c;
+        const sp_string *s;
+    } as;
+} sp_value;
+
+/* Where an instruction that can fail came from */
+typedef struct {
+    int line;
+    int column;
+    const char *function;
+} sp_site;
+
+/* Failures stay out of line so their buffers do not grow every frame; a
+   program need not use every helper */
+#if defined(__GNUC__) || defined(__clang__)
+#define SP_UNUSED __attribute__((unused))
+#define SP_COLD __attribute__((noinline, cold, unused))
+#else
+#define SP_UNUSED
+#define SP_COLD
+#endif
+
+#define SP_MAX_FRAMES 65536
+SP_UNUSED static long sp_depth = 1;
+
+static inline sp_value sp_null(void) { return (sp_value){SP_NULL, {.i = 0}}; }
+static inline sp_value sp_bool(bool b) { return (sp_value){SP_BOOL, {.b = b}}; }
+static inline sp_value sp_int(int64_t i) { return (sp_value){SP_INT, {.i = i}}; }
+static inline sp_value sp_double(double d) { return (sp_value){SP_DOUBLE, {.d = d}}; }
+static inline sp_value sp_char(char c) { return (sp_value){SP_CHAR, {.c = c}}; }
+static inline sp_value sp_str(const sp_string *s) { return (sp_value){SP_STRING, {.s = s}}; }
+
+SP_UNUSED static const char *sp_kind_name(sp_value v) {
+    switch (v.kind) {
+        case SP_NULL: return "null";
+        case SP_BOOL: return "bool";
+        case SP_INT: return "integer";
+        case SP_DOUBLE: return "floating-point";
+        case SP_CHAR: return "char";
+        default: return "string";
+    }
+}
+
+SP_COLD _Noreturn static void sp_fail(const sp_site *site, const char *message) {
+    fflush(stdout);
+    fprintf(stderr, "%s:%d:%d: error: Runtime error: %s in '%s'\n", sp_file, site->line, site->column, message,
+            site->function);
+    exit(1);
+}
+
+SP_COLD _Noreturn static void sp_operand_error(const char *symbol, sp_value a, sp_value b, const sp_site *site) {
+    char message[96];
+    snprintf(message, sizeof message, "Operator '%s' cannot be applied to %s and %s", symbol, sp_kind_name(a),
+             sp_kind_name(b));
+    sp_fail(site, message);
+}
+
+SP_COLD _Noreturn static void sp_negate_error(sp_value a, const sp_site *site) {
+    char message[64];
+    snprintf(message, sizeof message, "Operator '-' cannot be applied to %s", sp_kind_name(a));
+    sp_fail(site, message);
+}
+
+SP_COLD _Noreturn static void sp_overflow(const sp_site *site, const char *callee) {
+    char message[128];
+    snprintf(message, sizeof message, "Stack overflow calling '%s'", callee);
+    sp_fail(site, message);
+}
+
+SP_COLD _Noreturn static void sp_bool_error(sp_value v, const sp_site *site) {
+    char message[64];
+    snprintf(message, sizeof message, "Expected a bool but found %s", sp_kind_name(v));
+    sp_fail(site, message);
+}
+
+static inline bool sp_truthy(sp_value v, const sp_site *site) {
+    if (v.kind != SP_BOOL) sp_bool_error(v, site);
+    return v.as.b;
+}
+
+/* The operands of a typed instruction must be integers */
+static inline void sp_require_ints(const char *symbol, sp_value a, sp_value b, const sp_site *site) {
+    if (a.kind != SP_INT || b.kind != SP_INT) sp_operand_error(symbol, a, b, site);
+}
+
+static inline void sp_require_int(sp_value a, const sp_site *site) {
+    if (a.kind != SP_INT) sp_negate_error(a, site);
+}
+
+/* Typed arithmetic in a width T, computed in its unsigned twin U so that
+   overflow wraps instead of being undefined; MIN / -1 wraps too */
+#define SP_INT_OPS(W, T, U, SIGNED)                                                                               \
+    static inline int64_t sp_add_##W(int64_t a, int64_t b) { return (int64_t)(T)(U)((uint64_t)a + (uint64_t)b); } \
+    static inline int64_t sp_sub_##W(int64_t a, int64_t b) { return (int64_t)(T)(U)((uint64_t)a - (uint64_t)b); } \
+    static inline int64_t sp_mul_##W(int64_t a, int64_t b) { return (int64_t)(T)(U)((uint64_t)a * (uint64_t)b); } \
+    static inline int64_t sp_neg_##W(int64_t a) { return (int64_t)(T)(U)(0 - (uint64_t)a); }                      \
+    static inline int64_t sp_div_##W(int64_t a, int64_t b, const sp_site *site) {                                 \
+        if (b == 0) sp_fail(site, "Division by zero");                                                            \
+        if (SIGNED) return b == -1 ? sp_neg_##W(a) : (int64_t)(T)(U)(uint64_t)(a / b);                            \
+        return (int64_t)(T)((T)a / (T)b);                                                                         \
+    }                                                                                                             \
+    static inline int64_t sp_mod_##W(int64_t a, int64_t b, const sp_site *site) {                                 \
+        if (b == 0) sp_fail(site, "Division by zero");                                                            \
+        if (SIGNED) return b == -1 ? 0 : (int64_t)(T)(U)(uint64_t)(a % b);                                       \
+        return (int64_t)(T)((T)a % (T)b);                                                                         \
+    }
+
+SP_INT_OPS(I8, int8_t, uint8_t, 1)
+SP_INT_OPS(I16, int16_t, uint16_t, 1)
+SP_INT_OPS(I32, int32_t, uint32_t, 1)
+SP_INT_OPS(I64, int64_t, uint64_t, 1)
+SP_INT_OPS(U8, uint8_t, uint8_t, 0)
+SP_INT_OPS(U16, uint16_t, uint16_t, 0)
+SP_INT_OPS(U32, uint32_t, uint32_t, 0)
+SP_INT_OPS(U64, uint64_t, uint64_t, 0)
+
+static inline bool sp_is_number(sp_value v) { return v.kind == SP_INT || v.kind == SP_DOUBLE; }
+static inline double sp_number(sp_value v) { return v.kind == SP_INT ? (double)v.as.i : v.as.d; }
+
+SP_UNUSED static sp_value sp_concat(const sp_string *a, const sp_string *b) {
+    sp_string *s = malloc(sizeof *s);
+    char *text = malloc(a->length + b->length + 1);
+    if (!s || !text) {
+        fputs("out of memory\n", stderr);
+        exit(1);
+    }
+    memcpy(text, a->text, a->length);
+    memcpy(text + a->length, b->text, b->length);
+    text[a->length + b->length] = '\0';
+    s->length = a->length + b->length;
+    s->text = text;
+    return sp_str(s);
+}
+
+/* Generic arithmetic: integers as i64, numbers as doubles, strings concatenate */
+SP_UNUSED static sp_value sp_arithmetic(char op, sp_value a, sp_value b, const sp_site *site) {
+    if (a.kind == SP_INT && b.kind == SP_INT) {
+        switch (op) {
+            case '+': return sp_int(sp_add_I64(a.as.i, b.as.i));
+            case '-': return sp_int(sp_sub_I64(a.as.i, b.as.i));
+            case '*': return sp_int(sp_mul_I64(a.as.i, b.as.i));
+            case '/': return sp_int(sp_div_I64(a.as.i, b.as.i, site));
+            default: return sp_int(sp_mod_I64(a.as.i, b.as.i, site));
+        }
+    }
+    if (sp_is_number(a) && sp_is_number(b)) {
+        const double x = sp_number(a), y = sp_number(b);
+        switch (op) {
+            case '+': return sp_double(x + y);
+            case '-': return sp_double(x - y);
+            case '*': return sp_double(x * y);
+            case '/': return sp_double(x / y);
+            default: return sp_double(fmod(x, y));
+        }
+    }
+    if (op == '+' && a.kind == SP_STRING && b.kind == SP_STRING) return sp_concat(a.as.s, b.as.s);
+
+    const char symbol[2] = {op, '\0'};
+    sp_operand_error(symbol, a, b, site);
+}
+
+SP_UNUSED static sp_value sp_negate(sp_value a, const sp_site *site) {
+    if (a.kind == SP_INT) return sp_int(sp_neg_I64(a.as.i));
+    if (a.kind == SP_DOUBLE) return sp_double(-a.as.d);
+    sp_negate_error(a, site);
+}
+
+SP_UNUSED static int sp_compare_strings(const sp_string *a, const sp_string *b) {
+    const int order = memcmp(a->text, b->text, a->length < b->length ? a->length : b->length);
+    if (order != 0) return order;
+    return a->length < b->length ? -1 : a->length > b->length;
+}
+
+SP_UNUSED static bool sp_equal(sp_value a, sp_value b) {
+    if (sp_is_number(a) && sp_is_number(b)) {
+        if (a.kind == SP_INT && b.kind == SP_INT) return a.as.i == b.as.i;
+        return sp_number(a) == sp_number(b);
+    }
+    if (a.kind != b.kind) return false;
+    switch (a.kind) {
+        case SP_NULL: return true;
+        case SP_BOOL: return a.as.b == b.as.b;
+        case SP_CHAR: return a.as.c == b.as.c;
+        case SP_STRING: return sp_compare_strings(a.as.s, b.as.s) == 0;
+        default: return false;
+    }
+}
+
+SP_UNUSED static bool sp_less(bool or_equal, bool is_unsigned, sp_value a, sp_value b, const sp_site *site) {
+    if (a.kind == SP_INT && b.kind == SP_INT) {
+        if (is_unsigned) {
+            const uint64_t x = (uint64_t)a.as.i, y = (uint64_t)b.as.i;
+            return or_equal ? x <= y : x < y;
+        }
+        return or_equal ? a.as.i <= b.as.i : a.as.i < b.as.i;
+    }
+    if (sp_is_number(a) && sp_is_number(b)) {
+        return or_equal ? sp_number(a) <= sp_number(b) : sp_number(a) < sp_number(b);
+    }
+    if (a.kind == SP_CHAR && b.kind == SP_CHAR) return or_equal ? a.as.c <= b.as.c : a.as.c < b.as.c;
+    if (a.kind == SP_STRING && b.kind == SP_STRING) {
+        const int order = sp_compare_strings(a.as.s, b.as.s);
+        return or_equal ? order <= 0 : order < 0;
+    }
+    sp_operand_error(or_equal ? "<=" : "<", a, b, site);
+}
+
+/* The shortest text that reads back as the same double, fixed or scientific,
+   whichever is shorter */
+SP_UNUSED static void sp_print_double(double d) {
+    if (isnan(d)) {
+        fputs("nan", stdout);
+        return;
+    }
+    if (isinf(d)) {
+        fputs(d < 0 ? "-inf" : "inf", stdout);
+        return;
+    }
+
+    char scientific[32], fixed[400];
+    int precision = 0;
+    for (; precision < 17; ++precision) {
+        snprintf(scientific, sizeof scientific, "%.*e", precision, d);
+        if (strtod(scientific, NULL) == d) break;
+    }
+    const int decimals = precision - atoi(strchr(scientific, 'e') + 1);
+    snprintf(fixed, sizeof fixed, "%.*f", decimals > 0 ? decimals : 0, d);
+    fputs(strlen(fixed) <= strlen(scientific) ? fixed : scientific, stdout);
+}
+
+SP_UNUSED static void sp_print(sp_value v) {
+    switch (v.kind) {
+        case SP_NULL: fputs("null", stdout); break;
+        case SP_BOOL: fputs(v.as.b ? "true" : "false", stdout); break;
+        case SP_INT: printf("%" PRId64, v.as.i); break;
+        case SP_DOUBLE: sp_print_double(v.as.d); break;
+        case SP_CHAR: putchar(v.as.c); break;
+        default: fwrite(v.as.s->text, 1, v.as.s->length, stdout); break;
+    }
+}
+
+/* A value of type u64, which holds its bit pattern */
+SP_UNUSED static void sp_print_u64(sp_value v) {
+    if (v.kind == SP_INT) {
+        printf("%" PRIu64, (uint64_t)v.as.i);
+    } else {
+        sp_print(v);
+    }
+}
+)";
+
+    // The typed helpers' suffix for an integer type id
+    const char *width_name(TypeId type) {
+        static constexpr const char *NAMES[] = {"I8", "I16", "I32", "I64", "U8", "U16", "U32", "U64"};
+        return NAMES[type - TYPE_I8];
+    }
+
+    char operator_char(IROp op) {
+        switch (op) {
+            case IROp::Add: return '+';
+            case IROp::Sub: return '-';
+            case IROp::Mul: return '*';
+            case IROp::Div: return '/';
+            default: return '%';
+        }
+    }
+
+    const char *helper_name(IROp op) {
+        switch (op) {
+            case IROp::Add: return "add";
+            case IROp::Sub: return "sub";
+            case IROp::Mul: return "mul";
+            case IROp::Div: return "div";
+            case IROp::Mod: return "mod";
+            default: return "neg";
+        }
+    }
+
+    std::string c_string(const std::string &text) {
+        std::string out = "\"";
+        for (const char c : text) {
+            const auto byte = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (byte < 0x20 || byte >= 0x7f || c == '?') {
+                // Octal, always three digits so a following digit cannot extend it; '?' avoids trigraphs
+                char escape[5];
+                std::snprintf(escape, sizeof escape, "\\%03o", byte);
+                out += escape;
+            } else {
+                out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+    std::string c_double(double value) {
+        if (std::isnan(value)) return "NAN";
+        if (std::isinf(value)) return value < 0 ? "(-HUGE_VAL)" : "HUGE_VAL";
+        char buffer[40];
+        std::snprintf(buffer, sizeof buffer, "%a", value); // exact
+        return std::string("(") + buffer + ")";
+    }
+
+    std::string c_int(int64_t value) {
+        if (value == INT64_MIN) return "INT64_MIN";
+        return "INT64_C(" + std::to_string(value) + ")";
+    }
+
+    const char *c_type(uint8_t kind) {
+        static constexpr const char *TYPES[] = {"sp_value", "int64_t", "double", "bool", "sp_value"};
+        return TYPES[kind];
+    }
+}
+
+CGenerator::CGenerator(const IRModule &module) : module(module) {
+}
+
+std::string CGenerator::generate(const IRModule &module, const std::string &source_path) {
+    // Only what the entry can call; inlining leaves callees nothing refers to
+    std::vector<bool> reachable(module.functions.size());
+    std::vector<uint32_t> worklist{module.entry};
+    reachable[module.entry] = true;
+    while (!worklist.empty()) {
+        const IRFunction &function = *module.functions[worklist.back()];
+        worklist.pop_back();
+        for (const auto &block : function.blocks) {
+            for (const auto &instruction : block->instructions) {
+                if (instruction->op == IROp::Call && !reachable[instruction->index]) {
+                    reachable[instruction->index] = true;
+                    worklist.push_back(instruction->index);
+                }
+            }
+        }
+    }
+
+    CGenerator generator(module);
+    for (size_t i = 0; i < module.functions.size(); ++i) {
+        if (reachable[i]) generator.generate_function(*module.functions[i], static_cast<uint32_t>(i));
+    }
+
+    std::ostringstream out;
+    out << "/* Generated by sparkc from " << source_path << " */\n";
+    out << "static const char *const sp_file = " << c_string(source_path) << ";\n\n";
+    out << PRELUDE << "\n";
+
+    out << "SP_UNUSED static const sp_site sp_sites[] = {\n";
+    for (const std::string &site : generator.sites) out << "    " << site << ",\n";
+    if (generator.sites.empty()) out << "    {0, 0, \"\"},\n";
+    out << "};\n\n";
+
+    out << generator.strings.str();
+    if (!module.globals.empty()) out << "static sp_value sp_globals[" << module.globals.size() << "];\n\n";
+
+    for (size_t i = 0; i < module.functions.size(); ++i) {
+        if (!reachable[i]) continue;
+        const IRFunction &function = *module.functions[i];
+        out << "static sp_value sp_f" << i << "(";
+        for (size_t p = 0; p < function.parameters.size(); ++p) out << (p > 0 ? ", " : "") << "sp_value a" << p;
+        out << (function.parameters.empty() ? "void" : "") << "); /* " << function.name << " */\n";
+    }
+    out << "\n" << generator.functions.str();
+
+    // The program runs on a thread whose stack holds SP_MAX_FRAMES of even large frames
+    out << "static void *sp_run(void *unused) {\n    (void)unused;\n    sp_f" << module.entry
+        << "();\n    return NULL;\n}\n\n";
+    out << R"(#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+
+int main(void) {
+    pthread_attr_t attributes;
+    pthread_t thread;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, (size_t)1 << 30);
+    if (pthread_create(&thread, &attributes, sp_run, NULL) != 0) {
+        sp_run(NULL);
+    } else {
+        pthread_join(thread, NULL);
+    }
+    return 0;
+}
+#else
+int main(void) {
+    sp_run(NULL);
+    return 0;
+}
+#endif
+)";
+    return out.str();
+}
+
+int CGenerator::build_executable(const std::string &c_path, const std::string &output) {
+#ifdef SPARKC_HAS_FORK
+    const char *compiler = std::getenv("CC");
+    if (!compiler || !*compiler) compiler = "cc";
+
+    const pid_t child = fork();
+    if (child < 0) return -1;
+    if (child == 0) {
+        execlp(compiler, compiler, "-std=c11", "-O2", "-pthread", "-o", output.c_str(), c_path.c_str(), "-lm",
+               static_cast<char *>(nullptr));
+        _exit(127);
+    }
+
+    int status = 0;
+    if (waitpid(child, &status, 0) < 0 || !WIFEXITED(status)) return -1;
+    return WEXITSTATUS(status) == 127 ? -1 : WEXITSTATUS(status);
+#else
+    (void) c_path;
+    (void) output;
+    return -1;
+#endif
+}
+
+// ===== FUNCTIONS =====
+
+void CGenerator::generate_function(const IRFunction &function, uint32_t index) {
+    this->function = &function;
+    body.str("");
+    infer_kinds(function);
+    find_live_values(function);
+
+    const std::vector<BasicBlock *> order = reverse_postorder(function);
+    std::vector<const IRInstruction *> values;
+    for (const BasicBlock *block : order) {
+        for (const auto &instruction : block->instructions) {
+            if (live[instruction->id] && kind(*instruction) != Kind::Top) values.push_back(instruction.get());
+        }
+    }
+
+    functions << "static sp_value sp_f" << index << "(";
+    for (size_t p = 0; p < function.parameters.size(); ++p) functions << (p > 0 ? ", " : "") << "sp_value a" << p;
+    functions << (function.parameters.empty() ? "void" : "") << ") {\n";
+    for (const IRInstruction *value : values) {
+        functions << "    " << c_type(static_cast<uint8_t>(kind(*value))) << " " << name(*value) << ";";
+        if (value->op == IROp::Phi) functions << " " << c_type(static_cast<uint8_t>(kind(*value))) << " p" << value->id << ";";
+        functions << "\n";
+    }
+
+    for (const BasicBlock *block : order) {
+        if (!block->predecessors.empty()) body << "b" << block->id << ":\n";
+        for (const auto &instruction : block->instructions) {
+            if (is_terminator(instruction->op)) {
+                terminator(*instruction);
+            } else if (live[instruction->id] || instruction->has_side_effects()) {
+                this->instruction(*instruction);
+            }
+        }
+    }
+    functions << body.str() << "}\n\n";
+}
+
+// Values something observable depends on; -O0 leaves dead ones the C compiler
+// would otherwise warn about. Instructions that may fail count as observable.
+void CGenerator::find_live_values(const IRFunction &function) {
+    live.assign(function.value_count(), false);
+    std::vector<const IRInstruction *> worklist;
+    for (const auto &block : function.blocks) {
+        for (const auto &instruction : block->instructions) {
+            if (instruction->may_trap()) live[instruction->id] = true;
+            if (instruction->may_trap() || instruction->has_side_effects()) worklist.push_back(instruction.get());
+        }
+    }
+
+    while (!worklist.empty()) {
+        const IRInstruction *instruction = worklist.back();
+        worklist.pop_back();
+        for (const IRInstruction *operand : instruction->operands) {
+            if (live[operand->id]) continue;
+            live[operand->id] = true;
+            worklist.push_back(operand);
+        }
+    }
+}
+
+// The most specific C type of every value, found optimistically: phis start
+// out unknown and only widen to sp_value when their operands disagree
+void CGenerator::infer_kinds(const IRFunction &function) {
+    kinds.assign(function.value_count(), Kind::Top);
+    const std::vector<BasicBlock *> order = reverse_postorder(function);
+
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const BasicBlock *block : order) {
+            for (const auto &instruction : block->instructions) {
+                const Kind result = result_kind(*instruction);
+                if (result != kinds[instruction->id]) {
+                    kinds[instruction->id] = result;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // Whatever is still unknown only depends on phis of itself
+    for (const BasicBlock *block : order) {
+        for (const auto &instruction : block->instructions) {
+            const IROp op = instruction->op;
+            const bool produces = op != IROp::SetGlobal && op != IROp::Print && !is_terminator(op);
+            if (kinds[instruction->id] == Kind::Top && produces) kinds[instruction->id] = Kind::Value;
+        }
+    }
+}
+
+// Top for instructions that produce nothing
+CGenerator::Kind CGenerator::result_kind(const IRInstruction &instruction) const {
+    const auto &operands = instruction.operands;
+    auto all = [&](Kind wanted) {
+        return std::ranges::all_of(operands, [&](const IRInstruction *operand) { return kind(*operand) == wanted; });
+    };
+    auto numeric = [&] {
+        return std::ranges::all_of(operands, [&](const IRInstruction *operand) {
+            return kind(*operand) == Kind::Int || kind(*operand) == Kind::Double;
+        });
+    };
+    const bool pending = std::ranges::any_of(operands, [&](const IRInstruction *operand) {
+        return kind(*operand) == Kind::Top;
+    });
+
+    switch (instruction.op) {
+        case IROp::Const: {
+            const Literal &value = instruction.constant;
+            if (std::holds_alternative<int64_t>(value)) return Kind::Int;
+            if (std::holds_alternative<double>(value) || std::holds_alternative<float>(value)) return Kind::Double;
+            if (std::holds_alternative<bool>(value)) return Kind::Bool;
+            return Kind::Value;
+        }
+        case IROp::Param:
+        case IROp::GetGlobal:
+        case IROp::Call:
+            return Kind::Value;
+        case IROp::Phi: {
+            Kind merged = Kind::Top;
+            for (const IRInstruction *operand : operands) {
+                const Kind k = kind(*operand);
+                if (k == Kind::Top) continue;
+                merged = merged == Kind::Top || merged == k ? k : Kind::Value;
+            }
+            return merged;
+        }
+        case IROp::Add:
+        case IROp::Sub:
+        case IROp::Mul:
+        case IROp::Div:
+        case IROp::Mod:
+        case IROp::Neg:
+            if (instruction.operation != TYPE_UNKNOWN) return Kind::Int; // or it fails
+            if (pending) return Kind::Top;
+            if (all(Kind::Int)) return Kind::Int;
+            if (numeric()) return Kind::Double;
+            return Kind::Value;
+        case IROp::Not:
+        case IROp::Eq:
+        case IROp::Ne:
+        case IROp::Lt:
+        case IROp::Le:
+            return Kind::Bool;
+        default:
+            return Kind::Top;
+    }
+}
+
+// ===== INSTRUCTIONS =====
+
+void CGenerator::instruction(const IRInstruction &instruction) {
+    const auto &operands = instruction.operands;
+    const std::string result = name(instruction);
+
+    switch (instruction.op) {
+        case IROp::Const:
+            body << "    " << result << " = " << literal(instruction) << ";\n";
+            break;
+        case IROp::Param:
+            body << "    " << result << " = a" << instruction.index << ";\n";
+            break;
+        case IROp::Phi:
+            body << "    " << result << " = p" << instruction.id << ";\n";
+            break;
+        case IROp::GetGlobal:
+            body << "    " << result << " = sp_globals[" << instruction.index << "];\n";
+            break;
+        case IROp::SetGlobal:
+            body << "    sp_globals[" << instruction.index << "] = " << boxed(*operands[0]) << ";\n";
+            break;
+        case IROp::Add:
+        case IROp::Sub:
+        case IROp::Mul:
+        case IROp::Div:
+        case IROp::Mod:
+        case IROp::Neg:
+            arithmetic(instruction);
+            break;
+        case IROp::Not:
+            if (kind(*operands[0]) == Kind::Bool) {
+                body << "    " << result << " = !" << name(*operands[0]) << ";\n";
+            } else {
+                body << "    " << result << " = !sp_truthy(" << boxed(*operands[0]) << ", " << site(instruction)
+                     << ");\n";
+            }
+            break;
+        case IROp::Eq:
+        case IROp::Ne:
+        case IROp::Lt:
+        case IROp::Le:
+            comparison(instruction);
+            break;
+        case IROp::Call:
+            call(instruction);
+            break;
+        case IROp::Print:
+            print(instruction);
+            break;
+        default:
+            throw CompileError(instruction.line, instruction.column, "Instruction is not supported by the C back end");
+    }
+}
+
+void CGenerator::arithmetic(const IRInstruction &instruction) {
+    const std::string result = name(instruction);
+    const IRInstruction &left = *instruction.operands[0];
+    const IRInstruction *right = instruction.operands.size() > 1 ? instruction.operands[1] : nullptr;
+    const bool negate = instruction.op == IROp::Neg;
+    const bool may_fail = instruction.op == IROp::Div || instruction.op == IROp::Mod;
+
+    // Integers in the instruction's width, or i64 for generic ones on integers
+    auto integer = [&](const char *width, const std::string &x, const std::string &y) {
+        body << "    " << result << " = sp_" << helper_name(instruction.op) << "_" << width << "(" << x;
+        if (!negate) body << ", " << y;
+        if (may_fail) body << ", " << site(instruction);
+        body << ");\n";
+    };
+
+    if (instruction.operation != TYPE_UNKNOWN) {
+        const bool checked = kind(left) != Kind::Int || (right && kind(*right) != Kind::Int);
+        if (checked && negate) {
+            body << "    sp_require_int(" << boxed(left) << ", " << site(instruction) << ");\n";
+        } else if (checked) {
+            body << "    sp_require_ints(\"" << operator_char(instruction.op) << "\", " << boxed(left) << ", "
+                 << boxed(*right) << ", " << site(instruction) << ");\n";
+        }
+        auto as_int = [&](const IRInstruction *value) {
+            if (!value) return std::string();
+            return kind(*value) == Kind::Int ? name(*value) : name(*value) + ".as.i";
+        };
+        integer(width_name(instruction.operation), as_int(&left), as_int(right));
+        return;
+    }
+
+    switch (kind(instruction)) {
+        case Kind::Int:
+            integer("I64", name(left), right ? name(*right) : "");
+            return;
+        case Kind::Double:
+            if (negate) {
+                body << "    " << result << " = -" << name(left) << ";\n";
+            } else if (instruction.op == IROp::Mod) {
+                body << "    " << result << " = fmod(" << as_double(left) << ", " << as_double(*right) << ");\n";
+            } else {
+                body << "    " << result << " = " << as_double(left) << " " << operator_char(instruction.op) << " "
+                     << as_double(*right) << ";\n";
+            }
+            return;
+        default:
+            if (negate) {
+                body << "    " << result << " = sp_negate(" << boxed(left) << ", " << site(instruction) << ");\n";
+            } else {
+                body << "    " << result << " = sp_arithmetic('" << operator_char(instruction.op) << "', "
+                     << boxed(left) << ", " << boxed(*right) << ", " << site(instruction) << ");\n";
+            }
+            return;
+    }
+}
+
+void CGenerator::comparison(const IRInstruction &instruction) {
+    const std::string result = name(instruction);
+    const IRInstruction &left = *instruction.operands[0], &right = *instruction.operands[1];
+    const Kind a = kind(left), b = kind(right);
+    const bool numeric = (a == Kind::Int || a == Kind::Double) && (b == Kind::Int || b == Kind::Double);
+    const bool equality = instruction.op == IROp::Eq || instruction.op == IROp::Ne;
+    const bool is_unsigned = instruction.operation == TYPE_U64;
+
+    const char *symbol;
+    switch (instruction.op) {
+        case IROp::Eq: symbol = "=="; break;
+        case IROp::Ne: symbol = "!="; break;
+        case IROp::Lt: symbol = "<"; break;
+        default: symbol = "<="; break;
+    }
+
+    if (a == Kind::Int && b == Kind::Int) {
+        const char *cast = is_unsigned && !equality ? "(uint64_t)" : "";
+        body << "    " << result << " = " << cast << name(left) << " " << symbol << " " << cast << name(right) << ";\n";
+    } else if (numeric) {
+        body << "    " << result << " = " << as_double(left) << " " << symbol << " " << as_double(right) << ";\n";
+    } else if (equality && a == Kind::Bool && b == Kind::Bool) {
+        body << "    " << result << " = " << name(left) << " " << symbol << " " << name(right) << ";\n";
+    } else if (equality) {
+        body << "    " << result << " = " << (instruction.op == IROp::Ne ? "!" : "") << "sp_equal(" << boxed(left)
+             << ", " << boxed(right) << ");\n";
+    } else {
+        body << "    " << result << " = sp_less(" << (instruction.op == IROp::Le ? "true" : "false") << ", "
+             << (is_unsigned ? "true" : "false") << ", " << boxed(left) << ", " << boxed(right) << ", "
+             << site(instruction) << ");\n";
+    }
+}
+
+void CGenerator::call(const IRInstruction &call) {
+    const IRFunction &callee = *module.functions[call.index];
+    body << "    if (sp_depth >= SP_MAX_FRAMES) sp_overflow(" << site(call) << ", " << c_string(callee.name) << ");\n";
+    body << "    ++sp_depth;\n";
+    body << "    " << (live[call.id] ? name(call) + " = " : "") << "sp_f" << call.index << "(";
+    for (size_t i = 0; i < call.operands.size(); ++i) body << (i > 0 ? ", " : "") << boxed(*call.operands[i]);
+    body << ");\n";
+    body << "    --sp_depth;\n";
+}
+
+void CGenerator::print(const IRInstruction &print) {
+    for (size_t i = 0; i < print.operands.size(); ++i) {
+        const IRInstruction &argument = *print.operands[i];
+        if (i > 0) body << "    putchar(' ');\n";
+        // A u64 is held as its bit pattern, so printing needs to know it is unsigned
+        if (argument.type == TYPE_U64 && kind(argument) == Kind::Int) {
+            body << "    printf(\"%\" PRIu64, (uint64_t)" << name(argument) << ");\n";
+        } else if (argument.type == TYPE_U64) {
+            body << "    sp_print_u64(" << boxed(argument) << ");\n";
+        } else if (kind(argument) == Kind::Int) {
+            body << "    printf(\"%\" PRId64, " << name(argument) << ");\n";
+        } else if (kind(argument) == Kind::Double) {
+            body << "    sp_print_double(" << name(argument) << ");\n";
+        } else {
+            body << "    sp_print(" << boxed(argument) << ");\n";
+        }
+    }
+    body << "    putchar('\\n');\n";
+}
+
+void CGenerator::terminator(const IRInstruction &instruction) {
+    const BasicBlock &block = *instruction.block;
+
+    switch (instruction.op) {
+        case IROp::Jump:
+            phi_moves(block, *block.successors[0], 0, "    ");
+            body << "    goto b" << block.successors[0]->id << ";\n";
+            break;
+        case IROp::Branch: {
+            const IRInstruction &condition = *instruction.operands[0];
+            const BasicBlock &taken = *block.successors[0], &not_taken = *block.successors[1];
+            if (kind(condition) == Kind::Bool) {
+                body << "    if (" << name(condition) << ") {\n";
+            } else {
+                body << "    if (sp_truthy(" << boxed(condition) << ", " << site(instruction) << ")) {\n";
+            }
+            phi_moves(block, taken, 0, "        ");
+            body << "        goto b" << taken.id << ";\n    }\n";
+            // A branch to one block on both edges is its predecessor twice
+            phi_moves(block, not_taken, &taken == &not_taken ? 1 : 0, "    ");
+            body << "    goto b" << not_taken.id << ";\n";
+            break;
+        }
+        default:
+            if (instruction.operands.empty()) {
+                body << "    return sp_null();\n";
+            } else {
+                body << "    return " << boxed(*instruction.operands[0]) << ";\n";
+            }
+            break;
+    }
+}
+
+// Assigns the inputs of `to`'s phis for the `occurrence`th edge from `from`.
+// Phis read their inputs only at the top of `to`, so the order does not matter.
+void CGenerator::phi_moves(const BasicBlock &from, const BasicBlock &to, size_t occurrence, const char *indent) {
+    size_t index = 0;
+    for (size_t seen = 0; index < to.predecessors.size(); ++index) {
+        if (to.predecessors[index] == &from && seen++ == occurrence) break;
+    }
+
+    for (size_t p = 0; p < to.phi_count(); ++p) {
+        const IRInstruction &phi = *to.instructions[p];
+        if (!live[phi.id]) continue;
+        const IRInstruction &input = *phi.operands[index];
+        body << indent << "p" << phi.id << " = " << (kind(phi) == Kind::Value ? boxed(input) : name(input)) << ";\n";
+    }
+}
+
+// ===== OPERANDS =====
+
+std::string CGenerator::name(const IRInstruction &value) {
+    return "v" + std::to_string(value.id);
+}
+
+std::string CGenerator::boxed(const IRInstruction &value) const {
+    switch (kind(value)) {
+        case Kind::Int: return "sp_int(" + name(value) + ")";
+        case Kind::Double: return "sp_double(" + name(value) + ")";
+        case Kind::Bool: return "sp_bool(" + name(value) + ")";
+        default: return name(value);
+    }
+}
+
+std::string CGenerator::as_double(const IRInstruction &value) const {
+    return kind(value) == Kind::Int ? "(double)" + name(value) : name(value);
+}
+
+std::string CGenerator::site(const IRInstruction &at) {
+    // Errors in inlined code name the function it came from, like the VM's
+    const std::string &function_name = at.origin ? at.origin->name : function->name;
+    const std::string entry = "{" + std::to_string(at.line) + ", " + std::to_string(at.column) + ", " +
+                              c_string(function_name) + "}";
+    const auto [it, inserted] = site_ids.emplace(entry, sites.size());
+    if (inserted) sites.push_back(entry);
+    return "&sp_sites[" + std::to_string(it->second) + "]";
+}
+
+std::string CGenerator::literal(const IRInstruction &constant) {
+    const Literal &value = constant.constant;
+    if (const auto *i = std::get_if<int64_t>(&value)) return c_int(*i);
+    if (const auto *d = std::get_if<double>(&value)) return c_double(*d);
+    if (const auto *f = std::get_if<float>(&value)) return c_double(*f);
+    if (const auto *b = std::get_if<bool>(&value)) return *b ? "true" : "false";
+    if (const auto *c = std::get_if<char>(&value)) return "sp_char((char) " + std::to_string(static_cast<int>(*c)) + ")";
+    if (const auto *s = std::get_if<std::string>(&value)) {
+        const std::string id = "sp_s" + std::to_string(string_count++);
+        strings << "static const sp_string " << id << " = {" << s->size() << ", " << c_string(*s) << "};\n";
+        return "sp_str(&" + id + ")";
+    }
+    return "sp_null()";
+}
@@ -3,14 +3,93 @@
 //
 
 #include "../../include/commands/Commands.h"
+#include "../../include/cgen/CGenerator.h"
+#include "../../include/concurrency/WorkStealingPool.h"
+#include "../../include/driver/Driver.h"
+#include "../../include/format/Formatter.h"
+#include "../../include/ir/IRBuilder.h"
+#include "../../include/ir/PassManager.h"
 #include "../../include/lexer/Lexer.h"
+#include "../../include/lsp/LanguageServer.h"
+#include "../../include/modules/InterfaceFile.h"
+#include "../../include/server/CompileServer.h"
 #include "../../include/tokens/TokenCategory.h"
+#include "../../include/util/MemoryStats.h"
+#include "../../include/util/TimeStats.h"
+#include "../../include/util/Trace.h"
+#include "../../include/util/Version.h"
+#include "../../include/vm/BytecodeCompiler.h"
+#include "../../include/vm/VirtualMachine.h"
 
-#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
-#include <sstream>
+#include <iostream>
+#include <map>
+#include <memory>
+
+int Commands::run(const std::vector<std::string>& raw_args, bool forward) {
+    std::vector<std::string> args;
+    bool mem_report = false;
+    std::string time_report; // "", "text" or "json"
+    std::string trace_path;
+    bool explicit_server = false;
+    std::string server;
+
+    if (const char* env = std::getenv("SPARKC_SERVER"); env && *env) server = env;
+
+    for (const auto& arg : raw_args) {
+        if (arg == "--mem-report") {
+            mem_report = true;
+            continue;
+        }
+        if (arg == "--time-report" || arg == "--time-report=text" || arg == "--time-report=json") {
+            time_report = arg == "--time-report=json" ? "json" : "text";
+            continue;
+        }
+        if (arg.starts_with("--trace=") && arg.size() > 8) {
+            trace_path = arg.substr(8);
+            continue;
+        }
+        if (arg == "--connect" || arg.starts_with("--connect=")) {
+            explicit_server = true;
+            server = arg == "--connect" ? CompileServer::default_socket_path() : arg.substr(10);
+            continue;
+        }
+        args.push_back(arg);
+    }
+
+    // Hand the whole command line to a warm server, or fall back to doing the work here
+    if (forward && !server.empty() && !args.empty() && CompileServer::forwardable(args[0])) {
+        std::vector<std::string> forwarded = args;
+        if (mem_report) forwarded.emplace_back("--mem-report");
+        if (!time_report.empty()) forwarded.push_back("--time-report=" + time_report);
+        if (!trace_path.empty()) forwarded.push_back("--trace=" + trace_path);
+        if (const auto status = CompileServer::forward(server, forwarded)) return *status;
+        if (explicit_server) std::cerr << "note: no compile server at " << server << ", running locally\n";
+    }
+
+    if (mem_report) MemoryStats::reset();
+    if (!time_report.empty()) TimeStats::start();
+    if (!trace_path.empty()) Trace::start(trace_path);
+
+    int status;
+    {
+        TraceScope trace("sparkc", args.empty() ? "" : args[0]);
+        status = dispatch(args);
+    }
 
-int Commands::run(const std::vector<std::string>& args) {
+    if (!trace_path.empty() && !Trace::stop()) std::cerr << "warning: could not write trace " << trace_path << "\n";
+
+    if (mem_report) MemoryStats::report(std::cerr);
+    if (time_report == "text") TimeStats::report(std::cerr);
+    if (time_report == "json") TimeStats::report_json(std::cerr);
+
+    return status;
+}
+
+int Commands::dispatch(const std::vector<std::string>& args) {
     if (args.empty()) {
         std::cerr << "No command provided. Use `spark --help`.\n";
         return 1;
@@ -22,7 +101,14 @@ int Commands::run(const std::vector<std::string>& args) {
     if (command == "--parse")    return run_parse(args);
     if (command == "--check")    return run_check(args);
     if (command == "--run")      return run_run(args);
+    if (command == "--emit-c")   return run_emit_c(args);
     if (command == "--format")   return run_format(args);
+    if (command == "--serve")    return run_serve(args);
+    if (command == "--lsp")      return run_lsp(args);
+    if (command == "--shutdown") {
+        std::cerr << "No compile server is running.\n";
+        return 1;
+    }
     if (command == "--version")  return run_version();
     if (command == "--help")     return run_help();
 
@@ -49,25 +135,340 @@ int Commands::run_lexer(const std::vector<std::string>& args) {
 }
 
 int Commands::run_parse(const std::vector<std::string>& args) {
+    MemoryPhaseScope phase(CompilerPhase::Parse);
+    PhaseTimer timer(CompilerPhase::Parse);
+    TraceScope trace("parse");
     return 0;
 }
 
 int Commands::run_check(const std::vector<std::string>& args) {
-    return 0;
+    CheckOptions options;
+    options.jobs = WorkStealingPool::default_thread_count();
+    bool use_cache = true;
+    std::string cache_path = BuildCache::DEFAULT_PATH;
+    std::string interface_dir = InterfaceFile::DEFAULT_DIR;
+    std::vector<std::string> inputs;
+
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        const bool takes_value = arg == "-j" || arg == "--jobs" || arg == "--cache-file" || arg == "-I" ||
+                                 arg == "--interface-dir";
+
+        if (takes_value && i + 1 >= args.size()) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return 1;
+        }
+
+        if (arg == "-j" || arg == "--jobs") {
+            if (!parse_jobs(args[++i], options.jobs)) return 1;
+        } else if (arg.starts_with("-j") && arg.size() > 2) {
+            if (!parse_jobs(arg.substr(2), options.jobs)) return 1;
+        } else if (arg == "-I") {
+            options.search_paths.push_back(args[++i]);
+        } else if (arg.starts_with("-I") && arg.size() > 2) {
+            options.search_paths.push_back(arg.substr(2));
+        } else if (arg == "--critical-path") {
+            options.critical_path = true;
+        } else if (arg == "--no-cache") {
+            use_cache = false;
+        } else if (arg == "--cache-file") {
+            cache_path = args[++i];
+        } else if (arg == "--interface-dir") {
+            interface_dir = args[++i];
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+
+    if (inputs.empty()) {
+        std::cerr << "Usage: spark --check [-j N] [-I <dir>] [--critical-path] [--no-cache] [--cache-file <path>] [--interface-dir <dir>] <file|dir>...\n";
+        return 1;
+    }
+
+    const std::vector<std::string> files = Driver::collect_sources(inputs);
+
+    if (!use_cache) {
+        return Driver::check_files(files, options, std::cerr) == 0 ? 0 : 1;
+    }
+
+    BuildCache& cache = resident_cache(cache_path, BuildCache::make_config_hash("--check", options.search_paths));
+    cache.load();
+    options.cache = &cache;
+    options.interface_dir = interface_dir; // only meaningful alongside the cache that validates them
+    const size_t failures = Driver::check_files(files, options, std::cerr);
+    if (!cache.save()) std::cerr << "warning: could not write build cache " << cache_path << "\n";
+
+    return failures == 0 ? 0 : 1;
+}
+
+BuildCache& Commands::resident_cache(const std::string& path, uint64_t config_hash) {
+    // Kept for the life of the process so a compile server answers from memory
+    static std::map<std::pair<std::string, uint64_t>, std::unique_ptr<BuildCache>> caches;
+    auto& cache = caches[{path, config_hash}];
+    if (!cache) cache = std::make_unique<BuildCache>(path, config_hash);
+    return *cache;
+}
+
+bool Commands::parse_jobs(const std::string& value, unsigned& jobs) {
+    try {
+        const long parsed = std::stol(value);
+        if (parsed < 1) throw std::out_of_range(value);
+        jobs = static_cast<unsigned>(parsed);
+        return true;
+    } catch (const std::exception&) {
+        std::cerr << "Invalid job count: " << value << "\n";
+        return false;
+    }
 }
 
 int Commands::run_run(const std::vector<std::string>& args) {
-    std::cout << "[run] Command received (stub)\n";
+    bool dump_bytecode = false;
+    bool dump_ir = false;
+    bool pass_stats = false;
+    bool gc_stats = false;
+    bool optimize = true;
+    bool jit = true;
+    unsigned workers = 0;
+    std::string file;
+
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (args[i] == "--workers") {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Missing value for --workers\n";
+                return 1;
+            }
+            if (!parse_jobs(args[++i], workers)) return 1;
+        } else if (args[i] == "--dump-bytecode") {
+            dump_bytecode = true;
+        } else if (args[i] == "--dump-ir") {
+            dump_ir = true;
+        } else if (args[i] == "--pass-stats") {
+            pass_stats = true;
+        } else if (args[i] == "--gc-stats") {
+            gc_stats = true;
+        } else if (args[i] == "-O0") {
+            optimize = false;
+        } else if (args[i] == "--no-jit") {
+            jit = false;
+        } else {
+            file = args[i];
+        }
+    }
+
+    if (file.empty()) {
+        std::cerr << "Usage: spark --run [--dump-ir] [--dump-bytecode] [--pass-stats] [--gc-stats] [-O0] [--no-jit] [--workers N] <file>\n";
+        return 1;
+    }
+
+    const SourceUnit unit = Driver::check_file(file);
+    if (unit.has_errors()) {
+        for (const auto& diagnostic : unit.diagnostics) print_diagnostic(std::cerr, diagnostic);
+        return 1;
+    }
+
+    try {
+        BytecodeModule module;
+        {
+            MemoryPhaseScope phase(CompilerPhase::Optimize);
+            PhaseTimer timer(CompilerPhase::Optimize);
+            TraceScope trace("optimize", file);
+
+            IRModule ir = IRBuilder::build(*unit.program, *unit.types);
+            PassManager passes = optimize ? PassManager::standard() : PassManager();
+            passes.run(ir);
+            if (pass_stats) passes.report(std::cerr);
+            if (dump_ir) {
+                print(ir, std::cout);
+                return 0;
+            }
+            module = BytecodeCompiler::compile(ir);
+        }
+        if (dump_bytecode) {
+            disassemble(module, std::cout);
+            return 0;
+        }
+
+        MemoryPhaseScope phase(CompilerPhase::Run);
+        PhaseTimer timer(CompilerPhase::Run);
+        TraceScope trace("run", file);
+
+        VirtualMachine vm(std::cout, jit, workers);
+        try {
+            vm.run(module);
+        } catch (const RuntimeError& e) {
+            std::cout.flush();
+            if (gc_stats) vm.gc_statistics().report(std::cerr);
+            print_diagnostic(std::cerr, {Severity::Error, file, e.location.line, e.location.column,
+                                         std::string("Runtime error: ") + e.what()});
+            return 1;
+        }
+        TimeStats::count(Throughput::Instructions, vm.instructions());
+        if (gc_stats) {
+            std::cout.flush();
+            vm.gc_statistics().report(std::cerr);
+        }
+    } catch (const CompileError& e) {
+        print_diagnostic(std::cerr, {Severity::Error, file, e.line, e.column, e.what()});
+        return 1;
+    }
+
     return 0;
 }
 
-int Commands::run_format(const std::vector<std::string>& args) {
-    std::cout << "[format] Command received (stub)\n";
+int Commands::run_emit_c(const std::vector<std::string>& args) {
+    bool optimize = true;
+    std::string output;
+    std::string file;
+
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (args[i] == "-O0") {
+            optimize = false;
+        } else if (args[i] == "-o" && i + 1 < args.size()) {
+            output = args[++i];
+        } else {
+            file = args[i];
+        }
+    }
+
+    if (file.empty()) {
+        std::cerr << "Usage: spark --emit-c [-O0] [-o <file.c|executable>] <file>\n";
+        return 1;
+    }
+
+    const SourceUnit unit = Driver::check_file(file);
+    if (unit.has_errors()) {
+        for (const auto& diagnostic : unit.diagnostics) print_diagnostic(std::cerr, diagnostic);
+        return 1;
+    }
+
+    std::string source;
+    try {
+        MemoryPhaseScope phase(CompilerPhase::Optimize);
+        PhaseTimer timer(CompilerPhase::Optimize);
+        TraceScope trace("optimize", file);
+
+        IRModule ir = IRBuilder::build(*unit.program, *unit.types);
+        PassManager passes = optimize ? PassManager::standard() : PassManager();
+        passes.run(ir);
+        source = CGenerator::generate(ir, file);
+    } catch (const CompileError& e) {
+        print_diagnostic(std::cerr, {Severity::Error, file, e.line, e.column, e.what()});
+        return 1;
+    }
+
+    if (output.empty()) {
+        std::cout << source;
+        return 0;
+    }
+
+    // Anything but a .c path is an executable, built from a C file next to it
+    const bool executable = !output.ends_with(".c");
+    const std::string c_path = executable ? output + ".c" : output;
+    {
+        std::ofstream out(c_path, std::ios::binary);
+        out << source;
+        if (!out) {
+            std::cerr << "Could not write " << c_path << "\n";
+            return 1;
+        }
+    }
+    if (!executable) return 0;
+
+    const int status = CGenerator::build_executable(c_path, output);
+    if (status != 0) {
+        if (status < 0) std::cerr << "Could not run the C compiler; set CC to one\n";
+        std::cerr << "The generated C is kept in " << c_path << "\n";
+        return 1;
+    }
+    std::remove(c_path.c_str());
     return 0;
 }
 
+int Commands::run_format(const std::vector<std::string>& args) {
+    unsigned jobs = WorkStealingPool::default_thread_count();
+    bool check = false;
+    std::vector<std::string> inputs;
+
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        if (arg == "-j" || arg == "--jobs") {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Missing value for " << arg << "\n";
+                return 1;
+            }
+            if (!parse_jobs(args[++i], jobs)) return 1;
+        } else if (arg.starts_with("-j") && arg.size() > 2) {
+            if (!parse_jobs(arg.substr(2), jobs)) return 1;
+        } else if (arg == "--check") {
+            check = true;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+
+    if (inputs.empty()) {
+        std::cerr << "Usage: spark --format [--check] [-j N] <file|dir>...\n";
+        return 1;
+    }
+
+    const std::vector<std::string> files = Driver::collect_sources(inputs);
+    std::vector<Formatter::Result> results(files.size(), Formatter::Result::Unchanged);
+    std::vector<std::string> errors(files.size());
+
+    {
+        WorkStealingPool pool(std::min<unsigned>(jobs, std::max<size_t>(files.size(), 1)));
+        for (size_t i = 0; i < files.size(); ++i) {
+            pool.submit([&, i] {
+                try {
+                    results[i] = Formatter::format_file(files[i], !check);
+                } catch (const std::exception& e) {
+                    errors[i] = e.what();
+                }
+            });
+        }
+        pool.wait();
+    }
+
+    // Report in input order regardless of which worker finished first
+    bool failed = false;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!errors[i].empty()) {
+            std::cerr << files[i] << ": " << errors[i] << "\n";
+            failed = true;
+        } else if (results[i] == Formatter::Result::Reformatted) {
+            std::cout << (check ? "would reformat " : "reformatted ") << files[i] << "\n";
+            failed = failed || check;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
+
+int Commands::run_serve(const std::vector<std::string>& args) {
+    std::string socket_path = CompileServer::default_socket_path();
+
+    if (args.size() == 3 && args[1] == "--socket") {
+        socket_path = args[2];
+    } else if (args.size() != 1) {
+        std::cerr << "Usage: spark --serve [--socket <path>]\n";
+        return 1;
+    }
+
+    return CompileServer::serve(socket_path);
+}
+
+int Commands::run_lsp(const std::vector<std::string>& args) {
+    if (args.size() != 1) {
+        std::cerr << "Usage: spark --lsp\n";
+        return 1;
+    }
+
+    LanguageServer server(std::cin, std::cout);
+    return server.run();
+}
+
 int Commands::run_version() {
-    std::cout << "Spark Language Toolchain v0.1.0\n";
+    std::cout << "Spark Language Toolchain v" << SPARKC_VERSION << "\n";
     return 0;
 }
 
@@ -75,28 +476,54 @@ int Commands::run_help() {
     std::cout << "Spark CLI commands:\n";
     std::cout << "  --lexer <file>     Tokenize and print tokens\n";
     std::cout << "  --parse <file>     Parse and dump AST (stub)\n";
-    std::cout << "  --check <file>     Check for syntax and semantic errors (stub)\n";
-    std::cout << "  --run <file>       Run source file (stub)\n";
-    std::cout << "  --format <file>    Format source file (stub)\n";
+    std::cout << "  --check [-j N] <file|dir>...\n";
+    std::cout << "                     Check files for syntax and semantic errors on N threads,\n";
+    std::cout << "                     reusing results from .sparkc-cache (--no-cache, --cache-file <path>)\n";
+    std::cout << "                     Unchanged imports are read from precompiled interfaces in\n";
+    std::cout << "                     .sparkc-interfaces (--interface-dir <dir>)\n";
+    std::cout << "                     Imports are found next to the importer or under -I <dir>;\n";
+    std::cout << "                     --critical-path reports the slowest chain of module dependencies\n";
+    std::cout << "  --run <file>       Compile a source file to bytecode and run it on the VM\n";
+    std::cout << "                     (--dump-ir or --dump-bytecode prints the optimized IR or the bytecode\n";
+    std::cout << "                     instead, --pass-stats reports each optimization pass, -O0 skips them;\n";
+    std::cout << "                     hot functions run as native code where supported unless --no-jit;\n";
+    std::cout << "                     spawned tasks run on --workers N threads, one per core by default;\n";
+    std::cout << "                     --gc-stats reports heap usage and collection pauses)\n";
+    std::cout << "  --emit-c [-o <path>] <file>\n";
+    std::cout << "                     Compile a source file to portable C11, printed or written to a .c path;\n";
+    std::cout << "                     any other path is built into an executable with $CC -O2 (default cc)\n";
+    std::cout << "  --format <file>    Format source files in place, leaving unchanged files untouched\n";
+    std::cout << "                     (--check reports files that would change, -j N sets parallelism)\n";
+    std::cout << "  --serve [--socket <path>]\n";
+    std::cout << "                     Run a compile server that keeps caches warm between requests\n";
+    std::cout << "  --connect[=<path>] Forward --check, --format or --lexer to a compile server\n";
+    std::cout << "                     (also enabled by SPARKC_SERVER=<path>); --shutdown stops it\n";
+    std::cout << "  --lsp              Serve semantic highlighting over the Language Server Protocol on stdio\n";
     std::cout << "  --version          Show version\n";
+    std::cout << "  --mem-report       Print allocations per compiler phase (needs SPARKC_MEM_INSTRUMENT build)\n";
+    std::cout << "  --trace=<file>     Write a Chrome trace of per-file and per-phase work (Perfetto, chrome://tracing)\n";
+    std::cout << "  --time-report[=json]\n";
+    std::cout << "                     Print time and throughput per compiler phase (needs SPARKC_TIME_INSTRUMENT build)\n";
     std::cout << "  --help             Show this help message\n";
     return 0;
 }
 
 std::string Commands::read_file(const std::string& path) {
-    std::ifstream in(path);
-    if (!in) throw std::runtime_error("Could not open file: " + path);
-    std::ostringstream buffer;
-    buffer << in.rdbuf();
-    return buffer.str();
+    return Driver::read_source(path);
 }
 
 void Commands::print_token_output(const std::string& file) {
     std::string source = read_file(file);
+
+    MemoryPhaseScope phase(CompilerPhase::Lex);
+    PhaseTimer timer(CompilerPhase::Lex);
+    TraceScope trace("lex");
     Lexer lexer(source, file);
+    uint64_t token_count = 0;
 
     while (lexer.has_more_tokens()) {
         Token token = lexer.next_token();
+        ++token_count;
 
         std::cout << "[" << token.line << ":" << token.column << "] "
                   << "Type: " << token_type_to_string(token.type)
@@ -120,4 +547,6 @@ void Commands::print_token_output(const std::string& file) {
 
         if (token.type == TokenType::END_OF_FILE) break;
     }
+
+    TimeStats::count(Throughput::Tokens, token_count);
 }
@@ -0,0 +1,143 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/concurrency/WorkStealingPool.h"
+
+#include <random>
+
+namespace {
+    // Index of the pool worker running on this thread, -1 elsewhere
+    thread_local int current_worker = -1;
+    thread_local const WorkStealingPool *current_pool = nullptr;
+}
+
+WorkStealingPool::WorkStealingPool(unsigned thread_count) {
+    if (thread_count <= 1) return;
+
+    for (unsigned i = 0; i < thread_count; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned i = 0; i < thread_count; ++i) {
+        workers.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lock(state_mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+
+    for (auto &worker : workers) worker.join();
+}
+
+unsigned WorkStealingPool::default_thread_count() {
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+}
+
+unsigned WorkStealingPool::size() const {
+    return workers.empty() ? 1 : static_cast<unsigned>(workers.size());
+}
+
+void WorkStealingPool::submit(Task task) {
+    if (workers.empty()) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        execute(task);
+        return;
+    }
+
+    // Tasks spawned by a worker go to its own deque, external ones round-robin
+    const unsigned index = current_pool == this && current_worker >= 0
+                               ? static_cast<unsigned>(current_worker)
+                               : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    pending.fetch_add(1, std::memory_order_acq_rel);
+    {
+        std::lock_guard lock(state_mutex);
+        queued.fetch_add(1, std::memory_order_acq_rel);
+    }
+    {
+        std::lock_guard lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    work_available.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock lock(state_mutex);
+    all_done.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+
+    if (first_error) {
+        std::exception_ptr error = first_error;
+        first_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+bool WorkStealingPool::pop_local(unsigned index, Task &out) {
+    WorkerQueue &queue = *queues[index];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+
+    out = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned thief, Task &out) {
+    thread_local std::minstd_rand rng(std::random_device{}());
+    const auto count = static_cast<unsigned>(queues.size());
+    const unsigned offset = rng() % count;
+
+    for (unsigned i = 0; i < count; ++i) {
+        const unsigned victim = (offset + i) % count;
+        if (victim == thief) continue;
+
+        WorkerQueue &queue = *queues[victim];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+
+        out = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    return false;
+}
+
+void WorkStealingPool::execute(Task &task) {
+    try {
+        task();
+    } catch (...) {
+        std::lock_guard lock(state_mutex);
+        if (!first_error) first_error = std::current_exception();
+    }
+
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard lock(state_mutex);
+        all_done.notify_all();
+    }
+}
+
+void WorkStealingPool::worker_loop(unsigned index) {
+    current_worker = static_cast<int>(index);
+    current_pool = this;
+
+    while (true) {
+        Task task;
+        if (pop_local(index, task) || steal(index, task)) {
+            queued.fetch_sub(1, std::memory_order_acq_rel);
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock lock(state_mutex);
+        work_available.wait(lock, [this] {
+            return stopping || queued.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+    }
+}
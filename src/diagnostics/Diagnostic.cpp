@@ -0,0 +1,19 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/diagnostics/Diagnostic.h"
+
+std::string to_string(Severity severity) {
+    switch (severity) {
+        case Severity::Warning: return "warning";
+        case Severity::Note: return "note";
+        case Severity::Error: // fallthrough
+        default: return "error";
+    }
+}
+
+void print_diagnostic(std::ostream &out, const Diagnostic &diagnostic) {
+    out << diagnostic.file << ":" << diagnostic.line << ":" << diagnostic.column << ": "
+        << to_string(diagnostic.severity) << ": " << diagnostic.message << "\n";
+}
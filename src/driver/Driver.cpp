@@ -0,0 +1,358 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/driver/Driver.h"
+#include "../../include/cache/Fingerprint.h"
+#include "../../include/concurrency/WorkStealingPool.h"
+#include "../../include/lexer/Lexer.h"
+#include "../../include/macro/MacroExpander.h"
+#include "../../include/modules/InterfaceFile.h"
+#include "../../include/modules/ModuleGraph.h"
+#include "../../include/parser/Parser.h"
+#include "../../include/semantic/ModuleInterface.h"
+#include "../../include/util/MemoryStats.h"
+#include "../../include/util/TimeStats.h"
+#include "../../include/util/Trace.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+bool SourceUnit::has_errors() const {
+    return std::ranges::any_of(diagnostics, [](const Diagnostic &d) { return d.severity == Severity::Error; });
+}
+
+std::string Driver::read_source(const std::string &path) {
+    MemoryPhaseScope phase(CompilerPhase::Read);
+    PhaseTimer timer(CompilerPhase::Read);
+    TraceScope trace("read");
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Could not open file: " + path);
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    std::string source = buffer.str();
+    TimeStats::count(Throughput::Bytes, source.size());
+    return source;
+}
+
+std::vector<std::string> Driver::collect_sources(const std::vector<std::string> &inputs) {
+    std::vector<std::string> files;
+
+    for (const auto &input : inputs) {
+        std::error_code ec;
+        if (!fs::is_directory(input, ec)) {
+            files.push_back(input);
+            continue;
+        }
+
+        std::vector<std::string> found;
+        for (fs::recursive_directory_iterator it(input, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec) && it->path().extension() == SOURCE_EXTENSION) {
+                found.push_back(it->path().string());
+            }
+        }
+        std::ranges::sort(found);
+        files.insert(files.end(), found.begin(), found.end());
+    }
+
+    return files;
+}
+
+void Driver::lex(SourceUnit &unit) {
+    MemoryPhaseScope phase(CompilerPhase::Lex);
+    PhaseTimer timer(CompilerPhase::Lex);
+    TraceScope trace("lex");
+
+    Lexer lexer(unit.source, unit.path);
+    std::vector<Token> tokens = lexer.tokenize();
+
+    // A number too large for its type stays in as a zero, so the parser has nothing more to say about it
+    for (Token &token : tokens) {
+        if (token.type != TokenType::UNKNOWN || !std::isdigit(static_cast<unsigned char>(token.lexeme.front()))) continue;
+        unit.diagnostics.push_back({Severity::Error, unit.path, token.line, token.column,
+                                    "Number literal '" + token.lexeme + "' is out of range"});
+        token.type = TokenType::INT64_LITERAL;
+        token.literal = int64_t{0};
+    }
+
+    // Report stray characters once here and keep them away from the parser
+    std::erase_if(tokens, [&](const Token &token) {
+        if (token.type != TokenType::UNKNOWN) return false;
+        unit.diagnostics.push_back({Severity::Error, unit.path, token.line, token.column,
+                                    "Unexpected character '" + token.lexeme + "'"});
+        return true;
+    });
+    unit.tokens = TokenStream(std::move(tokens));
+}
+
+void Driver::expand(SourceUnit &unit) {
+    MemoryPhaseScope phase(CompilerPhase::Expand);
+    PhaseTimer timer(CompilerPhase::Expand);
+    TraceScope trace("expand");
+
+    MacroExpander expander(unit.path);
+    unit.tokens = expander.expand(unit.tokens, unit.diagnostics);
+}
+
+void Driver::parse(SourceUnit &unit) {
+    MemoryPhaseScope phase(CompilerPhase::Parse);
+    PhaseTimer timer(CompilerPhase::Parse);
+    TraceScope trace("parse");
+
+    Parser parser(unit.tokens, unit.path);
+    unit.program = parser.parseProgram();
+    unit.diagnostics.insert(unit.diagnostics.end(), parser.diagnostics().begin(), parser.diagnostics().end());
+
+    // Lexer and parser errors interleave by position; semantic errors follow in walk order
+    std::ranges::stable_sort(unit.diagnostics, [](const Diagnostic &a, const Diagnostic &b) {
+        return a.line != b.line ? a.line < b.line : a.column < b.column;
+    });
+
+    unit.module_name = fs::path(unit.path).stem().string();
+    for (const auto &node : unit.program->statements) {
+        if (const auto *module = dynamic_cast<const ModuleDeclaration *>(node.get())) {
+            unit.module_name = module->name;
+        } else if (const auto *import = dynamic_cast<const ImportDeclaration *>(node.get())) {
+            unit.imports.push_back(import->module);
+        }
+    }
+}
+
+void Driver::check(SourceUnit &unit, const Checker::ModuleMap &modules) {
+    MemoryPhaseScope phase(CompilerPhase::Check);
+    PhaseTimer timer(CompilerPhase::Check);
+    TraceScope trace("check");
+
+    unit.types = std::make_unique<TypeTable>();
+    Checker checker(unit.path, unit.module_name, modules, *unit.types);
+    checker.check(*unit.program);
+    unit.diagnostics.insert(unit.diagnostics.end(), checker.diagnostics().begin(), checker.diagnostics().end());
+}
+
+void Driver::run_front_end(SourceUnit &unit, const Checker::ModuleMap &modules) {
+    lex(unit);
+    expand(unit);
+    parse(unit);
+    check(unit, modules);
+}
+
+SourceUnit Driver::check_file(const std::string &path, const Checker::ModuleMap &modules) {
+    SourceUnit unit;
+    unit.path = path;
+
+    try {
+        unit.source = read_source(path);
+    } catch (const std::exception &e) {
+        unit.diagnostics.push_back({Severity::Error, path, 0, 0, e.what()});
+        return unit;
+    }
+
+    run_front_end(unit, modules);
+    return unit;
+}
+
+namespace {
+    // Per-module bookkeeping for check_files
+    struct ModuleState {
+        std::string key;          // normalised path used as the cache key
+        bool needs_check = false; // false while the cached entry can be reused
+        bool cacheable = false;
+        std::once_flag parsed;    // cycle peers may parse each other's source concurrently
+        std::unique_ptr<SourceUnit> unit;
+        ModuleInterface interface;
+        bool has_interface = false;
+        CacheEntry entry;
+    };
+
+    int64_t modification_time(const fs::path &path, std::error_code &ec) {
+        return static_cast<int64_t>(fs::last_write_time(path, ec).time_since_epoch().count());
+    }
+
+    // Lex and parse `path` (reading it unless `source` is given) and record its interface
+    void parse_into(ModuleState &state, const std::string &path, std::string source = {}) {
+        auto unit = std::make_unique<SourceUnit>();
+        unit->path = path;
+
+        try {
+            unit->source = source.empty() ? Driver::read_source(path) : std::move(source);
+        } catch (const std::exception &e) {
+            state.cacheable = false;
+            state.entry.diagnostics = {{Severity::Error, path, 0, 0, e.what()}};
+            return;
+        }
+
+        Driver::lex(*unit);
+        Driver::expand(*unit);
+        Driver::parse(*unit);
+
+        state.interface = ModuleInterface::from_program(unit->module_name, *unit->program);
+        state.has_interface = true;
+        state.entry.token_fingerprint = token_fingerprint(unit->tokens);
+        state.entry.interface_hash = interface_hash(state.interface);
+        state.entry.module_name = unit->module_name;
+        state.unit = std::move(unit);
+    }
+
+    void ensure_parsed(ModuleState &state, const std::string &path, std::string source = {}) {
+        std::call_once(state.parsed, [&] { parse_into(state, path, std::move(source)); });
+    }
+
+    // Map the precompiled interface of a module whose cached result is reused.
+    // Fails if the file is missing or was written for a different source.
+    bool load_interface(ModuleState &state, const std::string &interface_dir) {
+        const auto file = InterfaceFile::open(InterfaceFile::path_for(interface_dir, state.entry.module_name));
+        if (!file || file->content_hash() != state.entry.content_hash ||
+            file->interface_hash() != state.entry.interface_hash) {
+            return false;
+        }
+        state.interface = file->to_interface();
+        state.has_interface = true;
+        return true;
+    }
+
+    // Try to reuse the cached result for `path`. Returns false with `source`
+    // filled in when the file changed (or was never seen) and must be checked.
+    bool reuse_cached(ModuleState &state, const std::string &path, const BuildCache *cache, std::string &source) {
+        std::error_code ec;
+        state.key = fs::absolute(path, ec).lexically_normal().string();
+        const uint64_t size = fs::file_size(path, ec);
+        const int64_t mtime = ec ? 0 : modification_time(path, ec);
+        const CacheEntry *cached = cache && !ec ? cache->find(state.key) : nullptr;
+        state.cacheable = !ec;
+
+        // Untouched since last time: trust the recorded hash without reading
+        if (cached && cached->mtime == mtime && cached->size == size) {
+            state.entry = *cached;
+            return true;
+        }
+
+        source = Driver::read_source(path);
+        const uint64_t content_hash = BuildCache::hash_content(source);
+
+        if (cached && cached->content_hash == content_hash) {
+            state.entry = *cached; // touched but not changed
+        } else {
+            state.entry.content_hash = content_hash;
+        }
+        state.entry.mtime = mtime;
+        state.entry.size = size;
+        return cached && cached->content_hash == content_hash;
+    }
+}
+
+size_t Driver::check_files(const std::vector<std::string> &paths, const CheckOptions &options, std::ostream &out) {
+    WorkStealingPool pool(std::min<unsigned>(options.jobs, std::max<size_t>(paths.size(), 1)));
+    const ModuleGraph graph = ModuleGraph::build(paths, options.search_paths, pool);
+    std::vector<ModuleState> states(graph.size());
+
+    // Dependencies outside an import cycle have finished by the time a module runs
+    auto work = [&](size_t node) {
+        ModuleState &state = states[node];
+        const ModuleHeader &header = graph.header(node);
+        TraceScope trace("module", header.path);
+
+        if (!header.error.empty()) {
+            state.entry.diagnostics = {{Severity::Error, header.path, 0, 0, header.error}};
+            return;
+        }
+
+        std::string source;
+        try {
+            if (reuse_cached(state, header.path, options.cache, source) && !graph.in_cycle(node)) {
+                const bool stale = std::ranges::any_of(state.entry.dependencies, [&](const auto &dependency) {
+                    const size_t provider = graph.find(dependency.first);
+                    const uint64_t current = provider != SIZE_MAX ? states[provider].entry.interface_hash : 0;
+                    return current != dependency.second;
+                });
+                // Importers read a reused module through its interface file, so a
+                // missing or mismatched one makes this module a cache miss
+                const bool provider = graph.find(state.entry.module_name) == node;
+                if (!stale && (options.interface_dir.empty() || !provider ||
+                               load_interface(state, options.interface_dir))) {
+                    return;
+                }
+            }
+        } catch (const std::exception &e) {
+            state.cacheable = false;
+            state.entry.diagnostics = {{Severity::Error, header.path, 0, 0, e.what()}};
+            return;
+        }
+
+        state.needs_check = true;
+        ensure_parsed(state, header.path, std::move(source));
+        if (!state.unit) return;
+
+        Checker::ModuleMap modules;
+        for (const size_t dependency : graph.dependencies(node)) {
+            ModuleState &imported = states[dependency];
+            // Finished modules outside a cycle already hold their interface
+            if (graph.in_cycle(dependency) || !imported.has_interface) {
+                ensure_parsed(imported, graph.header(dependency).path);
+            }
+            if (imported.has_interface) modules.emplace(imported.interface.module, &imported.interface);
+        }
+
+        check(*state.unit, modules);
+        state.entry.diagnostics = std::move(state.unit->diagnostics);
+
+        // Cycle peers may be reading the parse-time interface; everyone else
+        // waits for this module and sees the types the checker resolved
+        if (graph.in_cycle(node)) return;
+        state.interface = ModuleInterface::from_program(state.unit->module_name, *state.unit->program,
+                                                        state.unit->types.get());
+        state.entry.interface_hash = interface_hash(state.interface);
+
+        if (!options.interface_dir.empty() && graph.find(state.unit->module_name) == node) {
+            const std::string file = InterfaceFile::path_for(options.interface_dir, state.unit->module_name);
+            InterfaceFile::write(file, state.interface, state.entry.content_hash, state.entry.interface_hash);
+        }
+    };
+
+    if (!options.interface_dir.empty()) {
+        std::error_code ec;
+        fs::create_directories(options.interface_dir, ec);
+    }
+
+    const std::vector<double> durations = graph.schedule(pool, work);
+
+    if (options.cache) {
+        for (size_t node = 0; node < graph.size(); ++node) {
+            ModuleState &state = states[node];
+            if (!state.cacheable || state.key.empty()) continue;
+
+            if (state.needs_check) {
+                state.entry.dependencies.clear();
+                for (const auto &import : state.unit->imports) {
+                    const size_t provider = graph.find(import);
+                    const uint64_t hash = provider != SIZE_MAX ? states[provider].entry.interface_hash : 0;
+                    state.entry.dependencies.emplace_back(import, hash);
+                }
+            }
+            options.cache->store(state.key, state.entry);
+        }
+    }
+
+    size_t failures = 0;
+    for (size_t node = 0; node < graph.size(); ++node) {
+        std::vector<Diagnostic> diagnostics;
+        for (const auto &problem : graph.diagnostics()) {
+            if (problem.file == graph.header(node).path) diagnostics.push_back(problem);
+        }
+        diagnostics.insert(diagnostics.end(), states[node].entry.diagnostics.begin(), states[node].entry.diagnostics.end());
+
+        for (const auto &diagnostic : diagnostics) print_diagnostic(out, diagnostic);
+        failures += std::ranges::any_of(diagnostics, [](const Diagnostic &d) { return d.severity == Severity::Error; });
+    }
+
+    if (options.critical_path) graph.print_critical_path(out, durations);
+
+    return failures;
+}
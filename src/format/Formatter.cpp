@@ -0,0 +1,338 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/format/Formatter.h"
+#include "../../include/driver/Driver.h"
+#include "../../include/tokens/TokenCategory.h"
+#include "../../include/util/Trace.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string_view>
+
+namespace {
+    bool is_operator_char(char c) {
+        return std::string_view("+-*/%=<>!&|^.:?~").find(c) != std::string_view::npos;
+    }
+
+    bool is_word_char(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    bool is_operator(TokenType type) {
+        switch (get_token_category(type)) {
+            case TokenCategory::Operator:
+            case TokenCategory::Assignment:
+            case TokenCategory::Comparison:
+            case TokenCategory::Logical:
+            case TokenCategory::Bitwise:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool is_numeric_literal(TokenType type) {
+        return get_token_category(type) == TokenCategory::Literal && type != TokenType::STRING_LITERAL &&
+               type != TokenType::CHAR_LITERAL;
+    }
+
+    // Compares formatted output against the original as it is produced. Nothing
+    // is buffered while the two agree; at the first difference a temporary file
+    // is started with the agreed prefix and everything after goes there.
+    class RewriteBuffer : public std::streambuf {
+    public:
+        RewriteBuffer(const std::string &path, const std::string &original, bool write)
+            : path(path), temp_path(path + ".fmt.tmp"), original(original), write(write) {
+        }
+
+        ~RewriteBuffer() override {
+            if (temp.is_open()) {
+                temp.close();
+                std::error_code ec;
+                std::filesystem::remove(temp_path, ec); // never committed
+            }
+        }
+
+        // Replace the original with what was written; false if it was identical
+        bool commit() {
+            if (!diverged && matched != original.size()) diverge(); // the output is a prefix
+            if (!diverged || !write) return diverged;
+
+            temp.close();
+            if (!temp) throw std::runtime_error("Could not write " + temp_path);
+
+            std::error_code ec;
+            std::filesystem::permissions(temp_path, std::filesystem::status(path, ec).permissions(), ec);
+            std::filesystem::rename(temp_path, path, ec);
+            if (ec) throw std::runtime_error("Could not replace " + path + ": " + ec.message());
+            return true;
+        }
+
+    protected:
+        int_type overflow(int_type ch) override {
+            if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+            const char c = traits_type::to_char_type(ch);
+            xsputn(&c, 1);
+            return ch;
+        }
+
+        std::streamsize xsputn(const char *data, std::streamsize count) override {
+            const auto size = static_cast<size_t>(count);
+            if (!diverged) {
+                const size_t available = std::min(size, original.size() - matched);
+                const auto [mismatch, _] = std::mismatch(data, data + available, original.data() + matched);
+                const auto same = static_cast<size_t>(mismatch - data);
+                matched += same;
+                if (same == size) return count;
+                diverge();
+                data += same;
+                count -= static_cast<std::streamsize>(same);
+            }
+            if (temp.is_open()) temp.write(data, count);
+            return static_cast<std::streamsize>(size);
+        }
+
+    private:
+        void diverge() {
+            diverged = true;
+            if (!write) return;
+            temp.open(temp_path, std::ios::binary | std::ios::trunc); // failure surfaces in commit()
+            temp.write(original.data(), static_cast<std::streamsize>(matched));
+        }
+
+        const std::string &path;
+        std::string temp_path;
+        const std::string &original;
+        bool write;
+        bool diverged = false;
+        size_t matched = 0;
+        std::ofstream temp;
+    };
+
+    // Tokens a '(' or '[' attaches to without a space: calls and indexing
+    bool is_callee(TokenType type) {
+        switch (type) {
+            case TokenType::IDENTIFIER:
+            case TokenType::RIGHT_PAREN:
+            case TokenType::RIGHT_BRACKET:
+            case TokenType::THIS:
+            case TokenType::SUPER:
+            case TokenType::INT8: case TokenType::INT16: case TokenType::INT32: case TokenType::INT64:
+            case TokenType::UINT8: case TokenType::UINT16: case TokenType::UINT32: case TokenType::UINT64:
+            case TokenType::FLOAT8: case TokenType::FLOAT16: case TokenType::FLOAT32: case TokenType::FLOAT64:
+            case TokenType::DOUBLE: case TokenType::BOOLEAN: case TokenType::CHAR: case TokenType::STRING:
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
+Formatter::Formatter(std::ostream &out) : out(out) {
+}
+
+void Formatter::format(const std::string &source) {
+    Lexer lexer(source, "");
+    lexer.set_keep_trivia(true);
+
+    while (true) {
+        const Token next = lexer.next_token();
+        const int newlines = comments(source, lexer.trivia());
+        lexer.clear_trivia();
+
+        if (next.type == TokenType::END_OF_FILE) break;
+        token(source, next, newlines);
+    }
+
+    // An unterminated block comment runs to the end of the file; a newline would join it
+    if (!first && !open_comment) out << '\n';
+}
+
+Formatter::Result Formatter::format_file(const std::string &path, bool write) {
+    TraceScope trace("format", path);
+    const std::string source = Driver::read_source(path);
+
+    RewriteBuffer buffer(path, source, write);
+    std::ostream out(&buffer);
+    Formatter(out).format(source);
+    out.flush();
+
+    return buffer.commit() ? Result::Reformatted : Result::Unchanged;
+}
+
+// Emit the comments among `trivia`; returns the line breaks after the last one
+int Formatter::comments(const std::string &source, const std::vector<Trivia> &trivia) {
+    int newlines = 0;
+
+    for (const auto &span : trivia) {
+        if (span.kind == TriviaKind::Newline) ++newlines;
+        if (span.kind == TriviaKind::Newline || span.kind == TriviaKind::Whitespace) continue;
+
+        if (first) {
+            // nothing to separate from
+        } else if (newlines == 0 && !after_line_comment) {
+            out << ' '; // trailing comment stays on its line
+        } else {
+            const bool boundary = nesting == 0 && ends_statement();
+            line_break(std::min(newlines, 2), depth + (boundary ? 0 : 1));
+        }
+
+        const std::string_view text(source.data() + span.offset, span.length);
+        out << text;
+        open_comment = span.kind == TriviaKind::BlockComment && (text.size() < 4 || !text.ends_with("*/"));
+        last_char = source[span.offset + span.length - 1];
+        first = false;
+        after_comment = true;
+        after_line_comment = span.kind == TriviaKind::LineComment;
+        newlines = 0;
+    }
+
+    return newlines;
+}
+
+void Formatter::token(const std::string &source, const Token &token, int newlines_before) {
+    const TokenType type = token.type;
+    const bool closing = type == TokenType::RIGHT_BRACE;
+    if (closing) depth = std::max(0, depth - 1);
+
+    // Statements end at ';' and at braces; everything else continues a statement
+    const bool boundary = nesting == 0 && ends_statement();
+    int breaks = 0;
+
+    if (first) {
+        breaks = 0;
+    } else if (after_line_comment) {
+        breaks = std::clamp(newlines_before, 1, 2);
+    } else if (boundary) {
+        const bool joins_brace = previous == TokenType::RIGHT_BRACE &&
+                                 (type == TokenType::ELSE || type == TokenType::SEMICOLON ||
+                                  type == TokenType::COMMA || type == TokenType::RIGHT_PAREN);
+        if (joins_brace || (previous == TokenType::LEFT_BRACE && closing)) {
+            breaks = 0;
+        } else {
+            // Keep one blank line where the source had any, except at block edges
+            breaks = newlines_before >= 2 && previous != TokenType::LEFT_BRACE && !closing ? 2 : 1;
+        }
+    } else if (closing || newlines_before > 0) {
+        breaks = 1;
+    }
+
+    const std::string_view text(source.data() + token.offset, token.length);
+
+    if (breaks > 0) {
+        line_break(breaks, depth + (boundary || closing ? 0 : 1));
+    } else if (!first && (after_comment || space_between(type, text))) {
+        out << ' ';
+    }
+
+    const bool unary = (type == TokenType::MINUS || type == TokenType::PLUS || type == TokenType::NOT ||
+                        type == TokenType::TILDE) && is_unary_position();
+
+    out << text;
+    if (!text.empty()) last_char = text.back();
+
+    switch (type) {
+        case TokenType::LEFT_BRACE: ++depth; break;
+        case TokenType::LEFT_PAREN:
+        case TokenType::LEFT_BRACKET: ++nesting; break;
+        case TokenType::RIGHT_PAREN:
+        case TokenType::RIGHT_BRACKET: nesting = std::max(0, nesting - 1); break;
+        case TokenType::QUESTION: ++ternaries; break;
+        case TokenType::COLON: ternaries = std::max(0, ternaries - 1); break;
+        default: break;
+    }
+
+    previous = type;
+    first = false;
+    after_unary = unary;
+    after_comment = false;
+    after_line_comment = false;
+}
+
+void Formatter::line_break(int newlines, int indent) {
+    for (int i = 0; i < newlines; ++i) out << '\n';
+    for (int i = 0; i < indent * INDENT_WIDTH; ++i) out << ' ';
+    last_char = ' ';
+}
+
+bool Formatter::space_between(TokenType next, std::string_view text) {
+    const char first_char = text.empty() ? ' ' : text.front();
+
+    // Never let two tokens run together into a different token
+    if ((is_operator_char(last_char) && is_operator_char(first_char)) ||
+        (is_word_char(last_char) && is_word_char(first_char)) ||
+        (next == TokenType::DOT && is_numeric_literal(previous))) {
+        return true;
+    }
+
+    ternary_colon = next == TokenType::COLON && ternaries > 0;
+
+    if (after_unary) return false;
+
+    switch (next) {
+        case TokenType::RIGHT_PAREN:
+        case TokenType::RIGHT_BRACKET:
+        case TokenType::COMMA:
+        case TokenType::SEMICOLON:
+        case TokenType::DOT:
+        case TokenType::DOUBLE_COLON:
+        case TokenType::RANGE:
+        case TokenType::RANGE_INCLUSIVE:
+        case TokenType::ELLIPSIS:
+            return false;
+        case TokenType::COLON:
+            return ternary_colon; // `a ? b : c`, but `name: type`
+        default:
+            break;
+    }
+
+    switch (previous) {
+        case TokenType::LEFT_PAREN:
+        case TokenType::LEFT_BRACKET:
+        case TokenType::DOT:
+        case TokenType::DOUBLE_COLON:
+        case TokenType::RANGE:
+        case TokenType::RANGE_INCLUSIVE:
+        case TokenType::ELLIPSIS:
+        case TokenType::AT:
+        case TokenType::HASH:
+        case TokenType::DOLLAR:
+            return false;
+        default:
+            break;
+    }
+
+    if (next == TokenType::RIGHT_BRACE) return previous != TokenType::LEFT_BRACE; // `{}`
+    if (next == TokenType::LEFT_PAREN || next == TokenType::LEFT_BRACKET) return !is_callee(previous);
+    return true;
+}
+
+bool Formatter::is_unary_position() const {
+    if (first || is_operator(previous)) return true;
+
+    switch (previous) {
+        case TokenType::LEFT_PAREN:
+        case TokenType::LEFT_BRACKET:
+        case TokenType::LEFT_BRACE:
+        case TokenType::COMMA:
+        case TokenType::SEMICOLON:
+        case TokenType::COLON:
+        case TokenType::QUESTION:
+        case TokenType::ARROW:
+        case TokenType::FAT_ARROW:
+            return true;
+        default:
+            return get_token_category(previous) == TokenCategory::ControlFlow; // `ret -1`
+    }
+}
+
+bool Formatter::ends_statement() const {
+    return previous == TokenType::SEMICOLON || previous == TokenType::LEFT_BRACE ||
+           previous == TokenType::RIGHT_BRACE || previous == TokenType::END_OF_FILE;
+}
@@ -0,0 +1,154 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/ir/CommonSubexpressionElimination.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <unordered_set>
+
+namespace {
+    bool is_pure(IROp op) {
+        switch (op) {
+            case IROp::Const:
+            case IROp::Add:
+            case IROp::Sub:
+            case IROp::Mul:
+            case IROp::Div:
+            case IROp::Mod:
+            case IROp::Neg:
+            case IROp::Not:
+            case IROp::Eq:
+            case IROp::Ne:
+            case IROp::Lt:
+            case IROp::Le:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Equality does not care about operand order; integer sums and products
+    // do not either, but string concatenation does
+    bool is_commutative(const IRInstruction &instruction) {
+        switch (instruction.op) {
+            case IROp::Eq:
+            case IROp::Ne: return true;
+            case IROp::Add:
+            case IROp::Mul: return instruction.operation != TYPE_UNKNOWN;
+            default: return false;
+        }
+    }
+
+    struct Expression {
+        const IRInstruction *instruction;
+        std::vector<const IRInstruction *> operands; // sorted for commutative operations
+    };
+
+    Expression expression_of(const IRInstruction &instruction) {
+        Expression expression{&instruction, {instruction.operands.begin(), instruction.operands.end()}};
+        if (is_commutative(instruction)) {
+            std::ranges::sort(expression.operands, {}, [](const IRInstruction *operand) { return operand->id; });
+        }
+        return expression;
+    }
+
+    struct ExpressionHash {
+        size_t operator()(const Expression &expression) const {
+            const IRInstruction &instruction = *expression.instruction;
+            size_t hash = static_cast<size_t>(instruction.op) * 31 + instruction.type;
+            hash = hash * 31 + instruction.operation;
+            for (const IRInstruction *operand : expression.operands) hash = hash * 31 + operand->id;
+
+            if (instruction.is_constant()) {
+                hash = hash * 31 + instruction.constant.index();
+                std::visit([&]<typename T>(const T &value) {
+                    if constexpr (std::is_same_v<T, float>) hash = hash * 31 + std::bit_cast<uint32_t>(value);
+                    else if constexpr (std::is_same_v<T, double>) hash = hash * 31 + std::bit_cast<uint64_t>(value);
+                    else if constexpr (!std::is_same_v<T, std::monostate>) hash = hash * 31 + std::hash<T>{}(value);
+                }, instruction.constant);
+            }
+            return hash;
+        }
+    };
+
+    struct ExpressionEqual {
+        bool operator()(const Expression &a, const Expression &b) const {
+            const IRInstruction &x = *a.instruction, &y = *b.instruction;
+            return x.op == y.op && x.type == y.type && x.operation == y.operation && a.operands == b.operands &&
+                   identical_constants(x.constant, y.constant);
+        }
+    };
+}
+
+bool CommonSubexpressionElimination::run(IRModule &module, PassStatistics &statistics) {
+    bool changed = false;
+    for (const auto &function : module.functions) changed = run(*function, statistics) || changed;
+    return changed;
+}
+
+bool CommonSubexpressionElimination::run(IRFunction &function, PassStatistics &statistics) {
+    const DominatorTree dominators(function);
+    std::unordered_map<Expression, IRInstruction *, ExpressionHash, ExpressionEqual> available;
+    std::unordered_map<const IRInstruction *, IRInstruction *> replacements;
+
+    // Operands are looked up through `replacements` first, so a use of an
+    // eliminated value counts as a use of the value that replaced it
+    auto resolve = [&](IRInstruction &instruction) {
+        for (IRInstruction *&operand : instruction.operands) {
+            if (const auto it = replacements.find(operand); it != replacements.end()) operand = it->second;
+        }
+    };
+
+    // Iterative preorder walk; a block's entries leave the table once its subtree is done
+    struct Frame {
+        BasicBlock *block;
+        size_t next_child = 0;
+        std::vector<Expression> added;
+    };
+    std::vector<Frame> stack;
+    if (!dominators.order().empty()) stack.push_back({dominators.order().front(), 0, {}});
+
+    bool entered = false;
+    while (!stack.empty()) {
+        Frame &frame = stack.back();
+        if (!entered) {
+            for (const auto &instruction : frame.block->instructions) {
+                resolve(*instruction);
+                if (!is_pure(instruction->op)) continue;
+
+                Expression expression = expression_of(*instruction);
+                if (const auto it = available.find(expression); it != available.end()) {
+                    replacements.emplace(instruction.get(), it->second);
+                } else {
+                    available.emplace(expression, instruction.get());
+                    frame.added.push_back(std::move(expression));
+                }
+            }
+        }
+
+        const auto &children = dominators.children(frame.block);
+        if (frame.next_child < children.size()) {
+            BasicBlock *child = children[frame.next_child++];
+            stack.push_back({child, 0, {}});
+            entered = false;
+            continue;
+        }
+
+        for (const Expression &expression : frame.added) available.erase(expression);
+        stack.pop_back();
+        entered = true;
+    }
+
+    if (replacements.empty()) return false;
+
+    // Phis can refer to values from blocks visited later
+    replace_uses(function, replacements);
+    for (const auto &block : function.blocks) {
+        std::erase_if(block->instructions, [&](const auto &i) { return replacements.contains(i.get()); });
+    }
+    statistics.add("eliminated", replacements.size());
+    return true;
+}
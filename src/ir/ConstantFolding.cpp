@@ -0,0 +1,250 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/ir/ConstantFolding.h"
+
+#include <cmath>
+
+namespace {
+    bool is_number(const Literal &value) {
+        return std::holds_alternative<int64_t>(value) || std::holds_alternative<float>(value) ||
+               std::holds_alternative<double>(value);
+    }
+
+    // Every floating-point width is a double at run time
+    double as_double(const Literal &value) {
+        if (const auto *i = std::get_if<int64_t>(&value)) return static_cast<double>(*i);
+        if (const auto *f = std::get_if<float>(&value)) return *f;
+        return std::get<double>(value);
+    }
+
+    // Reduce to `bits` and sign- or zero-extend back to 64, like the VM's typed instructions
+    int64_t wrap(int64_t value, unsigned bits, bool is_signed) {
+        if (bits >= 64) return value;
+        const uint64_t mask = (uint64_t{1} << bits) - 1;
+        const uint64_t low = static_cast<uint64_t>(value) & mask;
+        if (is_signed && (low >> (bits - 1)) != 0) return static_cast<int64_t>(low | ~mask);
+        return static_cast<int64_t>(low);
+    }
+
+    std::optional<Literal> fold_integer(IROp op, int64_t a, int64_t b, unsigned bits, bool is_signed) {
+        const auto ua = static_cast<uint64_t>(a), ub = static_cast<uint64_t>(b);
+        const bool is_u64 = bits >= 64 && !is_signed;
+
+        switch (op) {
+            case IROp::Add: return wrap(static_cast<int64_t>(ua + ub), bits, is_signed);
+            case IROp::Sub: return wrap(static_cast<int64_t>(ua - ub), bits, is_signed);
+            case IROp::Mul: return wrap(static_cast<int64_t>(ua * ub), bits, is_signed);
+            case IROp::Neg: return wrap(static_cast<int64_t>(0 - ua), bits, is_signed);
+            case IROp::Div:
+            case IROp::Mod:
+                if (b == 0) return std::nullopt; // the VM reports it
+                if (is_u64) return static_cast<int64_t>(op == IROp::Div ? ua / ub : ua % ub);
+                if (b == -1) return op == IROp::Div ? wrap(static_cast<int64_t>(0 - ua), bits, is_signed) : 0;
+                return wrap(op == IROp::Div ? a / b : a % b, bits, is_signed);
+            case IROp::Lt: return is_u64 ? ua < ub : a < b;
+            case IROp::Le: return is_u64 ? ua <= ub : a <= b;
+            case IROp::Eq: return a == b;
+            case IROp::Ne: return a != b;
+            default: return std::nullopt;
+        }
+    }
+
+    // The VM's values_equal
+    std::optional<bool> equal(const Literal &a, const Literal &b) {
+        if (is_number(a) && is_number(b)) {
+            if (std::holds_alternative<int64_t>(a) && std::holds_alternative<int64_t>(b)) {
+                return std::get<int64_t>(a) == std::get<int64_t>(b);
+            }
+            return as_double(a) == as_double(b);
+        }
+        if (a.index() != b.index()) return false;
+        if (std::holds_alternative<std::monostate>(a)) return true;
+        return a == b;
+    }
+
+    std::optional<Literal> fold_generic(IROp op, const Literal &a, const Literal &b) {
+        if (op == IROp::Eq || op == IROp::Ne) {
+            const auto same = equal(a, b);
+            if (!same) return std::nullopt;
+            return op == IROp::Eq ? *same : !*same;
+        }
+
+        if (std::holds_alternative<int64_t>(a) && std::holds_alternative<int64_t>(b)) {
+            return fold_integer(op, std::get<int64_t>(a), std::get<int64_t>(b), 64, true);
+        }
+
+        if (is_number(a) && is_number(b)) {
+            const double x = as_double(a), y = as_double(b);
+            switch (op) {
+                case IROp::Add: return x + y;
+                case IROp::Sub: return x - y;
+                case IROp::Mul: return x * y;
+                case IROp::Div: return x / y;
+                case IROp::Mod: return std::fmod(x, y);
+                case IROp::Neg: return -x;
+                case IROp::Lt: return x < y;
+                case IROp::Le: return x <= y;
+                default: return std::nullopt;
+            }
+        }
+
+        if (const auto *x = std::get_if<char>(&a), *y = std::get_if<char>(&b); x && y) {
+            if (op == IROp::Lt) return *x < *y;
+            if (op == IROp::Le) return *x <= *y;
+        }
+
+        if (const auto *x = std::get_if<std::string>(&a), *y = std::get_if<std::string>(&b); x && y) {
+            if (op == IROp::Add) return *x + *y;
+            if (op == IROp::Lt) return *x < *y;
+            if (op == IROp::Le) return *x <= *y;
+        }
+
+        if (const auto *x = std::get_if<bool>(&a); x && op == IROp::Not) return !*x;
+        return std::nullopt;
+    }
+
+    bool is_integer_constant(const IRInstruction *value, int64_t expected) {
+        if (!value->is_constant()) return false;
+        const auto *i = std::get_if<int64_t>(&value->constant);
+        return i && *i == expected;
+    }
+
+    // x + 0, 0 + x, x - 0, x * 1, 1 * x and x / 1 on integers
+    IRInstruction *identity(const IRInstruction &instruction) {
+        if (instruction.operation == TYPE_UNKNOWN || instruction.operands.size() != 2) return nullptr;
+        IRInstruction *left = instruction.operands[0], *right = instruction.operands[1];
+
+        switch (instruction.op) {
+            case IROp::Add:
+                if (is_integer_constant(right, 0)) return left;
+                if (is_integer_constant(left, 0)) return right;
+                return nullptr;
+            case IROp::Sub: return is_integer_constant(right, 0) ? left : nullptr;
+            case IROp::Mul:
+                if (is_integer_constant(right, 1)) return left;
+                if (is_integer_constant(left, 1)) return right;
+                return nullptr;
+            case IROp::Div: return is_integer_constant(right, 1) ? left : nullptr;
+            default: return nullptr;
+        }
+    }
+
+    bool same_value(const IRInstruction *a, const IRInstruction *b) {
+        return a == b || (a->is_constant() && b->is_constant() && a->type == b->type &&
+                                  identical_constants(a->constant, b->constant));
+    }
+
+    // The one value a phi merges besides itself, or null when there are several
+    IRInstruction *trivial_value(const IRInstruction &phi) {
+        IRInstruction *same = nullptr;
+        for (IRInstruction *operand : phi.operands) {
+            if (operand == &phi || (same && same_value(operand, same))) continue;
+            if (same) return nullptr;
+            same = operand;
+        }
+        return same;
+    }
+}
+
+std::optional<Literal> ConstantFolding::fold(const IRInstruction &instruction, const TypeTable &types) {
+    switch (instruction.op) {
+        case IROp::Add:
+        case IROp::Sub:
+        case IROp::Mul:
+        case IROp::Div:
+        case IROp::Mod:
+        case IROp::Neg:
+        case IROp::Not:
+        case IROp::Eq:
+        case IROp::Ne:
+        case IROp::Lt:
+        case IROp::Le:
+            break;
+        default:
+            return std::nullopt;
+    }
+
+    for (const IRInstruction *operand : instruction.operands) {
+        if (!operand->is_constant()) return std::nullopt;
+    }
+    const Literal &a = instruction.operands[0]->constant;
+    const Literal &b = instruction.operands.size() > 1 ? instruction.operands[1]->constant : a;
+
+    if (instruction.operation != TYPE_UNKNOWN) {
+        const auto *x = std::get_if<int64_t>(&a), *y = std::get_if<int64_t>(&b);
+        if (!x || !y) return std::nullopt;
+        return fold_integer(instruction.op, *x, *y, types.bit_width(instruction.operation),
+                            types.is_signed(instruction.operation));
+    }
+    return fold_generic(instruction.op, a, b);
+}
+
+bool ConstantFolding::run(IRModule &module, PassStatistics &statistics) {
+    bool changed = false;
+    for (const auto &function : module.functions) changed = run(*function, *module.types, statistics) || changed;
+    return changed;
+}
+
+bool ConstantFolding::run(IRFunction &function, const TypeTable &types, PassStatistics &statistics) {
+    bool changed = false;
+
+    for (bool progress = true; progress;) {
+        progress = false;
+        std::unordered_map<const IRInstruction *, IRInstruction *> replacements;
+        auto replace = [&](const IRInstruction *instruction, IRInstruction *value) {
+            // A cycle of phis that only merge each other stays as it is
+            for (auto it = replacements.find(value); it != replacements.end(); it = replacements.find(value)) {
+                value = it->second;
+            }
+            if (value == instruction) return false;
+            replacements.emplace(instruction, value);
+            return true;
+        };
+
+        for (BasicBlock *block : reverse_postorder(function)) {
+            for (const auto &instruction : block->instructions) {
+                if (instruction->op == IROp::Phi) {
+                    IRInstruction *value = trivial_value(*instruction);
+                    if (value && replace(instruction.get(), value)) statistics.add("phis");
+                } else if (auto value = fold(*instruction, types)) {
+                    // Becomes the constant in place, so its uses need not change
+                    instruction->op = IROp::Const;
+                    instruction->constant = std::move(*value);
+                    instruction->operation = TYPE_UNKNOWN;
+                    instruction->operands.clear();
+                    statistics.add("folded");
+                    progress = true;
+                } else if (IRInstruction *operand = identity(*instruction); operand && replace(instruction.get(), operand)) {
+                    statistics.add("identities");
+                }
+            }
+
+            IRInstruction *terminator = block->terminator();
+            if (terminator->op != IROp::Branch) continue;
+
+            BasicBlock *taken = block->successors[0], *not_taken = block->successors[1];
+            const auto *condition = std::get_if<bool>(&terminator->operands[0]->constant);
+            if (taken != not_taken && (!terminator->operands[0]->is_constant() || !condition)) continue;
+
+            remove_edge(block, taken != not_taken && *condition ? not_taken : taken);
+            terminator->op = IROp::Jump;
+            terminator->operands.clear();
+            statistics.add("branches");
+            progress = true;
+        }
+
+        if (!replacements.empty()) {
+            replace_uses(function, replacements);
+            for (const auto &block : function.blocks) {
+                std::erase_if(block->instructions, [&](const auto &i) { return replacements.contains(i.get()); });
+            }
+            progress = true;
+        }
+        if (remove_unreachable_blocks(function) > 0) progress = true;
+        changed = changed || progress;
+    }
+
+    return changed;
+}
@@ -0,0 +1,90 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/ir/DeadCodeElimination.h"
+
+#include <unordered_set>
+
+bool DeadCodeElimination::run(IRModule &module, PassStatistics &statistics) {
+    bool changed = false;
+    for (const auto &function : module.functions) {
+        if (const size_t removed = remove_unreachable_blocks(*function); removed > 0) {
+            statistics.add("blocks", removed);
+            changed = true;
+        }
+        changed = remove_dead(*function, statistics) || changed;
+        changed = merge_blocks(*function, statistics) || changed;
+    }
+    return changed;
+}
+
+// Marks everything an effect depends on and deletes the rest
+bool DeadCodeElimination::remove_dead(IRFunction &function, PassStatistics &statistics) {
+    std::unordered_set<const IRInstruction *> live;
+    std::vector<const IRInstruction *> work;
+
+    for (const auto &block : function.blocks) {
+        for (const auto &instruction : block->instructions) {
+            if ((instruction->has_side_effects() || instruction->may_trap()) && live.insert(instruction.get()).second) {
+                work.push_back(instruction.get());
+            }
+        }
+    }
+
+    while (!work.empty()) {
+        const IRInstruction *instruction = work.back();
+        work.pop_back();
+        for (const IRInstruction *operand : instruction->operands) {
+            if (live.insert(operand).second) work.push_back(operand);
+        }
+    }
+
+    size_t removed = 0;
+    for (const auto &block : function.blocks) {
+        removed += std::erase_if(block->instructions, [&](const auto &i) { return !live.contains(i.get()); });
+    }
+    if (removed > 0) statistics.add("removed", removed);
+    return removed > 0;
+}
+
+// A block with a single predecessor that has no other successor is just the rest of that predecessor
+bool DeadCodeElimination::merge_blocks(IRFunction &function, PassStatistics &statistics) {
+    std::unordered_set<const BasicBlock *> merged;
+    std::unordered_map<const IRInstruction *, IRInstruction *> replacements;
+
+    for (const auto &owner : function.blocks) {
+        BasicBlock *block = owner.get();
+        if (merged.contains(block)) continue;
+
+        while (block->successors.size() == 1) {
+            BasicBlock *next = block->successors[0];
+            if (next == block || next == function.blocks.front().get() || next->predecessors.size() != 1) break;
+
+            // Its phis have the one operand from `block`
+            const size_t phis = next->phi_count();
+            for (size_t i = 0; i < phis; ++i) {
+                replacements.emplace(next->instructions[i].get(), next->instructions[i]->operands[0]);
+            }
+
+            block->instructions.pop_back(); // the jump
+            for (size_t i = phis; i < next->instructions.size(); ++i) {
+                next->instructions[i]->block = block;
+                block->instructions.push_back(std::move(next->instructions[i]));
+            }
+            next->instructions.clear();
+
+            block->successors = next->successors;
+            for (BasicBlock *successor : next->successors) replace_predecessor(successor, next, block);
+            next->successors.clear();
+            next->predecessors.clear();
+            merged.insert(next);
+        }
+    }
+
+    if (merged.empty()) return false;
+    replace_uses(function, replacements);
+    std::erase_if(function.blocks, [&](const auto &block) { return merged.contains(block.get()); });
+    statistics.add("merged", merged.size());
+    return true;
+}
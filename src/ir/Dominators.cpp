@@ -0,0 +1,105 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/ir/Dominators.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+    constexpr size_t UNDEFINED = SIZE_MAX;
+}
+
+DominatorTree::DominatorTree(const IRFunction &function) : rpo(reverse_postorder(function)) {
+    for (size_t i = 0; i < rpo.size(); ++i) position.emplace(rpo[i], i);
+    idoms.assign(rpo.size(), UNDEFINED);
+    tree.resize(rpo.size());
+    if (rpo.empty()) return;
+    idoms[0] = 0;
+
+    auto intersect = [&](size_t a, size_t b) {
+        while (a != b) {
+            while (a > b) a = idoms[a];
+            while (b > a) b = idoms[b];
+        }
+        return a;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < rpo.size(); ++i) {
+            size_t candidate = UNDEFINED;
+            for (const BasicBlock *predecessor : rpo[i]->predecessors) {
+                const auto it = position.find(predecessor);
+                if (it == position.end() || idoms[it->second] == UNDEFINED) continue;
+                candidate = candidate == UNDEFINED ? it->second : intersect(it->second, candidate);
+            }
+            if (candidate != idoms[i]) {
+                idoms[i] = candidate;
+                changed = true;
+            }
+        }
+    }
+
+    for (size_t i = 1; i < rpo.size(); ++i) tree[idoms[i]].push_back(rpo[i]);
+}
+
+BasicBlock *DominatorTree::idom(const BasicBlock *block) const {
+    const auto it = position.find(block);
+    if (it == position.end() || it->second == 0) return nullptr;
+    return rpo[idoms[it->second]];
+}
+
+bool DominatorTree::dominates(const BasicBlock *a, const BasicBlock *b) const {
+    const auto from = position.find(a), to = position.find(b);
+    if (from == position.end() || to == position.end()) return false;
+
+    size_t current = to->second;
+    while (current > from->second) current = idoms[current]; // dominators come first in reverse postorder
+    return current == from->second;
+}
+
+const std::vector<BasicBlock *> &DominatorTree::children(const BasicBlock *block) const {
+    static const std::vector<BasicBlock *> none;
+    const auto it = position.find(block);
+    return it == position.end() ? none : tree[it->second];
+}
+
+std::vector<Loop> find_loops(const DominatorTree &dominators) {
+    std::vector<Loop> loops;
+
+    for (BasicBlock *header : dominators.order()) {
+        std::unordered_set<BasicBlock *> members{header};
+        std::vector<BasicBlock *> work;
+        for (BasicBlock *tail : header->predecessors) {
+            if (dominators.dominates(header, tail) && members.insert(tail).second) work.push_back(tail);
+        }
+        if (members.size() == 1 && std::ranges::find(header->predecessors, header) == header->predecessors.end()) {
+            continue; // no back edge
+        }
+
+        while (!work.empty()) {
+            BasicBlock *block = work.back();
+            work.pop_back();
+            for (BasicBlock *predecessor : block->predecessors) {
+                if (members.insert(predecessor).second) work.push_back(predecessor);
+            }
+        }
+
+        Loop loop{header, {}, 1};
+        for (BasicBlock *block : dominators.order()) {
+            if (members.contains(block)) loop.blocks.push_back(block);
+        }
+        loops.push_back(std::move(loop));
+    }
+
+    for (Loop &loop : loops) {
+        for (const Loop &other : loops) {
+            if (&other != &loop && std::ranges::find(other.blocks, loop.header) != other.blocks.end()) ++loop.depth;
+        }
+    }
+    std::ranges::stable_sort(loops, [](const Loop &a, const Loop &b) { return a.depth > b.depth; });
+    return loops;
+}
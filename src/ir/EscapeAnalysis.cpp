@@ -0,0 +1,61 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/ir/EscapeAnalysis.h"
+
+#include <unordered_set>
+
+namespace {
+    // Whether the callee may run before `instruction` instead of partly after it
+    bool order_independent(const IRInstruction &instruction) {
+        return !instruction.has_side_effects() && !instruction.may_trap() && instruction.op != IROp::GetGlobal;
+    }
+}
+
+bool EscapeAnalysis::run(IRModule &module, PassStatistics &statistics) {
+    bool changed = false;
+    for (const auto &function : module.functions) changed = run(*function, statistics) || changed;
+    return changed;
+}
+
+bool EscapeAnalysis::run(IRFunction &function, PassStatistics &statistics) {
+    std::unordered_map<const IRInstruction *, std::vector<IRInstruction *>> users;
+    for (const auto &block : function.blocks) {
+        for (const auto &instruction : block->instructions) {
+            for (const IRInstruction *operand : instruction->operands) users[operand].push_back(instruction.get());
+        }
+    }
+
+    std::unordered_map<const IRInstruction *, IRInstruction *> replacements;
+    std::unordered_set<const IRInstruction *> consumed;
+    for (const auto &block : function.blocks) {
+        const auto &instructions = block->instructions;
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            IRInstruction &start = *instructions[i];
+            if (start.op != IROp::Spawn && start.op != IROp::Async) continue;
+
+            const auto found = users.find(&start);
+            if (found == users.end() || found->second.size() != 1) continue;
+            const IRInstruction &user = *found->second.front();
+            if (user.op != (start.op == IROp::Spawn ? IROp::Join : IROp::Await) || user.block != block.get()) continue;
+
+            size_t j = i + 1;
+            while (j < instructions.size() && instructions[j].get() != &user && order_independent(*instructions[j])) ++j;
+            if (j == instructions.size() || instructions[j].get() != &user) continue;
+
+            statistics.add(start.op == IROp::Spawn ? "tasks" : "coroutines");
+            start.op = start.op == IROp::Spawn ? IROp::Call : IROp::AwaitCall;
+            start.type = user.type;
+            replacements.emplace(&user, &start);
+            consumed.insert(&user);
+        }
+    }
+
+    if (consumed.empty()) return false;
+    for (const auto &block : function.blocks) {
+        std::erase_if(block->instructions, [&](const auto &instruction) { return consumed.contains(instruction.get()); });
+    }
+    replace_uses(function, replacements);
+    return true;
+}
@@ -0,0 +1,387 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/ir/IR.h"
+
+#include <algorithm>
+#include <bit>
+#include <sstream>
+#include <unordered_set>
+
+const char *ir_op_name(IROp op) {
+    switch (op) {
+        case IROp::Const: return "const";
+        case IROp::Param: return "param";
+        case IROp::Phi: return "phi";
+        case IROp::GetGlobal: return "getglobal";
+        case IROp::SetGlobal: return "setglobal";
+        case IROp::Add: return "add";
+        case IROp::Sub: return "sub";
+        case IROp::Mul: return "mul";
+        case IROp::Div: return "div";
+        case IROp::Mod: return "mod";
+        case IROp::Neg: return "neg";
+        case IROp::Not: return "not";
+        case IROp::Eq: return "eq";
+        case IROp::Ne: return "ne";
+        case IROp::Lt: return "lt";
+        case IROp::Le: return "le";
+        case IROp::Call: return "call";
+        case IROp::Print: return "print";
+        case IROp::Spawn: return "spawn";
+        case IROp::Thread: return "thread";
+        case IROp::Join: return "join";
+        case IROp::Async: return "async";
+        case IROp::AwaitCall: return "awaitcall";
+        case IROp::Await: return "await";
+        case IROp::Sleep: return "sleep";
+        case IROp::Readable: return "readable";
+        case IROp::Jump: return "jump";
+        case IROp::Branch: return "branch";
+        case IROp::Return: return "return";
+    }
+    return "?";
+}
+
+bool is_terminator(IROp op) {
+    return op == IROp::Jump || op == IROp::Branch || op == IROp::Return;
+}
+
+bool IRInstruction::has_side_effects() const {
+    switch (op) {
+        case IROp::SetGlobal:
+        case IROp::Call:
+        case IROp::Print:
+        case IROp::Spawn:
+        case IROp::Thread:
+        case IROp::Join:
+        case IROp::Async:
+        case IROp::AwaitCall:
+        case IROp::Await:
+        case IROp::Sleep:
+        case IROp::Readable:
+        case IROp::Jump:
+        case IROp::Branch:
+        case IROp::Return:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool IRInstruction::may_trap() const {
+    switch (op) {
+        case IROp::Div:
+        case IROp::Mod: {
+            const IRInstruction *divisor = operands[1];
+            if (!divisor->is_constant()) return true;
+            if (const auto *i = std::get_if<int64_t>(&divisor->constant)) return *i == 0;
+            return !std::holds_alternative<float>(divisor->constant) &&
+                   !std::holds_alternative<double>(divisor->constant);
+        }
+        case IROp::Add:
+        case IROp::Sub:
+        case IROp::Mul:
+        case IROp::Neg:
+        case IROp::Not:
+        case IROp::Lt:
+        case IROp::Le:
+            // Operands the checker could not type may turn out to be the wrong kind
+            return std::ranges::any_of(operands, [](const IRInstruction *operand) {
+                return operand->type == TYPE_UNKNOWN || operand->type == TYPE_ERROR;
+            });
+        default:
+            return false;
+    }
+}
+
+bool identical_constants(const Literal &a, const Literal &b) {
+    if (a.index() != b.index()) return false;
+    if (const auto *f = std::get_if<float>(&a)) return std::bit_cast<uint32_t>(*f) == std::bit_cast<uint32_t>(std::get<float>(b));
+    if (const auto *d = std::get_if<double>(&a)) {
+        return std::bit_cast<uint64_t>(*d) == std::bit_cast<uint64_t>(std::get<double>(b));
+    }
+    return a == b;
+}
+
+// ===== BLOCKS AND FUNCTIONS =====
+
+IRInstruction *BasicBlock::terminator() const {
+    if (instructions.empty() || !is_terminator(instructions.back()->op)) return nullptr;
+    return instructions.back().get();
+}
+
+size_t BasicBlock::phi_count() const {
+    size_t count = 0;
+    while (count < instructions.size() && instructions[count]->op == IROp::Phi) ++count;
+    return count;
+}
+
+IRInstruction *BasicBlock::append(std::unique_ptr<IRInstruction> instruction) {
+    const size_t position = terminator() && !is_terminator(instruction->op) ? instructions.size() - 1
+                                                                             : instructions.size();
+    return insert(position, std::move(instruction));
+}
+
+IRInstruction *BasicBlock::insert(size_t position, std::unique_ptr<IRInstruction> instruction) {
+    instruction->block = this;
+    IRInstruction *raw = instruction.get();
+    instructions.insert(instructions.begin() + static_cast<std::ptrdiff_t>(position), std::move(instruction));
+    return raw;
+}
+
+BasicBlock *IRFunction::add_block() {
+    blocks.push_back(std::make_unique<BasicBlock>());
+    blocks.back()->id = next_block++;
+    return blocks.back().get();
+}
+
+std::unique_ptr<IRInstruction> IRFunction::make(IROp op, TypeId type, int line, int column) {
+    auto instruction = std::make_unique<IRInstruction>(op);
+    instruction->id = next_value++;
+    instruction->type = type;
+    instruction->line = line;
+    instruction->column = column;
+    return instruction;
+}
+
+size_t IRFunction::instruction_count() const {
+    size_t count = 0;
+    for (const auto &block : blocks) count += block->instructions.size();
+    return count;
+}
+
+// ===== CFG EDITING =====
+
+void add_edge(BasicBlock *from, BasicBlock *to) {
+    from->successors.push_back(to);
+    to->predecessors.push_back(from);
+}
+
+void remove_edge(BasicBlock *from, BasicBlock *to) {
+    const auto successor = std::ranges::find(from->successors, to);
+    if (successor != from->successors.end()) from->successors.erase(successor);
+
+    const auto predecessor = std::ranges::find(to->predecessors, from);
+    if (predecessor == to->predecessors.end()) return;
+    const auto index = predecessor - to->predecessors.begin();
+    to->predecessors.erase(predecessor);
+
+    for (size_t i = 0; i < to->phi_count(); ++i) {
+        auto &operands = to->instructions[i]->operands;
+        if (index < static_cast<std::ptrdiff_t>(operands.size())) operands.erase(operands.begin() + index);
+    }
+}
+
+void replace_predecessor(BasicBlock *to, BasicBlock *from, BasicBlock *replacement) {
+    const auto predecessor = std::ranges::find(to->predecessors, from);
+    if (predecessor != to->predecessors.end()) *predecessor = replacement;
+}
+
+void replace_uses(IRFunction &function,
+                  const std::unordered_map<const IRInstruction *, IRInstruction *> &replacements) {
+    if (replacements.empty()) return;
+
+    for (const auto &block : function.blocks) {
+        for (const auto &instruction : block->instructions) {
+            for (IRInstruction *&operand : instruction->operands) {
+                for (auto it = replacements.find(operand); it != replacements.end(); it = replacements.find(operand)) {
+                    operand = it->second;
+                }
+            }
+        }
+    }
+}
+
+std::vector<BasicBlock *> reverse_postorder(const IRFunction &function) {
+    std::vector<BasicBlock *> order;
+    if (function.blocks.empty()) return order;
+
+    std::unordered_set<const BasicBlock *> visited;
+    std::vector<std::pair<BasicBlock *, size_t>> stack{{function.blocks.front().get(), 0}};
+    visited.insert(function.blocks.front().get());
+
+    while (!stack.empty()) {
+        auto &[block, next] = stack.back();
+        if (next < block->successors.size()) {
+            // Last successor first, so a branch's taken block ends up right after it in the order
+            BasicBlock *successor = block->successors[block->successors.size() - 1 - next++];
+            if (visited.insert(successor).second) stack.emplace_back(successor, 0);
+        } else {
+            order.push_back(block);
+            stack.pop_back();
+        }
+    }
+
+    std::ranges::reverse(order);
+    return order;
+}
+
+size_t remove_unreachable_blocks(IRFunction &function) {
+    const std::vector<BasicBlock *> reachable_order = reverse_postorder(function);
+    if (reachable_order.size() == function.blocks.size()) return 0;
+    const std::unordered_set<const BasicBlock *> reachable(reachable_order.begin(), reachable_order.end());
+
+    for (const auto &block : function.blocks) {
+        if (reachable.contains(block.get())) continue;
+        for (BasicBlock *successor : std::vector(block->successors)) {
+            if (reachable.contains(successor)) remove_edge(block.get(), successor);
+        }
+    }
+
+    const size_t before = function.blocks.size();
+    std::erase_if(function.blocks, [&](const auto &block) { return !reachable.contains(block.get()); });
+    return before - function.blocks.size();
+}
+
+void split_critical_edges(IRFunction &function) {
+    const size_t count = function.blocks.size();
+    for (size_t b = 0; b < count; ++b) {
+        BasicBlock *block = function.blocks[b].get();
+        if (block->successors.size() < 2) continue;
+
+        for (BasicBlock *&successor : block->successors) {
+            if (successor->predecessors.size() < 2) continue;
+
+            const IRInstruction *branch = block->terminator();
+            BasicBlock *edge = function.add_block();
+            edge->append(function.make(IROp::Jump, TYPE_VOID, branch->line, branch->column));
+            edge->predecessors.push_back(block);
+            edge->successors.push_back(successor);
+            replace_predecessor(successor, block, edge);
+            successor = edge;
+        }
+    }
+}
+
+// ===== VERIFICATION =====
+
+std::string verify(const IRModule &module) {
+    for (const auto &function : module.functions) {
+        const std::string where = "in function '" + function->name + "': ";
+
+        std::unordered_set<const IRInstruction *> defined;
+        std::unordered_set<const BasicBlock *> blocks;
+        for (const auto &block : function->blocks) {
+            blocks.insert(block.get());
+            for (const auto &instruction : block->instructions) defined.insert(instruction.get());
+        }
+
+        for (const auto &block : function->blocks) {
+            const std::string at = where + "bb" + std::to_string(block->id) + ": ";
+            const IRInstruction *terminator = block->terminator();
+            if (!terminator) return at + "no terminator";
+
+            const size_t expected = terminator->op == IROp::Jump ? 1 : terminator->op == IROp::Branch ? 2 : 0;
+            if (block->successors.size() != expected) return at + "successors do not match the terminator";
+
+            for (const BasicBlock *successor : block->successors) {
+                if (!blocks.contains(successor)) return at + "successor outside the function";
+                if (std::ranges::count(block->successors, successor) !=
+                    std::ranges::count(successor->predecessors, block.get())) {
+                    return at + "edge to bb" + std::to_string(successor->id) + " missing from its predecessors";
+                }
+            }
+            for (const BasicBlock *predecessor : block->predecessors) {
+                if (!blocks.contains(predecessor)) return at + "predecessor outside the function";
+            }
+
+            const size_t phis = block->phi_count();
+            for (size_t i = 0; i < block->instructions.size(); ++i) {
+                const IRInstruction &instruction = *block->instructions[i];
+                const std::string value = at + "%" + std::to_string(instruction.id) + ": ";
+
+                if (instruction.block != block.get()) return value + "wrong parent block";
+                if (instruction.op == IROp::Phi && i >= phis) return value + "phi after a non-phi";
+                if (instruction.op == IROp::Phi && instruction.operands.size() != block->predecessors.size()) {
+                    return value + "phi operands do not match the predecessors";
+                }
+                if (is_terminator(instruction.op) && i + 1 != block->instructions.size()) {
+                    return value + "terminator in the middle of a block";
+                }
+                for (const IRInstruction *operand : instruction.operands) {
+                    if (!operand || !defined.contains(operand)) return value + "operand is not defined in the function";
+                }
+            }
+        }
+    }
+    return "";
+}
+
+// ===== PRINTING =====
+
+namespace {
+    std::string constant_text(const Literal &constant) {
+        std::ostringstream out;
+        if (const auto *i = std::get_if<int64_t>(&constant)) out << *i;
+        else if (const auto *f = std::get_if<float>(&constant)) out << *f;
+        else if (const auto *d = std::get_if<double>(&constant)) out << *d;
+        else if (const auto *b = std::get_if<bool>(&constant)) out << (*b ? "true" : "false");
+        else if (const auto *c = std::get_if<char>(&constant)) out << '\'' << *c << '\'';
+        else if (const auto *s = std::get_if<std::string>(&constant)) out << '"' << *s << '"';
+        else out << "null";
+        return out.str();
+    }
+
+    void print_instruction(const IRModule &module, const IRInstruction &instruction, std::ostream &out) {
+        const TypeTable &types = *module.types;
+        out << "  ";
+        const bool has_value = !is_terminator(instruction.op) && instruction.op != IROp::SetGlobal &&
+                               instruction.op != IROp::Print;
+        if (has_value) out << "%" << instruction.id << " = ";
+
+        out << ir_op_name(instruction.op);
+        if (instruction.operation != TYPE_UNKNOWN) out << "." << types.to_string(instruction.operation);
+
+        switch (instruction.op) {
+            case IROp::Const: out << " " << constant_text(instruction.constant); break;
+            case IROp::Param: out << " " << instruction.index; break;
+            case IROp::GetGlobal:
+            case IROp::SetGlobal: out << " @" << module.globals[instruction.index]; break;
+            case IROp::Call:
+            case IROp::Spawn:
+            case IROp::Thread:
+            case IROp::Async:
+            case IROp::AwaitCall: out << " " << module.functions[instruction.index]->name; break;
+            default: break;
+        }
+
+        const bool named = instruction.op == IROp::SetGlobal || instruction.op == IROp::Call ||
+                           instruction.op == IROp::Spawn || instruction.op == IROp::Thread ||
+                           instruction.op == IROp::Async || instruction.op == IROp::AwaitCall;
+        for (size_t i = 0; i < instruction.operands.size(); ++i) {
+            out << (i == 0 && !named ? " " : ", ");
+            out << "%" << instruction.operands[i]->id;
+            if (instruction.op == IROp::Phi) out << " bb" << instruction.block->predecessors[i]->id;
+        }
+
+        for (size_t i = 0; i < instruction.block->successors.size() && is_terminator(instruction.op); ++i) {
+            out << (i == 0 && instruction.operands.empty() ? " " : ", ") << "bb" << instruction.block->successors[i]->id;
+        }
+
+        if (has_value) out << " : " << types.to_string(instruction.type);
+        out << "\n";
+    }
+}
+
+void print(const IRModule &module, std::ostream &out) {
+    for (const auto &function : module.functions) {
+        out << (function->is_async ? "async func " : "func ") << function->name << "(";
+        for (size_t i = 0; i < function->parameters.size(); ++i) {
+            out << (i ? ", " : "") << module.types->to_string(function->parameters[i]);
+        }
+        out << ") {\n";
+
+        for (const auto &block : function->blocks) {
+            out << "bb" << block->id << ":";
+            if (!block->predecessors.empty()) {
+                out << "  ; from";
+                for (const BasicBlock *predecessor : block->predecessors) out << " bb" << predecessor->id;
+            }
+            out << "\n";
+            for (const auto &instruction : block->instructions) print_instruction(module, *instruction, out);
+        }
+        out << "}\n";
+    }
+}
@@ -0,0 +1,492 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/ir/IRBuilder.h"
+
+namespace {
+    constexpr const char *ENTRY_NAME = "<script>";
+
+    IROp arithmetic_op(TokenType type) {
+        switch (type) {
+            case TokenType::PLUS:
+            case TokenType::PLUS_EQUAL: return IROp::Add;
+            case TokenType::MINUS:
+            case TokenType::MINUS_EQUAL: return IROp::Sub;
+            case TokenType::STAR:
+            case TokenType::STAR_EQUAL: return IROp::Mul;
+            case TokenType::SLASH:
+            case TokenType::SLASH_EQUAL: return IROp::Div;
+            case TokenType::MODULO:
+            case TokenType::MODULO_EQUAL: // fallthrough
+            default: return IROp::Mod;
+        }
+    }
+
+    TypeId declared_type(const std::string &spelling) {
+        const TypeId type = TypeTable::primitive(spelling);
+        return type == TYPE_ERROR ? TYPE_UNKNOWN : type;
+    }
+}
+
+IRBuilder::IRBuilder(IRModule &module, TypeTable &types) : module(module), types(types) {
+}
+
+IRModule IRBuilder::build(const Program &program, TypeTable &types) {
+    IRModule module;
+    module.types = &types;
+    IRBuilder builder(module, types);
+    builder.build_program(program);
+    return module;
+}
+
+void IRBuilder::build_program(const Program &program) {
+    // Ids are assigned up front so functions can call each other in any order
+    for (const auto &node : program.statements) {
+        if (const auto *declaration = dynamic_cast<const FunctionDeclaration *>(node.get())) {
+            if (function_ids.contains(declaration->name)) continue;
+            function_ids.emplace(declaration->name, static_cast<uint32_t>(declarations.size()));
+            declarations.push_back(declaration);
+        } else if (const auto *variable = dynamic_cast<const VariableDeclaration *>(node.get())) {
+            if (global_ids.contains(variable->name)) continue;
+            global_ids.emplace(variable->name, static_cast<uint32_t>(module.globals.size()));
+            module.globals.push_back(variable->name);
+        }
+    }
+
+    for (size_t i = 0; i <= declarations.size(); ++i) module.functions.push_back(std::make_unique<IRFunction>());
+    for (size_t i = 0; i < declarations.size(); ++i) build_function(*declarations[i], *module.functions[i]);
+
+    module.entry = static_cast<uint32_t>(declarations.size());
+    IRFunction &entry = *module.functions[module.entry];
+    entry.name = ENTRY_NAME;
+    begin_function(entry);
+
+    for (const auto &node : program.statements) {
+        if (const auto *variable = dynamic_cast<const VariableDeclaration *>(node.get())) {
+            IRInstruction *value = variable->initializer ? expression(*variable->initializer) : null_in(current);
+            IRInstruction *store = emit(IROp::SetGlobal, TYPE_VOID, *variable);
+            store->index = global_ids.at(variable->name);
+            store->operands.push_back(value);
+        } else if (dynamic_cast<const Statement *>(node.get())) {
+            statement(*node);
+        }
+    }
+
+    const auto main = function_ids.find("main");
+    if (main != function_ids.end() && declarations[main->second]->parameters.empty() && !terminated()) {
+        // An async main is started like any other coroutine; the run ends once it and its awaits have
+        emit(declarations[main->second]->is_async ? IROp::Async : IROp::Call, TYPE_UNKNOWN, program)->index =
+            main->second;
+    }
+    finish_function(program);
+}
+
+void IRBuilder::begin_function(IRFunction &function) {
+    this->function = &function;
+    locals.clear();
+    variable_types.clear();
+    definitions.clear();
+    sealed.clear();
+    incomplete_phis.clear();
+
+    current = function.add_block();
+    sealed.insert(current);
+}
+
+void IRBuilder::build_function(const FunctionDeclaration &declaration, IRFunction &function) {
+    begin_function(function);
+    function.name = declaration.name;
+    function.is_async = declaration.is_async;
+
+    for (size_t i = 0; i < declaration.parameters.size(); ++i) {
+        const TypeId type = i < declaration.parameter_types.size() ? declared_type(declaration.parameter_types[i])
+                                                                    : TYPE_UNKNOWN;
+        function.parameters.push_back(type);
+
+        IRInstruction *parameter = emit(IROp::Param, type, declaration);
+        parameter->index = static_cast<uint32_t>(i);
+        write(declare(declaration.parameters[i], type), current, parameter);
+    }
+
+    for (const auto &node : declaration.body) statement(*node);
+    finish_function(declaration);
+}
+
+void IRBuilder::finish_function(const ASTNode &at) {
+    if (!terminated()) emit(IROp::Return, TYPE_VOID, at);
+    remove_unreachable_blocks(*function);
+}
+
+// ===== STATEMENTS =====
+
+void IRBuilder::statement(const ASTNode &node) {
+    if (terminated()) {
+        // Code after a return still has to be built, into a block nothing reaches
+        current = function->add_block();
+        sealed.insert(current);
+    }
+
+    if (const auto *variable = dynamic_cast<const VariableDeclaration *>(&node)) {
+        // The initializer cannot see the name it initializes
+        IRInstruction *value = variable->initializer ? expression(*variable->initializer) : null_in(current);
+        const TypeId type = variable->type_name.empty() ? value->type : declared_type(variable->type_name);
+        write(declare(variable->name, type), current, value);
+    } else if (const auto *statement = dynamic_cast<const ExpressionStatement *>(&node)) {
+        expression(*statement->expression);
+    } else if (const auto *ret = dynamic_cast<const ReturnStatement *>(&node)) {
+        IRInstruction *value = ret->expression ? expression(*ret->expression) : nullptr;
+        IRInstruction *instruction = emit(IROp::Return, TYPE_VOID, node);
+        if (value) instruction->operands.push_back(value);
+    } else if (const auto *nested = dynamic_cast<const BlockStatement *>(&node)) {
+        block(nested->statements);
+    } else if (const auto *branch = dynamic_cast<const IfStatement *>(&node)) {
+        if_statement(*branch);
+    } else if (const auto *loop = dynamic_cast<const WhileStatement *>(&node)) {
+        while_statement(*loop);
+    } else {
+        throw CompileError(node, "Statement is not supported by the back end");
+    }
+}
+
+void IRBuilder::block(const std::vector<std::unique_ptr<Statement>> &statements) {
+    const size_t outer = locals.size();
+    for (const auto &statement : statements) this->statement(*statement);
+    locals.resize(outer);
+}
+
+void IRBuilder::if_statement(const IfStatement &branch) {
+    IRInstruction *condition = expression(*branch.condition);
+    BasicBlock *then_block = function->add_block();
+    BasicBlock *else_block = branch.else_branch ? function->add_block() : nullptr;
+    BasicBlock *merge = function->add_block();
+
+    this->branch(condition, then_block, else_block ? else_block : merge, branch);
+    seal(then_block);
+
+    current = then_block;
+    statement(*branch.then_branch);
+    if (!terminated()) jump(merge, branch);
+
+    if (else_block) {
+        seal(else_block);
+        current = else_block;
+        statement(*branch.else_branch);
+        if (!terminated()) jump(merge, branch);
+    }
+
+    seal(merge);
+    current = merge;
+}
+
+void IRBuilder::while_statement(const WhileStatement &loop) {
+    BasicBlock *header = function->add_block();
+    jump(header, loop);
+    current = header; // not sealed until the back edge exists
+
+    IRInstruction *condition = expression(*loop.condition);
+    BasicBlock *body = function->add_block();
+    BasicBlock *exit = function->add_block();
+    branch(condition, body, exit, loop);
+    seal(body);
+
+    current = body;
+    statement(*loop.body);
+    if (!terminated()) jump(header, loop);
+
+    seal(header);
+    seal(exit);
+    current = exit;
+}
+
+// ===== EXPRESSIONS =====
+
+IRInstruction *IRBuilder::expression(const Expression &expression) {
+    if (const auto *literal = dynamic_cast<const LiteralExpression *>(&expression)) {
+        return constant(literal->literal, expression.type, expression);
+    }
+    if (const auto *variable = dynamic_cast<const VariableExpression *>(&expression)) return this->variable(*variable);
+    if (const auto *unary = dynamic_cast<const UnaryExpression *>(&expression)) {
+        IRInstruction *operand = this->expression(*unary->operand);
+        const bool negate = unary->op.type != TokenType::NOT;
+        IRInstruction *instruction = emit(negate ? IROp::Neg : IROp::Not, expression.type, expression);
+        if (negate) instruction->operation = integer_operation(unary->operand->type, unary->operand->type);
+        instruction->operands.push_back(operand);
+        return instruction;
+    }
+    if (const auto *operation = dynamic_cast<const BinaryExpression *>(&expression)) return binary(*operation);
+    if (const auto *store = dynamic_cast<const AssignmentExpression *>(&expression)) return assignment(*store);
+    if (const auto *invocation = dynamic_cast<const CallExpression *>(&expression)) return call(*invocation);
+    if (const auto *task = dynamic_cast<const SpawnExpression *>(&expression)) return spawn(*task);
+    if (const auto *await = dynamic_cast<const AwaitExpression *>(&expression)) return this->await(*await);
+
+    throw CompileError(expression, "Expression is not supported by the back end");
+}
+
+IRInstruction *IRBuilder::variable(const VariableExpression &variable) {
+    if (const Variable *local = find_local(variable.name)) return read(*local, current);
+
+    const auto global = global_ids.find(variable.name);
+    if (global == global_ids.end()) {
+        throw CompileError(variable, "'" + variable.name + "' cannot be used as a value at run time");
+    }
+    IRInstruction *load = emit(IROp::GetGlobal, variable.type, variable);
+    load->index = global->second;
+    return load;
+}
+
+IRInstruction *IRBuilder::binary(const BinaryExpression &binary) {
+    const TokenType type = binary.op.type;
+    if (type == TokenType::AND || type == TokenType::OR) return short_circuit(binary);
+
+    IRInstruction *left = expression(*binary.left);
+    IRInstruction *right = expression(*binary.right);
+
+    // a > b is b < a; both operands have been evaluated in source order already
+    IROp op;
+    bool swap = false;
+    switch (type) {
+        case TokenType::EQUAL_EQUAL: op = IROp::Eq; break;
+        case TokenType::NOT_EQUAL: op = IROp::Ne; break;
+        case TokenType::LESS: op = IROp::Lt; break;
+        case TokenType::LESS_EQUAL: op = IROp::Le; break;
+        case TokenType::GREATER: op = IROp::Lt; swap = true; break;
+        case TokenType::GREATER_EQUAL: op = IROp::Le; swap = true; break;
+        default: op = arithmetic_op(type); break;
+    }
+
+    IRInstruction *instruction = emit(op, binary.type, binary);
+    if (op != IROp::Eq && op != IROp::Ne) {
+        instruction->operation = integer_operation(binary.left->type, binary.right->type);
+    }
+    instruction->operands = swap ? std::vector{right, left} : std::vector{left, right};
+    return instruction;
+}
+
+IRInstruction *IRBuilder::short_circuit(const BinaryExpression &binary) {
+    const bool is_and = binary.op.type == TokenType::AND;
+
+    IRInstruction *left = expression(*binary.left);
+    BasicBlock *left_end = current;
+    BasicBlock *rest = function->add_block();
+    BasicBlock *merge = function->add_block();
+    is_and ? branch(left, rest, merge, binary) : branch(left, merge, rest, binary);
+    seal(rest);
+
+    current = rest;
+    IRInstruction *right = expression(*binary.right);
+    jump(merge, binary);
+    seal(merge);
+    current = merge;
+
+    auto phi = function->make(IROp::Phi, binary.type, binary.line, binary.column);
+    for (const BasicBlock *predecessor : merge->predecessors) phi->operands.push_back(predecessor == left_end ? left : right);
+    return merge->insert(merge->phi_count(), std::move(phi));
+}
+
+IRInstruction *IRBuilder::assignment(const AssignmentExpression &assignment) {
+    const auto &target = static_cast<const VariableExpression &>(*assignment.target);
+    const bool compound = assignment.op.type != TokenType::EQUAL;
+    const Variable *local = find_local(target.name);
+    const auto global = global_ids.find(target.name);
+
+    if (!local && global == global_ids.end()) {
+        throw CompileError(assignment, "'" + target.name + "' cannot be assigned at run time");
+    }
+
+    IRInstruction *value;
+    if (compound) {
+        IRInstruction *old = local ? read(*local, current) : variable(target);
+        IRInstruction *operand = expression(*assignment.value);
+        value = emit(arithmetic_op(assignment.op.type), target.type, assignment);
+        value->operation = integer_operation(target.type, assignment.value->type);
+        value->operands = {old, operand};
+    } else {
+        value = expression(*assignment.value);
+    }
+
+    if (local) {
+        write(*local, current, value);
+    } else {
+        IRInstruction *store = emit(IROp::SetGlobal, TYPE_VOID, assignment);
+        store->index = global->second;
+        store->operands.push_back(value);
+    }
+    return value;
+}
+
+IRInstruction *IRBuilder::call(const CallExpression &call) {
+    const auto *callee = dynamic_cast<const VariableExpression *>(call.callee.get());
+    const bool local = callee && find_local(callee->name);
+    const auto function_id = callee && !local ? function_ids.find(callee->name) : function_ids.end();
+    const bool builtin = callee && !local && function_id == function_ids.end() && !global_ids.contains(callee->name);
+    const std::string name = builtin ? callee->name : "";
+    const bool print = name == "print";
+
+    IROp op = IROp::Call;
+    if (function_id != function_ids.end()) {
+        if (declarations[function_id->second]->is_async) op = IROp::Async;
+    } else if (print) {
+        op = IROp::Print;
+    } else if (name == "join") {
+        op = IROp::Join;
+    } else if (name == "sleep") {
+        op = IROp::Sleep;
+    } else if (name == "readable") {
+        op = IROp::Readable;
+    } else {
+        throw CompileError(call, "Only functions declared in this file can be called at run time");
+    }
+
+    std::vector<IRInstruction *> arguments;
+    for (const auto &argument : call.arguments) arguments.push_back(expression(*argument));
+
+    IRInstruction *instruction = emit(op, print ? TYPE_VOID : call.type, call);
+    instruction->operands = std::move(arguments);
+    if (print) return constant(std::monostate{}, TYPE_NULL, call);
+
+    if (op == IROp::Call || op == IROp::Async) instruction->index = function_id->second;
+    return instruction;
+}
+
+// `await f(...)` of an async function declared here needs no handle: the callee
+// runs like a call and only becomes a coroutine if it suspends
+IRInstruction *IRBuilder::await(const AwaitExpression &await) {
+    if (const auto *call = dynamic_cast<const CallExpression *>(await.operand.get())) {
+        const auto *callee = dynamic_cast<const VariableExpression *>(call->callee.get());
+        const auto function_id = callee && !find_local(callee->name) ? function_ids.find(callee->name)
+                                                                     : function_ids.end();
+        if (function_id != function_ids.end() && declarations[function_id->second]->is_async) {
+            std::vector<IRInstruction *> arguments;
+            for (const auto &argument : call->arguments) arguments.push_back(expression(*argument));
+
+            IRInstruction *instruction = emit(IROp::AwaitCall, await.type, await);
+            instruction->operands = std::move(arguments);
+            instruction->index = function_id->second;
+            return instruction;
+        }
+    }
+
+    IRInstruction *operand = expression(*await.operand);
+    IRInstruction *instruction = emit(IROp::Await, await.type, await);
+    instruction->operands.push_back(operand);
+    return instruction;
+}
+
+IRInstruction *IRBuilder::spawn(const SpawnExpression &spawn) {
+    const CallExpression &call = *spawn.call;
+    const auto *callee = dynamic_cast<const VariableExpression *>(call.callee.get());
+    const auto function_id = callee && !find_local(callee->name) ? function_ids.find(callee->name) : function_ids.end();
+    if (function_id == function_ids.end()) {
+        throw CompileError(spawn, "Only functions declared in this file can be started as tasks");
+    }
+
+    std::vector<IRInstruction *> arguments;
+    for (const auto &argument : call.arguments) arguments.push_back(expression(*argument));
+
+    IRInstruction *instruction = emit(spawn.kind == TokenType::SPAWN ? IROp::Spawn : IROp::Thread, spawn.type, spawn);
+    instruction->operands = std::move(arguments);
+    instruction->index = function_id->second;
+    return instruction;
+}
+
+// ===== SSA CONSTRUCTION =====
+
+IRBuilder::Variable IRBuilder::declare(const std::string &name, TypeId type) {
+    const auto variable = static_cast<Variable>(variable_types.size());
+    variable_types.push_back(type);
+    definitions.emplace_back();
+    locals.emplace_back(name, variable);
+    return variable;
+}
+
+const IRBuilder::Variable *IRBuilder::find_local(const std::string &name) const {
+    for (auto it = locals.rbegin(); it != locals.rend(); ++it) {
+        if (it->first == name) return &it->second;
+    }
+    return nullptr;
+}
+
+void IRBuilder::write(Variable variable, BasicBlock *block, IRInstruction *value) {
+    definitions[variable][block] = value;
+}
+
+IRInstruction *IRBuilder::read(Variable variable, BasicBlock *block) {
+    const auto it = definitions[variable].find(block);
+    return it != definitions[variable].end() ? it->second : read_recursive(variable, block);
+}
+
+IRInstruction *IRBuilder::read_recursive(Variable variable, BasicBlock *block) {
+    IRInstruction *value;
+    if (!sealed.contains(block)) {
+        auto phi = function->make(IROp::Phi, variable_types[variable], 0, 0);
+        value = block->insert(block->phi_count(), std::move(phi));
+        incomplete_phis[block].emplace_back(variable, value);
+    } else if (block->predecessors.empty()) {
+        value = null_in(block); // only in code nothing reaches
+    } else if (block->predecessors.size() == 1) {
+        value = read(variable, block->predecessors.front());
+    } else {
+        // Recorded before the operands are read, so a cycle through this block ends here
+        auto phi = function->make(IROp::Phi, variable_types[variable], 0, 0);
+        value = block->insert(block->phi_count(), std::move(phi));
+        write(variable, block, value);
+        value = add_phi_operands(variable, value);
+    }
+
+    write(variable, block, value);
+    return value;
+}
+
+IRInstruction *IRBuilder::add_phi_operands(Variable variable, IRInstruction *phi) {
+    for (BasicBlock *predecessor : phi->block->predecessors) phi->operands.push_back(read(variable, predecessor));
+    return phi;
+}
+
+void IRBuilder::seal(BasicBlock *block) {
+    if (!sealed.insert(block).second) return;
+
+    const auto it = incomplete_phis.find(block);
+    if (it == incomplete_phis.end()) return;
+    for (const auto &[variable, phi] : it->second) add_phi_operands(variable, phi);
+    incomplete_phis.erase(it);
+}
+
+// ===== EMISSION =====
+
+IRInstruction *IRBuilder::emit(IROp op, TypeId type, const ASTNode &at) {
+    return current->append(function->make(op, type, at.line, at.column));
+}
+
+IRInstruction *IRBuilder::constant(Literal value, TypeId type, const ASTNode &at) {
+    IRInstruction *instruction = emit(IROp::Const, type, at);
+    instruction->constant = std::move(value);
+    return instruction;
+}
+
+IRInstruction *IRBuilder::null_in(BasicBlock *block) {
+    auto instruction = function->make(IROp::Const, TYPE_NULL, 0, 0);
+    return block->insert(block->phi_count(), std::move(instruction));
+}
+
+void IRBuilder::jump(BasicBlock *target, const ASTNode &at) {
+    emit(IROp::Jump, TYPE_VOID, at);
+    add_edge(current, target);
+}
+
+void IRBuilder::branch(IRInstruction *condition, BasicBlock *taken, BasicBlock *not_taken, const ASTNode &at) {
+    emit(IROp::Branch, TYPE_VOID, at)->operands.push_back(condition);
+    add_edge(current, taken);
+    add_edge(current, not_taken);
+}
+
+bool IRBuilder::terminated() const {
+    return current->terminator() != nullptr;
+}
+
+// The integer type a typed instruction can use when the checker typed both operands as integers
+TypeId IRBuilder::integer_operation(TypeId left, TypeId right) {
+    if (!types.is_integer(left) || !types.is_integer(right)) return TYPE_UNKNOWN;
+    const TypeId common = types.unify(left, right);
+    return types.is_integer(common) ? common : TYPE_UNKNOWN;
+}
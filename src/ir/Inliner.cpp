@@ -0,0 +1,198 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/ir/Inliner.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+    // Instructions an inlined copy adds; parameters become the arguments and constants are usually shared
+    size_t cost(const IRFunction &function) {
+        size_t count = 0;
+        for (const auto &block : function.blocks) {
+            count += std::ranges::count_if(block->instructions, [](const auto &instruction) {
+                return instruction->op != IROp::Param && instruction->op != IROp::Const;
+            });
+        }
+        return count;
+    }
+
+    bool is_recursive(const IRFunction &function, uint32_t id) {
+        for (const auto &block : function.blocks) {
+            for (const auto &instruction : block->instructions) {
+                if (instruction->op == IROp::Call && instruction->index == id) return true;
+            }
+        }
+        return false;
+    }
+
+    void collect_calls(const IRFunction &function, std::vector<IRInstruction *> &calls) {
+        for (const auto &block : function.blocks) {
+            for (const auto &instruction : block->instructions) {
+                if (instruction->op == IROp::Call) calls.push_back(instruction.get());
+            }
+        }
+    }
+
+    // Callees before their callers; a cycle is broken where the walk first meets it
+    std::vector<uint32_t> bottom_up(const IRModule &module) {
+        std::vector<uint32_t> order;
+        std::vector<bool> visited(module.functions.size());
+
+        for (uint32_t root = 0; root < module.functions.size(); ++root) {
+            if (visited[root]) continue;
+            visited[root] = true;
+
+            std::vector<std::pair<uint32_t, std::vector<IRInstruction *>>> stack;
+            stack.emplace_back(root, std::vector<IRInstruction *>{});
+            collect_calls(*module.functions[root], stack.back().second);
+
+            while (!stack.empty()) {
+                auto &[id, calls] = stack.back();
+                if (calls.empty()) {
+                    order.push_back(id);
+                    stack.pop_back();
+                    continue;
+                }
+
+                const uint32_t callee = calls.back()->index;
+                calls.pop_back();
+                if (visited[callee]) continue;
+                visited[callee] = true;
+                std::vector<IRInstruction *> callee_calls;
+                collect_calls(*module.functions[callee], callee_calls);
+                stack.emplace_back(callee, std::move(callee_calls));
+            }
+        }
+        return order;
+    }
+}
+
+bool Inliner::run(IRModule &module, PassStatistics &statistics) {
+    const size_t count = module.functions.size();
+    std::vector<size_t> costs(count), call_sites(count);
+    std::vector<bool> inlinable(count);
+
+    for (uint32_t id = 0; id < count; ++id) {
+        costs[id] = cost(*module.functions[id]);
+        inlinable[id] = !is_recursive(*module.functions[id], id);
+        std::vector<IRInstruction *> calls;
+        collect_calls(*module.functions[id], calls);
+        for (const IRInstruction *call : calls) ++call_sites[call->index];
+    }
+
+    bool changed = false;
+    for (const uint32_t id : bottom_up(module)) {
+        IRFunction &caller = *module.functions[id];
+        std::vector<IRInstruction *> calls;
+        collect_calls(caller, calls);
+
+        bool grew = false;
+        for (IRInstruction *call : calls) {
+            const uint32_t callee = call->index;
+            if (callee == id || !inlinable[callee]) continue;
+
+            const auto constants = std::ranges::count_if(call->operands, &IRInstruction::is_constant);
+            size_t budget = CALLEE_BUDGET + CONSTANT_ARGUMENT_BONUS * static_cast<size_t>(constants);
+            if (call_sites[callee] == 1) budget *= 2;
+            if (costs[callee] > budget || caller.instruction_count() + costs[callee] > GROWTH_LIMIT) continue;
+
+            inline_call(caller, call, *module.functions[callee]);
+            statistics.add("inlined");
+            grew = true;
+        }
+
+        if (grew) {
+            costs[id] = cost(caller);
+            inlinable[id] = !is_recursive(caller, id);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void Inliner::inline_call(IRFunction &caller, IRInstruction *call, const IRFunction &callee) {
+    BasicBlock *block = call->block;
+    const auto position = static_cast<size_t>(
+        std::ranges::find_if(block->instructions, [&](const auto &i) { return i.get() == call; }) -
+        block->instructions.begin());
+
+    // What follows the call moves to a block of its own that the inlined returns jump to
+    BasicBlock *rest = caller.add_block();
+    for (size_t i = position + 1; i < block->instructions.size(); ++i) {
+        block->instructions[i]->block = rest;
+        rest->instructions.push_back(std::move(block->instructions[i]));
+    }
+    block->instructions.resize(position + 1);
+    rest->successors = std::move(block->successors);
+    block->successors.clear();
+    for (BasicBlock *successor : rest->successors) replace_predecessor(successor, block, rest);
+
+    // Copy the callee with its parameters replaced by the arguments; operands are remapped once everything exists
+    std::unordered_map<const BasicBlock *, BasicBlock *> blocks;
+    std::unordered_map<const IRInstruction *, IRInstruction *> values;
+    for (const auto &original : callee.blocks) blocks.emplace(original.get(), caller.add_block());
+
+    for (const auto &original : callee.blocks) {
+        BasicBlock *copy = blocks.at(original.get());
+        for (const auto &instruction : original->instructions) {
+            if (instruction->op == IROp::Param) {
+                values.emplace(instruction.get(), call->operands[instruction->index]);
+                continue;
+            }
+            auto clone = caller.make(instruction->op, instruction->type, instruction->line, instruction->column);
+            clone->operation = instruction->operation;
+            clone->constant = instruction->constant;
+            clone->index = instruction->index;
+            clone->origin = instruction->origin ? instruction->origin : &callee;
+            clone->operands = instruction->operands;
+            values.emplace(instruction.get(), copy->append(std::move(clone)));
+        }
+    }
+
+    for (const auto &original : callee.blocks) {
+        BasicBlock *copy = blocks.at(original.get());
+        for (const BasicBlock *predecessor : original->predecessors) copy->predecessors.push_back(blocks.at(predecessor));
+        for (const BasicBlock *successor : original->successors) copy->successors.push_back(blocks.at(successor));
+        for (const auto &instruction : copy->instructions) {
+            for (IRInstruction *&operand : instruction->operands) operand = values.at(operand);
+        }
+    }
+
+    // Each return becomes a jump to `rest`, in predecessor order, and what it returns an operand of the result
+    std::vector<IRInstruction *> results;
+    for (const auto &original : callee.blocks) {
+        BasicBlock *copy = blocks.at(original.get());
+        IRInstruction *terminator = copy->terminator();
+        if (terminator->op != IROp::Return) continue;
+
+        IRInstruction *value = terminator->operands.empty()
+                                   ? copy->append(caller.make(IROp::Const, TYPE_NULL, terminator->line,
+                                                              terminator->column))
+                                   : terminator->operands[0];
+        terminator->op = IROp::Jump;
+        terminator->type = TYPE_VOID;
+        terminator->operands.clear();
+        add_edge(copy, rest);
+        results.push_back(value);
+    }
+
+    IRInstruction *result;
+    if (results.size() == 1) {
+        result = results[0];
+    } else {
+        // No result at all means the callee never returns, and `rest` is unreachable
+        auto merge = caller.make(results.empty() ? IROp::Const : IROp::Phi, results.empty() ? TYPE_NULL : call->type,
+                                 call->line, call->column);
+        merge->operands = results;
+        result = rest->insert(0, std::move(merge));
+    }
+
+    auto jump = caller.make(IROp::Jump, TYPE_VOID, call->line, call->column);
+    replace_uses(caller, {{call, result}});
+    block->instructions.pop_back(); // the call
+    block->append(std::move(jump));
+    add_edge(block, blocks.at(callee.blocks.front().get()));
+}
@@ -0,0 +1,155 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/ir/LoopInvariantCodeMotion.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+    bool is_hoistable(const IRInstruction &instruction, bool globals_stable) {
+        switch (instruction.op) {
+            case IROp::Const:
+                return true;
+            case IROp::GetGlobal:
+                return globals_stable;
+            case IROp::Add:
+            case IROp::Sub:
+            case IROp::Mul:
+            case IROp::Div:
+            case IROp::Mod:
+            case IROp::Neg:
+            case IROp::Not:
+            case IROp::Eq:
+            case IROp::Ne:
+            case IROp::Lt:
+            case IROp::Le:
+                return !instruction.may_trap();
+            default:
+                return false;
+        }
+    }
+}
+
+bool LoopInvariantCodeMotion::run(IRModule &module, PassStatistics &statistics) {
+    bool changed = false;
+    for (const auto &function : module.functions) changed = run(*function, statistics) || changed;
+    return changed;
+}
+
+bool LoopInvariantCodeMotion::run(IRFunction &function, PassStatistics &statistics) {
+    std::vector<Loop> loops;
+    {
+        const DominatorTree dominators(function);
+        loops = find_loops(dominators);
+    }
+
+    bool changed = false;
+    for (Loop &loop : loops) {
+        BasicBlock *target = preheader(function, loop, loops, statistics);
+        if (!target) continue;
+
+        const std::unordered_set<const BasicBlock *> members(loop.blocks.begin(), loop.blocks.end());
+        const bool globals_stable = std::ranges::none_of(loop.blocks, [](const BasicBlock *block) {
+            return std::ranges::any_of(block->instructions, [](const auto &instruction) {
+                // Tasks may store to globals, and joining one makes its stores visible; so
+                // may coroutines, which any await can let run
+                return instruction->op == IROp::SetGlobal || instruction->op == IROp::Call ||
+                       instruction->op == IROp::Spawn || instruction->op == IROp::Thread ||
+                       instruction->op == IROp::Join || instruction->op == IROp::Async ||
+                       instruction->op == IROp::AwaitCall || instruction->op == IROp::Await;
+            });
+        });
+
+        // Blocks are in reverse postorder, so apart from phis every operand is seen before its uses
+        std::unordered_set<const IRInstruction *> invariant;
+        std::vector<std::unique_ptr<IRInstruction>> hoisted;
+        for (BasicBlock *block : loop.blocks) {
+            for (auto &instruction : block->instructions) {
+                if (!is_hoistable(*instruction, globals_stable)) continue;
+                const bool operands_invariant = std::ranges::all_of(instruction->operands, [&](const auto *operand) {
+                    return !members.contains(operand->block) || invariant.contains(operand);
+                });
+                if (!operands_invariant) continue;
+
+                invariant.insert(instruction.get());
+                hoisted.push_back(std::move(instruction));
+            }
+            std::erase(block->instructions, nullptr);
+        }
+
+        for (auto &instruction : hoisted) target->append(std::move(instruction));
+        if (!hoisted.empty()) {
+            statistics.add("hoisted", hoisted.size());
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// The block every entry into the loop comes through, inserted if needed; null if the header is the function entry
+BasicBlock *LoopInvariantCodeMotion::preheader(IRFunction &function, Loop &loop, std::vector<Loop> &loops,
+                                               PassStatistics &statistics) {
+    BasicBlock *header = loop.header;
+    if (header == function.blocks.front().get()) return nullptr;
+
+    const std::unordered_set<const BasicBlock *> members(loop.blocks.begin(), loop.blocks.end());
+    std::vector<size_t> outside;
+    for (size_t i = 0; i < header->predecessors.size(); ++i) {
+        if (!members.contains(header->predecessors[i])) outside.push_back(i);
+    }
+    if (outside.size() == 1 && header->predecessors[outside[0]]->successors.size() == 1) {
+        return header->predecessors[outside[0]];
+    }
+
+    const IRInstruction &first = *header->instructions.front();
+    BasicBlock *block = function.add_block();
+
+    // Header phis keep their operands from inside the loop and take the rest from a phi in the preheader
+    const size_t phis = header->phi_count();
+    for (size_t p = 0; p < phis; ++p) {
+        IRInstruction &phi = *header->instructions[p];
+        std::vector<IRInstruction *> entering;
+        for (const size_t i : outside) entering.push_back(phi.operands[i]);
+
+        IRInstruction *value = entering[0];
+        if (std::ranges::any_of(entering, [&](const IRInstruction *operand) { return operand != value; })) {
+            auto merge = function.make(IROp::Phi, phi.type, phi.line, phi.column);
+            merge->operands = std::move(entering);
+            value = block->append(std::move(merge));
+        }
+
+        std::vector<IRInstruction *> operands;
+        for (size_t i = 0; i < phi.operands.size(); ++i) {
+            if (members.contains(header->predecessors[i])) operands.push_back(phi.operands[i]);
+        }
+        operands.push_back(value);
+        phi.operands = std::move(operands);
+    }
+
+    std::vector<BasicBlock *> predecessors;
+    for (size_t i = 0; i < header->predecessors.size(); ++i) {
+        BasicBlock *predecessor = header->predecessors[i];
+        if (members.contains(predecessor)) {
+            predecessors.push_back(predecessor);
+            continue;
+        }
+        block->predecessors.push_back(predecessor);
+        *std::ranges::find(predecessor->successors, header) = block;
+    }
+    predecessors.push_back(block);
+    header->predecessors = std::move(predecessors);
+    block->successors.push_back(header);
+    block->append(function.make(IROp::Jump, TYPE_VOID, first.line, first.column));
+
+    // Enclosing loops contain the preheader too, so what is hoisted into it can keep climbing
+    for (Loop &other : loops) {
+        if (&other == &loop) continue;
+        const auto at = std::ranges::find(other.blocks, header);
+        if (at != other.blocks.end()) other.blocks.insert(at, block);
+    }
+
+    statistics.add("preheaders");
+    return block;
+}
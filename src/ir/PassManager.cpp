@@ -0,0 +1,93 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/ir/PassManager.h"
+
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+
+#include "../../include/ir/CommonSubexpressionElimination.h"
+#include "../../include/ir/ConstantFolding.h"
+#include "../../include/ir/DeadCodeElimination.h"
+#include "../../include/ir/EscapeAnalysis.h"
+#include "../../include/ir/Inliner.h"
+#include "../../include/ir/LoopInvariantCodeMotion.h"
+#include "../../include/util/Trace.h"
+
+namespace {
+    size_t instruction_count(const IRModule &module) {
+        size_t count = 0;
+        for (const auto &function : module.functions) count += function->instruction_count();
+        return count;
+    }
+}
+
+void PassStatistics::add(const std::string &name, uint64_t amount) {
+    for (auto &[counter, value] : counters) {
+        if (counter == name) {
+            value += amount;
+            return;
+        }
+    }
+    counters.emplace_back(name, amount);
+}
+
+PassManager PassManager::standard() {
+    PassManager manager;
+    // Escape analysis first, so the tasks it turns into calls can still be inlined
+    manager.add(std::make_unique<EscapeAnalysis>());
+    // Inlining then exposes constant arguments and redundancy across call boundaries to the rest
+    manager.add(std::make_unique<Inliner>());
+    manager.add(std::make_unique<ConstantFolding>());
+    manager.add(std::make_unique<CommonSubexpressionElimination>());
+    manager.add(std::make_unique<LoopInvariantCodeMotion>());
+    manager.add(std::make_unique<DeadCodeElimination>());
+    return manager;
+}
+
+void PassManager::add(std::unique_ptr<Pass> pass) {
+    passes.push_back(std::move(pass));
+    records.emplace_back();
+}
+
+void PassManager::run(IRModule &module) {
+    for (size_t i = 0; i < passes.size(); ++i) {
+        Pass &pass = *passes[i];
+        Record &record = records[i];
+        TraceScope trace("pass", pass.name());
+
+        record.before = instruction_count(module);
+        const auto start = std::chrono::steady_clock::now();
+        record.changed = pass.run(module, record.statistics) || record.changed;
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        record.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        record.after = instruction_count(module);
+
+#ifndef NDEBUG
+        if (const std::string problem = verify(module); !problem.empty()) {
+            throw std::logic_error(std::string("IR is malformed after pass '") + pass.name() + "': " + problem);
+        }
+#endif
+    }
+}
+
+void PassManager::report(std::ostream &out) const {
+    out << "Pass statistics:\n";
+    uint64_t total = 0;
+
+    for (size_t i = 0; i < passes.size(); ++i) {
+        const Record &record = records[i];
+        total += record.nanoseconds;
+
+        out << "  " << std::left << std::setw(34) << passes[i]->name() << std::right << std::fixed
+            << std::setprecision(3) << std::setw(9) << static_cast<double>(record.nanoseconds) / 1e6 << " ms  "
+            << std::setw(6) << record.before << " -> " << std::setw(6) << std::left << record.after << std::right;
+        for (const auto &[counter, value] : record.statistics.counters) out << "  " << counter << " " << value;
+        out << "\n";
+    }
+
+    out << "  " << std::left << std::setw(34) << "total" << std::right << std::setw(9)
+        << static_cast<double>(total) / 1e6 << " ms\n";
+}
@@ -0,0 +1,40 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/jit/ExecutableMemory.h"
+
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define SPARKC_HAS_MMAP 1
+#endif
+
+ExecutableMemory::~ExecutableMemory() {
+#ifdef SPARKC_HAS_MMAP
+    for (const auto &[address, size] : regions) munmap(address, size);
+#endif
+}
+
+const void *ExecutableMemory::install(const std::vector<uint8_t> &code) {
+#ifdef SPARKC_HAS_MMAP
+    const auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t size = (code.size() + page - 1) / page * page;
+
+    void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED) return nullptr;
+
+    std::memcpy(address, code.data(), code.size());
+    if (mprotect(address, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(address, size);
+        return nullptr;
+    }
+    regions.emplace_back(address, size);
+    return address;
+#else
+    (void) code;
+    return nullptr;
+#endif
+}
@@ -0,0 +1,539 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/jit/JitCompiler.h"
+
+#include <algorithm>
+#include <optional>
+
+#include "../../include/jit/X64Assembler.h"
+
+namespace {
+    // Fixed registers of native code: rax caches a VM register and rcx holds a
+    // second operand, while rdx is scratch for guards and division
+    constexpr Reg REGISTERS = Reg::RBX; // R
+    constexpr Reg GLOBALS = Reg::R12;
+    constexpr Reg BOOL_BITS = Reg::R13;
+    constexpr Reg INT_BITS = Reg::R14;
+    constexpr Reg PAYLOAD = Reg::R15;
+
+    // The tags in the top 16 bits, and the 13 bits every non-double has set
+    const uint32_t INT_TAG = static_cast<uint32_t>(Value::small_integer(0).raw() >> 48);
+    const uint32_t BOOL_TAG = static_cast<uint32_t>(Value::boolean(false).raw() >> 48);
+    const uint32_t OBJECT_TAG = static_cast<uint32_t>(Value::object(nullptr).raw() >> 48);
+    constexpr uint32_t BOXED_TAG = 0x1fff;
+    constexpr uint64_t SIGN_BIT = uint64_t{1} << 63;
+
+    // What is known about the value in rax
+    enum class Known : uint8_t { Nothing, SmallInt, Bool };
+
+    Known known_kind(const Value &value) {
+        if (value.is_small_int()) return Known::SmallInt;
+        if (value.is_bool()) return Known::Bool;
+        return Known::Nothing;
+    }
+
+    int32_t slot(uint8_t reg) { return static_cast<int32_t>(reg) * static_cast<int32_t>(sizeof(Value)); }
+
+    class Emitter {
+    public:
+        explicit Emitter(const BytecodeFunction &function) : function(function) {}
+
+        std::vector<uint8_t> emit();
+
+    private:
+        void instruction(uint32_t index, uint32_t word);
+        void arithmetic(OpCode op, uint32_t index, uint32_t word);
+        void typed_arithmetic(OpCode op, unsigned width, uint32_t index, uint32_t word);
+        void comparison(OpCode op, uint32_t index, uint32_t word);
+
+        // rax = R[reg], or `dst` = R[reg] for other registers
+        void load(Reg dst, uint8_t reg);
+        void store(uint8_t reg, Known kind);
+        [[nodiscard]] Known known(uint8_t reg) const { return cached == reg ? kind : Known::Nothing; }
+        void forget() { cached = -1; }
+
+        Label deopt(uint32_t index);
+        void jump_unless_tag(Reg reg, uint32_t tag, Label target);
+        void jump_unless_double(Reg reg, Label target);
+        void guard_small_int(Reg reg, Known known, uint32_t index);
+        void unbox(Reg reg);
+        void box(Reg reg);
+        void check_fits(Reg reg, uint32_t index); // deoptimizes when it would need boxing
+        void wrap(Reg reg, unsigned width);
+        void bool_result();
+        void exit(uint32_t index);
+
+        const BytecodeFunction &function;
+        X64Assembler as;
+        std::vector<Label> starts; // of each instruction
+        std::vector<bool> entries;
+        std::vector<std::optional<Label>> deopts;
+        Label epilogue{};
+        int cached = -1; // VM register in rax
+        Known kind = Known::Nothing;
+    };
+
+    // The most instructions native code can run from each index before it
+    // exits, ignoring guards; UINT32_MAX where it can reach a loop
+    std::vector<uint32_t> native_spans(const std::vector<uint32_t> &code) {
+        std::vector<uint32_t> spans(code.size() + 1, 0);
+        auto through = [&](size_t from, int offset) {
+            return offset < 0 ? UINT32_MAX : spans[from + 1 + offset];
+        };
+
+        for (size_t i = code.size(); i-- > 0;) {
+            uint32_t next;
+            switch (Instruction::op(code[i])) {
+                case OpCode::CALL:
+                case OpCode::PRINT:
+                case OpCode::RETURN:
+                case OpCode::RETURNNULL:
+                case OpCode::USTR:
+                case OpCode::SPAWN:
+                case OpCode::THREAD:
+                case OpCode::JOIN:
+                case OpCode::ASYNC:
+                case OpCode::AWAITCALL:
+                case OpCode::AWAIT:
+                case OpCode::SLEEP:
+                case OpCode::READABLE:
+                    continue; // exits before running anything
+                case OpCode::JMP:
+                    next = through(i, Instruction::sbx(code[i]));
+                    break;
+                case OpCode::JMPIF:
+                case OpCode::JMPIFNOT:
+                    next = std::max(spans[i + 1], through(i, Instruction::sbx(code[i])));
+                    break;
+                default:
+                    next = spans[i + 1];
+                    break;
+            }
+            spans[i] = next == UINT32_MAX ? next : next + 1;
+        }
+        spans.pop_back();
+        return spans;
+    }
+
+    // Typed opcodes come in groups of six per width: I8, I16, I32, I64, U8, U16, U32, U64
+    bool is_signed(unsigned width) { return width < 4; }
+    bool is_wide(unsigned width) { return width == 3 || width == 7; }
+}
+
+std::vector<uint8_t> Emitter::emit() {
+    const std::vector<uint32_t> &code = function.code;
+    entries.assign(code.size(), false);
+    deopts.assign(code.size(), std::nullopt);
+    entries[0] = true;
+    for (size_t i = 0; i < code.size(); ++i) {
+        switch (Instruction::op(code[i])) {
+            case OpCode::JMP:
+            case OpCode::JMPIF:
+            case OpCode::JMPIFNOT:
+                entries[i + 1 + Instruction::sbx(code[i])] = true;
+                break;
+            case OpCode::CALL:
+            case OpCode::AWAIT: // where a coroutine resumes
+                if (i + 1 < code.size()) entries[i + 1] = true;
+                break;
+            default:
+                break;
+        }
+    }
+    for (size_t i = 0; i < code.size(); ++i) starts.push_back(as.new_label());
+    epilogue = as.new_label();
+    const Label table = as.new_label();
+
+    for (const Reg reg : {Reg::RBX, Reg::R12, Reg::R13, Reg::R14, Reg::R15}) as.push(reg);
+    as.mov(REGISTERS, Reg::RDI);
+    as.mov(GLOBALS, Reg::RSI);
+    as.mov(BOOL_BITS, Value::boolean(false).raw());
+    as.mov(INT_BITS, Value::small_integer(0).raw());
+    as.mov(PAYLOAD, (uint64_t{1} << Value::SMALL_INT_BITS) - 1);
+    as.mov32(Reg::RAX, Reg::RDX);
+    as.lea(Reg::RCX, table);
+    as.movsxd_indexed(Reg::RDX, Reg::RCX, Reg::RAX);
+    as.add(Reg::RDX, Reg::RCX);
+    as.jmp(Reg::RDX);
+
+    for (uint32_t i = 0; i < code.size(); ++i) {
+        as.bind(starts[i]);
+        if (entries[i]) forget();
+        instruction(i, code[i]);
+    }
+
+    for (uint32_t i = 0; i < code.size(); ++i) {
+        if (!deopts[i]) continue;
+        as.bind(*deopts[i]);
+        as.mov(Reg::RAX, uint64_t{i | JitCompiler::DEOPT});
+        as.jmp(epilogue);
+    }
+
+    as.bind(epilogue);
+    for (const Reg reg : {Reg::R15, Reg::R14, Reg::R13, Reg::R12, Reg::RBX}) as.pop(reg);
+    as.ret();
+
+    as.align(4);
+    as.bind(table);
+    for (uint32_t i = 0; i < code.size(); ++i) {
+        // Entering anywhere else hands the index straight back, so the interpreter carries on there
+        const Label target = entries[i] ? starts[i] : epilogue;
+        as.emit32(static_cast<uint32_t>(static_cast<int32_t>(as.offset(target)) - static_cast<int32_t>(as.offset(table))));
+    }
+    return as.finish();
+}
+
+void Emitter::instruction(uint32_t index, uint32_t word) {
+    const OpCode op = Instruction::op(word);
+    const uint8_t a = Instruction::a(word), b = Instruction::b(word);
+
+    switch (op) {
+        case OpCode::MOVE: {
+            const Known k = known(b);
+            load(Reg::RAX, b);
+            store(a, k);
+            return;
+        }
+        case OpCode::LOADK: {
+            const Value &constant = function.constants[Instruction::bx(word)];
+            as.mov(Reg::RAX, constant.raw());
+            store(a, known_kind(constant));
+            return;
+        }
+        case OpCode::LOADI:
+            as.mov(Reg::RAX, Value::small_integer(Instruction::sbx(word)).raw());
+            store(a, Known::SmallInt);
+            return;
+        case OpCode::LOADBOOL:
+            as.mov(Reg::RAX, Value::boolean(b != 0).raw());
+            store(a, Known::Bool);
+            return;
+        case OpCode::LOADNULL:
+            as.mov(Reg::RAX, Value::null().raw());
+            store(a, Known::Nothing);
+            return;
+        case OpCode::GETGLOBAL:
+            as.load(Reg::RAX, GLOBALS, static_cast<int32_t>(Instruction::bx(word) * sizeof(Value)));
+            store(a, Known::Nothing);
+            return;
+        case OpCode::SETGLOBAL: {
+            const Known k = known(a);
+            load(Reg::RAX, a);
+            if (k == Known::Nothing) {
+                // Objects have to be shared before other threads can see them, which the interpreter does
+                as.mov(Reg::RDX, Reg::RAX);
+                as.shr(Reg::RDX, 48);
+                as.cmp32(Reg::RDX, static_cast<int32_t>(OBJECT_TAG));
+                as.jcc(Cond::E, deopt(index));
+            }
+            as.store(GLOBALS, static_cast<int32_t>(Instruction::bx(word) * sizeof(Value)), Reg::RAX);
+            return;
+        }
+        case OpCode::ADD:
+        case OpCode::SUB:
+        case OpCode::MUL:
+        case OpCode::DIV:
+        case OpCode::MOD:
+        case OpCode::NEG:
+            arithmetic(op, index, word);
+            return;
+        case OpCode::EQ:
+        case OpCode::NE:
+        case OpCode::LT:
+        case OpCode::LE:
+        case OpCode::LTU:
+        case OpCode::LEU:
+            comparison(op, index, word);
+            return;
+        case OpCode::NOT: {
+            const Known k = known(b);
+            load(Reg::RAX, b);
+            if (k != Known::Bool) jump_unless_tag(Reg::RAX, BOOL_TAG, deopt(index));
+            as.xor_(Reg::RAX, 1);
+            store(a, Known::Bool);
+            return;
+        }
+        case OpCode::JMP:
+            as.jmp(starts[index + 1 + Instruction::sbx(word)]);
+            forget();
+            return;
+        case OpCode::JMPIF:
+        case OpCode::JMPIFNOT: {
+            const Known k = known(a);
+            load(Reg::RAX, a);
+            if (k != Known::Bool) jump_unless_tag(Reg::RAX, BOOL_TAG, deopt(index));
+            kind = Known::Bool;
+            as.test8(Reg::RAX, 1);
+            as.jcc(op == OpCode::JMPIF ? Cond::NE : Cond::E, starts[index + 1 + Instruction::sbx(word)]);
+            return;
+        }
+        default:
+            break;
+    }
+
+    if (op >= OpCode::ADD_I8) {
+        static constexpr OpCode GENERIC[] = {OpCode::ADD, OpCode::SUB, OpCode::MUL,
+                                             OpCode::DIV, OpCode::MOD, OpCode::NEG};
+        const auto typed = static_cast<unsigned>(op) - static_cast<unsigned>(OpCode::ADD_I8);
+        typed_arithmetic(GENERIC[typed % 6], typed / 6, index, word);
+        return;
+    }
+
+    exit(index); // CALL, PRINT, RETURN, RETURNNULL, USTR and the task and coroutine instructions
+}
+
+// Generic arithmetic: inline integers as i64 and doubles; mixed operands,
+// strings, boxed integers and results that need boxing deoptimize
+void Emitter::arithmetic(OpCode op, uint32_t index, uint32_t word) {
+    const uint8_t a = Instruction::a(word), b = Instruction::b(word);
+    const uint8_t c = op == OpCode::NEG ? b : Instruction::c(word);
+    const bool integers = known(b) == Known::SmallInt && known(c) == Known::SmallInt;
+    const Label doubles = op == OpCode::MOD ? deopt(index) : as.new_label(), done = as.new_label();
+
+    if (op != OpCode::NEG) load(Reg::RCX, c);
+    load(Reg::RAX, b);
+    if (!integers) {
+        jump_unless_tag(Reg::RAX, INT_TAG, doubles);
+        if (op != OpCode::NEG) jump_unless_tag(Reg::RCX, INT_TAG, doubles);
+    }
+
+    unbox(Reg::RAX);
+    if (op != OpCode::NEG) unbox(Reg::RCX);
+    switch (op) {
+        case OpCode::ADD: as.add(Reg::RAX, Reg::RCX); break;
+        case OpCode::SUB: as.sub(Reg::RAX, Reg::RCX); break;
+        case OpCode::MUL: as.imul(Reg::RAX, Reg::RCX); break;
+        case OpCode::NEG: as.neg(Reg::RAX); break;
+        default:
+            // Zero and -1 divisors take the interpreter's checks
+            as.test(Reg::RCX, Reg::RCX);
+            as.jcc(Cond::LE, deopt(index));
+            as.cqo();
+            as.idiv(Reg::RCX);
+            if (op == OpCode::MOD) as.mov(Reg::RAX, Reg::RDX);
+            break;
+    }
+    if (op != OpCode::DIV && op != OpCode::MOD) check_fits(Reg::RAX, index);
+    box(Reg::RAX);
+
+    if (!integers && op != OpCode::MOD) {
+        as.jmp(done);
+        as.bind(doubles);
+        jump_unless_double(Reg::RAX, deopt(index));
+        if (op == OpCode::NEG) {
+            as.mov(Reg::RCX, SIGN_BIT);
+            as.xor_(Reg::RAX, Reg::RCX);
+            as.movq_to_xmm(0, Reg::RAX);
+        } else {
+            jump_unless_double(Reg::RCX, deopt(index));
+            as.movq_to_xmm(0, Reg::RAX);
+            as.movq_to_xmm(1, Reg::RCX);
+            switch (op) {
+                case OpCode::ADD: as.addsd(0, 1); break;
+                case OpCode::SUB: as.subsd(0, 1); break;
+                case OpCode::MUL: as.mulsd(0, 1); break;
+                default: as.divsd(0, 1); break;
+            }
+            as.movq_from_xmm(Reg::RAX, 0);
+        }
+        // A NaN must be canonicalized, which the interpreter does
+        as.ucomisd(0, 0);
+        as.jcc(Cond::P, deopt(index));
+    }
+    as.bind(done);
+    store(a, integers ? Known::SmallInt : Known::Nothing);
+}
+
+// Typed arithmetic for one width; only boxed operands, results that need
+// boxing and divisors that are not positive deoptimize
+void Emitter::typed_arithmetic(OpCode op, unsigned width, uint32_t index, uint32_t word) {
+    const uint8_t a = Instruction::a(word), b = Instruction::b(word);
+    const uint8_t c = op == OpCode::NEG ? b : Instruction::c(word);
+    const Known left = known(b), right = known(c);
+
+    if (op != OpCode::NEG) load(Reg::RCX, c);
+    load(Reg::RAX, b);
+    guard_small_int(Reg::RAX, left, index);
+    if (op != OpCode::NEG) guard_small_int(Reg::RCX, right, index);
+    unbox(Reg::RAX);
+    if (op != OpCode::NEG) unbox(Reg::RCX);
+
+    switch (op) {
+        case OpCode::ADD: as.add(Reg::RAX, Reg::RCX); break;
+        case OpCode::SUB: as.sub(Reg::RAX, Reg::RCX); break;
+        case OpCode::MUL: as.imul(Reg::RAX, Reg::RCX); break;
+        case OpCode::NEG: as.neg(Reg::RAX); break;
+        default:
+            wrap(Reg::RAX, width);
+            wrap(Reg::RCX, width);
+            as.test(Reg::RCX, Reg::RCX);
+            as.jcc(Cond::LE, deopt(index));
+            if (is_signed(width)) {
+                as.cqo();
+                as.idiv(Reg::RCX);
+            } else {
+                as.xor_(Reg::RDX, Reg::RDX);
+                as.div(Reg::RCX);
+            }
+            if (op == OpCode::MOD) as.mov(Reg::RAX, Reg::RDX);
+            break;
+    }
+
+    if (is_wide(width)) {
+        check_fits(Reg::RAX, index);
+    } else {
+        wrap(Reg::RAX, width);
+    }
+    box(Reg::RAX);
+    store(a, Known::SmallInt);
+}
+
+// Comparisons produce a bool. Equality only handles inline integers, ordering
+// doubles too.
+void Emitter::comparison(OpCode op, uint32_t index, uint32_t word) {
+    const uint8_t a = Instruction::a(word), b = Instruction::b(word), c = Instruction::c(word);
+    const bool integers = known(b) == Known::SmallInt && known(c) == Known::SmallInt;
+    const bool ordered = op == OpCode::LT || op == OpCode::LE;
+    const Label doubles = ordered ? as.new_label() : deopt(index), done = as.new_label();
+
+    load(Reg::RCX, c);
+    load(Reg::RAX, b);
+    if (!integers) {
+        jump_unless_tag(Reg::RAX, INT_TAG, doubles);
+        jump_unless_tag(Reg::RCX, INT_TAG, doubles);
+    }
+
+    // Shifting the tag out keeps the order of the payloads, signed and unsigned
+    as.shl(Reg::RAX, 16);
+    as.shl(Reg::RCX, 16);
+    as.cmp(Reg::RAX, Reg::RCX);
+    switch (op) {
+        case OpCode::EQ: as.setcc(Cond::E, Reg::RAX); break;
+        case OpCode::NE: as.setcc(Cond::NE, Reg::RAX); break;
+        case OpCode::LT: as.setcc(Cond::L, Reg::RAX); break;
+        case OpCode::LE: as.setcc(Cond::LE, Reg::RAX); break;
+        case OpCode::LTU: as.setcc(Cond::B, Reg::RAX); break;
+        default: as.setcc(Cond::BE, Reg::RAX); break;
+    }
+
+    if (!integers && ordered) {
+        as.jmp(done);
+        as.bind(doubles);
+        jump_unless_double(Reg::RAX, deopt(index));
+        jump_unless_double(Reg::RCX, deopt(index));
+        as.movq_to_xmm(0, Reg::RAX);
+        as.movq_to_xmm(1, Reg::RCX);
+        // right > left and right >= left are false when unordered, as NaN comparisons must be
+        as.ucomisd(1, 0);
+        as.setcc(op == OpCode::LT ? Cond::A : Cond::AE, Reg::RAX);
+    }
+    as.bind(done);
+    bool_result();
+    store(a, Known::Bool);
+}
+
+// ===== HELPERS =====
+
+void Emitter::load(Reg dst, uint8_t reg) {
+    if (cached == reg) {
+        if (dst != Reg::RAX) as.mov(dst, Reg::RAX);
+        return;
+    }
+    as.load(dst, REGISTERS, slot(reg));
+    if (dst == Reg::RAX) {
+        cached = reg;
+        kind = Known::Nothing;
+    }
+}
+
+void Emitter::store(uint8_t reg, Known known) {
+    as.store(REGISTERS, slot(reg), Reg::RAX);
+    cached = reg;
+    kind = known;
+}
+
+Label Emitter::deopt(uint32_t index) {
+    if (!deopts[index]) deopts[index] = as.new_label();
+    return *deopts[index];
+}
+
+void Emitter::jump_unless_tag(Reg reg, uint32_t tag, Label target) {
+    as.mov(Reg::RDX, reg);
+    as.shr(Reg::RDX, 48);
+    as.cmp32(Reg::RDX, static_cast<int32_t>(tag));
+    as.jcc(Cond::NE, target);
+}
+
+void Emitter::jump_unless_double(Reg reg, Label target) {
+    as.mov(Reg::RDX, reg);
+    as.shr(Reg::RDX, 51);
+    as.cmp32(Reg::RDX, BOXED_TAG);
+    as.jcc(Cond::E, target);
+}
+
+void Emitter::guard_small_int(Reg reg, Known known, uint32_t index) {
+    if (known != Known::SmallInt) jump_unless_tag(reg, INT_TAG, deopt(index));
+}
+
+void Emitter::unbox(Reg reg) {
+    as.shl(reg, 16);
+    as.sar(reg, 16);
+}
+
+void Emitter::box(Reg reg) {
+    as.and_(reg, PAYLOAD);
+    as.or_(reg, INT_BITS);
+}
+
+void Emitter::check_fits(Reg reg, uint32_t index) {
+    as.mov(Reg::RDX, reg);
+    unbox(Reg::RDX);
+    as.cmp(Reg::RDX, reg);
+    as.jcc(Cond::NE, deopt(index));
+}
+
+void Emitter::wrap(Reg reg, unsigned width) {
+    switch (width) {
+        case 0: as.movsx8(reg, reg); break;
+        case 1: as.movsx16(reg, reg); break;
+        case 2: as.movsx32(reg, reg); break;
+        case 4: as.movzx8(reg, reg); break;
+        case 5: as.movzx16(reg, reg); break;
+        case 6: as.mov32(reg, reg); break;
+        default: break;
+    }
+}
+
+// rax = the bool in al, as set by setcc
+void Emitter::bool_result() {
+    as.movzx8(Reg::RAX, Reg::RAX);
+    as.or_(Reg::RAX, BOOL_BITS);
+}
+
+void Emitter::exit(uint32_t index) {
+    as.mov(Reg::RAX, uint64_t{index});
+    as.jmp(epilogue);
+    forget();
+}
+
+JitCompiler::NativeCode JitCompiler::compile(const BytecodeFunction &function) {
+    NativeCode native;
+#ifdef SPARKC_JIT_SUPPORTED
+    const std::vector<uint32_t> spans = native_spans(function.code);
+    native.entries.resize(spans.size());
+    bool any = false;
+    for (size_t i = 0; i < spans.size(); ++i) {
+        native.entries[i] = spans[i] >= MIN_SPAN;
+        any = any || native.entries[i];
+    }
+    if (!any) return native;
+
+    const std::vector<uint8_t> code = Emitter(function).emit();
+    native.run = reinterpret_cast<NativeFunction>(const_cast<void *>(memory.install(code)));
+#else
+    (void) function;
+#endif
+    return native;
+}
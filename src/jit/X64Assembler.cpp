@@ -0,0 +1,295 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/jit/X64Assembler.h"
+
+#include <stdexcept>
+
+namespace {
+    uint8_t code(Reg reg) { return static_cast<uint8_t>(reg); }
+}
+
+Label X64Assembler::new_label() {
+    positions.push_back(-1);
+    return {static_cast<uint32_t>(positions.size() - 1)};
+}
+
+void X64Assembler::bind(Label label) {
+    positions[label.id] = static_cast<int64_t>(bytes.size());
+}
+
+// ===== ENCODING =====
+
+void X64Assembler::rex(bool wide, uint8_t reg, uint8_t index, uint8_t base, bool force) {
+    const uint8_t prefix = 0x40 | (wide ? 8 : 0) | (reg >> 3) << 2 | (index >> 3) << 1 | base >> 3;
+    if (prefix != 0x40 || force) emit8(prefix);
+}
+
+void X64Assembler::register_op(uint8_t opcode, Reg rm, Reg reg) {
+    rex(true, code(reg), 0, code(rm));
+    emit8(opcode);
+    emit8(0xc0 | (code(reg) & 7) << 3 | (code(rm) & 7));
+}
+
+void X64Assembler::sse(uint8_t prefix, uint8_t opcode, uint8_t dst, uint8_t src) {
+    emit8(prefix);
+    rex(false, dst, 0, src);
+    emit8(0x0f);
+    emit8(opcode);
+    emit8(0xc0 | (dst & 7) << 3 | (src & 7));
+}
+
+void X64Assembler::rel32(Label target) {
+    fixups.emplace_back(bytes.size(), target.id);
+    emit32(0);
+}
+
+void X64Assembler::emit32(uint32_t value) {
+    for (int i = 0; i < 4; ++i) emit8(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void X64Assembler::align(size_t alignment) {
+    while (bytes.size() % alignment != 0) emit8(0xcc);
+}
+
+// ===== MOVES =====
+
+void X64Assembler::mov(Reg dst, Reg src) {
+    register_op(0x89, dst, src);
+}
+
+void X64Assembler::mov(Reg dst, uint64_t imm) {
+    rex(true, 0, 0, code(dst));
+    emit8(0xb8 | (code(dst) & 7));
+    for (int i = 0; i < 8; ++i) emit8(static_cast<uint8_t>(imm >> (8 * i)));
+}
+
+void X64Assembler::mov32(Reg dst, Reg src) {
+    rex(false, code(src), 0, code(dst));
+    emit8(0x89);
+    emit8(0xc0 | (code(src) & 7) << 3 | (code(dst) & 7));
+}
+
+void X64Assembler::load(Reg dst, Reg base, int32_t disp) {
+    rex(true, code(dst), 0, code(base));
+    emit8(0x8b);
+    emit8(0x80 | (code(dst) & 7) << 3 | (code(base) & 7));
+    if ((code(base) & 7) == 4) emit8(0x24); // rsp and r12 need a SIB byte
+    emit32(static_cast<uint32_t>(disp));
+}
+
+void X64Assembler::store(Reg base, int32_t disp, Reg src) {
+    rex(true, code(src), 0, code(base));
+    emit8(0x89);
+    emit8(0x80 | (code(src) & 7) << 3 | (code(base) & 7));
+    if ((code(base) & 7) == 4) emit8(0x24);
+    emit32(static_cast<uint32_t>(disp));
+}
+
+// ===== ARITHMETIC =====
+
+void X64Assembler::add(Reg dst, Reg src) { register_op(0x01, dst, src); }
+void X64Assembler::sub(Reg dst, Reg src) { register_op(0x29, dst, src); }
+void X64Assembler::and_(Reg dst, Reg src) { register_op(0x21, dst, src); }
+void X64Assembler::or_(Reg dst, Reg src) { register_op(0x09, dst, src); }
+void X64Assembler::xor_(Reg dst, Reg src) { register_op(0x31, dst, src); }
+void X64Assembler::cmp(Reg left, Reg right) { register_op(0x39, left, right); }
+void X64Assembler::test(Reg left, Reg right) { register_op(0x85, left, right); }
+
+void X64Assembler::imul(Reg dst, Reg src) {
+    rex(true, code(dst), 0, code(src));
+    emit8(0x0f);
+    emit8(0xaf);
+    emit8(0xc0 | (code(dst) & 7) << 3 | (code(src) & 7));
+}
+
+void X64Assembler::xor_(Reg dst, int8_t imm) {
+    rex(true, 0, 0, code(dst));
+    emit8(0x83);
+    emit8(0xc0 | 6 << 3 | (code(dst) & 7));
+    emit8(static_cast<uint8_t>(imm));
+}
+
+void X64Assembler::cmp32(Reg left, int32_t imm) {
+    rex(false, 0, 0, code(left));
+    emit8(0x81);
+    emit8(0xc0 | 7 << 3 | (code(left) & 7));
+    emit32(static_cast<uint32_t>(imm));
+}
+
+void X64Assembler::test8(Reg left, int8_t imm) {
+    rex(false, 0, 0, code(left), code(left) >= 4);
+    emit8(0xf6);
+    emit8(0xc0 | (code(left) & 7));
+    emit8(static_cast<uint8_t>(imm));
+}
+
+void X64Assembler::neg(Reg reg) {
+    rex(true, 0, 0, code(reg));
+    emit8(0xf7);
+    emit8(0xc0 | 3 << 3 | (code(reg) & 7));
+}
+
+void X64Assembler::shl(Reg reg, uint8_t count) {
+    rex(true, 0, 0, code(reg));
+    emit8(0xc1);
+    emit8(0xc0 | 4 << 3 | (code(reg) & 7));
+    emit8(count);
+}
+
+void X64Assembler::shr(Reg reg, uint8_t count) {
+    rex(true, 0, 0, code(reg));
+    emit8(0xc1);
+    emit8(0xc0 | 5 << 3 | (code(reg) & 7));
+    emit8(count);
+}
+
+void X64Assembler::sar(Reg reg, uint8_t count) {
+    rex(true, 0, 0, code(reg));
+    emit8(0xc1);
+    emit8(0xc0 | 7 << 3 | (code(reg) & 7));
+    emit8(count);
+}
+
+void X64Assembler::cqo() {
+    emit8(0x48);
+    emit8(0x99);
+}
+
+void X64Assembler::idiv(Reg divisor) {
+    rex(true, 0, 0, code(divisor));
+    emit8(0xf7);
+    emit8(0xc0 | 7 << 3 | (code(divisor) & 7));
+}
+
+void X64Assembler::div(Reg divisor) {
+    rex(true, 0, 0, code(divisor));
+    emit8(0xf7);
+    emit8(0xc0 | 6 << 3 | (code(divisor) & 7));
+}
+
+// ===== EXTENSION AND FLAGS =====
+
+void X64Assembler::movsx8(Reg dst, Reg src) {
+    rex(true, code(dst), 0, code(src));
+    emit8(0x0f);
+    emit8(0xbe);
+    emit8(0xc0 | (code(dst) & 7) << 3 | (code(src) & 7));
+}
+
+void X64Assembler::movsx16(Reg dst, Reg src) {
+    rex(true, code(dst), 0, code(src));
+    emit8(0x0f);
+    emit8(0xbf);
+    emit8(0xc0 | (code(dst) & 7) << 3 | (code(src) & 7));
+}
+
+void X64Assembler::movsx32(Reg dst, Reg src) {
+    rex(true, code(dst), 0, code(src));
+    emit8(0x63);
+    emit8(0xc0 | (code(dst) & 7) << 3 | (code(src) & 7));
+}
+
+void X64Assembler::movzx8(Reg dst, Reg src) {
+    rex(false, code(dst), 0, code(src), code(src) >= 4); // without REX, 4..7 would mean ah..bh
+    emit8(0x0f);
+    emit8(0xb6);
+    emit8(0xc0 | (code(dst) & 7) << 3 | (code(src) & 7));
+}
+
+void X64Assembler::movzx16(Reg dst, Reg src) {
+    rex(false, code(dst), 0, code(src));
+    emit8(0x0f);
+    emit8(0xb7);
+    emit8(0xc0 | (code(dst) & 7) << 3 | (code(src) & 7));
+}
+
+void X64Assembler::setcc(Cond cond, Reg dst) {
+    rex(false, 0, 0, code(dst), code(dst) >= 4);
+    emit8(0x0f);
+    emit8(0x90 | static_cast<uint8_t>(cond));
+    emit8(0xc0 | (code(dst) & 7));
+}
+
+// ===== FLOATING POINT =====
+
+void X64Assembler::movq_to_xmm(uint8_t xmm, Reg src) {
+    emit8(0x66);
+    rex(true, xmm, 0, code(src));
+    emit8(0x0f);
+    emit8(0x6e);
+    emit8(0xc0 | (xmm & 7) << 3 | (code(src) & 7));
+}
+
+void X64Assembler::movq_from_xmm(Reg dst, uint8_t xmm) {
+    emit8(0x66);
+    rex(true, xmm, 0, code(dst));
+    emit8(0x0f);
+    emit8(0x7e);
+    emit8(0xc0 | (xmm & 7) << 3 | (code(dst) & 7));
+}
+
+void X64Assembler::addsd(uint8_t dst, uint8_t src) { sse(0xf2, 0x58, dst, src); }
+void X64Assembler::subsd(uint8_t dst, uint8_t src) { sse(0xf2, 0x5c, dst, src); }
+void X64Assembler::mulsd(uint8_t dst, uint8_t src) { sse(0xf2, 0x59, dst, src); }
+void X64Assembler::divsd(uint8_t dst, uint8_t src) { sse(0xf2, 0x5e, dst, src); }
+void X64Assembler::ucomisd(uint8_t left, uint8_t right) { sse(0x66, 0x2e, left, right); }
+
+// ===== CONTROL FLOW =====
+
+void X64Assembler::jmp(Label target) {
+    emit8(0xe9);
+    rel32(target);
+}
+
+void X64Assembler::jmp(Reg target) {
+    rex(false, 0, 0, code(target));
+    emit8(0xff);
+    emit8(0xc0 | 4 << 3 | (code(target) & 7));
+}
+
+void X64Assembler::jcc(Cond cond, Label target) {
+    emit8(0x0f);
+    emit8(0x80 | static_cast<uint8_t>(cond));
+    rel32(target);
+}
+
+void X64Assembler::lea(Reg dst, Label target) {
+    rex(true, code(dst), 0, 0);
+    emit8(0x8d);
+    emit8(0x05 | (code(dst) & 7) << 3);
+    rel32(target);
+}
+
+void X64Assembler::movsxd_indexed(Reg dst, Reg base, Reg index) {
+    if ((code(base) & 7) == 5) throw std::logic_error("rbp and r13 cannot be a base without a displacement");
+    rex(true, code(dst), code(index), code(base));
+    emit8(0x63);
+    emit8(0x04 | (code(dst) & 7) << 3);
+    emit8(2 << 6 | (code(index) & 7) << 3 | (code(base) & 7));
+}
+
+void X64Assembler::push(Reg reg) {
+    rex(false, 0, 0, code(reg));
+    emit8(0x50 | (code(reg) & 7));
+}
+
+void X64Assembler::pop(Reg reg) {
+    rex(false, 0, 0, code(reg));
+    emit8(0x58 | (code(reg) & 7));
+}
+
+void X64Assembler::ret() {
+    emit8(0xc3);
+}
+
+std::vector<uint8_t> X64Assembler::finish() {
+    for (const auto &[position, label] : fixups) {
+        if (positions[label] < 0) throw std::logic_error("jump to an unbound label");
+        const auto displacement = static_cast<int32_t>(positions[label] - static_cast<int64_t>(position + 4));
+        for (int i = 0; i < 4; ++i) bytes[position + i] = static_cast<uint8_t>(static_cast<uint32_t>(displacement) >> (8 * i));
+    }
+    fixups.clear();
+    return std::move(bytes);
+}
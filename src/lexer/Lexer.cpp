@@ -3,6 +3,7 @@
 //
 
 #include "../../include/lexer/Lexer.h"
+#include "../../include/util/TimeStats.h"
 
 #include <algorithm>
 #include <cctype>
@@ -41,25 +42,50 @@ bool Lexer::match(char expected) {
     return true;
 }
 
+void Lexer::set_keep_trivia(bool keep) {
+    keep_trivia = keep;
+}
+
+const std::vector<Trivia> &Lexer::trivia() const {
+    return trivia_spans;
+}
+
+void Lexer::clear_trivia() {
+    trivia_spans.clear();
+}
+
+void Lexer::add_trivia(TriviaKind kind, size_t from) {
+    if (keep_trivia && current > from) {
+        trivia_spans.push_back({kind, static_cast<uint32_t>(from), static_cast<uint32_t>(current - from)});
+    }
+}
+
 void Lexer::skip_whitespace() {
     while (true) {
+        const size_t from = current;
         char c = peek();
         switch (c) {
             case ' ':
             case '\t':
             case '\r':
+                while (peek() == ' ' || peek() == '\t' || peek() == '\r') advance();
+                add_trivia(TriviaKind::Whitespace, from);
+                break;
             case '\n':
                 advance();
+                add_trivia(TriviaKind::Newline, from);
                 break;
             case '/':
                 if (peek_next() == '/') {
                     skip_comment();
+                    add_trivia(TriviaKind::LineComment, from);
                     break;
                 }
 
                 if (peek_next() == '*') {
                     if (peek_next() == '*') skip_documentation_comment();
                     else skip_block_comment();
+                    add_trivia(TriviaKind::BlockComment, from);
                     break;
                 }
 
@@ -97,13 +123,19 @@ void Lexer::skip_documentation_comment() {
 }
 
 Token Lexer::make_token(TokenType type, const std::string &lexeme, const Literal &literal) {
-    return {type, lexeme, literal, context.line(), context.column()};
+    Token token{type, lexeme, literal, context.line(), context.column()};
+    token.offset = static_cast<uint32_t>(start);
+    token.length = static_cast<uint32_t>(current - start);
+    return token;
 }
 
 Token Lexer::make_char_token(TokenType type, const char &lexeme, const Literal &literal) {
     char str1[2] = {lexeme, '\0'};
     char str2[5] = "";
-    return {type, strcpy(str2, str1), literal, context.line(), context.column()};
+    Token token{type, strcpy(str2, str1), literal, context.line(), context.column()};
+    token.offset = static_cast<uint32_t>(start);
+    token.length = static_cast<uint32_t>(current - start);
+    return token;
 }
 
 Token Lexer::next_token() {
@@ -207,6 +239,16 @@ Token Lexer::next_token() {
     }
 }
 
+std::vector<Token> Lexer::tokenize() {
+    std::vector<Token> tokens;
+    while (true) {
+        tokens.push_back(next_token());
+        if (tokens.back().type == TokenType::END_OF_FILE) break;
+    }
+    TimeStats::count(Throughput::Tokens, tokens.size());
+    return tokens;
+}
+
 Token Lexer::identifier() {
     while (std::isalnum(peek()) || peek() == '_') advance();
     std::string text = source.substr(start, current - start);
@@ -263,12 +305,17 @@ Token Lexer::number() {
         if (c != '_') cleanNumeric.push_back(c);
     }
 
-    return makeNumberTokenFromSuffix(
-        text,
-        cleanNumeric,
-        suffix,
-        hasDot
-    );
+    // a literal too large for its type comes out as an UNKNOWN token for the caller to report
+    try {
+        return makeNumberTokenFromSuffix(
+            text,
+            cleanNumeric,
+            suffix,
+            hasDot
+        );
+    } catch (const std::logic_error&) { // out_of_range or invalid_argument from stoll and friends
+        return make_token(TokenType::UNKNOWN, text);
+    }
 }
 
 Token Lexer::string() {
@@ -372,36 +419,37 @@ Token Lexer::makeNumberTokenFromSuffix(const std::string& text, const std::strin
     std::string sfx = suffix;
     std::transform(sfx.begin(), sfx.end(), sfx.begin(), [](unsigned char c){ return std::tolower(c); });
 
-    // map suffix → a lambda that builds the right Token
-    static const std::unordered_map<std::string, std::function<Token(const std::string&, const std::string&)>>
+    // map suffix → a lambda that builds the right Token. The table is shared by
+    // every lexer, so the lexer is passed in rather than captured.
+    static const std::unordered_map<std::string, std::function<Token(Lexer&, const std::string&, const std::string&)>>
     handlers = {
         // floats
-        { "f", [&](const auto &fullText, const auto &numericStr) { return make_token(TokenType::FLOAT64_LITERAL,  fullText, std::stof(numericStr));}},
-        { "f8", [&](const auto &fullText, const auto &numericStr) { return make_token(TokenType::FLOAT8_LITERAL,  fullText, std::stof(numericStr));}},
-        { "f16", [&](const auto &fullText, const auto &numericStr) { return make_token(TokenType::FLOAT16_LITERAL,  fullText, std::stof(numericStr));}},
-        { "f32", [&](const auto &fullText, const auto &numericStr) { return make_token(TokenType::FLOAT32_LITERAL,  fullText, std::stof(numericStr));}},
-        { "f64", [&](const auto &fullText, const auto &numericStr) { return make_token(TokenType::FLOAT64_LITERAL,  fullText, std::stof(numericStr));}},
+        { "f", [](Lexer &lexer, const auto &fullText, const auto &numericStr) { return lexer.make_token(TokenType::FLOAT64_LITERAL,  fullText, std::stof(numericStr));}},
+        { "f8", [](Lexer &lexer, const auto &fullText, const auto &numericStr) { return lexer.make_token(TokenType::FLOAT8_LITERAL,  fullText, std::stof(numericStr));}},
+        { "f16", [](Lexer &lexer, const auto &fullText, const auto &numericStr) { return lexer.make_token(TokenType::FLOAT16_LITERAL,  fullText, std::stof(numericStr));}},
+        { "f32", [](Lexer &lexer, const auto &fullText, const auto &numericStr) { return lexer.make_token(TokenType::FLOAT32_LITERAL,  fullText, std::stof(numericStr));}},
+        { "f64", [](Lexer &lexer, const auto &fullText, const auto &numericStr) { return lexer.make_token(TokenType::FLOAT64_LITERAL,  fullText, std::stof(numericStr));}},
 
         // doubles
-        {"d",  [&](const auto &fullText, const auto &numericStr){ return make_token(TokenType::DOUBLE_LITERAL, fullText, std::stod(numericStr)); }},
+        {"d",  [](Lexer &lexer, const auto &fullText, const auto &numericStr){ return lexer.make_token(TokenType::DOUBLE_LITERAL, fullText, std::stod(numericStr)); }},
 
         // signed ints
-        {"i8", [&](const auto &fullText, const auto &numericStr){ return make_token(TokenType::INT8_LITERAL,  fullText, std::stoll(numericStr)); }},
-        {"i16", [&](const auto &fullText, const auto &numericStr){ return make_token(TokenType::INT16_LITERAL, fullText, std::stoll(numericStr)); }},
-        {"i32", [&](const auto &fullText, const auto &numericStr){ return make_token(TokenType::INT32_LITERAL, fullText, std::stoll(numericStr)); }},
-        {"i64", [&](const auto &fullText, const auto &numericStr){ return make_token(TokenType::INT64_LITERAL, fullText, std::stoll(numericStr)); }},
+        {"i8", [](Lexer &lexer, const auto &fullText, const auto &numericStr){ return lexer.make_token(TokenType::INT8_LITERAL,  fullText, std::stoll(numericStr)); }},
+        {"i16", [](Lexer &lexer, const auto &fullText, const auto &numericStr){ return lexer.make_token(TokenType::INT16_LITERAL, fullText, std::stoll(numericStr)); }},
+        {"i32", [](Lexer &lexer, const auto &fullText, const auto &numericStr){ return lexer.make_token(TokenType::INT32_LITERAL, fullText, std::stoll(numericStr)); }},
+        {"i64", [](Lexer &lexer, const auto &fullText, const auto &numericStr){ return lexer.make_token(TokenType::INT64_LITERAL, fullText, std::stoll(numericStr)); }},
 
         // unsigned ints
-        {"u8", [&](const auto &fullText, const auto &numericStr){ return make_token(TokenType::UINT8_LITERAL,  fullText, std::stoll(numericStr)); }},
-        {"u16", [&](const auto &fullText, const auto &numericStr){ return make_token(TokenType::UINT16_LITERAL, fullText, std::stoll(numericStr)); }},
-        {"u32", [&](const auto &fullText, const auto &numericStr){ return make_token(TokenType::UINT32_LITERAL, fullText, std::stoll(numericStr)); }},
-        {"u64", [&](const auto &fullText, const auto &numericStr){ return make_token(TokenType::UINT64_LITERAL, fullText, std::stoll(numericStr)); }},
+        {"u8", [](Lexer &lexer, const auto &fullText, const auto &numericStr){ return lexer.make_token(TokenType::UINT8_LITERAL,  fullText, std::stoll(numericStr)); }},
+        {"u16", [](Lexer &lexer, const auto &fullText, const auto &numericStr){ return lexer.make_token(TokenType::UINT16_LITERAL, fullText, std::stoll(numericStr)); }},
+        {"u32", [](Lexer &lexer, const auto &fullText, const auto &numericStr){ return lexer.make_token(TokenType::UINT32_LITERAL, fullText, std::stoll(numericStr)); }},
+        {"u64", [](Lexer &lexer, const auto &fullText, const auto &numericStr){ return lexer.make_token(TokenType::UINT64_LITERAL, fullText, static_cast<int64_t>(std::stoull(numericStr))); }},
 
     };
 
     if (auto it = handlers.find(sfx); it != handlers.end()) {
         // found a custom handler for this suffix
-        return it->second(text, numericPart);
+        return it->second(*this, text, numericPart);
     }
 
     // fallback: choose double vs. int64 by whether we saw a dot
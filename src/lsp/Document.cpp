@@ -0,0 +1,249 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/lsp/Document.h"
+#include "../../include/lexer/Lexer.h"
+#include "../../include/tokens/TokenCategory.h"
+
+#include <algorithm>
+
+namespace {
+    constexpr uint32_t TYPE_KEYWORD = 0;
+    constexpr uint32_t TYPE_TYPE = 1;
+    constexpr uint32_t TYPE_MODIFIER = 2;
+    constexpr uint32_t TYPE_VARIABLE = 3;
+    constexpr uint32_t TYPE_STRING = 4;
+    constexpr uint32_t TYPE_NUMBER = 5;
+    constexpr uint32_t TYPE_OPERATOR = 6;
+
+    constexpr size_t MIN_WINDOW = 4096;
+}
+
+Document::Document(std::string text) {
+    replace(std::move(text));
+}
+
+void Document::replace(std::string text) {
+    content = std::move(text);
+    index_lines();
+    highlighted.clear();
+    relex(0, 0, static_cast<uint32_t>(content.size()));
+}
+
+void Document::edit(TextPosition start, TextPosition end, std::string_view text) {
+    const uint32_t begin = offset_of(start);
+    const uint32_t old_end = std::max(begin, offset_of(end));
+    const auto new_end = static_cast<uint32_t>(begin + text.size());
+    const int64_t delta = static_cast<int64_t>(text.size()) - (old_end - begin);
+
+    // Swap the line starts inside the replaced range for those of the new text
+    const auto first = std::upper_bound(line_starts.begin(), line_starts.end(), begin);
+    const auto last = std::upper_bound(first, line_starts.end(), old_end);
+    std::vector<uint32_t> inserted;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\n') inserted.push_back(static_cast<uint32_t>(begin + i + 1));
+    }
+    const auto tail = line_starts.erase(first, last);
+    const auto shifted = line_starts.insert(tail, inserted.begin(), inserted.end()) + static_cast<ptrdiff_t>(inserted.size());
+    for (auto it = shifted; it != line_starts.end(); ++it) *it = static_cast<uint32_t>(*it + delta);
+
+    content.replace(begin, old_end - begin, text);
+    relex(begin, old_end, new_end);
+}
+
+const std::string &Document::text() const {
+    return content;
+}
+
+const std::vector<SemanticToken> &Document::tokens() const {
+    return highlighted;
+}
+
+std::vector<uint32_t> Document::encode_all() {
+    std::vector<uint32_t> data;
+    encode(0, highlighted.size(), data);
+    sent_count = clean_head = clean_tail = highlighted.size();
+    return data;
+}
+
+Document::TokenEdit Document::encode_delta() {
+    const size_t common = std::min(sent_count, highlighted.size());
+    const size_t head = std::min(clean_head, common);
+    const size_t tail = std::min(clean_tail, common - head);
+
+    TokenEdit edit;
+    edit.start = static_cast<uint32_t>(head * 5);
+    edit.delete_count = static_cast<uint32_t>((sent_count - head - tail) * 5);
+    encode(head, highlighted.size() - tail, edit.data);
+
+    sent_count = clean_head = clean_tail = highlighted.size();
+    return edit;
+}
+
+std::optional<uint32_t> Document::classify(TokenType type) {
+    switch (type) {
+        case TokenType::INT8: case TokenType::INT16: case TokenType::INT32: case TokenType::INT64:
+        case TokenType::UINT8: case TokenType::UINT16: case TokenType::UINT32: case TokenType::UINT64:
+        case TokenType::FLOAT8: case TokenType::FLOAT16: case TokenType::FLOAT32: case TokenType::FLOAT64:
+        case TokenType::DOUBLE: case TokenType::BOOLEAN: case TokenType::CHAR: case TokenType::STRING:
+            return TYPE_TYPE;
+        case TokenType::STRING_LITERAL:
+        case TokenType::CHAR_LITERAL:
+            return TYPE_STRING;
+        default:
+            break;
+    }
+
+    switch (get_token_category(type)) {
+        case TokenCategory::Identifier: return TYPE_VARIABLE;
+        case TokenCategory::Literal:
+            return type == TokenType::BOOLEAN_LITERAL || type == TokenType::NULL_LITERAL ||
+                   type == TokenType::TRUE_VALUE || type == TokenType::FALSE_VALUE ||
+                   type == TokenType::NULL_VALUE || type == TokenType::OK || type == TokenType::FAIL
+                       ? TYPE_KEYWORD
+                       : TYPE_NUMBER;
+        case TokenCategory::Operator:
+        case TokenCategory::Assignment:
+        case TokenCategory::Comparison:
+        case TokenCategory::Logical:
+        case TokenCategory::Bitwise:
+            return TYPE_OPERATOR;
+        case TokenCategory::Keyword:
+        case TokenCategory::ControlFlow:
+        case TokenCategory::Declaration:
+        case TokenCategory::TypeSystem:
+        case TokenCategory::Concurrency:
+            return TYPE_KEYWORD;
+        case TokenCategory::Modifier: return TYPE_MODIFIER;
+        default: return std::nullopt; // punctuation, grouping and end of file
+    }
+}
+
+uint32_t Document::offset_of(TextPosition position) const {
+    if (position.line >= line_starts.size()) return static_cast<uint32_t>(content.size());
+
+    const uint32_t line_start = line_starts[position.line];
+    const uint32_t line_end = position.line + 1 < line_starts.size()
+                                  ? line_starts[position.line + 1] - 1
+                                  : static_cast<uint32_t>(content.size());
+    return std::min(line_start + position.character, line_end);
+}
+
+TextPosition Document::position_of(uint32_t offset) const {
+    const auto next = std::upper_bound(line_starts.begin(), line_starts.end(), offset);
+    const auto line = static_cast<uint32_t>(next - line_starts.begin() - 1);
+    return {line, offset - line_starts[line]};
+}
+
+void Document::index_lines() {
+    line_starts.assign(1, 0);
+    for (size_t i = 0; i < content.size(); ++i) {
+        if (content[i] == '\n') line_starts.push_back(static_cast<uint32_t>(i + 1));
+    }
+}
+
+// The old text [begin, old_end) became the new text [begin, new_end).
+// Lexing restarts at the last token ending before the edit (stray punctuation
+// in between may fuse with the new text) and stops at the first old token
+// past the edit that is lexed again at its shifted position: the lexer keeps
+// no state across token boundaries, so everything after it is unchanged.
+void Document::relex(uint32_t begin, uint32_t old_end, uint32_t new_end) {
+    const int64_t delta = static_cast<int64_t>(new_end) - old_end;
+    const auto first_touched = std::partition_point(highlighted.begin(), highlighted.end(), [&](const SemanticToken &t) {
+        return t.offset + t.length < begin;
+    });
+    const size_t restart_index = first_touched == highlighted.begin() ? 0 : first_touched - highlighted.begin() - 1;
+    const uint32_t restart = restart_index < highlighted.size() && first_touched != highlighted.begin()
+                                 ? highlighted[restart_index].offset
+                                 : 0;
+
+    std::vector<SemanticToken> fresh;
+    size_t resync = highlighted.size();
+    size_t window = std::max<size_t>(MIN_WINDOW, 2 * (new_end - restart));
+
+    while (true) {
+        const size_t end = std::min(content.size(), restart + window);
+        const bool at_eof = end == content.size();
+        bool truncated = false;
+        fresh.clear();
+        resync = highlighted.size();
+
+        Lexer lexer(content.substr(restart, end - restart), "");
+        while (true) {
+            std::optional<Token> lexed;
+            try {
+                lexed = lexer.next_token();
+            } catch (const std::exception &) {
+                continue; // an out-of-range literal; the lexer has already moved past it
+            }
+            const Token &token = *lexed;
+            if (token.type == TokenType::END_OF_FILE) {
+                truncated = !at_eof; // a comment or string may run on past the window
+                break;
+            }
+
+            const uint32_t offset = restart + token.offset;
+            if (!at_eof && offset + token.length >= end) {
+                truncated = true; // the token may continue past the window
+                break;
+            }
+
+            const auto type = classify(token.type);
+            if (!type) continue;
+
+            if (offset >= new_end) {
+                const auto old_offset = static_cast<uint32_t>(offset - delta);
+                const auto match = std::lower_bound(highlighted.begin() + static_cast<ptrdiff_t>(restart_index),
+                                                    highlighted.end(), old_offset,
+                                                    [](const SemanticToken &t, uint32_t o) { return t.offset < o; });
+                if (match != highlighted.end() && match->offset == old_offset && match->length == token.length &&
+                    match->type == *type) {
+                    resync = match - highlighted.begin();
+                    break;
+                }
+            }
+
+            fresh.push_back({offset, token.length, *type});
+        }
+
+        if (!truncated || resync != highlighted.size()) break;
+        window *= 2;
+    }
+
+    const size_t old_count = highlighted.size();
+    highlighted.erase(highlighted.begin() + static_cast<ptrdiff_t>(restart_index),
+                      highlighted.begin() + static_cast<ptrdiff_t>(resync));
+    highlighted.insert(highlighted.begin() + static_cast<ptrdiff_t>(restart_index), fresh.begin(), fresh.end());
+    for (size_t i = restart_index + fresh.size(); i < highlighted.size(); ++i) {
+        highlighted[i].offset = static_cast<uint32_t>(highlighted[i].offset + delta);
+    }
+
+    // The resync token's encoding is relative to a token that may have changed
+    clean_head = std::min(clean_head, restart_index);
+    clean_tail = std::min(clean_tail, resync < old_count ? old_count - resync - 1 : 0);
+}
+
+void Document::encode(size_t first, size_t last, std::vector<uint32_t> &out) const {
+    TextPosition previous{0, 0};
+    if (first > 0) previous = position_of(highlighted[first - 1].offset);
+
+    out.reserve(out.size() + (last - first) * 5);
+    for (size_t i = first; i < last; ++i) {
+        const SemanticToken &token = highlighted[i];
+        const TextPosition position = position_of(token.offset);
+
+        // Tokens may not span lines; a multi-line string is cut at its first line break
+        const size_t line_break = content.find('\n', token.offset);
+        const uint32_t length = line_break < token.offset + token.length
+                                    ? static_cast<uint32_t>(line_break - token.offset)
+                                    : token.length;
+
+        out.push_back(position.line - previous.line);
+        out.push_back(position.line == previous.line ? position.character - previous.character : position.character);
+        out.push_back(length);
+        out.push_back(token.type);
+        out.push_back(0);
+        previous = position;
+    }
+}
@@ -0,0 +1,214 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/lsp/LanguageServer.h"
+#include "../../include/util/Version.h"
+
+#include <algorithm>
+
+namespace {
+    // JSON-RPC error codes
+    constexpr int PARSE_ERROR = -32700;
+    constexpr int INVALID_PARAMS = -32602;
+    constexpr int METHOD_NOT_FOUND = -32601;
+    constexpr int INVALID_REQUEST = -32600;
+
+    constexpr int TEXT_DOCUMENT_SYNC_INCREMENTAL = 2;
+
+    TextPosition position_from(const JsonValue &position) {
+        return {static_cast<uint32_t>(position["line"].as_int()), static_cast<uint32_t>(position["character"].as_int())};
+    }
+
+    JsonValue::Array to_array(const std::vector<uint32_t> &data) {
+        JsonValue::Array array;
+        array.reserve(data.size());
+        for (const uint32_t value : data) array.emplace_back(static_cast<int64_t>(value));
+        return array;
+    }
+}
+
+LanguageServer::LanguageServer(std::istream &in, std::ostream &out) : in(in), out(out) {
+}
+
+int LanguageServer::run() {
+    while (!exit_requested) {
+        const auto body = read_message();
+        if (!body) break;
+
+        JsonValue message;
+        try {
+            message = JsonValue::parse(*body);
+        } catch (const JsonError &e) {
+            respond_error(nullptr, PARSE_ERROR, e.what());
+            continue;
+        }
+
+        try {
+            handle(message);
+        } catch (const JsonError &e) {
+            if (!message["id"].is_null()) respond_error(message["id"], INVALID_PARAMS, e.what());
+        }
+    }
+
+    // Per the protocol, exiting without a prior shutdown request is an error
+    return shutdown_requested ? 0 : 1;
+}
+
+std::optional<std::string> LanguageServer::read_message() {
+    size_t length = 0;
+    bool has_length = false;
+    std::string line;
+
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) {
+            if (has_length) break;
+            continue;
+        }
+
+        constexpr std::string_view CONTENT_LENGTH = "Content-Length:";
+        if (line.size() > CONTENT_LENGTH.size() &&
+            std::equal(CONTENT_LENGTH.begin(), CONTENT_LENGTH.end(), line.begin(),
+                       [](char a, char b) { return std::tolower(a) == std::tolower(b); })) {
+            try {
+                length = std::stoul(line.substr(CONTENT_LENGTH.size()));
+                has_length = true;
+            } catch (const std::exception &) {
+                has_length = false;
+            }
+        }
+    }
+
+    if (!has_length) return std::nullopt;
+
+    std::string body(length, '\0');
+    if (!in.read(body.data(), static_cast<std::streamsize>(length))) return std::nullopt;
+    return body;
+}
+
+void LanguageServer::send(const JsonValue &message) {
+    const std::string body = message.dump();
+    out << "Content-Length: " << body.size() << "\r\n\r\n" << body;
+    out.flush();
+}
+
+void LanguageServer::respond(const JsonValue &id, JsonValue result) {
+    send(JsonValue::Object{{"jsonrpc", "2.0"}, {"id", id}, {"result", std::move(result)}});
+}
+
+void LanguageServer::respond_error(const JsonValue &id, int code, const std::string &message) {
+    JsonValue error = JsonValue::Object{{"code", code}, {"message", message}};
+    send(JsonValue::Object{{"jsonrpc", "2.0"}, {"id", id}, {"error", std::move(error)}});
+}
+
+void LanguageServer::handle(const JsonValue &message) {
+    const JsonValue &id = message["id"];
+    const bool is_request = message.is_object() && !id.is_null();
+    const std::string method = message["method"].is_string() ? message["method"].as_string() : "";
+    const JsonValue &params = message["params"];
+
+    if (method.empty()) {
+        if (is_request) respond_error(id, INVALID_REQUEST, "Missing method");
+        return; // a response to something we never send
+    }
+
+    if (method == "initialize") return respond(id, initialize(params));
+    if (method == "shutdown") {
+        shutdown_requested = true;
+        return respond(id, nullptr);
+    }
+    if (method == "exit") {
+        exit_requested = true;
+        return;
+    }
+    if (method == "textDocument/didOpen") return did_open(params);
+    if (method == "textDocument/didChange") return did_change(params);
+    if (method == "textDocument/didClose") {
+        documents.erase(params["textDocument"]["uri"].as_string());
+        return;
+    }
+    if (method == "textDocument/semanticTokens/full") return respond(id, semantic_tokens_full(params));
+    if (method == "textDocument/semanticTokens/full/delta") return respond(id, semantic_tokens_delta(params));
+
+    // Unknown notifications ("initialized", "$/..." and the like) are ignored
+    if (is_request) respond_error(id, METHOD_NOT_FOUND, "Unsupported method " + method);
+}
+
+JsonValue LanguageServer::initialize(const JsonValue &params) {
+    JsonValue::Array token_types;
+    for (const char *type : SEMANTIC_TOKEN_TYPES) token_types.emplace_back(type);
+
+    JsonValue legend = JsonValue::Object{{"tokenTypes", std::move(token_types)}, {"tokenModifiers", JsonValue::Array{}}};
+    JsonValue capabilities = JsonValue::Object{
+        {"textDocumentSync", JsonValue::Object{{"openClose", true}, {"change", TEXT_DOCUMENT_SYNC_INCREMENTAL}}},
+        {"semanticTokensProvider", JsonValue::Object{{"legend", std::move(legend)},
+                                                     {"full", JsonValue::Object{{"delta", true}}}}},
+    };
+
+    // Columns are byte offsets; say so when the client lets us
+    const JsonValue &encodings = params["capabilities"]["general"]["positionEncodings"];
+    if (encodings.is_array() && std::ranges::any_of(encodings.as_array(), [](const JsonValue &e) {
+            return e.is_string() && e.as_string() == "utf-8";
+        })) {
+        capabilities.set("positionEncoding", "utf-8");
+    }
+
+    return JsonValue::Object{
+        {"capabilities", std::move(capabilities)},
+        {"serverInfo", JsonValue::Object{{"name", "sparkc"}, {"version", SPARKC_VERSION}}},
+    };
+}
+
+void LanguageServer::did_open(const JsonValue &params) {
+    const JsonValue &item = params["textDocument"];
+    documents.insert_or_assign(item["uri"].as_string(), OpenDocument{Document(item["text"].as_string())});
+}
+
+void LanguageServer::did_change(const JsonValue &params) {
+    OpenDocument &open = document(params);
+
+    for (const auto &change : params["contentChanges"].as_array()) {
+        const JsonValue &range = change["range"];
+        if (range.is_null()) {
+            open.document.replace(change["text"].as_string());
+        } else {
+            open.document.edit(position_from(range["start"]), position_from(range["end"]), change["text"].as_string());
+        }
+    }
+}
+
+JsonValue LanguageServer::semantic_tokens_full(const JsonValue &params) {
+    OpenDocument &open = document(params);
+    open.result_id = next_result_id++;
+    return JsonValue::Object{{"resultId", std::to_string(open.result_id)},
+                             {"data", to_array(open.document.encode_all())}};
+}
+
+JsonValue LanguageServer::semantic_tokens_delta(const JsonValue &params) {
+    OpenDocument &open = document(params);
+
+    // A delta is only meaningful against the last result we sent for this document
+    const JsonValue &previous = params["previousResultId"];
+    if (open.result_id == 0 || !previous.is_string() || previous.as_string() != std::to_string(open.result_id)) {
+        return semantic_tokens_full(params);
+    }
+
+    Document::TokenEdit edit = open.document.encode_delta();
+    open.result_id = next_result_id++;
+
+    JsonValue::Array edits;
+    if (edit.delete_count > 0 || !edit.data.empty()) {
+        edits.emplace_back(JsonValue::Object{{"start", static_cast<int64_t>(edit.start)},
+                                             {"deleteCount", static_cast<int64_t>(edit.delete_count)},
+                                             {"data", to_array(edit.data)}});
+    }
+    return JsonValue::Object{{"resultId", std::to_string(open.result_id)}, {"edits", std::move(edits)}};
+}
+
+LanguageServer::OpenDocument &LanguageServer::document(const JsonValue &params) {
+    const std::string &uri = params["textDocument"]["uri"].as_string();
+    const auto it = documents.find(uri);
+    if (it == documents.end()) throw JsonError("Document is not open: " + uri);
+    return it->second;
+}
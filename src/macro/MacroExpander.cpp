@@ -0,0 +1,329 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/macro/MacroExpander.h"
+#include "../../include/util/Hash.h"
+
+#include <algorithm>
+
+namespace {
+    bool is_open(TokenType type) {
+        return type == TokenType::LEFT_PAREN || type == TokenType::LEFT_BRACKET || type == TokenType::LEFT_BRACE;
+    }
+
+    bool is_close(TokenType type) {
+        return type == TokenType::RIGHT_PAREN || type == TokenType::RIGHT_BRACKET || type == TokenType::RIGHT_BRACE;
+    }
+
+    bool same_token(const Token &a, const Token &b) {
+        return a.type == b.type && a.lexeme == b.lexeme;
+    }
+
+    // Index of the end-of-file token, or the end of a run that has none
+    size_t end_of(const std::vector<Token> &run) {
+        return !run.empty() && run.back().type == TokenType::END_OF_FILE ? run.size() - 1 : run.size();
+    }
+}
+
+MacroExpander::MacroExpander(std::string filename) : filename(std::move(filename)) {
+}
+
+TokenStream MacroExpander::expand(const TokenStream &tokens, std::vector<Diagnostic> &diagnostics) {
+    this->diagnostics = &diagnostics;
+
+    const TokenRun run = tokens.flatten();
+    const bool uses_macros = std::ranges::any_of(*run, [](const Token &token) {
+        return token.type == TokenType::HASH || token.type == TokenType::AT;
+    });
+    if (!uses_macros) return tokens;
+
+    const size_t end = end_of(*run);
+    TokenStream out = expand_run(run, 0, end, 0);
+    out.append(run, end, run->size()); // the end-of-file token
+    return out;
+}
+
+size_t MacroExpander::cache_hits() const {
+    return hits;
+}
+
+size_t MacroExpander::cache_misses() const {
+    return expansions.size();
+}
+
+TokenStream MacroExpander::expand_run(const TokenRun &run, size_t begin, size_t end, int depth) {
+    const std::vector<Token> &tokens = *run;
+    TokenStream out;
+    size_t literal = begin;
+
+    for (size_t i = begin; i < end;) {
+        const TokenType type = tokens[i].type;
+        const bool named = i + 1 < end && tokens[i + 1].type == TokenType::IDENTIFIER;
+
+        if (type == TokenType::HASH && named && tokens[i + 1].lexeme == "macro") {
+            out.append(run, literal, i);
+            if (depth > 0) error(tokens[i], "Macros cannot be defined inside a macro body");
+            i = define(tokens, i, end);
+            literal = i;
+        } else if (type == TokenType::AT && named) {
+            out.append(run, literal, i);
+            i = invoke(run, i, end, depth, out);
+            literal = i;
+        } else {
+            ++i;
+        }
+    }
+
+    out.append(run, literal, end);
+    return out;
+}
+
+// `#macro name(params) { body }`; returns the index after the definition
+size_t MacroExpander::define(const std::vector<Token> &run, size_t at, size_t end) {
+    size_t i = at + 2;
+
+    if (i >= end || run[i].type != TokenType::IDENTIFIER) {
+        error(run[at + 1], "Expected macro name");
+        return i;
+    }
+
+    Macro macro;
+    macro.name = run[i++].lexeme;
+
+    if (i < end && run[i].type == TokenType::LEFT_PAREN) {
+        ++i;
+        while (i < end && run[i].type == TokenType::IDENTIFIER) {
+            macro.parameters.push_back(run[i++].lexeme);
+            if (i < end && run[i].type == TokenType::COMMA) ++i;
+        }
+        if (i >= end || run[i].type != TokenType::RIGHT_PAREN) {
+            error(run[std::min(i, end - 1)], "Expected ')' after macro parameters");
+            return i;
+        }
+        ++i;
+    }
+
+    if (i >= end || run[i].type != TokenType::LEFT_BRACE) {
+        error(run[std::min(i, end - 1)], "Expected '{' before macro body");
+        return i;
+    }
+
+    const size_t body_begin = ++i;
+    for (int braces = 1; i < end; ++i) {
+        if (run[i].type == TokenType::LEFT_BRACE) ++braces;
+        if (run[i].type == TokenType::RIGHT_BRACE && --braces == 0) break;
+    }
+    if (i >= end) {
+        error(run[at], "Unterminated body of macro '" + macro.name + "'");
+        return end;
+    }
+
+    std::vector<Token> body(run.begin() + static_cast<ptrdiff_t>(body_begin), run.begin() + static_cast<ptrdiff_t>(i));
+    int braces = 0;
+    for (size_t j = 0; j < body.size(); ++j) {
+        const TokenType type = body[j].type;
+        if (type == TokenType::LEFT_BRACE) ++braces;
+        if (type == TokenType::RIGHT_BRACE) --braces;
+        if (type == TokenType::AT) macro.invokes_macros = true;
+
+        const bool binding = type == TokenType::LET || type == TokenType::VAR || type == TokenType::CONST;
+        if (binding && braces > 0 && j + 1 < body.size() && body[j + 1].type == TokenType::IDENTIFIER) {
+            const std::string &name = body[j + 1].lexeme;
+            if (std::ranges::find(macro.parameters, name) == macro.parameters.end() &&
+                std::ranges::find(macro.locals, name) == macro.locals.end()) {
+                macro.locals.push_back(name);
+            }
+        }
+    }
+    macro.body = std::make_shared<const std::vector<Token>>(std::move(body));
+
+    if (macro_ids.contains(macro.name)) {
+        error(run[at + 2], "Redefinition of macro '" + macro.name + "'");
+    } else {
+        macro_ids.emplace(macro.name, macros.size());
+        macros.push_back(std::move(macro));
+    }
+    return i + 1;
+}
+
+// `@name` or `@name(args)`; appends the expansion and returns the index after the invocation
+size_t MacroExpander::invoke(const TokenRun &run, size_t at, size_t end, int depth, TokenStream &out) {
+    const std::vector<Token> &tokens = *run;
+    const Token &name = tokens[at + 1];
+    size_t i = at + 2;
+
+    // Arguments stay where they are in the run until an expansion needs them
+    std::vector<Span> arguments;
+    if (i < end && tokens[i].type == TokenType::LEFT_PAREN) {
+        ++i;
+        int nesting = 0;
+        size_t argument = i;
+        bool closed = false;
+
+        for (; i < end; ++i) {
+            const TokenType type = tokens[i].type;
+            if (nesting == 0 && (type == TokenType::COMMA || type == TokenType::RIGHT_PAREN)) {
+                if (type == TokenType::COMMA || i > argument || !arguments.empty()) arguments.push_back({argument, i});
+                argument = i + 1;
+                if (type == TokenType::RIGHT_PAREN) {
+                    closed = true;
+                    ++i;
+                    break;
+                }
+                continue;
+            }
+            if (is_open(type)) ++nesting;
+            if (is_close(type)) --nesting;
+        }
+
+        if (!closed) {
+            error(name, "Unterminated arguments to macro '" + name.lexeme + "'");
+            return end;
+        }
+    }
+
+    const auto found = macro_ids.find(name.lexeme);
+    if (found == macro_ids.end()) {
+        error(name, "Unknown macro '" + name.lexeme + "'");
+        return i;
+    }
+
+    const size_t expected = macros[found->second].parameters.size();
+    if (arguments.size() != expected) {
+        error(name, "Macro '" + name.lexeme + "' expects " + std::to_string(expected) + " argument(s) but got " +
+                    std::to_string(arguments.size()));
+        return i;
+    }
+
+    const TokenStream expansion = expansion_of(found->second, run, arguments, name, depth + 1);
+    out.append(expansion);
+
+    // A statement macro's body ends in its own '}' or ';', so `@name(...);` needs no empty statement
+    if (!expansion.empty() && i < end && tokens[i].type == TokenType::SEMICOLON) {
+        const TokenType last = expansion[expansion.size() - 1].type;
+        if (last == TokenType::RIGHT_BRACE || last == TokenType::SEMICOLON) ++i;
+    }
+    return i;
+}
+
+TokenStream MacroExpander::expansion_of(size_t macro, const TokenRun &run, const std::vector<Span> &arguments,
+                                        const Token &site, int depth) {
+    if (depth > MAX_DEPTH) {
+        if (!too_deep) error(site, "Macro '" + site.lexeme + "' nests deeper than " + std::to_string(MAX_DEPTH) + " expansions");
+        too_deep = true;
+        return {};
+    }
+
+    const std::vector<Token> &tokens = *run;
+    const auto span_of = [&](const Span &span) {
+        return std::ranges::subrange(tokens.begin() + static_cast<ptrdiff_t>(span.begin),
+                                     tokens.begin() + static_cast<ptrdiff_t>(span.end));
+    };
+
+    uint64_t key = hash_combine(FNV_OFFSET_BASIS, macro);
+    for (const auto &argument : arguments) {
+        key = hash_combine(key, argument.end - argument.begin);
+        for (const Token &token : span_of(argument)) {
+            key = fnv1a(token.lexeme, hash_combine(key, static_cast<uint64_t>(token.type)));
+        }
+    }
+
+    for (auto [it, last] = cache.equal_range(key); it != last; ++it) {
+        const Expansion &cached = expansions[it->second];
+        const bool same = cached.macro == macro &&
+                          std::ranges::equal(cached.arguments, arguments, [&](const auto &a, const Span &b) {
+                              return std::ranges::equal(a, span_of(b), same_token);
+                          });
+        if (same) {
+            ++hits;
+            return relocate(cached, tokens, arguments);
+        }
+    }
+
+    // Arguments are expanded before substitution, like C's argument prescan
+    std::vector<TokenStream> expanded;
+    expanded.reserve(arguments.size());
+    for (const auto &argument : arguments) expanded.push_back(expand_run(run, argument.begin, argument.end, depth));
+
+    const Macro &definition = macros[macro];
+    const TokenRun body = hygienic_body(definition, next_local_id++);
+    const std::vector<std::string> &parameters = definition.parameters;
+    const bool rescan = definition.invokes_macros;
+
+    TokenStream result;
+    size_t literal = 0;
+    for (size_t i = 0; i < body->size(); ++i) {
+        const Token &token = (*body)[i];
+        if (token.type != TokenType::IDENTIFIER) continue;
+
+        const auto parameter = std::ranges::find(parameters, token.lexeme);
+        if (parameter == parameters.end()) continue;
+
+        result.append(body, literal, i);
+        result.append(expanded[static_cast<size_t>(parameter - parameters.begin())]);
+        literal = i + 1;
+    }
+    result.append(body, literal, body->size());
+
+    if (result.size() > MAX_TOKENS) {
+        if (!over_budget) error(site, "Macro expansion produces more than " + std::to_string(MAX_TOKENS) + " tokens");
+        over_budget = true;
+        return {};
+    }
+
+    if (rescan) {
+        const TokenRun substituted = result.flatten();
+        result = expand_run(substituted, 0, substituted->size(), depth);
+    }
+
+    Expansion entry{macro, {}, result};
+    for (const auto &argument : arguments) entry.arguments.emplace_back(span_of(argument).begin(), span_of(argument).end());
+    cache.emplace(key, expansions.size());
+    expansions.push_back(std::move(entry));
+    return result;
+}
+
+// A cached expansion's argument tokens still carry the positions of the call
+// that expanded it first; moves them to the call at `arguments` in `tokens`, so
+// diagnostics in the expansion point at the call they came from
+TokenStream MacroExpander::relocate(const Expansion &cached, const std::vector<Token> &tokens,
+                                    const std::vector<Span> &arguments) {
+    std::unordered_map<uint32_t, std::pair<const Token *, const Token *>> moved; // by offset: from, to
+    for (size_t a = 0; a < arguments.size(); ++a) {
+        for (size_t t = 0; t < cached.arguments[a].size(); ++t) {
+            const Token &from = cached.arguments[a][t];
+            const Token &to = tokens[arguments[a].begin + t];
+            if (from.offset != to.offset || from.line != to.line || from.column != to.column) {
+                moved.try_emplace(from.offset, &from, &to);
+            }
+        }
+    }
+    if (moved.empty()) return cached.tokens; // the same call again, or tokens that came out of one body
+
+    return cached.tokens.relocated([&](const Token &token) -> const Token * {
+        const auto found = moved.find(token.offset);
+        if (found == moved.end()) return nullptr;
+        const Token &from = *found->second.first;
+        return token.line == from.line && token.column == from.column ? found->second.second : nullptr;
+    });
+}
+
+// The body with its local temporaries renamed apart; shared as-is when it declares none.
+// '#' cannot appear in an identifier, so no source name can collide with a renamed one.
+TokenRun MacroExpander::hygienic_body(const Macro &macro, size_t expansion_id) {
+    if (macro.locals.empty()) return macro.body;
+
+    auto body = std::make_shared<std::vector<Token>>(*macro.body);
+    const std::string suffix = "#" + std::to_string(expansion_id);
+    for (auto &token : *body) {
+        if (token.type == TokenType::IDENTIFIER && std::ranges::find(macro.locals, token.lexeme) != macro.locals.end()) {
+            token.lexeme += suffix;
+        }
+    }
+    return body;
+}
+
+void MacroExpander::error(const Token &token, const std::string &message) {
+    diagnostics->push_back({Severity::Error, filename, token.line, token.column, message});
+}
@@ -0,0 +1,100 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/macro/TokenStream.h"
+
+#include <algorithm>
+
+TokenStream::TokenStream(std::vector<Token> tokens) {
+    const size_t count = tokens.size();
+    append(std::make_shared<const std::vector<Token>>(std::move(tokens)), 0, count);
+}
+
+void TokenStream::append(const TokenRun &run, size_t begin, size_t end) {
+    if (begin >= end) return;
+
+    // Adjacent slices of the same run merge, so plain source stays one slice
+    if (!slices.empty() && slices.back().run == run && slices.back().end == begin) {
+        slices.back().end = end;
+    } else {
+        slices.push_back({run, begin, end, total});
+    }
+    total += end - begin;
+}
+
+void TokenStream::append(const TokenStream &other) {
+    for (const auto &slice : other.slices) append(slice.run, slice.begin, slice.end);
+}
+
+size_t TokenStream::size() const {
+    return total;
+}
+
+bool TokenStream::empty() const {
+    return total == 0;
+}
+
+size_t TokenStream::slice_count() const {
+    return slices.size();
+}
+
+const Token &TokenStream::operator[](size_t index) const {
+    const auto contains = [&](size_t i) {
+        return i < slices.size() && index >= slices[i].start &&
+               index < slices[i].start + (slices[i].end - slices[i].begin);
+    };
+
+    if (!contains(hint)) {
+        if (contains(hint + 1)) {
+            ++hint;
+        } else {
+            const auto it = std::ranges::upper_bound(slices, index, {}, &Slice::start);
+            hint = static_cast<size_t>(it - slices.begin()) - 1;
+        }
+    }
+
+    const Slice &slice = slices[hint];
+    return (*slice.run)[slice.begin + (index - slice.start)];
+}
+
+TokenRun TokenStream::flatten() const {
+    if (slices.size() == 1 && slices[0].begin == 0 && slices[0].end == slices[0].run->size()) {
+        return slices[0].run;
+    }
+
+    std::vector<Token> tokens;
+    tokens.reserve(total);
+    for (const auto &slice : slices) {
+        tokens.insert(tokens.end(), slice.run->begin() + static_cast<ptrdiff_t>(slice.begin),
+                      slice.run->begin() + static_cast<ptrdiff_t>(slice.end));
+    }
+    return std::make_shared<const std::vector<Token>>(std::move(tokens));
+}
+
+TokenStream TokenStream::relocated(const std::function<const Token *(const Token &)> &position_of) const {
+    TokenStream result;
+    for (const auto &slice : slices) {
+        std::shared_ptr<std::vector<Token>> copy; // made on the slice's first move
+        for (size_t i = slice.begin; i < slice.end; ++i) {
+            const Token *position = position_of((*slice.run)[i]);
+            if (!position) continue;
+
+            if (!copy) {
+                copy = std::make_shared<std::vector<Token>>(slice.run->begin() + static_cast<ptrdiff_t>(slice.begin),
+                                                            slice.run->begin() + static_cast<ptrdiff_t>(slice.end));
+            }
+            Token &token = (*copy)[i - slice.begin];
+            token.line = position->line;
+            token.column = position->column;
+            token.offset = position->offset;
+        }
+
+        if (copy) {
+            result.append(std::move(copy), 0, slice.end - slice.begin);
+        } else {
+            result.append(slice.run, slice.begin, slice.end);
+        }
+    }
+    return result;
+}
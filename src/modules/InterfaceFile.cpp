@@ -0,0 +1,212 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/modules/InterfaceFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr uint32_t INTERFACE_MAGIC = 0x494b5053; // "SPKI"
+    constexpr uint32_t INTERFACE_FORMAT = 1;
+}
+
+// Layout: Header, SymbolRecord[symbol_count], StringRef[parameter_count], string pool.
+// Every field is naturally aligned so records can be read in place from the mapping.
+struct InterfaceFile::StringRef {
+    uint32_t offset; // into the string pool
+    uint32_t length;
+};
+
+struct InterfaceFile::Header {
+    uint32_t magic;
+    uint32_t format;
+    uint64_t content_hash;
+    uint64_t interface_hash;
+    StringRef module;
+    uint32_t symbol_count;
+    uint32_t parameter_count;
+    uint32_t pool_size;
+    uint32_t reserved;
+};
+
+struct InterfaceFile::SymbolRecord {
+    StringRef name;
+    StringRef type;
+    uint32_t first_parameter;
+    uint16_t parameter_count;
+    uint8_t kind;
+    uint8_t visibility;
+};
+
+std::string InterfaceFile::path_for(const std::string &dir, const std::string &module) {
+    return dir + "/" + module + EXTENSION;
+}
+
+bool InterfaceFile::write(const std::string &path, const ModuleInterface &interface, uint64_t content_hash,
+                          uint64_t interface_hash) {
+    std::string pool;
+    std::vector<SymbolRecord> symbols;
+    std::vector<StringRef> parameters;
+
+    auto add = [&pool](std::string_view value) {
+        const StringRef ref{static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(value.size())};
+        pool.append(value);
+        return ref;
+    };
+
+    const StringRef module = add(interface.module);
+    for (const auto &symbol : interface.symbols) {
+        const bool exported = symbol.visibility != Visibility::Private;
+        SymbolRecord record{add(symbol.name), exported ? add(symbol.type) : StringRef{0, 0},
+                            static_cast<uint32_t>(parameters.size()), 0,
+                            static_cast<uint8_t>(symbol.kind), static_cast<uint8_t>(symbol.visibility)};
+        if (exported) {
+            for (const auto &parameter : symbol.parameter_types) parameters.push_back(add(parameter));
+            record.parameter_count = static_cast<uint16_t>(symbol.parameter_types.size());
+        }
+        symbols.push_back(record);
+    }
+
+    const Header header{INTERFACE_MAGIC, INTERFACE_FORMAT, content_hash, interface_hash, module,
+                        static_cast<uint32_t>(symbols.size()), static_cast<uint32_t>(parameters.size()),
+                        static_cast<uint32_t>(pool.size()), 0};
+
+    const std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char *>(&header), sizeof header);
+        file.write(reinterpret_cast<const char *>(symbols.data()),
+                   static_cast<std::streamsize>(symbols.size() * sizeof(SymbolRecord)));
+        file.write(reinterpret_cast<const char *>(parameters.data()),
+                   static_cast<std::streamsize>(parameters.size() * sizeof(StringRef)));
+        file.write(pool.data(), static_cast<std::streamsize>(pool.size()));
+        if (!file) return false;
+    }
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+std::optional<InterfaceFile> InterfaceFile::open(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return std::nullopt;
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    const auto size = static_cast<size_t>(info.st_size);
+    void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file alive
+    if (mapping == MAP_FAILED) return std::nullopt;
+
+    InterfaceFile file(static_cast<const char *>(mapping), size);
+    if (!file.valid()) return std::nullopt;
+    return file;
+}
+
+InterfaceFile::InterfaceFile(const char *data, size_t size) : data(data), size(size) {
+}
+
+InterfaceFile::InterfaceFile(InterfaceFile &&other) noexcept
+    : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {
+}
+
+InterfaceFile &InterfaceFile::operator=(InterfaceFile &&other) noexcept {
+    if (this != &other) {
+        if (data) ::munmap(const_cast<char *>(data), size);
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
+InterfaceFile::~InterfaceFile() {
+    if (data) ::munmap(const_cast<char *>(data), size);
+}
+
+const InterfaceFile::Header &InterfaceFile::header() const {
+    return *reinterpret_cast<const Header *>(data);
+}
+
+std::string_view InterfaceFile::text(const StringRef &ref) const {
+    const Header &h = header();
+    const char *pool = data + sizeof(Header) + h.symbol_count * sizeof(SymbolRecord) +
+                       h.parameter_count * sizeof(StringRef);
+    return {pool + ref.offset, ref.length};
+}
+
+bool InterfaceFile::valid() const {
+    const Header &h = header();
+    if (h.magic != INTERFACE_MAGIC || h.format != INTERFACE_FORMAT) return false;
+
+    const uint64_t expected = sizeof(Header) + uint64_t{h.symbol_count} * sizeof(SymbolRecord) +
+                              uint64_t{h.parameter_count} * sizeof(StringRef) + h.pool_size;
+    if (expected != size) return false;
+
+    auto in_pool = [&](const StringRef &ref) { return uint64_t{ref.offset} + ref.length <= h.pool_size; };
+    if (!in_pool(h.module)) return false;
+
+    const auto *symbols = reinterpret_cast<const SymbolRecord *>(data + sizeof(Header));
+    const auto *parameters = reinterpret_cast<const StringRef *>(symbols + h.symbol_count);
+    for (uint32_t i = 0; i < h.symbol_count; ++i) {
+        const SymbolRecord &symbol = symbols[i];
+        if (!in_pool(symbol.name) || !in_pool(symbol.type) ||
+            uint64_t{symbol.first_parameter} + symbol.parameter_count > h.parameter_count) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < h.parameter_count; ++i) {
+        if (!in_pool(parameters[i])) return false;
+    }
+    return true;
+}
+
+std::string_view InterfaceFile::module() const {
+    return text(header().module);
+}
+
+uint64_t InterfaceFile::content_hash() const {
+    return header().content_hash;
+}
+
+uint64_t InterfaceFile::interface_hash() const {
+    return header().interface_hash;
+}
+
+size_t InterfaceFile::symbol_count() const {
+    return header().symbol_count;
+}
+
+ModuleInterface InterfaceFile::to_interface() const {
+    const Header &h = header();
+    const auto *symbols = reinterpret_cast<const SymbolRecord *>(data + sizeof(Header));
+    const auto *parameters = reinterpret_cast<const StringRef *>(symbols + h.symbol_count);
+
+    ModuleInterface interface;
+    interface.module = module();
+    interface.symbols.reserve(h.symbol_count);
+
+    for (uint32_t i = 0; i < h.symbol_count; ++i) {
+        const SymbolRecord &record = symbols[i];
+        ExportedSymbol symbol{std::string(text(record.name)), static_cast<SymbolKind>(record.kind),
+                              static_cast<Visibility>(record.visibility), std::string(text(record.type)), {}};
+        for (uint16_t p = 0; p < record.parameter_count; ++p) {
+            symbol.parameter_types.emplace_back(text(parameters[record.first_parameter + p]));
+        }
+        interface.symbols.push_back(std::move(symbol));
+    }
+
+    return interface;
+}
@@ -0,0 +1,373 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/modules/ModuleGraph.h"
+#include "../../include/driver/Driver.h"
+#include "../../include/lexer/Lexer.h"
+#include "../../include/util/Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr size_t INITIAL_HEADER_CHUNK = 4096;
+
+    enum class ScanState { Done, NeedMore };
+
+    // Parse `module` / `import` / `use` declarations from the start of `text`.
+    // NeedMore means the prologue may continue past the end of the buffer.
+    ScanState scan_prologue(const std::string &text, bool complete, ModuleHeader &header) {
+        Lexer lexer(text, header.path);
+        header.imports.clear();
+
+        while (true) {
+            Token keyword = lexer.next_token();
+            if (keyword.type == TokenType::END_OF_FILE) return complete ? ScanState::Done : ScanState::NeedMore;
+            if (keyword.type != TokenType::MODULE && keyword.type != TokenType::IMPORT && keyword.type != TokenType::USE) {
+                // A token running into the end of the buffer may have been cut short
+                return complete || lexer.has_more_tokens() ? ScanState::Done : ScanState::NeedMore;
+            }
+
+            std::string name;
+            Token token = lexer.next_token();
+            while (token.type == TokenType::IDENTIFIER) {
+                name += token.lexeme;
+                token = lexer.next_token();
+                if (token.type != TokenType::DOT && token.type != TokenType::DOUBLE_COLON) break;
+                name += ".";
+                token = lexer.next_token();
+            }
+
+            if (token.type == TokenType::END_OF_FILE && !complete) return ScanState::NeedMore;
+            // Malformed declarations are left for the parser to report
+            if (token.type != TokenType::SEMICOLON || name.empty() || name.back() == '.') return ScanState::Done;
+
+            if (keyword.type == TokenType::MODULE) {
+                header.module = name;
+            } else {
+                header.imports.push_back({name, keyword.line, keyword.column});
+            }
+        }
+    }
+
+    std::string normalise(const std::string &path) {
+        std::error_code ec;
+        return fs::absolute(path, ec).lexically_normal().string();
+    }
+}
+
+ModuleHeader ModuleGraph::scan_header(const std::string &path) {
+    TraceScope trace("scan", path);
+    ModuleHeader header;
+    header.path = path;
+    header.module = fs::path(path).stem().string();
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        header.error = "Could not open file: " + path;
+        return header;
+    }
+
+    std::string text;
+    for (size_t chunk = INITIAL_HEADER_CHUNK;; chunk *= 2) {
+        const size_t offset = text.size();
+        text.resize(offset + chunk);
+        in.read(text.data() + offset, static_cast<std::streamsize>(chunk));
+        text.resize(offset + static_cast<size_t>(in.gcount()));
+
+        const std::string fallback = header.module;
+        if (scan_prologue(text, !in, header) == ScanState::Done) return header;
+        header.module = fallback;
+    }
+}
+
+ModuleGraph ModuleGraph::build(const std::vector<std::string> &inputs, const std::vector<std::string> &search_paths,
+                               WorkStealingPool &pool) {
+    ModuleGraph graph;
+
+    std::vector<ModuleHeader> scanned(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        pool.submit([&, i] { scanned[i] = scan_header(inputs[i]); });
+    }
+    pool.wait();
+
+    std::unordered_set<std::string> seen;
+    for (auto &header : scanned) {
+        if (seen.insert(normalise(header.path)).second) graph.add_node(std::move(header));
+    }
+
+    auto register_module = [&](size_t node) {
+        const auto [it, inserted] = graph.providers.emplace(graph.headers[node].module, node);
+        if (!inserted) {
+            graph.problems.push_back({Severity::Error, graph.headers[node].path, 1, 1,
+                                      "Module '" + graph.headers[node].module + "' is also declared by " +
+                                      graph.headers[it->second].path});
+        }
+    };
+    for (size_t node = 0; node < graph.size(); ++node) register_module(node);
+
+    // Pull in imported modules that were not given on the command line
+    for (size_t node = 0; node < graph.size(); ++node) {
+        for (const auto &import : graph.headers[node].imports) {
+            if (graph.providers.contains(import.module)) continue;
+
+            std::string relative = import.module;
+            std::ranges::replace(relative, '.', '/');
+            relative += Driver::SOURCE_EXTENSION;
+
+            std::vector<fs::path> roots{fs::path(graph.headers[node].path).parent_path()};
+            roots.insert(roots.end(), search_paths.begin(), search_paths.end());
+
+            for (const auto &root : roots) {
+                const fs::path candidate = root / relative;
+                std::error_code ec;
+                if (!fs::is_regular_file(candidate, ec) || !seen.insert(normalise(candidate.string())).second) continue;
+
+                ModuleHeader header = scan_header(candidate.string());
+                if (header.module != import.module) continue; // declares some other module
+                graph.add_node(std::move(header));
+                register_module(graph.size() - 1);
+                break;
+            }
+        }
+    }
+
+    graph.link();
+    graph.find_cycles();
+    return graph;
+}
+
+void ModuleGraph::add_node(ModuleHeader header) {
+    headers.push_back(std::move(header));
+}
+
+void ModuleGraph::link() {
+    edges.assign(size(), {});
+    dependents.assign(size(), {});
+
+    for (size_t node = 0; node < size(); ++node) {
+        for (const auto &import : headers[node].imports) {
+            const size_t target = find(import.module);
+            if (target == SIZE_MAX || std::ranges::find(edges[node], target) != edges[node].end()) continue;
+            edges[node].push_back(target);
+            dependents[target].push_back(node);
+        }
+    }
+}
+
+size_t ModuleGraph::find(const std::string &module) const {
+    const auto it = providers.find(module);
+    return it != providers.end() ? it->second : SIZE_MAX;
+}
+
+// Tarjan's strongly connected components, iteratively so long import chains
+// cannot overflow the stack
+void ModuleGraph::find_cycles() {
+    const size_t n = size();
+    constexpr size_t UNVISITED = SIZE_MAX;
+
+    std::vector<size_t> order(n, UNVISITED), low(n, 0);
+    std::vector<char> on_stack(n, 0);
+    std::vector<size_t> stack;
+    std::vector<std::pair<size_t, size_t>> frames; // node, next edge
+    component.assign(n, 0);
+    size_t counter = 0, components = 0;
+
+    for (size_t root = 0; root < n; ++root) {
+        if (order[root] != UNVISITED) continue;
+        frames.emplace_back(root, 0);
+
+        while (!frames.empty()) {
+            auto &[node, next] = frames.back();
+            if (next == 0 && order[node] == UNVISITED) {
+                order[node] = low[node] = counter++;
+                stack.push_back(node);
+                on_stack[node] = 1;
+            }
+
+            if (next < edges[node].size()) {
+                const size_t target = edges[node][next++];
+                if (order[target] == UNVISITED) {
+                    frames.emplace_back(target, 0);
+                } else if (on_stack[target]) {
+                    low[node] = std::min(low[node], order[target]);
+                }
+                continue;
+            }
+
+            if (low[node] == order[node]) {
+                size_t member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    on_stack[member] = 0;
+                    component[member] = components;
+                } while (member != node);
+                ++components;
+            }
+
+            const size_t finished = node;
+            frames.pop_back();
+            if (!frames.empty()) low[frames.back().first] = std::min(low[frames.back().first], low[finished]);
+        }
+    }
+
+    // Report each cycle once, walking it from its first node
+    std::vector<char> reported(components, 0);
+    for (size_t node = 0; node < n; ++node) {
+        const bool self_import = std::ranges::find(edges[node], node) != edges[node].end();
+        const bool in_cycle = std::ranges::any_of(edges[node], [&](size_t target) {
+            return target != node && component[target] == component[node];
+        });
+        if ((!self_import && !in_cycle) || reported[component[node]]) continue;
+        reported[component[node]] = 1;
+
+        std::string path = headers[node].module;
+        size_t current = node;
+        std::vector<char> visited(n, 0);
+        do {
+            visited[current] = 1;
+            current = *std::ranges::find_if(edges[current], [&](size_t target) {
+                return component[target] == component[node];
+            });
+            path += " -> " + headers[current].module;
+        } while (!visited[current]);
+
+        const auto &import = *std::ranges::find_if(headers[node].imports, [&](const ImportReference &ref) {
+            const size_t target = find(ref.module);
+            return target != SIZE_MAX && component[target] == component[node];
+        });
+        problems.push_back({Severity::Error, headers[node].path, import.line, import.column, "Import cycle: " + path});
+    }
+}
+
+bool ModuleGraph::in_cycle(size_t node) const {
+    return std::ranges::any_of(edges[node], [&](size_t target) { return component[target] == component[node]; });
+}
+
+bool ModuleGraph::counts(size_t from, size_t to) const {
+    return component[from] != component[to];
+}
+
+std::vector<size_t> ModuleGraph::topological_order() const {
+    std::vector<size_t> remaining(size(), 0), order;
+    order.reserve(size());
+
+    for (size_t node = 0; node < size(); ++node) {
+        for (const size_t dependency : edges[node]) remaining[node] += counts(node, dependency);
+        if (remaining[node] == 0) order.push_back(node);
+    }
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (const size_t importer : dependents[order[i]]) {
+            if (counts(importer, order[i]) && --remaining[importer] == 0) order.push_back(importer);
+        }
+    }
+
+    return order;
+}
+
+size_t ModuleGraph::size() const {
+    return headers.size();
+}
+
+const ModuleHeader &ModuleGraph::header(size_t node) const {
+    return headers[node];
+}
+
+const std::vector<size_t> &ModuleGraph::dependencies(size_t node) const {
+    return edges[node];
+}
+
+const std::vector<Diagnostic> &ModuleGraph::diagnostics() const {
+    return problems;
+}
+
+std::vector<double> ModuleGraph::schedule(WorkStealingPool &pool, const std::function<void(size_t)> &work) const {
+    std::vector<double> durations(size(), 0);
+
+    auto timed = [&](size_t node) {
+        const auto start = std::chrono::steady_clock::now();
+        work(node);
+        durations[node] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // An inline pool would recurse once per link of a chain; just walk the order
+    if (pool.size() == 1) {
+        for (const size_t node : topological_order()) timed(node);
+        return durations;
+    }
+
+    std::vector<std::atomic<size_t>> remaining(size());
+    for (size_t node = 0; node < size(); ++node) {
+        size_t count = 0;
+        for (const size_t dependency : edges[node]) count += counts(node, dependency);
+        remaining[node].store(count, std::memory_order_relaxed);
+    }
+
+    std::function<void(size_t)> run = [&](size_t node) {
+        timed(node);
+        for (const size_t importer : dependents[node]) {
+            if (counts(importer, node) && remaining[importer].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                pool.submit([&run, importer] { run(importer); });
+            }
+        }
+    };
+
+    for (size_t node = 0; node < size(); ++node) {
+        if (remaining[node].load(std::memory_order_relaxed) == 0) pool.submit([&run, node] { run(node); });
+    }
+    pool.wait();
+
+    return durations;
+}
+
+ModuleGraph::CriticalPath ModuleGraph::critical_path(const std::vector<double> &durations) const {
+    CriticalPath path;
+    std::vector<double> finish(size(), 0);
+    std::vector<size_t> previous(size(), SIZE_MAX);
+
+    for (const size_t node : topological_order()) {
+        double start = 0;
+        for (const size_t dependency : edges[node]) {
+            if (counts(node, dependency) && finish[dependency] > start) {
+                start = finish[dependency];
+                previous[node] = dependency;
+            }
+        }
+        finish[node] = start + durations[node];
+        path.work_ms += durations[node];
+    }
+
+    if (size() == 0) return path;
+
+    size_t node = static_cast<size_t>(std::ranges::max_element(finish) - finish.begin());
+    path.total_ms = finish[node];
+    for (; node != SIZE_MAX; node = previous[node]) path.modules.push_back(node);
+    std::ranges::reverse(path.modules);
+
+    return path;
+}
+
+void ModuleGraph::print_critical_path(std::ostream &out, const std::vector<double> &durations) const {
+    const CriticalPath path = critical_path(durations);
+
+    out << std::fixed << std::setprecision(2);
+    out << "Critical path: " << path.total_ms << " ms over " << path.modules.size() << " module(s), "
+        << path.work_ms << " ms total work across " << size() << " module(s)\n";
+
+    for (const size_t node : path.modules) {
+        out << "  " << std::left << std::setw(24) << headers[node].module << std::right
+            << std::setw(10) << durations[node] << " ms  " << headers[node].path << "\n";
+    }
+    out << std::defaultfloat;
+}
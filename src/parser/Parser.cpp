@@ -3,3 +3,491 @@
 //
 
 #include "../../include/parser/Parser.h"
+#include "../../include/util/TimeStats.h"
+
+#include <utility>
+
+namespace {
+#ifdef SPARKC_TIME_INSTRUMENT
+    thread_local uint64_t nodes_built = 0; // for the time report
+#endif
+
+    template<typename T>
+    std::unique_ptr<T> located(std::unique_ptr<T> node, const Token &token) {
+#ifdef SPARKC_TIME_INSTRUMENT
+        ++nodes_built;
+#endif
+        node->line = token.line;
+        node->column = token.column;
+        return node;
+    }
+
+    bool is_type_keyword(TokenType type) {
+        switch (type) {
+            case TokenType::INT8: case TokenType::INT16: case TokenType::INT32: case TokenType::INT64:
+            case TokenType::UINT8: case TokenType::UINT16: case TokenType::UINT32: case TokenType::UINT64:
+            case TokenType::FLOAT8: case TokenType::FLOAT16: case TokenType::FLOAT32: case TokenType::FLOAT64:
+            case TokenType::DOUBLE:
+            case TokenType::STRING:
+            case TokenType::BOOLEAN:
+            case TokenType::CHAR:
+            case TokenType::IDENTIFIER:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool is_integer_literal(TokenType type) {
+        switch (type) {
+            case TokenType::INT8_LITERAL: case TokenType::INT16_LITERAL: case TokenType::INT32_LITERAL:
+            case TokenType::INT64_LITERAL: case TokenType::UINT8_LITERAL: case TokenType::UINT16_LITERAL:
+            case TokenType::UINT32_LITERAL: case TokenType::UINT64_LITERAL:
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
+Parser::Parser(const TokenStream &tokens, std::string filename)
+    : tokens(tokens), filename(std::move(filename)) {
+}
+
+const std::vector<Diagnostic> &Parser::diagnostics() const {
+    return errors;
+}
+
+std::unique_ptr<Program> Parser::parseProgram() {
+    auto program = std::make_unique<Program>();
+#ifdef SPARKC_TIME_INSTRUMENT
+    const uint64_t nodes_before = nodes_built;
+#endif
+
+    while (!isAtEnd()) {
+        const size_t before = current;
+        try {
+            program->statements.push_back(parseUnit());
+        } catch (const ParseError &err) {
+            report(err);
+            synchronize();
+            if (current == before) ++current; // a stray '}' at top level
+        }
+    }
+
+#ifdef SPARKC_TIME_INSTRUMENT
+    TimeStats::count(Throughput::Nodes, nodes_built - nodes_before + 1);
+#endif
+    return program;
+}
+
+// ===== HELPERS =====
+
+bool Parser::isAtEnd() const {
+    return peek().type == TokenType::END_OF_FILE;
+}
+
+const Token &Parser::peek() const {
+    return tokens[current];
+}
+
+const Token &Parser::previous() const {
+    return tokens[current - 1];
+}
+
+bool Parser::check(TokenType type) const {
+    if (isAtEnd()) return false;
+    return peek().type == type;
+}
+
+bool Parser::match(std::initializer_list<TokenType> types) {
+    for (TokenType type : types) {
+        if (check(type)) {
+            ++current;
+            return true;
+        }
+    }
+    return false;
+}
+
+const Token &Parser::consume(TokenType type, const std::string &errMsg) {
+    if (check(type)) return tokens[current++];
+    throw error(peek(), errMsg);
+}
+
+ParseError Parser::error(const Token &token, const std::string &message) const {
+    if (token.type == TokenType::END_OF_FILE) return {token, message + " at end of file"};
+    return {token, message + " near '" + token.lexeme + "'"};
+}
+
+void Parser::report(const ParseError &err) {
+    errors.push_back({Severity::Error, filename, err.token.line, err.token.column, err.what()});
+}
+
+// Skip ahead to the start of the next statement after a syntax error
+void Parser::synchronize() {
+    if (!isAtEnd() && !check(TokenType::RIGHT_BRACE)) ++current;
+
+    while (!isAtEnd()) {
+        if (previous().type == TokenType::SEMICOLON) return;
+
+        switch (peek().type) {
+            case TokenType::FUNC:
+            case TokenType::ASYNC:
+            case TokenType::MODULE:
+            case TokenType::IMPORT:
+            case TokenType::USE:
+            case TokenType::LET:
+            case TokenType::VAR:
+            case TokenType::CONST:
+            case TokenType::IF:
+            case TokenType::WHILE:
+            case TokenType::RETURN:
+            case TokenType::RIGHT_BRACE:
+                return;
+            default:
+                ++current;
+        }
+    }
+}
+
+// ===== DECLARATIONS =====
+
+std::unique_ptr<ASTNode> Parser::parseUnit() {
+    if (match({TokenType::MODULE})) {
+        const Token &keyword = previous();
+        auto module = located(std::make_unique<ModuleDeclaration>(parseQualifiedName()), keyword);
+        consume(TokenType::SEMICOLON, "Expected ';' after module name");
+        return module;
+    }
+
+    if (match({TokenType::IMPORT, TokenType::USE})) {
+        const Token &keyword = previous();
+        auto import = located(std::make_unique<ImportDeclaration>(parseQualifiedName()), keyword);
+        consume(TokenType::SEMICOLON, "Expected ';' after import");
+        return import;
+    }
+
+    const Visibility visibility = parseModifiers();
+
+    if (match({TokenType::FUNC})) return parseFunctionDecl(visibility);
+    if (match({TokenType::ASYNC})) {
+        consume(TokenType::FUNC, "Expected 'func' after 'async'");
+        auto function = parseFunctionDecl(visibility);
+        function->is_async = true;
+        return function;
+    }
+    if (match({TokenType::LET, TokenType::VAR, TokenType::CONST})) return parseVarDecl(visibility);
+
+    return parseStatement();
+}
+
+Visibility Parser::parseModifiers() {
+    Visibility visibility = Visibility::Private;
+
+    while (match({TokenType::PUBLIC, TokenType::PRIVATE, TokenType::INTERNAL})) {
+        visibility = scopeFromString(previous().lexeme);
+    }
+
+    return visibility;
+}
+
+std::unique_ptr<FunctionDeclaration> Parser::parseFunctionDecl(Visibility visibility) {
+    const Token &name = consume(TokenType::IDENTIFIER, "Expected function name");
+    consume(TokenType::LEFT_PAREN, "Expected '(' after function name");
+
+    std::vector<std::string> parameters;
+    std::vector<std::string> parameterTypes;
+    if (!check(TokenType::RIGHT_PAREN)) {
+        do {
+            parameters.push_back(consume(TokenType::IDENTIFIER, "Expected parameter name").lexeme);
+            parameterTypes.push_back(match({TokenType::COLON}) ? parseTypeName() : "");
+        } while (match({TokenType::COMMA}));
+    }
+    consume(TokenType::RIGHT_PAREN, "Expected ')' after parameters");
+
+    auto function = located(std::make_unique<FunctionDeclaration>(name.lexeme, std::move(parameters)), name);
+    function->parameter_types = std::move(parameterTypes);
+    function->visibility = visibility;
+
+    if (match({TokenType::ARROW, TokenType::COLON})) {
+        function->return_type = parseTypeName();
+    }
+
+    auto block = parseBlock();
+    for (auto &statement : block->statements) {
+        function->body.push_back(std::move(statement));
+    }
+
+    return function;
+}
+
+std::unique_ptr<VariableDeclaration> Parser::parseVarDecl(Visibility visibility) {
+    const TokenType kind = previous().type;
+    const Token &name = consume(TokenType::IDENTIFIER, "Expected variable name");
+
+    std::string typeName;
+    if (match({TokenType::COLON})) typeName = parseTypeName();
+
+    std::unique_ptr<Expression> initializer;
+    if (match({TokenType::EQUAL})) initializer = parseExpression();
+
+    consume(TokenType::SEMICOLON, "Expected ';' after variable declaration");
+
+    auto declaration = located(std::make_unique<VariableDeclaration>(kind, name.lexeme, std::move(typeName), std::move(initializer)), name);
+    declaration->visibility = visibility;
+    return declaration;
+}
+
+// A type keyword or name, or `[element; length]` where the length is an integer
+// literal or the name of a constant
+std::string Parser::parseTypeName() {
+    if (match({TokenType::LEFT_BRACKET})) {
+        std::string element = parseTypeName();
+        consume(TokenType::SEMICOLON, "Expected ';' after array element type");
+        const Token &length = peek();
+        if (length.type != TokenType::IDENTIFIER && !is_integer_literal(length.type)) {
+            throw error(length, "Expected array length");
+        }
+        ++current;
+        consume(TokenType::RIGHT_BRACKET, "Expected ']' after array length");
+        return "[" + element + "; " + length.lexeme + "]";
+    }
+
+    if (!is_type_keyword(peek().type) || isAtEnd()) throw error(peek(), "Expected type name");
+    return tokens[current++].lexeme;
+}
+
+// a.b.c or a::b::c, normalised to dots
+std::string Parser::parseQualifiedName() {
+    std::string name = consume(TokenType::IDENTIFIER, "Expected module name").lexeme;
+    while (match({TokenType::DOT, TokenType::DOUBLE_COLON})) {
+        name += "." + consume(TokenType::IDENTIFIER, "Expected module name").lexeme;
+    }
+    return name;
+}
+
+// ===== STATEMENTS =====
+
+std::unique_ptr<Statement> Parser::parseStatement() {
+    if (match({TokenType::IF})) return parseIfStmt();
+    if (match({TokenType::WHILE})) return parseWhileStmt();
+    if (match({TokenType::RETURN})) return parseReturnStmt();
+    if (check(TokenType::LEFT_BRACE)) return parseBlock();
+    if (match({TokenType::LET, TokenType::VAR, TokenType::CONST})) return parseVarDecl(Visibility::Private);
+
+    return parseExprStmt();
+}
+
+std::unique_ptr<Statement> Parser::parseIfStmt() {
+    const Token &keyword = previous();
+    auto condition = parseExpression();
+    std::unique_ptr<Statement> thenBranch = parseBlock();
+
+    std::unique_ptr<Statement> elseBranch;
+    if (match({TokenType::ELSE})) {
+        elseBranch = match({TokenType::IF}) ? parseIfStmt() : parseBlock();
+    }
+
+    return located(std::make_unique<IfStatement>(std::move(condition), std::move(thenBranch), std::move(elseBranch)), keyword);
+}
+
+std::unique_ptr<Statement> Parser::parseWhileStmt() {
+    const Token &keyword = previous();
+    auto condition = parseExpression();
+    std::unique_ptr<Statement> body = parseBlock();
+
+    return located(std::make_unique<WhileStatement>(std::move(condition), std::move(body)), keyword);
+}
+
+std::unique_ptr<Statement> Parser::parseReturnStmt() {
+    const Token &keyword = previous();
+
+    std::unique_ptr<Expression> value;
+    if (!check(TokenType::SEMICOLON)) value = parseExpression();
+    consume(TokenType::SEMICOLON, "Expected ';' after return value");
+
+    return located(std::make_unique<ReturnStatement>(std::move(value)), keyword);
+}
+
+std::unique_ptr<Statement> Parser::parseExprStmt() {
+    const Token &first = peek();
+    auto expression = parseExpression();
+    consume(TokenType::SEMICOLON, "Expected ';' after expression");
+
+    return located(std::make_unique<ExpressionStatement>(std::move(expression)), first);
+}
+
+std::unique_ptr<BlockStatement> Parser::parseBlock() {
+    const Token &brace = consume(TokenType::LEFT_BRACE, "Expected '{'");
+    auto block = located(std::make_unique<BlockStatement>(), brace);
+
+    while (!check(TokenType::RIGHT_BRACE) && !isAtEnd()) {
+        try {
+            block->statements.push_back(parseStatement());
+        } catch (const ParseError &err) {
+            report(err);
+            synchronize();
+        }
+    }
+
+    consume(TokenType::RIGHT_BRACE, "Expected '}' after block");
+    return block;
+}
+
+// ===== EXPRESSIONS =====
+
+std::unique_ptr<Expression> Parser::parseExpression() {
+    return parseAssignment();
+}
+
+std::unique_ptr<Expression> Parser::parseAssignment() {
+    auto target = parseOr();
+
+    if (match({TokenType::EQUAL, TokenType::PLUS_EQUAL, TokenType::MINUS_EQUAL, TokenType::STAR_EQUAL,
+               TokenType::SLASH_EQUAL, TokenType::MODULO_EQUAL})) {
+        const Token &op = previous();
+        auto value = parseAssignment();
+
+        if (!dynamic_cast<VariableExpression *>(target.get())) {
+            throw error(op, "Invalid assignment target");
+        }
+
+        return located(std::make_unique<AssignmentExpression>(std::move(target), op, std::move(value)), op);
+    }
+
+    return target;
+}
+
+std::unique_ptr<Expression> Parser::parseOr() {
+    auto expr = parseAnd();
+    while (match({TokenType::OR})) {
+        const Token &op = previous();
+        expr = located(std::make_unique<BinaryExpression>(std::move(expr), op, parseAnd()), op);
+    }
+    return expr;
+}
+
+std::unique_ptr<Expression> Parser::parseAnd() {
+    auto expr = parseEquality();
+    while (match({TokenType::AND})) {
+        const Token &op = previous();
+        expr = located(std::make_unique<BinaryExpression>(std::move(expr), op, parseEquality()), op);
+    }
+    return expr;
+}
+
+std::unique_ptr<Expression> Parser::parseEquality() {
+    auto expr = parseComparison();
+    while (match({TokenType::EQUAL_EQUAL, TokenType::NOT_EQUAL})) {
+        const Token &op = previous();
+        expr = located(std::make_unique<BinaryExpression>(std::move(expr), op, parseComparison()), op);
+    }
+    return expr;
+}
+
+std::unique_ptr<Expression> Parser::parseComparison() {
+    auto expr = parseTerm();
+    while (match({TokenType::LESS, TokenType::LESS_EQUAL, TokenType::GREATER, TokenType::GREATER_EQUAL})) {
+        const Token &op = previous();
+        expr = located(std::make_unique<BinaryExpression>(std::move(expr), op, parseTerm()), op);
+    }
+    return expr;
+}
+
+std::unique_ptr<Expression> Parser::parseTerm() {
+    auto expr = parseFactor();
+    while (match({TokenType::PLUS, TokenType::MINUS})) {
+        const Token &op = previous();
+        expr = located(std::make_unique<BinaryExpression>(std::move(expr), op, parseFactor()), op);
+    }
+    return expr;
+}
+
+std::unique_ptr<Expression> Parser::parseFactor() {
+    auto expr = parseUnary();
+    while (match({TokenType::STAR, TokenType::SLASH, TokenType::MODULO})) {
+        const Token &op = previous();
+        expr = located(std::make_unique<BinaryExpression>(std::move(expr), op, parseUnary()), op);
+    }
+    return expr;
+}
+
+std::unique_ptr<Expression> Parser::parseUnary() {
+    if (match({TokenType::NOT, TokenType::MINUS})) {
+        const Token &op = previous();
+        return located(std::make_unique<UnaryExpression>(op, parseUnary()), op);
+    }
+    if (match({TokenType::SPAWN, TokenType::THREAD})) {
+        const Token &keyword = previous();
+        std::unique_ptr<Expression> operand = parseCall();
+        if (!dynamic_cast<CallExpression *>(operand.get())) {
+            throw error(keyword, "Expected a function call after '" + keyword.lexeme + "'");
+        }
+        std::unique_ptr<CallExpression> call(static_cast<CallExpression *>(operand.release()));
+        return located(std::make_unique<SpawnExpression>(keyword.type, std::move(call)), keyword);
+    }
+    if (match({TokenType::AWAIT})) {
+        const Token &keyword = previous();
+        return located(std::make_unique<AwaitExpression>(parseUnary()), keyword);
+    }
+    return parseCall();
+}
+
+std::unique_ptr<Expression> Parser::parseCall() {
+    auto expr = parsePrimary();
+    while (match({TokenType::LEFT_PAREN})) {
+        expr = finishCall(std::move(expr));
+    }
+    return expr;
+}
+
+std::unique_ptr<Expression> Parser::finishCall(std::unique_ptr<Expression> callee) {
+    const Token &paren = previous();
+    auto call = located(std::make_unique<CallExpression>(std::move(callee)), paren);
+
+    if (!check(TokenType::RIGHT_PAREN)) {
+        do {
+            call->arguments.push_back(parseExpression());
+        } while (match({TokenType::COMMA}));
+    }
+    consume(TokenType::RIGHT_PAREN, "Expected ')' after arguments");
+
+    return call;
+}
+
+std::unique_ptr<Expression> Parser::parsePrimary() {
+    const Token &token = peek();
+
+    switch (token.type) {
+        case TokenType::INT8_LITERAL: case TokenType::INT16_LITERAL:
+        case TokenType::INT32_LITERAL: case TokenType::INT64_LITERAL:
+        case TokenType::UINT8_LITERAL: case TokenType::UINT16_LITERAL:
+        case TokenType::UINT32_LITERAL: case TokenType::UINT64_LITERAL:
+        case TokenType::FLOAT8_LITERAL: case TokenType::FLOAT16_LITERAL:
+        case TokenType::FLOAT32_LITERAL: case TokenType::FLOAT64_LITERAL:
+        case TokenType::DOUBLE_LITERAL:
+        case TokenType::STRING_LITERAL:
+        case TokenType::CHAR_LITERAL:
+            ++current;
+            return located(std::make_unique<LiteralExpression>(token.literal, token.type), token);
+        case TokenType::TRUE_VALUE:
+        case TokenType::FALSE_VALUE:
+            ++current;
+            return located(std::make_unique<LiteralExpression>(token.type == TokenType::TRUE_VALUE, TokenType::BOOLEAN_LITERAL), token);
+        case TokenType::NULL_VALUE:
+            ++current;
+            return located(std::make_unique<LiteralExpression>(std::monostate{}, TokenType::NULL_LITERAL), token);
+        case TokenType::IDENTIFIER:
+            ++current;
+            return located(std::make_unique<VariableExpression>(token.lexeme), token);
+        case TokenType::LEFT_PAREN: {
+            ++current;
+            auto expr = parseExpression();
+            consume(TokenType::RIGHT_PAREN, "Expected ')' after expression");
+            return expr;
+        }
+        default:
+            throw error(token, "Expected expression");
+    }
+}
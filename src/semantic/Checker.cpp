@@ -0,0 +1,610 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/semantic/Checker.h"
+
+#include <charconv>
+
+namespace {
+    constexpr const char *BUILTINS[] = {"print", "join", "sleep", "readable"};
+
+    // Builtins that take exactly one argument: join(task), sleep(milliseconds) and readable(fd)
+    bool takes_one_argument(const std::string &builtin) {
+        return builtin == "join" || builtin == "sleep" || builtin == "readable";
+    }
+
+    const FunctionDeclaration *async_function(const Symbol *symbol) {
+        const auto *function = symbol ? dynamic_cast<const FunctionDeclaration *>(symbol->declaration) : nullptr;
+        return function && function->is_async ? function : nullptr;
+    }
+
+    std::string describe(SymbolKind kind) {
+        switch (kind) {
+            case SymbolKind::Immutable: return "let binding";
+            case SymbolKind::Constant: return "constant";
+            case SymbolKind::Function: return "function";
+            case SymbolKind::Builtin: return "builtin";
+            case SymbolKind::Parameter: return "parameter";
+            case SymbolKind::Variable: // fallthrough
+            default: return "variable";
+        }
+    }
+
+    // A numeric literal written without a width suffix, e.g. `42` or `1.5`
+    const LiteralExpression *untyped_literal(const Expression &expression) {
+        const auto *literal = dynamic_cast<const LiteralExpression *>(&expression);
+        if (!literal) return nullptr;
+        if (literal->type != TokenType::INT64_LITERAL && literal->type != TokenType::DOUBLE_LITERAL) return nullptr;
+        return literal;
+    }
+
+    bool fits(int64_t value, unsigned bits, bool is_signed) {
+        if (is_signed) {
+            if (bits >= 64) return true;
+            const int64_t limit = int64_t{1} << (bits - 1);
+            return value >= -limit && value < limit;
+        }
+        if (value < 0) return false;
+        return bits >= 64 || static_cast<uint64_t>(value) < (uint64_t{1} << bits);
+    }
+
+    TokenType arithmetic_of(TokenType compound) {
+        switch (compound) {
+            case TokenType::PLUS_EQUAL: return TokenType::PLUS;
+            case TokenType::MINUS_EQUAL: return TokenType::MINUS;
+            case TokenType::STAR_EQUAL: return TokenType::STAR;
+            case TokenType::SLASH_EQUAL: return TokenType::SLASH;
+            case TokenType::MODULO_EQUAL: return TokenType::MODULO;
+            default: return compound;
+        }
+    }
+}
+
+Checker::Checker(std::string filename, const std::string &module, const ModuleMap &modules, TypeTable &types)
+    : filename(std::move(filename)), package(package_of(module)), modules(modules),
+      names(StringInterner::global()), types(types) {
+    module_id = names.intern(module);
+}
+
+const std::vector<Diagnostic> &Checker::diagnostics() const {
+    return errors;
+}
+
+void Checker::error(const ASTNode &node, const std::string &message) {
+    errors.push_back({Severity::Error, filename, node.line, node.column, message});
+}
+
+void Checker::note(const ASTNode &node, const std::string &message) {
+    errors.push_back({Severity::Note, filename, node.line, node.column, message});
+}
+
+// Scopes: builtins (0) < imports (1) < module globals (2) < function locals
+void Checker::check(Program &program) {
+    constants = std::make_unique<ConstEvaluator>(program, types);
+    declare_builtins();
+
+    symbols.push_scope();
+    declare_imports(program);
+
+    symbols.push_scope();
+    declare_functions(program);
+
+    for (auto &node : program.statements) check_node(*node);
+
+    symbols.pop_scope();
+    symbols.pop_scope();
+}
+
+// ===== DECLARATIONS =====
+
+void Checker::declare_builtins() {
+    for (const char *name : BUILTINS) {
+        Symbol symbol;
+        symbol.name = names.intern(name);
+        symbol.kind = SymbolKind::Builtin;
+        symbol.visibility = Visibility::Public;
+        symbol.module = module_id;
+        symbols.declare(symbol);
+    }
+}
+
+void Checker::declare_imports(const Program &program) {
+    for (const auto &node : program.statements) {
+        const auto *import = dynamic_cast<const ImportDeclaration *>(node.get());
+        if (!import) continue;
+
+        const auto it = modules.find(import->module);
+        if (it == modules.end()) {
+            error(*import, "Unknown module '" + import->module + "'");
+            has_unresolved_import = true;
+            continue;
+        }
+
+        const NameId imported_module = names.intern(import->module);
+        for (const auto &exported : it->second->symbols) {
+            Symbol symbol;
+            symbol.name = names.intern(exported.name);
+            symbol.kind = exported.kind;
+            symbol.visibility = exported.visibility;
+            symbol.module = imported_module;
+            symbol.type = exported.kind == SymbolKind::Function
+                              ? function_type(exported.parameter_types, exported.type, *import)
+                              : resolve_type(exported.type, *import);
+            symbols.declare(symbol); // the first import providing a name wins
+        }
+    }
+}
+
+// Functions are visible throughout the module so they can call each other in any order
+void Checker::declare_functions(const Program &program) {
+    for (const auto &node : program.statements) {
+        const auto *function = dynamic_cast<const FunctionDeclaration *>(node.get());
+        if (!function) continue;
+
+        Symbol symbol;
+        symbol.name = names.intern(function->name);
+        symbol.kind = SymbolKind::Function;
+        symbol.visibility = function->visibility;
+        symbol.module = module_id;
+        symbol.declaration = function;
+        symbol.type = function_type(function->parameter_types, function->return_type, *function);
+        declare(symbol, *function, function->name);
+    }
+}
+
+void Checker::declare(const Symbol &symbol, const ASTNode &node, const std::string &name) {
+    if (const Symbol *existing = symbols.declare(symbol)) {
+        error(node, "Redeclaration of '" + name + "'");
+        if (existing->declaration) note(*existing->declaration, "previous declaration of '" + name + "' is here");
+    }
+}
+
+// An omitted annotation leaves the type unknown rather than guessing
+TypeId Checker::resolve_type(const std::string &spelling, const ASTNode &at) {
+    if (spelling.empty()) return TYPE_UNKNOWN;
+    if (spelling.front() == '[') return array_type(spelling, at);
+
+    const TypeId type = TypeTable::primitive(spelling);
+    if (type == TYPE_ERROR) error(at, "Unknown type '" + spelling + "'");
+    return type;
+}
+
+// `[element; length]`, where the length is an integer literal or a folded constant
+TypeId Checker::array_type(const std::string &spelling, const ASTNode &at) {
+    const size_t separator = spelling.rfind("; ");
+    const TypeId element = resolve_type(spelling.substr(1, separator - 1), at);
+    const std::string length = spelling.substr(separator + 2, spelling.size() - separator - 3);
+
+    int64_t value = 0;
+    if (std::isdigit(static_cast<unsigned char>(length.front()))) {
+        std::from_chars(length.data(), length.data() + length.size(), value);
+    } else {
+        const Symbol *symbol = resolve(length, at);
+        if (!symbol) return TYPE_ERROR;
+
+        const auto *constant = dynamic_cast<const VariableDeclaration *>(symbol->declaration);
+        if (symbol->kind != SymbolKind::Constant || !constant) {
+            error(at, "Array length '" + length + "' is not a constant of this module");
+            return TYPE_ERROR;
+        }
+
+        const auto *folded = dynamic_cast<const LiteralExpression *>(constant->initializer.get());
+        if (!folded) return TYPE_ERROR; // folding it already failed with an error
+        if (!types.is_integer(folded->Expression::type)) {
+            error(at, "Array length '" + length + "' must be an integer but is " +
+                      types.to_string(folded->Expression::type));
+            return TYPE_ERROR;
+        }
+        value = std::get<int64_t>(folded->literal);
+    }
+
+    if (value < 0 || value > UINT32_MAX) {
+        error(at, "Array length " + std::to_string(value) + " is out of range");
+        return TYPE_ERROR;
+    }
+    return element == TYPE_ERROR ? TYPE_ERROR : types.array(element, static_cast<uint32_t>(value));
+}
+
+TypeId Checker::function_type(const std::vector<std::string> &parameter_types, const std::string &return_type,
+                              const ASTNode &at) {
+    std::vector<TypeId> parameters;
+    parameters.reserve(parameter_types.size());
+    for (const auto &spelling : parameter_types) parameters.push_back(resolve_type(spelling, at));
+
+    return types.function(parameters, resolve_type(return_type, at));
+}
+
+// ===== STATEMENTS =====
+
+void Checker::check_node(ASTNode &node) {
+    if (auto *function = dynamic_cast<FunctionDeclaration *>(&node)) {
+        check_function(*function);
+    } else if (auto *statement = dynamic_cast<Statement *>(&node)) {
+        check_statement(*statement);
+    }
+    // module and import declarations were handled up front
+}
+
+void Checker::check_function(FunctionDeclaration &function) {
+    const Symbol *self = symbols.lookup(names.intern(function.name));
+    const TypeId signature = self && self->declaration == &function
+                                 ? self->type
+                                 : function_type(function.parameter_types, function.return_type, function);
+    const TypeId outer_return = return_type;
+    return_type = types.result(signature);
+
+    symbols.push_scope();
+
+    const auto parameter_types = types.parameters(signature);
+    for (size_t i = 0; i < function.parameters.size(); ++i) {
+        Symbol symbol;
+        symbol.name = names.intern(function.parameters[i]);
+        symbol.kind = SymbolKind::Parameter;
+        symbol.module = module_id;
+        symbol.declaration = &function;
+        symbol.type = parameter_types[i];
+        declare(symbol, function, function.parameters[i]);
+    }
+
+    for (auto &node : function.body) check_node(*node);
+
+    symbols.pop_scope();
+    return_type = outer_return;
+}
+
+void Checker::check_variable(VariableDeclaration &variable) {
+    TypeId type = resolve_type(variable.type_name, variable);
+
+    // The initializer cannot see the name it initializes
+    if (variable.initializer) {
+        const TypeId value = check_expression(*variable.initializer);
+        if (variable.type_name.empty()) {
+            type = value;
+        } else {
+            expect(*variable.initializer, type, "initializer of '" + variable.name + "'");
+        }
+    } else if (variable.kind == TokenType::CONST) {
+        error(variable, "Constant '" + variable.name + "' needs an initializer");
+    }
+
+    if (variable.kind == TokenType::CONST && variable.initializer) fold_constant(variable, type);
+
+    Symbol symbol;
+    symbol.name = names.intern(variable.name);
+    symbol.kind = symbol_kind_for(variable.kind);
+    symbol.visibility = variable.visibility;
+    symbol.module = module_id;
+    symbol.declaration = &variable;
+    symbol.type = type;
+    declare(symbol, variable, variable.name);
+}
+
+// Replaces the initializer with the literal it evaluates to. It is folded where
+// it is declared, so it sees exactly the names the checker resolved for it.
+void Checker::fold_constant(VariableDeclaration &constant, TypeId type) {
+    if (constant.initializer->type == TYPE_ERROR || type == TYPE_ERROR) {
+        constants->mark_failed(constant);
+        return;
+    }
+    if (dynamic_cast<const LiteralExpression *>(constant.initializer.get())) return; // already data
+
+    const ConstEvaluator::Lookup lookup = [this](const std::string &name) {
+        return symbols.lookup(names.intern(name));
+    };
+
+    try {
+        const ConstValue value = constants->evaluate(*constant.initializer, type, lookup);
+        auto folded = ConstEvaluator::to_literal(value);
+        folded->line = constant.initializer->line;
+        folded->column = constant.initializer->column;
+        constant.initializer = std::move(folded);
+    } catch (const ConstEvaluator::Failure &failure) {
+        constants->mark_failed(constant);
+        if (failure.reported) return;
+
+        error(*failure.node, failure.what());
+        if (failure.node != constant.initializer.get()) {
+            note(constant, "while evaluating the initializer of constant '" + constant.name + "'");
+        }
+    }
+}
+
+void Checker::check_statement(Statement &statement) {
+    if (auto *variable = dynamic_cast<VariableDeclaration *>(&statement)) {
+        check_variable(*variable);
+    } else if (auto *block = dynamic_cast<BlockStatement *>(&statement)) {
+        check_block(*block);
+    } else if (auto *expression = dynamic_cast<ExpressionStatement *>(&statement)) {
+        check_expression(*expression->expression);
+    } else if (auto *ret = dynamic_cast<ReturnStatement *>(&statement)) {
+        if (ret->expression) {
+            check_expression(*ret->expression);
+            if (types.kind(return_type) == TypeKind::Void) {
+                error(*ret, "Void function cannot return a value");
+            } else {
+                expect(*ret->expression, return_type, "return value");
+            }
+        } else if (!types.is_assignable(TYPE_VOID, return_type)) {
+            error(*ret, "Missing return value of type " + types.to_string(return_type));
+        }
+    } else if (auto *branch = dynamic_cast<IfStatement *>(&statement)) {
+        check_condition(*branch->condition);
+        check_statement(*branch->then_branch);
+        if (branch->else_branch) check_statement(*branch->else_branch);
+    } else if (auto *loop = dynamic_cast<WhileStatement *>(&statement)) {
+        check_condition(*loop->condition);
+        check_statement(*loop->body);
+    }
+}
+
+void Checker::check_block(BlockStatement &block) {
+    symbols.push_scope();
+    for (auto &statement : block.statements) check_statement(*statement);
+    symbols.pop_scope();
+}
+
+void Checker::check_condition(Expression &condition) {
+    check_expression(condition);
+    expect(condition, TYPE_BOOL, "condition");
+}
+
+// ===== EXPRESSIONS =====
+
+TypeId Checker::check_expression(Expression &expression) {
+    TypeId type = TYPE_UNKNOWN;
+
+    if (const auto *literal = dynamic_cast<LiteralExpression *>(&expression)) {
+        type = check_literal(*literal);
+    } else if (const auto *variable = dynamic_cast<VariableExpression *>(&expression)) {
+        const Symbol *symbol = resolve(variable->name, *variable);
+        type = symbol ? symbol->type : TYPE_ERROR;
+    } else if (auto *unary = dynamic_cast<UnaryExpression *>(&expression)) {
+        type = check_unary(*unary);
+    } else if (auto *binary = dynamic_cast<BinaryExpression *>(&expression)) {
+        type = check_binary(*binary);
+    } else if (auto *assignment = dynamic_cast<AssignmentExpression *>(&expression)) {
+        type = check_assignment(*assignment);
+    } else if (auto *call = dynamic_cast<CallExpression *>(&expression)) {
+        type = check_call(*call);
+    } else if (auto *spawn = dynamic_cast<SpawnExpression *>(&expression)) {
+        type = check_spawn(*spawn);
+    } else if (auto *await = dynamic_cast<AwaitExpression *>(&expression)) {
+        type = check_await(*await);
+    }
+
+    expression.type = type;
+    return type;
+}
+
+// A suffixed integer literal has its suffix's type, so its value must fit in
+// it. Under a minus sign a signed one may also be the type's minimum, as in -128i8.
+TypeId Checker::check_literal(const LiteralExpression &literal, bool negated) {
+    const TypeId type = TypeTable::literal(literal.type);
+    if (literal.type == TokenType::INT64_LITERAL || !types.is_integer(type) || types.bit_width(type) >= 64) {
+        return type; // the lexer already rejected what does not fit in 64 bits
+    }
+
+    const bool is_signed = types.is_signed(type);
+    const int64_t value = negated && is_signed ? -std::get<int64_t>(literal.literal) : std::get<int64_t>(literal.literal);
+    if (fits(value, types.bit_width(type), is_signed)) return type;
+
+    error(literal, "Literal " + std::to_string(value) + " does not fit in " + types.to_string(type));
+    return TYPE_ERROR;
+}
+
+TypeId Checker::check_unary(UnaryExpression &unary) {
+    const auto *literal = dynamic_cast<const LiteralExpression *>(unary.operand.get());
+    const TypeId operand = literal && unary.op.type == TokenType::MINUS
+                               ? unary.operand->type = check_literal(*literal, true)
+                               : check_expression(*unary.operand);
+    if (operand == TYPE_ERROR || operand == TYPE_UNKNOWN) return operand;
+
+    if (unary.op.type == TokenType::NOT) {
+        if (operand == TYPE_BOOL) return TYPE_BOOL;
+    } else if (types.is_numeric(operand)) {
+        return operand;
+    }
+
+    error(unary, "Operator '" + unary.op.lexeme + "' cannot be applied to " + types.to_string(operand));
+    return TYPE_ERROR;
+}
+
+TypeId Checker::check_binary(BinaryExpression &binary) {
+    check_expression(*binary.left);
+    check_expression(*binary.right);
+    return check_operator(binary.op, *binary.left, *binary.right, binary);
+}
+
+TypeId Checker::check_operator(const Token &op, Expression &left, Expression &right, const ASTNode &at) {
+    // An unsuffixed literal takes the type of the other operand
+    if (untyped_literal(left)) coerce(left, right.type);
+    if (untyped_literal(right)) coerce(right, left.type);
+
+    const TypeId lhs = left.type, rhs = right.type;
+    if (lhs == TYPE_ERROR || rhs == TYPE_ERROR) return TYPE_ERROR;
+
+    const TypeId common = types.unify(lhs, rhs);
+    const bool unknown = lhs == TYPE_UNKNOWN || rhs == TYPE_UNKNOWN;
+
+    switch (arithmetic_of(op.type)) {
+        case TokenType::PLUS:
+            if (common == TYPE_STRING) return TYPE_STRING;
+            [[fallthrough]];
+        case TokenType::MINUS:
+        case TokenType::STAR:
+        case TokenType::SLASH:
+        case TokenType::MODULO:
+            if (unknown || types.is_numeric(common)) return common;
+            break;
+        case TokenType::LESS:
+        case TokenType::LESS_EQUAL:
+        case TokenType::GREATER:
+        case TokenType::GREATER_EQUAL:
+            if (unknown || types.is_numeric(common) || common == TYPE_CHAR) return TYPE_BOOL;
+            break;
+        case TokenType::EQUAL_EQUAL:
+        case TokenType::NOT_EQUAL:
+            if (common != TYPE_ERROR || types.is_assignable(lhs, rhs) || types.is_assignable(rhs, lhs)) return TYPE_BOOL;
+            break;
+        case TokenType::AND:
+        case TokenType::OR:
+            if (unknown || common == TYPE_BOOL) return TYPE_BOOL;
+            break;
+        default:
+            break;
+    }
+
+    error(at, "Operator '" + op.lexeme + "' cannot be applied to " + types.to_string(lhs) + " and " +
+              types.to_string(rhs));
+    return TYPE_ERROR;
+}
+
+TypeId Checker::check_assignment(AssignmentExpression &assignment) {
+    check_expression(*assignment.value);
+
+    auto &target = static_cast<VariableExpression &>(*assignment.target);
+    const Symbol *symbol = resolve(target.name, target);
+    if (!symbol) return TYPE_ERROR;
+
+    target.type = symbol->type;
+    if (!symbol->is_assignable()) {
+        error(assignment, "Cannot assign to " + describe(symbol->kind) + " '" + target.name + "'");
+        return TYPE_ERROR;
+    }
+
+    if (assignment.op.type != TokenType::EQUAL) {
+        const TypeId result = check_operator(assignment.op, target, *assignment.value, assignment);
+        if (result != TYPE_ERROR && !types.is_assignable(result, target.type)) {
+            error(assignment, "Cannot store " + types.to_string(result) + " in '" + target.name + "' of type " +
+                              types.to_string(target.type));
+        }
+        return target.type;
+    }
+
+    expect(*assignment.value, target.type, "assignment to '" + target.name + "'");
+    return target.type;
+}
+
+TypeId Checker::check_call(CallExpression &call) {
+    const TypeId callee = check_expression(*call.callee);
+    for (auto &argument : call.arguments) check_expression(*argument);
+
+    if (callee == TYPE_ERROR) return TYPE_ERROR;
+
+    const auto *name = dynamic_cast<const VariableExpression *>(call.callee.get());
+    const Symbol *symbol = name ? symbols.lookup(names.intern(name->name)) : nullptr;
+    if (symbol && symbol->kind == SymbolKind::Builtin && takes_one_argument(name->name) && call.arguments.size() != 1) {
+        error(call, "Expected 1 argument(s) but got " + std::to_string(call.arguments.size()));
+        return TYPE_ERROR;
+    }
+    if (callee == TYPE_UNKNOWN) return TYPE_UNKNOWN; // builtins and untyped values
+
+    if (types.kind(callee) != TypeKind::Function) {
+        error(call, "Value of type " + types.to_string(callee) + " is not callable");
+        return TYPE_ERROR;
+    }
+
+    const auto parameters = types.parameters(callee);
+    if (parameters.size() != call.arguments.size()) {
+        error(call, "Expected " + std::to_string(parameters.size()) + " argument(s) but got " +
+                    std::to_string(call.arguments.size()));
+        return types.result(callee);
+    }
+
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        expect(*call.arguments[i], parameters[i], "argument " + std::to_string(i + 1));
+    }
+    // Calling an async function only starts it; the declared type is what awaiting it produces
+    return async_function(symbol) ? TYPE_UNKNOWN : types.result(callee);
+}
+
+// The handle has no static type: join() returns whatever the task did
+TypeId Checker::check_spawn(SpawnExpression &spawn) {
+    if (check_call(*spawn.call) == TYPE_ERROR) return TYPE_ERROR;
+
+    const auto *name = dynamic_cast<const VariableExpression *>(spawn.call->callee.get());
+    const Symbol *symbol = name ? symbols.lookup(names.intern(name->name)) : nullptr;
+    if (!symbol || symbol->kind != SymbolKind::Function) {
+        const char *keyword = spawn.kind == TokenType::SPAWN ? "spawn" : "thread";
+        error(spawn, std::string("Only functions can be started with '") + keyword + "'");
+        return TYPE_ERROR;
+    }
+    if (async_function(symbol)) {
+        error(spawn, "Async function '" + name->name + "' cannot be started as a task; call it and await the result");
+        return TYPE_ERROR;
+    }
+    return TYPE_UNKNOWN;
+}
+
+// Awaiting a direct call of an async function produces its declared result type;
+// coroutine and event handles are untyped, so anything else is only checked not
+// to have a static type that cannot be awaited
+TypeId Checker::check_await(AwaitExpression &await) {
+    const TypeId operand = check_expression(*await.operand);
+    if (operand == TYPE_ERROR) return TYPE_ERROR;
+
+    if (const auto *call = dynamic_cast<const CallExpression *>(await.operand.get())) {
+        const auto *name = dynamic_cast<const VariableExpression *>(call->callee.get());
+        const Symbol *symbol = name ? symbols.lookup(names.intern(name->name)) : nullptr;
+        if (async_function(symbol)) return types.result(symbol->type);
+    }
+    if (operand != TYPE_UNKNOWN) {
+        error(await, "Cannot await a value of type " + types.to_string(operand));
+        return TYPE_ERROR;
+    }
+    return TYPE_UNKNOWN;
+}
+
+bool Checker::coerce(Expression &expression, TypeId target) {
+    if (types.is_assignable(expression.type, target)) return true;
+
+    const LiteralExpression *literal = untyped_literal(expression);
+    if (!literal || !types.is_numeric(target)) return false;
+
+    if (literal->type == TokenType::DOUBLE_LITERAL) {
+        if (!types.is_floating(target)) return false;
+    } else if (types.is_integer(target)) {
+        const int64_t value = std::get<int64_t>(literal->literal);
+        if (!fits(value, types.bit_width(target), types.is_signed(target))) return false;
+    }
+
+    expression.type = target;
+    return true;
+}
+
+void Checker::expect(Expression &expression, TypeId target, const std::string &context) {
+    if (coerce(expression, target)) return;
+
+    const LiteralExpression *literal = untyped_literal(expression);
+    if (literal && literal->type == TokenType::INT64_LITERAL && types.is_integer(target)) {
+        error(expression, "Literal " + std::to_string(std::get<int64_t>(literal->literal)) + " does not fit in " +
+                          types.to_string(target));
+        return;
+    }
+
+    error(expression, "Type mismatch in " + context + ": expected " + types.to_string(target) + " but found " +
+                      types.to_string(expression.type));
+}
+
+const Symbol *Checker::resolve(const std::string &name, const ASTNode &use) {
+    const Symbol *symbol = symbols.lookup(names.intern(name));
+
+    if (!symbol) {
+        // Names may come from a module we could not load; don't pile on
+        if (!has_unresolved_import) error(use, "Use of undeclared identifier '" + name + "'");
+        return nullptr;
+    }
+
+    if (symbol->module != module_id) {
+        const std::string owner(names.spelling(symbol->module));
+
+        if (symbol->visibility == Visibility::Private) {
+            error(use, "'" + name + "' is private to module '" + owner + "'");
+        } else if (symbol->visibility == Visibility::Internal && package_of(owner) != package) {
+            error(use, "'" + name + "' is internal to package '" + package_of(owner) + "'");
+        }
+    }
+
+    return symbol;
+}
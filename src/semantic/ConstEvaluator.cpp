@@ -0,0 +1,539 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/semantic/ConstEvaluator.h"
+#include "../../include/util/Hash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace {
+    bool fits(int64_t value, unsigned bits, bool is_signed) {
+        if (is_signed) {
+            if (bits >= 64) return true;
+            const int64_t limit = int64_t{1} << (bits - 1);
+            return value >= -limit && value < limit;
+        }
+        if (value < 0) return false;
+        return bits >= 64 || static_cast<uint64_t>(value) < (uint64_t{1} << bits);
+    }
+
+    uint64_t truncate(uint64_t value, unsigned bits) {
+        return bits >= 64 ? value : value & ((uint64_t{1} << bits) - 1);
+    }
+
+    TokenType arithmetic_of(TokenType compound) {
+        switch (compound) {
+            case TokenType::PLUS_EQUAL: return TokenType::PLUS;
+            case TokenType::MINUS_EQUAL: return TokenType::MINUS;
+            case TokenType::STAR_EQUAL: return TokenType::STAR;
+            case TokenType::SLASH_EQUAL: return TokenType::SLASH;
+            case TokenType::MODULO_EQUAL: return TokenType::MODULO;
+            default: return compound;
+        }
+    }
+
+    uint64_t hash_value(uint64_t seed, const ConstValue &value) {
+        seed = hash_combine(hash_combine(seed, value.type), value.value.index());
+        if (const auto *i = std::get_if<int64_t>(&value.value)) return hash_combine(seed, static_cast<uint64_t>(*i));
+        if (const auto *d = std::get_if<double>(&value.value)) return hash_combine(seed, std::bit_cast<uint64_t>(*d));
+        if (const auto *b = std::get_if<bool>(&value.value)) return hash_combine(seed, *b);
+        if (const auto *c = std::get_if<char>(&value.value)) return hash_combine(seed, static_cast<uint8_t>(*c));
+        if (const auto *s = std::get_if<std::string>(&value.value)) return fnv1a(*s, seed);
+        return seed;
+    }
+}
+
+ConstEvaluator::ConstEvaluator(const Program &program, TypeTable &types) : types(types) {
+    for (const auto &node : program.statements) {
+        if (const auto *function = dynamic_cast<const FunctionDeclaration *>(node.get())) {
+            globals.emplace(function->name, function);
+        } else if (const auto *variable = dynamic_cast<const VariableDeclaration *>(node.get())) {
+            globals.emplace(variable->name, variable);
+        }
+    }
+}
+
+ConstValue ConstEvaluator::evaluate(const Expression &expression, TypeId target, const Lookup &lookup) {
+    steps = 0;
+    bytes = 0;
+    depth = 0;
+
+    Frame frame;
+    frame.lookup = &lookup;
+    return convert(eval(expression, frame), target, expression);
+}
+
+void ConstEvaluator::mark_failed(const VariableDeclaration &constant) {
+    failed.insert(&constant);
+}
+
+size_t ConstEvaluator::memo_hits() const {
+    return hits;
+}
+
+size_t ConstEvaluator::memo_size() const {
+    return memo.size();
+}
+
+std::unique_ptr<LiteralExpression> ConstEvaluator::to_literal(const ConstValue &value) {
+    Literal literal = value.value;
+    if (const auto *d = std::get_if<double>(&literal); d && value.type >= TYPE_F8 && value.type <= TYPE_F64) {
+        literal = static_cast<float>(*d); // the lexer stores f8..f64 literals as float
+    }
+
+    TokenType type = TokenType::NULL_LITERAL;
+    switch (value.type) {
+        case TYPE_I8: type = TokenType::INT8_LITERAL; break;
+        case TYPE_I16: type = TokenType::INT16_LITERAL; break;
+        case TYPE_I32: type = TokenType::INT32_LITERAL; break;
+        case TYPE_I64: type = TokenType::INT64_LITERAL; break;
+        case TYPE_U8: type = TokenType::UINT8_LITERAL; break;
+        case TYPE_U16: type = TokenType::UINT16_LITERAL; break;
+        case TYPE_U32: type = TokenType::UINT32_LITERAL; break;
+        case TYPE_U64: type = TokenType::UINT64_LITERAL; break;
+        case TYPE_F8: type = TokenType::FLOAT8_LITERAL; break;
+        case TYPE_F16: type = TokenType::FLOAT16_LITERAL; break;
+        case TYPE_F32: type = TokenType::FLOAT32_LITERAL; break;
+        case TYPE_F64: type = TokenType::FLOAT64_LITERAL; break;
+        case TYPE_DOUBLE: type = TokenType::DOUBLE_LITERAL; break;
+        case TYPE_STRING: type = TokenType::STRING_LITERAL; break;
+        case TYPE_CHAR: type = TokenType::CHAR_LITERAL; break;
+        case TYPE_BOOL: type = TokenType::BOOLEAN_LITERAL; break;
+        default: break;
+    }
+
+    auto expression = std::make_unique<LiteralExpression>(std::move(literal), type);
+    static_cast<Expression &>(*expression).type = value.type; // LiteralExpression::type is the token kind
+    return expression;
+}
+
+// ===== EXPRESSIONS =====
+
+ConstValue ConstEvaluator::eval(const Expression &expression, Frame &frame) {
+    step(expression);
+
+    if (const auto *literal = dynamic_cast<const LiteralExpression *>(&expression)) return literal_value(*literal);
+    if (const auto *variable = dynamic_cast<const VariableExpression *>(&expression)) return eval_name(*variable, frame);
+    if (const auto *unary = dynamic_cast<const UnaryExpression *>(&expression)) return eval_unary(*unary, frame);
+    if (const auto *binary = dynamic_cast<const BinaryExpression *>(&expression)) return eval_binary(*binary, frame);
+    if (const auto *assignment = dynamic_cast<const AssignmentExpression *>(&expression)) {
+        return eval_assignment(*assignment, frame);
+    }
+    if (const auto *call = dynamic_cast<const CallExpression *>(&expression)) return eval_call(*call, frame);
+
+    throw Failure(&expression, "Expression cannot be evaluated at compile time");
+}
+
+ConstValue ConstEvaluator::literal_value(const LiteralExpression &literal) {
+    // The checker may have given an unsuffixed literal the type it is used at
+    const TypeId checked = static_cast<const Expression &>(literal).type;
+    const TypeId type = checked > TYPE_NULL && checked <= TYPE_DOUBLE ? checked : TypeTable::literal(literal.type);
+    if (const auto *f = std::get_if<float>(&literal.literal)) return {static_cast<double>(*f), type};
+    if (const auto *s = std::get_if<std::string>(&literal.literal)) charge(s->size(), literal);
+    return {literal.literal, type};
+}
+
+ConstValue ConstEvaluator::eval_name(const VariableExpression &variable, Frame &frame) {
+    const std::string &name = variable.name;
+
+    for (auto it = frame.bindings.rbegin(); it != frame.bindings.rend(); ++it) {
+        if (it->name != name) continue;
+        if (!it->initialized) throw Failure(&variable, "'" + name + "' is used before it has a value");
+        return it->value;
+    }
+
+    // The constant's own initializer sees the scopes it was declared in
+    if (frame.lookup) {
+        const Symbol *symbol = (*frame.lookup)(name);
+        if (!symbol) throw Failure(&variable, "Use of undeclared identifier '" + name + "'", true);
+
+        if (!symbol->declaration) {
+            throw Failure(&variable, "'" + name + "' is not declared in this module and has no value at compile time");
+        }
+        if (symbol->kind == SymbolKind::Constant) {
+            return constant_value(static_cast<const VariableDeclaration &>(*symbol->declaration), variable);
+        }
+        if (symbol->kind == SymbolKind::Function) throw Failure(&variable, "Function '" + name + "' is not a value");
+        throw Failure(&variable, "'" + name + "' is not a constant");
+    }
+
+    // Function bodies see module-level declarations only
+    const auto global = globals.find(name);
+    if (global == globals.end()) throw Failure(&variable, "'" + name + "' has no value at compile time");
+
+    const auto *declaration = dynamic_cast<const VariableDeclaration *>(global->second);
+    if (!declaration) throw Failure(&variable, "Function '" + name + "' is not a value");
+    if (declaration->kind != TokenType::CONST) {
+        throw Failure(&variable, "'" + name + "' is not a constant, so it cannot be read at compile time");
+    }
+    return constant_value(*declaration, variable);
+}
+
+ConstValue ConstEvaluator::constant_value(const VariableDeclaration &constant, const ASTNode &use) {
+    if (failed.contains(&constant)) throw Failure(&use, "", true);
+
+    const auto *literal = dynamic_cast<const LiteralExpression *>(constant.initializer.get());
+    if (!literal) throw Failure(&use, "Constant '" + constant.name + "' is used before its declaration");
+    return literal_value(*literal);
+}
+
+ConstValue ConstEvaluator::eval_unary(const UnaryExpression &unary, Frame &frame) {
+    const ConstValue operand = eval(*unary.operand, frame);
+
+    if (unary.op.type == TokenType::NOT) {
+        if (const auto *b = std::get_if<bool>(&operand.value)) return {!*b, TYPE_BOOL};
+    } else if (const auto *i = std::get_if<int64_t>(&operand.value)) {
+        const unsigned bits = types.bit_width(operand.type);
+        const bool overflow = types.is_signed(operand.type)
+                                  ? *i == std::numeric_limits<int64_t>::min() || !fits(-*i, bits, true)
+                                  : *i != 0;
+        if (overflow) {
+            throw Failure(&unary, "Integer overflow in constant expression: -" + describe(operand) + " does not fit in " +
+                                  types.to_string(operand.type));
+        }
+        return {-*i, operand.type};
+    } else if (const auto *d = std::get_if<double>(&operand.value)) {
+        return {-*d, operand.type};
+    }
+
+    throw Failure(&unary, "Operator '" + unary.op.lexeme + "' cannot be applied to " + types.to_string(operand.type));
+}
+
+ConstValue ConstEvaluator::eval_binary(const BinaryExpression &binary, Frame &frame) {
+    const TokenType op = binary.op.type;
+    const ConstValue left = eval(*binary.left, frame);
+
+    if (op == TokenType::AND || op == TokenType::OR) {
+        const auto *lhs = std::get_if<bool>(&left.value);
+        if (!lhs) throw Failure(binary.left.get(), "Expected bool but found " + types.to_string(left.type));
+        if (*lhs == (op == TokenType::OR)) return left;
+
+        const ConstValue right = eval(*binary.right, frame);
+        if (!std::holds_alternative<bool>(right.value)) {
+            throw Failure(binary.right.get(), "Expected bool but found " + types.to_string(right.type));
+        }
+        return right;
+    }
+
+    const ConstValue right = eval(*binary.right, frame);
+    return apply(binary.op, op, left, right, binary);
+}
+
+ConstValue ConstEvaluator::eval_assignment(const AssignmentExpression &assignment, Frame &frame) {
+    const auto &target = static_cast<const VariableExpression &>(*assignment.target);
+    const ConstValue value = eval(*assignment.value, frame);
+
+    const auto binding = std::find_if(frame.bindings.rbegin(), frame.bindings.rend(),
+                                      [&](const Binding &candidate) { return candidate.name == target.name; });
+    if (binding == frame.bindings.rend()) {
+        throw Failure(&assignment, "Assignment to '" + target.name + "' is a side effect outside the function and "
+                                   "cannot happen at compile time");
+    }
+    if (!binding->assignable) throw Failure(&assignment, "Cannot assign to '" + target.name + "'", true);
+
+    ConstValue result = value;
+    if (assignment.op.type != TokenType::EQUAL) {
+        if (!binding->initialized) throw Failure(&target, "'" + target.name + "' is used before it has a value");
+        result = apply(assignment.op, arithmetic_of(assignment.op.type), binding->value, value, assignment);
+    }
+
+    binding->value = convert(result, binding->declared, assignment);
+    binding->initialized = true;
+    return binding->value;
+}
+
+ConstValue ConstEvaluator::eval_call(const CallExpression &call, Frame &frame) {
+    const FunctionDeclaration &function = callee(*call.callee, frame);
+
+    std::vector<ConstValue> arguments;
+    arguments.reserve(call.arguments.size());
+    for (const auto &argument : call.arguments) arguments.push_back(eval(*argument, frame));
+
+    return this->call(function, std::move(arguments), call);
+}
+
+const FunctionDeclaration &ConstEvaluator::callee(const Expression &callee, const Frame &frame) {
+    const auto *name = dynamic_cast<const VariableExpression *>(&callee);
+    if (!name) throw Failure(&callee, "Only named functions can be called at compile time");
+
+    const auto local = std::ranges::find(frame.bindings, name->name, &Binding::name);
+    if (local != frame.bindings.end()) throw Failure(&callee, "'" + name->name + "' is not a function");
+
+    const ASTNode *declaration = nullptr;
+    if (frame.lookup) {
+        const Symbol *symbol = (*frame.lookup)(name->name);
+        if (!symbol) throw Failure(&callee, "Use of undeclared identifier '" + name->name + "'", true);
+        if (symbol->kind == SymbolKind::Builtin) {
+            throw Failure(&callee, "Builtin '" + name->name + "' has side effects and cannot run at compile time");
+        }
+        if (!symbol->declaration && symbol->kind == SymbolKind::Function) {
+            throw Failure(&callee, "Function '" + name->name + "' is not declared in this module and cannot run "
+                                   "at compile time");
+        }
+        declaration = symbol->declaration;
+    } else if (const auto global = globals.find(name->name); global != globals.end()) {
+        declaration = global->second;
+    }
+
+    if (const auto *function = dynamic_cast<const FunctionDeclaration *>(declaration)) {
+        if (function->is_async) {
+            throw Failure(&callee, "Async function '" + name->name + "' cannot run at compile time");
+        }
+        return *function;
+    }
+    throw Failure(&callee, "'" + name->name + "' cannot be called at compile time");
+}
+
+ConstValue ConstEvaluator::call(const FunctionDeclaration &function, std::vector<ConstValue> arguments,
+                                const ASTNode &site) {
+    if (arguments.size() != function.parameters.size()) {
+        throw Failure(&site, "Expected " + std::to_string(function.parameters.size()) + " argument(s) but got " +
+                             std::to_string(arguments.size()), true);
+    }
+
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        const std::string &spelling = function.parameter_types[i];
+        const TypeId type = spelling.empty() ? TYPE_UNKNOWN : TypeTable::primitive(spelling);
+        arguments[i] = convert(arguments[i], type, site);
+    }
+
+    uint64_t key = hash_combine(FNV_OFFSET_BASIS, reinterpret_cast<uintptr_t>(&function));
+    for (const auto &argument : arguments) key = hash_value(key, argument);
+
+    for (auto [it, last] = memo_index.equal_range(key); it != last; ++it) {
+        const MemoEntry &entry = memo[it->second];
+        if (entry.function == &function && entry.arguments == arguments) {
+            ++hits;
+            return entry.result;
+        }
+    }
+
+    if (++depth > MAX_DEPTH) {
+        throw Failure(&site, "Constant evaluation nests deeper than " + std::to_string(MAX_DEPTH) + " calls");
+    }
+
+    Frame frame;
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        frame.bindings.push_back({function.parameters[i], arguments[i], arguments[i].type, true});
+    }
+    charge(sizeof(Frame) + arguments.size() * sizeof(Binding), site);
+
+    for (const auto &node : function.body) {
+        exec(*node, frame);
+        if (frame.returned) break;
+    }
+
+    const TypeId result_type = function.return_type.empty() ? TYPE_UNKNOWN : TypeTable::primitive(function.return_type);
+    if (!frame.returned) {
+        if (result_type != TYPE_UNKNOWN && result_type != TYPE_VOID) {
+            throw Failure(&function, "Function '" + function.name + "' ended without returning a value");
+        }
+        frame.result = {std::monostate{}, TYPE_VOID};
+    }
+    const ConstValue result = convert(frame.result, result_type, function);
+    --depth;
+
+    memo_index.emplace(key, memo.size());
+    memo.push_back({&function, std::move(arguments), result});
+    return result;
+}
+
+// ===== STATEMENTS =====
+
+void ConstEvaluator::exec(const ASTNode &node, Frame &frame) {
+    step(node);
+
+    if (const auto *variable = dynamic_cast<const VariableDeclaration *>(&node)) {
+        const TypeId declared = variable->type_name.empty() ? TYPE_UNKNOWN : TypeTable::primitive(variable->type_name);
+        Binding binding{variable->name, {}, declared, variable->kind == TokenType::VAR, false};
+        if (variable->initializer) {
+            binding.value = convert(eval(*variable->initializer, frame), declared, *variable->initializer);
+            if (declared == TYPE_UNKNOWN) binding.declared = binding.value.type;
+            binding.initialized = true;
+        }
+        charge(sizeof(Binding), node);
+        frame.bindings.push_back(std::move(binding));
+    } else if (const auto *expression = dynamic_cast<const ExpressionStatement *>(&node)) {
+        eval(*expression->expression, frame);
+    } else if (const auto *ret = dynamic_cast<const ReturnStatement *>(&node)) {
+        frame.result = ret->expression ? eval(*ret->expression, frame) : ConstValue{std::monostate{}, TYPE_VOID};
+        frame.returned = true;
+    } else if (const auto *block = dynamic_cast<const BlockStatement *>(&node)) {
+        const size_t mark = frame.bindings.size();
+        for (const auto &statement : block->statements) {
+            exec(*statement, frame);
+            if (frame.returned) break;
+        }
+        frame.bindings.erase(frame.bindings.begin() + static_cast<ptrdiff_t>(mark), frame.bindings.end());
+    } else if (const auto *branch = dynamic_cast<const IfStatement *>(&node)) {
+        const ConstValue condition = eval(*branch->condition, frame);
+        const auto *taken = std::get_if<bool>(&condition.value);
+        if (!taken) throw Failure(branch->condition.get(), "Condition is not a bool");
+        if (*taken) {
+            exec(*branch->then_branch, frame);
+        } else if (branch->else_branch) {
+            exec(*branch->else_branch, frame);
+        }
+    } else if (const auto *loop = dynamic_cast<const WhileStatement *>(&node)) {
+        while (!frame.returned) {
+            const ConstValue condition = eval(*loop->condition, frame);
+            const auto *again = std::get_if<bool>(&condition.value);
+            if (!again) throw Failure(loop->condition.get(), "Condition is not a bool");
+            if (!*again) break;
+            exec(*loop->body, frame);
+        }
+    } else {
+        throw Failure(&node, "Statement cannot be evaluated at compile time");
+    }
+}
+
+// ===== VALUES =====
+
+ConstValue ConstEvaluator::apply(const Token &op, TokenType operation, const ConstValue &left,
+                                 const ConstValue &right, const ASTNode &at) {
+    const TypeId common = types.unify(left.type, right.type);
+    const auto mismatch = [&] {
+        return Failure(&at, "Operator '" + op.lexeme + "' cannot be applied to " + types.to_string(left.type) + " and " +
+                            types.to_string(right.type));
+    };
+    if (common == TYPE_ERROR) throw mismatch();
+
+    const ConstValue lhs = convert(left, common, at);
+    const ConstValue rhs = convert(right, common, at);
+    const auto compare = [&](auto a, auto b) -> ConstValue {
+        switch (operation) {
+            case TokenType::EQUAL_EQUAL: return {a == b, TYPE_BOOL};
+            case TokenType::NOT_EQUAL: return {a != b, TYPE_BOOL};
+            case TokenType::LESS: return {a < b, TYPE_BOOL};
+            case TokenType::LESS_EQUAL: return {a <= b, TYPE_BOOL};
+            case TokenType::GREATER: return {a > b, TYPE_BOOL};
+            case TokenType::GREATER_EQUAL: return {a >= b, TYPE_BOOL};
+            default: throw mismatch();
+        }
+    };
+
+    if (types.is_integer(common)) {
+        const int64_t a = std::get<int64_t>(lhs.value), b = std::get<int64_t>(rhs.value);
+        const unsigned bits = types.bit_width(common);
+        const bool is_signed = types.is_signed(common);
+
+        if ((operation == TokenType::SLASH || operation == TokenType::MODULO) && b == 0) {
+            throw Failure(&at, "Division by zero in constant expression");
+        }
+
+        bool overflow = false;
+        if (!is_signed) {
+            const uint64_t x = static_cast<uint64_t>(a), y = static_cast<uint64_t>(b);
+            uint64_t result;
+            switch (operation) {
+                case TokenType::PLUS: overflow = __builtin_add_overflow(x, y, &result); break;
+                case TokenType::MINUS: overflow = __builtin_sub_overflow(x, y, &result); break;
+                case TokenType::STAR: overflow = __builtin_mul_overflow(x, y, &result); break;
+                case TokenType::SLASH: result = x / y; break;
+                case TokenType::MODULO: result = x % y; break;
+                default: return compare(x, y);
+            }
+            if (!overflow && truncate(result, bits) == result) return {static_cast<int64_t>(result), common};
+        } else {
+            int64_t result;
+            switch (operation) {
+                case TokenType::PLUS: overflow = __builtin_add_overflow(a, b, &result); break;
+                case TokenType::MINUS: overflow = __builtin_sub_overflow(a, b, &result); break;
+                case TokenType::STAR: overflow = __builtin_mul_overflow(a, b, &result); break;
+                case TokenType::SLASH:
+                case TokenType::MODULO:
+                    overflow = a == std::numeric_limits<int64_t>::min() && b == -1;
+                    result = overflow ? 0 : operation == TokenType::SLASH ? a / b : a % b;
+                    break;
+                default: return compare(a, b);
+            }
+            if (!overflow && fits(result, bits, true)) return {result, common};
+        }
+
+        // Overflow is an error rather than a wrap, so a table never silently changes contents
+        throw Failure(&at, "Integer overflow in constant expression: " + describe(lhs) + " " + op.lexeme + " " +
+                           describe(rhs) + " does not fit in " + types.to_string(common));
+    }
+
+    if (types.is_numeric(common)) {
+        const double a = std::get<double>(lhs.value), b = std::get<double>(rhs.value);
+        double result;
+        switch (operation) {
+            case TokenType::PLUS: result = a + b; break;
+            case TokenType::MINUS: result = a - b; break;
+            case TokenType::STAR: result = a * b; break;
+            case TokenType::SLASH: result = a / b; break;
+            case TokenType::MODULO: result = std::fmod(a, b); break;
+            default: return compare(a, b);
+        }
+        return convert({result, common}, common, at);
+    }
+
+    if (common == TYPE_STRING && operation == TokenType::PLUS) {
+        std::string result = std::get<std::string>(lhs.value) + std::get<std::string>(rhs.value);
+        charge(result.size(), at);
+        return {std::move(result), TYPE_STRING};
+    }
+    if (common == TYPE_CHAR) return compare(std::get<char>(lhs.value), std::get<char>(rhs.value));
+    if (operation == TokenType::EQUAL_EQUAL || operation == TokenType::NOT_EQUAL) {
+        return compare(lhs.value, rhs.value);
+    }
+
+    throw mismatch();
+}
+
+// Widening or range-checked narrowing, the conversions the checker allows implicitly
+ConstValue ConstEvaluator::convert(const ConstValue &value, TypeId target, const ASTNode &at) {
+    if (target == TYPE_UNKNOWN || target == TYPE_ERROR) return value;
+
+    if (types.is_integer(target)) {
+        if (const auto *i = std::get_if<int64_t>(&value.value)) {
+            // A u64 above INT64_MAX is negative here but fits only another u64
+            const bool huge = *i < 0 && !types.is_signed(value.type);
+            if ((huge && target != TYPE_U64) || (!huge && !fits(*i, types.bit_width(target), types.is_signed(target)))) {
+                throw Failure(&at, "Value " + describe(value) + " does not fit in " + types.to_string(target));
+            }
+            return {*i, target};
+        }
+    } else if (types.is_numeric(target)) {
+        double result;
+        if (const auto *i = std::get_if<int64_t>(&value.value)) {
+            result = types.is_signed(value.type) ? static_cast<double>(*i) : static_cast<double>(static_cast<uint64_t>(*i));
+        } else if (const auto *d = std::get_if<double>(&value.value)) {
+            result = *d;
+        } else {
+            throw Failure(&at, "Expected " + types.to_string(target) + " but found " + types.to_string(value.type));
+        }
+        if (types.kind(target) == TypeKind::Float) result = static_cast<float>(result);
+        return {result, target};
+    } else if (value.type == target) {
+        return value;
+    }
+
+    throw Failure(&at, "Expected " + types.to_string(target) + " but found " + types.to_string(value.type));
+}
+
+std::string ConstEvaluator::describe(const ConstValue &value) const {
+    if (const auto *i = std::get_if<int64_t>(&value.value)) {
+        return types.is_signed(value.type) ? std::to_string(*i) : std::to_string(static_cast<uint64_t>(*i));
+    }
+    if (const auto *d = std::get_if<double>(&value.value)) return std::to_string(*d);
+    return types.to_string(value.type) + " value";
+}
+
+void ConstEvaluator::step(const ASTNode &at) {
+    if (++steps > MAX_STEPS) {
+        throw Failure(&at, "Constant evaluation exceeds the limit of " + std::to_string(MAX_STEPS) + " steps");
+    }
+}
+
+void ConstEvaluator::charge(size_t amount, const ASTNode &at) {
+    bytes += amount;
+    if (bytes > MAX_BYTES) {
+        throw Failure(&at, "Constant evaluation uses more than " + std::to_string(MAX_BYTES >> 20) + " MiB of memory");
+    }
+}
@@ -0,0 +1,45 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/semantic/ModuleInterface.h"
+
+namespace {
+    std::string resolved(const std::string &spelling, const TypeTable *types) {
+        if (!types || spelling.empty()) return spelling;
+        const TypeId type = TypeTable::primitive(spelling);
+        return type != TYPE_ERROR ? types->to_string(type) : spelling;
+    }
+
+    // Only primitive types have a spelling the checker can read back
+    std::string inferred(const VariableDeclaration &variable, const TypeTable *types) {
+        if (!types || !variable.type_name.empty() || !variable.initializer) return variable.type_name;
+        const TypeId type = variable.initializer->type;
+        return type > TYPE_NULL && type <= TYPE_DOUBLE ? types->to_string(type) : std::string();
+    }
+}
+
+ModuleInterface ModuleInterface::from_program(const std::string &module, const Program &program,
+                                              const TypeTable *types) {
+    ModuleInterface interface;
+    interface.module = module;
+
+    // Private names are recorded too so importers get "is private" rather than "undeclared"
+    for (const auto &node : program.statements) {
+        if (const auto *function = dynamic_cast<const FunctionDeclaration *>(node.get())) {
+            std::vector<std::string> parameters;
+            for (const auto &spelling : function->parameter_types) parameters.push_back(resolved(spelling, types));
+            interface.symbols.push_back({function->name, SymbolKind::Function, function->visibility,
+                                         resolved(function->return_type, types), std::move(parameters)});
+        } else if (const auto *variable = dynamic_cast<const VariableDeclaration *>(node.get())) {
+            interface.symbols.push_back({variable->name, symbol_kind_for(variable->kind), variable->visibility,
+                                         resolved(inferred(*variable, types), types), {}});
+        }
+    }
+
+    return interface;
+}
+
+std::string package_of(const std::string &module) {
+    return module.substr(0, module.find('.'));
+}
@@ -0,0 +1,87 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/semantic/SymbolTable.h"
+
+namespace {
+    constexpr size_t INITIAL_CAPACITY = 64; // must be a power of two
+
+    size_t slot_hash(NameId name, size_t mask) {
+        return (static_cast<uint64_t>(name) * 0x9e3779b97f4a7c15ull >> 32) & mask;
+    }
+}
+
+SymbolTable::SymbolTable() : slots(INITIAL_CAPACITY) {
+    push_scope(); // global scope
+}
+
+void SymbolTable::push_scope() {
+    scopes.push_back({undo_log.size(), symbols.size()});
+}
+
+void SymbolTable::pop_scope() {
+    const ScopeMark mark = scopes.back();
+    scopes.pop_back();
+
+    while (undo_log.size() > mark.undo_size) {
+        const UndoEntry &entry = undo_log.back();
+        slots[entry.slot].symbol = entry.shadowed;
+        undo_log.pop_back();
+    }
+    symbols.resize(mark.symbol_count);
+}
+
+uint32_t SymbolTable::depth() const {
+    return static_cast<uint32_t>(scopes.size() - 1);
+}
+
+size_t SymbolTable::find_slot(NameId name) const {
+    const size_t mask = slots.size() - 1;
+    size_t index = slot_hash(name, mask);
+
+    while (slots[index].name != name && slots[index].name != INVALID_NAME) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+// Slots are never removed, only rebound, so growing just re-seats every used key
+void SymbolTable::grow() {
+    std::vector<Slot> old = std::move(slots);
+    slots.assign(old.size() * 2, Slot{});
+
+    std::vector<size_t> moved(old.size());
+    for (size_t i = 0; i < old.size(); ++i) {
+        if (old[i].name == INVALID_NAME) continue;
+        moved[i] = find_slot(old[i].name);
+        slots[moved[i]] = old[i];
+    }
+
+    for (auto &entry : undo_log) entry.slot = moved[entry.slot];
+}
+
+const Symbol *SymbolTable::declare(Symbol symbol) {
+    if ((used_slots + 1) * 10 > slots.size() * 7) grow();
+
+    const size_t index = find_slot(symbol.name);
+    Slot &slot = slots[index];
+
+    if (slot.name == INVALID_NAME) {
+        slot.name = symbol.name;
+        ++used_slots;
+    } else if (slot.symbol != NO_SYMBOL && symbols[slot.symbol].depth == depth()) {
+        return &symbols[slot.symbol];
+    }
+
+    symbol.depth = depth();
+    undo_log.push_back({index, slot.symbol});
+    slot.symbol = static_cast<int32_t>(symbols.size());
+    symbols.push_back(symbol);
+    return nullptr;
+}
+
+const Symbol *SymbolTable::lookup(NameId name) const {
+    const Slot &slot = slots[find_slot(name)];
+    return slot.symbol == NO_SYMBOL ? nullptr : &symbols[slot.symbol];
+}
@@ -0,0 +1,272 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/semantic/TypeTable.h"
+#include "../../include/util/Hash.h"
+
+#include <unordered_map>
+
+namespace {
+    constexpr TypeId EMPTY_SLOT = UINT32_MAX;
+
+    uint64_t memo_key(TypeId a, TypeId b) {
+        return static_cast<uint64_t>(a) << 32 | b;
+    }
+
+    size_t memo_slot(uint64_t key, size_t size) {
+        return (key * 0x9e3779b97f4a7c15ull >> 40) & (size - 1);
+    }
+}
+
+TypeTable::TypeTable() : index(64, EMPTY_SLOT) {
+    // Order must match the TYPE_* constants
+    intern(TypeKind::Unknown, 0, 0, {});
+    intern(TypeKind::Error, 0, 0, {});
+    intern(TypeKind::Void, 0, 0, {});
+    intern(TypeKind::Null, 0, 0, {});
+    intern(TypeKind::Bool, 0, 0, {});
+    intern(TypeKind::Char, 0, 0, {});
+    intern(TypeKind::String, 0, 0, {});
+    for (const bool is_signed : {true, false}) {
+        for (const uint32_t bits : {8u, 16u, 32u, 64u}) intern(TypeKind::Int, bits, is_signed, {});
+    }
+    for (const uint32_t bits : {8u, 16u, 32u, 64u}) intern(TypeKind::Float, bits, 0, {});
+    intern(TypeKind::Double, 64, 0, {});
+}
+
+TypeId TypeTable::function(std::span<const TypeId> parameters, TypeId result) {
+    return intern(TypeKind::Function, result, 0, parameters);
+}
+
+TypeId TypeTable::array(TypeId element, uint32_t length) {
+    return intern(TypeKind::Array, element, length, {});
+}
+
+TypeId TypeTable::nominal(TypeKind kind, NameId name, NameId module) {
+    return intern(kind, name, module, {});
+}
+
+TypeId TypeTable::primitive(std::string_view spelling) {
+    static const std::unordered_map<std::string_view, TypeId> names = {
+        {"void", TYPE_VOID}, {"bool", TYPE_BOOL}, {"char", TYPE_CHAR}, {"string", TYPE_STRING},
+        {"i8", TYPE_I8}, {"i16", TYPE_I16}, {"i32", TYPE_I32}, {"i64", TYPE_I64}, {"int", TYPE_I64},
+        {"u8", TYPE_U8}, {"u16", TYPE_U16}, {"u32", TYPE_U32}, {"u64", TYPE_U64}, {"uint", TYPE_U64},
+        {"f8", TYPE_F8}, {"f16", TYPE_F16}, {"f32", TYPE_F32}, {"f64", TYPE_F64}, {"float", TYPE_F64},
+        {"double", TYPE_DOUBLE},
+    };
+
+    const auto it = names.find(spelling);
+    return it != names.end() ? it->second : TYPE_ERROR;
+}
+
+TypeId TypeTable::literal(TokenType type) {
+    switch (type) {
+        case TokenType::INT8_LITERAL: return TYPE_I8;
+        case TokenType::INT16_LITERAL: return TYPE_I16;
+        case TokenType::INT32_LITERAL: return TYPE_I32;
+        case TokenType::INT64_LITERAL: return TYPE_I64;
+        case TokenType::UINT8_LITERAL: return TYPE_U8;
+        case TokenType::UINT16_LITERAL: return TYPE_U16;
+        case TokenType::UINT32_LITERAL: return TYPE_U32;
+        case TokenType::UINT64_LITERAL: return TYPE_U64;
+        case TokenType::FLOAT8_LITERAL: return TYPE_F8;
+        case TokenType::FLOAT16_LITERAL: return TYPE_F16;
+        case TokenType::FLOAT32_LITERAL: return TYPE_F32;
+        case TokenType::FLOAT64_LITERAL: return TYPE_F64;
+        case TokenType::DOUBLE_LITERAL: return TYPE_DOUBLE;
+        case TokenType::STRING_LITERAL: return TYPE_STRING;
+        case TokenType::CHAR_LITERAL: return TYPE_CHAR;
+        case TokenType::BOOLEAN_LITERAL: return TYPE_BOOL;
+        case TokenType::NULL_LITERAL: return TYPE_NULL;
+        default: return TYPE_UNKNOWN;
+    }
+}
+
+// ===== INTERNING =====
+
+TypeId TypeTable::intern(TypeKind kind, uint32_t a, uint32_t b, std::span<const TypeId> parameters) {
+    uint64_t hash = hash_combine(FNV_OFFSET_BASIS, static_cast<uint64_t>(kind));
+    hash = hash_combine(hash, a);
+    hash = hash_combine(hash, b);
+    for (const TypeId child : parameters) hash = hash_combine(hash, child);
+
+    size_t mask = index.size() - 1;
+    size_t slot = hash & mask;
+    while (index[slot] != EMPTY_SLOT) {
+        const TypeInfo &info = types[index[slot]];
+        if (info.hash == hash && same_shape(info, kind, a, b, parameters)) return index[slot];
+        slot = (slot + 1) & mask;
+    }
+
+    const auto id = static_cast<TypeId>(types.size());
+    TypeInfo info{kind, a, b, static_cast<uint32_t>(children.size()), static_cast<uint32_t>(parameters.size()), hash};
+    children.insert(children.end(), parameters.begin(), parameters.end());
+    types.push_back(info);
+    index[slot] = id;
+
+    if (types.size() * 10 > index.size() * 7) grow_index();
+    return id;
+}
+
+bool TypeTable::same_shape(const TypeInfo &info, TypeKind kind, uint32_t a, uint32_t b,
+                           std::span<const TypeId> parameters) const {
+    if (info.kind != kind || info.a != a || info.b != b || info.child_count != parameters.size()) return false;
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        if (children[info.child_begin + i] != parameters[i]) return false;
+    }
+    return true;
+}
+
+void TypeTable::grow_index() {
+    index.assign(index.size() * 2, EMPTY_SLOT);
+    const size_t mask = index.size() - 1;
+
+    for (TypeId id = 0; id < types.size(); ++id) {
+        size_t slot = types[id].hash & mask;
+        while (index[slot] != EMPTY_SLOT) slot = (slot + 1) & mask;
+        index[slot] = id;
+    }
+}
+
+// ===== QUERIES =====
+
+TypeKind TypeTable::kind(TypeId type) const {
+    return types[type].kind;
+}
+
+bool TypeTable::is_integer(TypeId type) const {
+    return kind(type) == TypeKind::Int;
+}
+
+bool TypeTable::is_floating(TypeId type) const {
+    return kind(type) == TypeKind::Float || kind(type) == TypeKind::Double;
+}
+
+bool TypeTable::is_numeric(TypeId type) const {
+    return is_integer(type) || is_floating(type);
+}
+
+bool TypeTable::is_signed(TypeId type) const {
+    return is_integer(type) ? types[type].b != 0 : is_floating(type);
+}
+
+unsigned TypeTable::bit_width(TypeId type) const {
+    return is_numeric(type) ? types[type].a : 0;
+}
+
+std::span<const TypeId> TypeTable::parameters(TypeId function) const {
+    const TypeInfo &info = types[function];
+    return {children.data() + info.child_begin, info.child_count};
+}
+
+TypeId TypeTable::result(TypeId function) const {
+    return types[function].a;
+}
+
+TypeId TypeTable::element(TypeId array) const {
+    return types[array].a;
+}
+
+uint32_t TypeTable::length(TypeId array) const {
+    return types[array].b;
+}
+
+size_t TypeTable::size() const {
+    return types.size();
+}
+
+// ===== RELATIONS =====
+
+bool TypeTable::is_assignable(TypeId from, TypeId to) {
+    if (from == to) return true;
+
+    const uint64_t key = memo_key(from, to);
+    MemoEntry &entry = assignable_memo[memo_slot(key, MEMO_SIZE)];
+    if (entry.key != key) {
+        entry.key = key;
+        entry.value = compute_assignable(from, to);
+    }
+    return entry.value != 0;
+}
+
+bool TypeTable::compute_assignable(TypeId from, TypeId to) const {
+    const TypeKind source = kind(from);
+    const TypeKind target = kind(to);
+
+    if (source == TypeKind::Unknown || target == TypeKind::Unknown) return true;
+    if (source == TypeKind::Error || target == TypeKind::Error) return true;
+
+    // null fits anything with reference semantics
+    if (source == TypeKind::Null) {
+        return target == TypeKind::String || target == TypeKind::Class || target == TypeKind::Interface;
+    }
+
+    // Widening: same signedness to more bits, unsigned to strictly wider signed
+    if (source == TypeKind::Int && target == TypeKind::Int) {
+        const unsigned from_bits = bit_width(from), to_bits = bit_width(to);
+        if (is_signed(from) == is_signed(to)) return from_bits <= to_bits;
+        return !is_signed(from) && from_bits < to_bits;
+    }
+
+    if (is_floating(from) && is_floating(to)) return bit_width(from) <= bit_width(to);
+
+    // Integers convert implicitly to any float wide enough to hold them exactly
+    if (source == TypeKind::Int && is_floating(to)) return bit_width(from) < bit_width(to);
+
+    return false;
+}
+
+TypeId TypeTable::unify(TypeId a, TypeId b) {
+    if (a == b) return a;
+
+    const uint64_t key = a < b ? memo_key(a, b) : memo_key(b, a);
+    MemoEntry &entry = unify_memo[memo_slot(key, MEMO_SIZE)];
+    if (entry.key != key) {
+        entry.key = key;
+        entry.value = compute_unify(a, b);
+    }
+    return entry.value;
+}
+
+TypeId TypeTable::compute_unify(TypeId a, TypeId b) const {
+    if (kind(a) == TypeKind::Error || kind(b) == TypeKind::Error) return TYPE_ERROR;
+    if (kind(a) == TypeKind::Unknown) return b;
+    if (kind(b) == TypeKind::Unknown) return a;
+
+    if (compute_assignable(a, b)) return b;
+    if (compute_assignable(b, a)) return a;
+
+    return TYPE_ERROR;
+}
+
+std::string TypeTable::to_string(TypeId type) const {
+    const TypeInfo &info = types[type];
+
+    switch (info.kind) {
+        case TypeKind::Unknown: return "unknown";
+        case TypeKind::Error: return "<error>";
+        case TypeKind::Void: return "void";
+        case TypeKind::Null: return "null";
+        case TypeKind::Bool: return "bool";
+        case TypeKind::Char: return "char";
+        case TypeKind::String: return "string";
+        case TypeKind::Int: return (info.b ? "i" : "u") + std::to_string(info.a);
+        case TypeKind::Float: return "f" + std::to_string(info.a);
+        case TypeKind::Double: return "double";
+        case TypeKind::Function: {
+            std::string text = "func(";
+            for (uint32_t i = 0; i < info.child_count; ++i) {
+                if (i) text += ", ";
+                text += to_string(children[info.child_begin + i]);
+            }
+            return text + ") -> " + to_string(info.a);
+        }
+        case TypeKind::Array: return "[" + to_string(info.a) + "; " + std::to_string(info.b) + "]";
+        case TypeKind::Struct:
+        case TypeKind::Class:
+        case TypeKind::Interface:
+            return std::string(StringInterner::global().spelling(info.a));
+        default: return "<invalid>";
+    }
+}
@@ -0,0 +1,280 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/server/CompileServer.h"
+#include "../../include/commands/Commands.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <streambuf>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    constexpr uint8_t CHANNEL_EXIT = 0;
+    constexpr uint8_t CHANNEL_STDOUT = 1;
+    constexpr uint8_t CHANNEL_STDERR = 2;
+    constexpr uint32_t MAX_REQUEST_STRINGS = 1 << 16;
+    constexpr uint32_t MAX_STRING_SIZE = 1 << 20;
+
+    // Owns a socket descriptor
+    class Socket {
+    public:
+        explicit Socket(int fd = -1) : fd(fd) {}
+        Socket(const Socket &) = delete;
+        Socket &operator=(const Socket &) = delete;
+        ~Socket() { if (fd >= 0) ::close(fd); }
+
+        [[nodiscard]] int get() const { return fd; }
+        [[nodiscard]] bool valid() const { return fd >= 0; }
+
+    private:
+        int fd;
+    };
+
+    bool make_address(const std::string &path, sockaddr_un &address) {
+        address = {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof address.sun_path) return false;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+
+    bool write_all(int fd, const void *data, size_t size) {
+        const auto *bytes = static_cast<const char *>(data);
+        while (size > 0) {
+            const ssize_t written = ::send(fd, bytes, size, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool read_all(int fd, void *data, size_t size) {
+        auto *bytes = static_cast<char *>(data);
+        while (size > 0) {
+            const ssize_t got = ::recv(fd, bytes, size, 0);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) return false;
+            bytes += got;
+            size -= static_cast<size_t>(got);
+        }
+        return true;
+    }
+
+    bool write_string(int fd, const std::string &value) {
+        const auto size = static_cast<uint32_t>(value.size());
+        return write_all(fd, &size, sizeof size) && write_all(fd, value.data(), value.size());
+    }
+
+    bool read_string(int fd, std::string &value) {
+        uint32_t size = 0;
+        if (!read_all(fd, &size, sizeof size) || size > MAX_STRING_SIZE) return false;
+        value.resize(size);
+        return read_all(fd, value.data(), size);
+    }
+
+    bool write_frame(int fd, uint8_t channel, const char *data, uint32_t size) {
+        return write_all(fd, &channel, sizeof channel) && write_all(fd, &size, sizeof size) &&
+               write_all(fd, data, size);
+    }
+
+    // Sends everything written to it as frames on one channel. A client that
+    // went away only loses its output; the server keeps going.
+    class FrameBuffer : public std::streambuf {
+    public:
+        FrameBuffer(int fd, uint8_t channel) : fd(fd), channel(channel) {
+            setp(buffer, buffer + sizeof buffer);
+        }
+
+        ~FrameBuffer() override { sync(); }
+
+    protected:
+        int_type overflow(int_type ch) override {
+            flush();
+            if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(ch);
+                pbump(1);
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        int sync() override {
+            flush();
+            return 0;
+        }
+
+    private:
+        void flush() {
+            const auto size = static_cast<uint32_t>(pptr() - pbase());
+            if (size > 0 && connected) connected = write_frame(fd, channel, pbase(), size);
+            setp(buffer, buffer + sizeof buffer);
+        }
+
+        int fd;
+        uint8_t channel;
+        bool connected = true;
+        char buffer[4096];
+    };
+
+    // Points std::cout and std::cerr at a client for the lifetime of the scope
+    class RedirectScope {
+    public:
+        explicit RedirectScope(int fd)
+            : out(fd, CHANNEL_STDOUT), err(fd, CHANNEL_STDERR),
+              saved_out(std::cout.rdbuf(&out)), saved_err(std::cerr.rdbuf(&err)) {
+        }
+
+        ~RedirectScope() {
+            std::cout.flush();
+            std::cerr.flush();
+            std::cout.rdbuf(saved_out);
+            std::cerr.rdbuf(saved_err);
+        }
+
+    private:
+        FrameBuffer out;
+        FrameBuffer err;
+        std::streambuf *saved_out;
+        std::streambuf *saved_err;
+    };
+
+    // Returns false once a client asks the server to stop
+    bool handle(int client) {
+        uint32_t count = 0;
+        if (!read_all(client, &count, sizeof count) || count == 0 || count > MAX_REQUEST_STRINGS) return true;
+
+        std::string cwd;
+        std::vector<std::string> args(count - 1);
+        if (!read_string(client, cwd)) return true;
+        for (auto &arg : args) {
+            if (!read_string(client, arg)) return true;
+        }
+
+        int32_t status = 0;
+        const bool shutdown = !args.empty() && args[0] == "--shutdown";
+        {
+            RedirectScope redirect(client);
+            std::error_code ec;
+            std::filesystem::current_path(cwd, ec);
+
+            if (ec) {
+                std::cerr << "Server cannot enter " << cwd << ": " << ec.message() << "\n";
+                status = 1;
+            } else if (!shutdown && !args.empty() && !CompileServer::forwardable(args[0])) {
+                std::cerr << "The compile server does not run " << args[0] << "\n";
+                status = 1;
+            } else if (!shutdown) {
+                try {
+                    status = Commands::run(args, false);
+                } catch (const std::exception &e) {
+                    std::cerr << "Internal error: " << e.what() << "\n";
+                    status = 1;
+                }
+            }
+        }
+
+        write_frame(client, CHANNEL_EXIT, reinterpret_cast<const char *>(&status), sizeof status);
+        return !shutdown;
+    }
+}
+
+bool CompileServer::forwardable(const std::string &command) {
+    // Not --run: requests are served one at a time, and a program that never
+    // finishes or waits for input would hold up every client after it
+    return command == "--check" || command == "--format" || command == "--lexer" || command == "--shutdown";
+}
+
+std::string CompileServer::default_socket_path() {
+    if (const char *runtime = std::getenv("XDG_RUNTIME_DIR"); runtime && *runtime) {
+        return std::string(runtime) + "/sparkc.sock";
+    }
+    return "/tmp/sparkc-" + std::to_string(::getuid()) + ".sock";
+}
+
+int CompileServer::serve(const std::string &socket_path) {
+    sockaddr_un address{};
+    if (!make_address(socket_path, address)) {
+        std::cerr << "Socket path too long: " << socket_path << "\n";
+        return 1;
+    }
+
+    // A socket file nobody answers on is left over from a server that died
+    {
+        Socket probe(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+        if (probe.valid() && ::connect(probe.get(), reinterpret_cast<sockaddr *>(&address), sizeof address) == 0) {
+            std::cerr << "A compile server is already listening on " << socket_path << "\n";
+            return 1;
+        }
+    }
+    ::unlink(socket_path.c_str());
+
+    Socket listener(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+    const mode_t previous_mask = ::umask(0077); // only our user may connect
+    const bool bound = listener.valid() &&
+                       ::bind(listener.get(), reinterpret_cast<sockaddr *>(&address), sizeof address) == 0;
+    ::umask(previous_mask);
+
+    if (!bound || ::listen(listener.get(), 64) != 0) {
+        std::cerr << "Could not listen on " << socket_path << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    std::cerr << "sparkc server listening on " << socket_path << "\n";
+
+    bool running = true;
+    while (running) {
+        Socket client(::accept4(listener.get(), nullptr, nullptr, SOCK_CLOEXEC));
+        if (!client.valid()) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            std::cerr << "accept failed: " << std::strerror(errno) << "\n";
+            break;
+        }
+        running = handle(client.get());
+    }
+
+    ::unlink(socket_path.c_str());
+    return running ? 1 : 0;
+}
+
+std::optional<int> CompileServer::forward(const std::string &socket_path, const std::vector<std::string> &args) {
+    sockaddr_un address{};
+    if (!make_address(socket_path, address)) return std::nullopt;
+
+    Socket server(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+    if (!server.valid() || ::connect(server.get(), reinterpret_cast<sockaddr *>(&address), sizeof address) != 0) {
+        return std::nullopt;
+    }
+
+    std::error_code ec;
+    const auto count = static_cast<uint32_t>(args.size() + 1);
+    bool sent = write_all(server.get(), &count, sizeof count) &&
+                write_string(server.get(), std::filesystem::current_path(ec).string());
+    for (const auto &arg : args) sent = sent && write_string(server.get(), arg);
+
+    std::string payload;
+    uint8_t channel = 0;
+    while (sent && read_all(server.get(), &channel, sizeof channel) && read_string(server.get(), payload)) {
+        if (channel == CHANNEL_EXIT && payload.size() == sizeof(int32_t)) {
+            int32_t status = 0;
+            std::memcpy(&status, payload.data(), sizeof status);
+            return status;
+        }
+        std::ostream &out = channel == CHANNEL_STDERR ? std::cerr : std::cout;
+        out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        out.flush();
+    }
+
+    std::cerr << "Lost connection to the compile server at " << socket_path << "\n";
+    return 1;
+}
@@ -0,0 +1,313 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/util/Json.h"
+
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <sstream>
+
+namespace {
+    class JsonParser {
+    public:
+        explicit JsonParser(std::string_view text) : text(text) {}
+
+        JsonValue document() {
+            JsonValue result = value(0);
+            skip_space();
+            if (position != text.size()) fail("trailing characters");
+            return result;
+        }
+
+    private:
+        static constexpr int MAX_DEPTH = 256;
+
+        [[noreturn]] void fail(const std::string &what) const {
+            throw JsonError("Invalid JSON at offset " + std::to_string(position) + ": " + what);
+        }
+
+        void skip_space() {
+            while (position < text.size() &&
+                   (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r')) {
+                ++position;
+            }
+        }
+
+        bool consume(char expected) {
+            skip_space();
+            if (position < text.size() && text[position] == expected) {
+                ++position;
+                return true;
+            }
+            return false;
+        }
+
+        void expect_word(std::string_view word) {
+            if (text.substr(position, word.size()) != word) fail("unexpected token");
+            position += word.size();
+        }
+
+        JsonValue value(int depth) {
+            if (depth > MAX_DEPTH) fail("nesting too deep");
+            skip_space();
+            if (position >= text.size()) fail("unexpected end of input");
+
+            switch (text[position]) {
+                case '{': return object(depth);
+                case '[': return array(depth);
+                case '"': return string();
+                case 't': expect_word("true"); return true;
+                case 'f': expect_word("false"); return false;
+                case 'n': expect_word("null"); return nullptr;
+                default: return number();
+            }
+        }
+
+        JsonValue object(int depth) {
+            ++position;
+            JsonValue::Object members;
+            if (consume('}')) return members;
+
+            do {
+                skip_space();
+                if (position >= text.size() || text[position] != '"') fail("expected member name");
+                std::string key = string().as_string();
+                if (!consume(':')) fail("expected ':'");
+                members.emplace_back(std::move(key), value(depth + 1));
+            } while (consume(','));
+
+            if (!consume('}')) fail("expected '}'");
+            return members;
+        }
+
+        JsonValue array(int depth) {
+            ++position;
+            JsonValue::Array elements;
+            if (consume(']')) return elements;
+
+            do {
+                elements.push_back(value(depth + 1));
+            } while (consume(','));
+
+            if (!consume(']')) fail("expected ']'");
+            return elements;
+        }
+
+        JsonValue number() {
+            const size_t begin = position;
+            if (position < text.size() && text[position] == '-') ++position;
+            while (position < text.size() &&
+                   (std::isdigit(static_cast<unsigned char>(text[position])) || text[position] == '.' ||
+                    text[position] == 'e' || text[position] == 'E' || text[position] == '+' || text[position] == '-')) {
+                ++position;
+            }
+
+            double result = 0;
+            const auto [end, error] = std::from_chars(text.data() + begin, text.data() + position, result);
+            if (error != std::errc() || end != text.data() + position || begin == position) fail("bad number");
+            return result;
+        }
+
+        uint32_t hex4() {
+            if (text.size() - position < 4) fail("truncated escape");
+            uint32_t code = 0;
+            const auto [end, error] = std::from_chars(text.data() + position, text.data() + position + 4, code, 16);
+            if (error != std::errc() || end != text.data() + position + 4) fail("bad escape");
+            position += 4;
+            return code;
+        }
+
+        static void append_utf8(std::string &out, uint32_t code) {
+            if (code < 0x80) {
+                out += static_cast<char>(code);
+            } else if (code < 0x800) {
+                out += static_cast<char>(0xC0 | (code >> 6));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                out += static_cast<char>(0xE0 | (code >> 12));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (code >> 18));
+                out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+
+        JsonValue string() {
+            ++position; // opening quote
+            std::string result;
+
+            while (true) {
+                if (position >= text.size()) fail("unterminated string");
+                const char c = text[position++];
+                if (c == '"') break;
+                if (c != '\\') {
+                    result += c;
+                    continue;
+                }
+
+                if (position >= text.size()) fail("unterminated escape");
+                switch (text[position++]) {
+                    case '"': result += '"'; break;
+                    case '\\': result += '\\'; break;
+                    case '/': result += '/'; break;
+                    case 'b': result += '\b'; break;
+                    case 'f': result += '\f'; break;
+                    case 'n': result += '\n'; break;
+                    case 'r': result += '\r'; break;
+                    case 't': result += '\t'; break;
+                    case 'u': {
+                        uint32_t code = hex4();
+                        // Combine a surrogate pair into one code point
+                        if (code >= 0xD800 && code < 0xDC00 && text.substr(position, 2) == "\\u") {
+                            position += 2;
+                            const uint32_t low = hex4();
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        append_utf8(result, code);
+                        break;
+                    }
+                    default: fail("bad escape");
+                }
+            }
+
+            return result;
+        }
+
+        std::string_view text;
+        size_t position = 0;
+    };
+
+    const JsonValue NULL_VALUE;
+}
+
+JsonValue JsonValue::parse(std::string_view text) {
+    return JsonParser(text).document();
+}
+
+bool JsonValue::as_bool() const {
+    if (const auto *b = std::get_if<bool>(&value)) return *b;
+    throw JsonError("Expected a JSON boolean");
+}
+
+double JsonValue::as_number() const {
+    if (const auto *d = std::get_if<double>(&value)) return *d;
+    throw JsonError("Expected a JSON number");
+}
+
+int64_t JsonValue::as_int() const {
+    return static_cast<int64_t>(as_number());
+}
+
+const std::string &JsonValue::as_string() const {
+    if (const auto *s = std::get_if<std::string>(&value)) return *s;
+    throw JsonError("Expected a JSON string");
+}
+
+const JsonValue::Array &JsonValue::as_array() const {
+    if (const auto *a = std::get_if<Array>(&value)) return *a;
+    throw JsonError("Expected a JSON array");
+}
+
+const JsonValue::Object &JsonValue::as_object() const {
+    if (const auto *o = std::get_if<Object>(&value)) return *o;
+    throw JsonError("Expected a JSON object");
+}
+
+const JsonValue &JsonValue::operator[](std::string_view key) const {
+    if (const auto *object = std::get_if<Object>(&value)) {
+        for (const auto &[name, member] : *object) {
+            if (name == key) return member;
+        }
+    }
+    return NULL_VALUE;
+}
+
+JsonValue &JsonValue::set(std::string key, JsonValue member) {
+    if (is_null()) value = Object{};
+    auto &object = std::get<Object>(value);
+    for (auto &[name, existing] : object) {
+        if (name == key) {
+            existing = std::move(member);
+            return *this;
+        }
+    }
+    object.emplace_back(std::move(key), std::move(member));
+    return *this;
+}
+
+void JsonValue::write(std::ostream &out) const {
+    switch (value.index()) {
+        case 0: out << "null"; break;
+        case 1: out << (std::get<bool>(value) ? "true" : "false"); break;
+        case 2: {
+            const double number = std::get<double>(value);
+            char buffer[32];
+            // Whole numbers print without a fraction so ids and offsets round-trip
+            const auto [end, error] = std::abs(number) < 9e15 && number == std::floor(number)
+                                          ? std::to_chars(buffer, buffer + sizeof buffer, static_cast<int64_t>(number))
+                                          : std::to_chars(buffer, buffer + sizeof buffer, number);
+            if (error == std::errc() && std::isfinite(number)) out.write(buffer, end - buffer);
+            else out << "null";
+            break;
+        }
+        case 3: write_json_string(out, std::get<std::string>(value)); break;
+        case 4: {
+            out << '[';
+            bool first = true;
+            for (const auto &element : std::get<Array>(value)) {
+                if (!first) out << ',';
+                first = false;
+                element.write(out);
+            }
+            out << ']';
+            break;
+        }
+        case 5: {
+            out << '{';
+            bool first = true;
+            for (const auto &[key, member] : std::get<Object>(value)) {
+                if (!first) out << ',';
+                first = false;
+                write_json_string(out, key);
+                out << ':';
+                member.write(out);
+            }
+            out << '}';
+            break;
+        }
+        default: break;
+    }
+}
+
+std::string JsonValue::dump() const {
+    std::ostringstream out;
+    write(out);
+    return out.str();
+}
+
+void write_json_string(std::ostream &out, std::string_view text) {
+    static constexpr char HEX[] = "0123456789abcdef";
+
+    out << '"';
+    for (const char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u00" << HEX[(c >> 4) & 0xF] << HEX[c & 0xF];
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
@@ -0,0 +1,231 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/util/MemoryStats.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+namespace {
+    struct AtomicCounters {
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> frees{0};
+        std::atomic<uint64_t> bytes_allocated{0};
+        std::atomic<int64_t> live_bytes{0};
+        std::atomic<int64_t> peak_live_bytes{0};
+    };
+
+    std::array<AtomicCounters, COMPILER_PHASE_COUNT> phase_counters;
+    std::atomic<int64_t> total_live_bytes{0};
+    std::atomic<int64_t> total_peak_live_bytes{0};
+
+    thread_local CompilerPhase thread_phase = CompilerPhase::Other;
+
+    void raise_peak(std::atomic<int64_t> &peak, int64_t value) {
+        int64_t seen = peak.load(std::memory_order_relaxed);
+        while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+bool MemoryStats::instrumented() {
+#ifdef SPARKC_MEM_INSTRUMENT
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MemoryStats::reset() {
+    for (auto &c : phase_counters) {
+        c.allocations.store(0, std::memory_order_relaxed);
+        c.frees.store(0, std::memory_order_relaxed);
+        c.bytes_allocated.store(0, std::memory_order_relaxed);
+        c.peak_live_bytes.store(c.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    total_peak_live_bytes.store(total_live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+CompilerPhase MemoryStats::current_phase() {
+    return thread_phase;
+}
+
+void MemoryStats::set_current_phase(CompilerPhase phase) {
+    thread_phase = phase;
+}
+
+void MemoryStats::record_allocation(CompilerPhase phase, std::size_t size) {
+    auto &c = phase_counters[static_cast<std::size_t>(phase)];
+    const auto bytes = static_cast<int64_t>(size);
+
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+    raise_peak(c.peak_live_bytes, c.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    raise_peak(total_peak_live_bytes, total_live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void MemoryStats::record_free(CompilerPhase phase, std::size_t size) {
+    auto &c = phase_counters[static_cast<std::size_t>(phase)];
+    const auto bytes = static_cast<int64_t>(size);
+
+    c.frees.fetch_add(1, std::memory_order_relaxed);
+    c.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    total_live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryStats::PhaseCounters MemoryStats::counters(CompilerPhase phase) {
+    const auto &c = phase_counters[static_cast<std::size_t>(phase)];
+    return {
+        c.allocations.load(std::memory_order_relaxed),
+        c.frees.load(std::memory_order_relaxed),
+        c.bytes_allocated.load(std::memory_order_relaxed),
+        c.live_bytes.load(std::memory_order_relaxed),
+        c.peak_live_bytes.load(std::memory_order_relaxed),
+    };
+}
+
+int64_t MemoryStats::peak_live_bytes() {
+    return total_peak_live_bytes.load(std::memory_order_relaxed);
+}
+
+void MemoryStats::report(std::ostream &out) {
+    if (!instrumented()) {
+        out << "Memory report unavailable: rebuild with -DSPARKC_MEM_INSTRUMENT=ON\n";
+        return;
+    }
+
+    out << "Memory report:\n";
+    out << "  " << std::left << std::setw(8) << "phase"
+        << std::right << std::setw(12) << "allocs"
+        << std::setw(12) << "frees"
+        << std::setw(16) << "bytes"
+        << std::setw(16) << "peak live" << "\n";
+
+    for (std::size_t i = 0; i < COMPILER_PHASE_COUNT; ++i) {
+        const auto phase = static_cast<CompilerPhase>(i);
+        const PhaseCounters c = counters(phase);
+        if (c.allocations == 0) continue;
+
+        out << "  " << std::left << std::setw(8) << phase_to_string(phase)
+            << std::right << std::setw(12) << c.allocations
+            << std::setw(12) << c.frees
+            << std::setw(16) << c.bytes_allocated
+            << std::setw(16) << c.peak_live_bytes << "\n";
+    }
+
+    out << "  peak live (all phases): " << peak_live_bytes() << " bytes\n";
+}
+
+#ifdef SPARKC_MEM_INSTRUMENT
+
+// Every block carries a small header with its size and the phase that
+// allocated it, so frees are credited back to the right phase.
+namespace {
+    struct alignas(std::max_align_t) AllocationHeader {
+        std::size_t size;
+        CompilerPhase phase;
+    };
+
+    void *instrumented_alloc(std::size_t size) noexcept {
+        auto *header = static_cast<AllocationHeader *>(std::malloc(sizeof(AllocationHeader) + size));
+        if (!header) return nullptr;
+
+        header->size = size;
+        header->phase = thread_phase;
+        MemoryStats::record_allocation(header->phase, size);
+        return header + 1;
+    }
+
+    void instrumented_free(void *ptr) noexcept {
+        if (!ptr) return;
+
+        auto *header = static_cast<AllocationHeader *>(ptr) - 1;
+        MemoryStats::record_free(header->phase, header->size);
+        std::free(header);
+    }
+
+    // Over-aligned blocks keep their header right below the aligned address,
+    // along with where the block really starts
+    struct AlignedHeader {
+        void *block;
+        std::size_t size;
+        CompilerPhase phase;
+    };
+
+    std::size_t round_up(std::size_t size, std::size_t alignment) {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    void *instrumented_aligned_alloc(std::size_t size, std::align_val_t alignment) noexcept {
+        const std::size_t align = std::max(static_cast<std::size_t>(alignment), alignof(AlignedHeader));
+        const std::size_t offset = round_up(sizeof(AlignedHeader), align);
+        if (size > SIZE_MAX - offset - align) return nullptr;
+
+        void *block = std::aligned_alloc(align, round_up(offset + size, align));
+        if (!block) return nullptr;
+
+        void *ptr = static_cast<char *>(block) + offset;
+        auto *header = static_cast<AlignedHeader *>(ptr) - 1;
+        header->block = block;
+        header->size = size;
+        header->phase = thread_phase;
+        MemoryStats::record_allocation(header->phase, size);
+        return ptr;
+    }
+
+    void instrumented_aligned_free(void *ptr) noexcept {
+        if (!ptr) return;
+
+        const auto *header = static_cast<AlignedHeader *>(ptr) - 1;
+        MemoryStats::record_free(header->phase, header->size);
+        std::free(header->block);
+    }
+
+    void *throwing_alloc(std::size_t size, std::align_val_t alignment = std::align_val_t{0}) {
+        if (size == 0) size = 1;
+        while (true) {
+            void *ptr = alignment == std::align_val_t{0} ? instrumented_alloc(size)
+                                                          : instrumented_aligned_alloc(size, alignment);
+            if (ptr) return ptr;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
+}
+
+void *operator new(std::size_t size) { return throwing_alloc(size); }
+void *operator new[](std::size_t size) { return throwing_alloc(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return instrumented_alloc(size ? size : 1); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return instrumented_alloc(size ? size : 1); }
+
+void operator delete(void *ptr) noexcept { instrumented_free(ptr); }
+void operator delete[](void *ptr) noexcept { instrumented_free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { instrumented_free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { instrumented_free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { instrumented_free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { instrumented_free(ptr); }
+
+void *operator new(std::size_t size, std::align_val_t alignment) { return throwing_alloc(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return throwing_alloc(size, alignment); }
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return instrumented_aligned_alloc(size ? size : 1, alignment);
+}
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return instrumented_aligned_alloc(size ? size : 1, alignment);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept { instrumented_aligned_free(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { instrumented_aligned_free(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { instrumented_aligned_free(ptr); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept { instrumented_aligned_free(ptr); }
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { instrumented_aligned_free(ptr); }
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { instrumented_aligned_free(ptr); }
+
+#endif
@@ -0,0 +1,46 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/util/StringInterner.h"
+
+#include <functional>
+
+NameId StringInterner::intern(std::string_view text) {
+    const size_t hash = std::hash<std::string_view>{}(text);
+    const auto shard_index = static_cast<NameId>(hash & (SHARD_COUNT - 1));
+    Shard &shard = shards[shard_index];
+
+    {
+        std::shared_lock lock(shard.mutex);
+        if (const auto it = shard.ids.find(text); it != shard.ids.end()) return it->second;
+    }
+
+    std::unique_lock lock(shard.mutex);
+    if (const auto it = shard.ids.find(text); it != shard.ids.end()) return it->second;
+
+    const auto id = static_cast<NameId>(shard.strings.size() << SHARD_BITS) | shard_index;
+    const std::string &stored = shard.strings.emplace_back(text);
+    shard.ids.emplace(stored, id);
+    return id;
+}
+
+std::string_view StringInterner::spelling(NameId id) const {
+    const Shard &shard = shards[id & (SHARD_COUNT - 1)];
+    std::shared_lock lock(shard.mutex);
+    return shard.strings[id >> SHARD_BITS];
+}
+
+size_t StringInterner::size() const {
+    size_t total = 0;
+    for (const auto &shard : shards) {
+        std::shared_lock lock(shard.mutex);
+        total += shard.strings.size();
+    }
+    return total;
+}
+
+StringInterner &StringInterner::global() {
+    static StringInterner interner;
+    return interner;
+}
@@ -0,0 +1,182 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/util/TimeStats.h"
+#include "../../include/util/Json.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+
+#include <sys/resource.h>
+
+namespace {
+    struct AtomicTimes {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> wall_ns{0};
+        std::atomic<uint64_t> cpu_ns{0};
+    };
+
+    std::array<AtomicTimes, COMPILER_PHASE_COUNT> phase_times;
+    std::array<std::atomic<uint64_t>, THROUGHPUT_COUNT> throughput;
+    std::atomic<bool> timing{false};
+    std::chrono::steady_clock::time_point started;
+
+    constexpr std::string_view THROUGHPUT_NAMES[] = {"bytes", "tokens", "nodes", "instructions"};
+
+    double seconds(uint64_t ns) {
+        return static_cast<double>(ns) / 1e9;
+    }
+
+    double elapsed_seconds() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    // Maximum resident set size of the process so far
+    uint64_t peak_rss_bytes() {
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // kilobytes on Linux
+    }
+
+    // The phase whose time a throughput counter is divided by
+    CompilerPhase phase_of(Throughput kind) {
+        switch (kind) {
+            case Throughput::Bytes: return CompilerPhase::Read;
+            case Throughput::Tokens: return CompilerPhase::Lex;
+            case Throughput::Instructions: return CompilerPhase::Run;
+            case Throughput::Nodes: // fallthrough
+            default: return CompilerPhase::Parse;
+        }
+    }
+
+    double rate(Throughput kind) {
+        const uint64_t wall = TimeStats::times(phase_of(kind)).wall_ns;
+        return wall == 0 ? 0.0 : static_cast<double>(TimeStats::total(kind)) / seconds(wall);
+    }
+}
+
+bool TimeStats::instrumented() {
+#ifdef SPARKC_TIME_INSTRUMENT
+    return true;
+#else
+    return false;
+#endif
+}
+
+void TimeStats::start() {
+    for (auto &t : phase_times) {
+        t.calls.store(0, std::memory_order_relaxed);
+        t.wall_ns.store(0, std::memory_order_relaxed);
+        t.cpu_ns.store(0, std::memory_order_relaxed);
+    }
+    for (auto &count : throughput) count.store(0, std::memory_order_relaxed);
+
+    started = std::chrono::steady_clock::now();
+    timing.store(instrumented(), std::memory_order_relaxed);
+}
+
+bool TimeStats::enabled() {
+    return timing.load(std::memory_order_relaxed);
+}
+
+void TimeStats::record_phase(CompilerPhase phase, uint64_t wall_ns, uint64_t cpu_ns) {
+    auto &t = phase_times[static_cast<std::size_t>(phase)];
+    t.calls.fetch_add(1, std::memory_order_relaxed);
+    t.wall_ns.fetch_add(wall_ns, std::memory_order_relaxed);
+    t.cpu_ns.fetch_add(cpu_ns, std::memory_order_relaxed);
+}
+
+void TimeStats::record(Throughput kind, uint64_t amount) {
+    throughput[static_cast<std::size_t>(kind)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+TimeStats::PhaseTimes TimeStats::times(CompilerPhase phase) {
+    const auto &t = phase_times[static_cast<std::size_t>(phase)];
+    return {
+        t.calls.load(std::memory_order_relaxed),
+        t.wall_ns.load(std::memory_order_relaxed),
+        t.cpu_ns.load(std::memory_order_relaxed),
+    };
+}
+
+uint64_t TimeStats::total(Throughput kind) {
+    return throughput[static_cast<std::size_t>(kind)].load(std::memory_order_relaxed);
+}
+
+void TimeStats::report(std::ostream &out) {
+    if (!instrumented()) {
+        out << "Time report unavailable: rebuild with -DSPARKC_TIME_INSTRUMENT=ON\n";
+        return;
+    }
+
+    const auto flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+
+    out << "Time report:\n";
+    out << "  " << std::left << std::setw(8) << "phase"
+        << std::right << std::setw(10) << "calls"
+        << std::setw(12) << "wall ms"
+        << std::setw(12) << "cpu ms" << "\n";
+
+    for (std::size_t i = 0; i < COMPILER_PHASE_COUNT; ++i) {
+        const auto phase = static_cast<CompilerPhase>(i);
+        const PhaseTimes t = times(phase);
+        if (t.calls == 0) continue;
+
+        out << "  " << std::left << std::setw(8) << phase_to_string(phase)
+            << std::right << std::setw(10) << t.calls
+            << std::setw(12) << seconds(t.wall_ns) * 1e3
+            << std::setw(12) << seconds(t.cpu_ns) * 1e3 << "\n";
+    }
+
+    for (std::size_t i = 0; i < THROUGHPUT_COUNT; ++i) {
+        const auto kind = static_cast<Throughput>(i);
+        if (total(kind) == 0) continue;
+        out << "  " << THROUGHPUT_NAMES[i] << ": " << total(kind) << " (" << std::setprecision(0) << rate(kind)
+            << "/s)\n" << std::setprecision(3);
+    }
+
+    out << "  elapsed: " << elapsed_seconds() * 1e3 << " ms\n";
+    out << "  peak rss: " << peak_rss_bytes() << " bytes\n";
+    out.flags(flags);
+}
+
+void TimeStats::report_json(std::ostream &out) {
+    if (!instrumented()) {
+        out << R"({"error":"rebuild with -DSPARKC_TIME_INSTRUMENT=ON"})" << "\n";
+        return;
+    }
+
+    JsonValue::Object phases;
+    for (std::size_t i = 0; i < COMPILER_PHASE_COUNT; ++i) {
+        const auto phase = static_cast<CompilerPhase>(i);
+        const PhaseTimes t = times(phase);
+        if (t.calls == 0) continue;
+
+        phases.emplace_back(std::string(phase_to_string(phase)), JsonValue::Object{
+            {"calls", static_cast<int64_t>(t.calls)},
+            {"wall_s", seconds(t.wall_ns)},
+            {"cpu_s", seconds(t.cpu_ns)},
+        });
+    }
+
+    JsonValue::Object counts;
+    JsonValue::Object rates;
+    for (std::size_t i = 0; i < THROUGHPUT_COUNT; ++i) {
+        const auto kind = static_cast<Throughput>(i);
+        counts.emplace_back(std::string(THROUGHPUT_NAMES[i]), static_cast<int64_t>(total(kind)));
+        rates.emplace_back(std::string(THROUGHPUT_NAMES[i]) + "_per_s", rate(kind));
+    }
+
+    JsonValue report = JsonValue::Object{
+        {"phases", std::move(phases)},
+        {"counts", std::move(counts)},
+        {"rates", std::move(rates)},
+        {"elapsed_s", elapsed_seconds()},
+        {"peak_rss_bytes", static_cast<int64_t>(peak_rss_bytes())},
+    };
+    out << report.dump() << "\n";
+}
@@ -0,0 +1,152 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/util/Trace.h"
+#include "../../include/util/Json.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Trace::recording{false};
+
+namespace {
+    constexpr size_t RING_CAPACITY = 1 << 16; // events kept per thread
+
+    struct Event {
+        uint64_t ts_ns = 0;
+        const char *name = nullptr;
+        char phase = 0;     // 'B' or 'E'
+        std::string detail; // copied in place, reusing the slot's capacity once the ring has wrapped
+    };
+
+    // Written only by its own thread, which shares ownership with the registry:
+    // stop() hands the registry's share back, so a thread still winding down
+    // never writes into a freed ring
+    struct ThreadRing {
+        uint32_t tid = 0;
+        std::unique_ptr<Event[]> events = std::make_unique<Event[]>(RING_CAPACITY);
+        std::atomic<uint64_t> written{0};
+    };
+
+    std::mutex registry_mutex;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    std::atomic<uint64_t> generation{0}; // bumped by start() and stop() so stale thread slots re-register
+    std::string output_path;
+    std::chrono::steady_clock::time_point epoch;
+
+    struct ThreadSlot {
+        std::shared_ptr<ThreadRing> ring;
+        uint64_t generation = 0;
+    };
+
+    thread_local ThreadSlot slot;
+
+    ThreadRing &thread_ring() {
+        const uint64_t current = generation.load(std::memory_order_acquire);
+        if (slot.ring && slot.generation == current) return *slot.ring;
+
+        std::lock_guard lock(registry_mutex);
+        auto ring = std::make_shared<ThreadRing>();
+        ring->tid = static_cast<uint32_t>(rings.size() + 1);
+        slot = {ring, current};
+        rings.push_back(std::move(ring));
+        return *slot.ring;
+    }
+
+    void record(char phase, const char *name, std::string_view detail) {
+        const auto now = std::chrono::steady_clock::now() - epoch;
+        ThreadRing &ring = thread_ring();
+        const uint64_t index = ring.written.load(std::memory_order_relaxed);
+        Event &event = ring.events[index % RING_CAPACITY];
+        event.ts_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+        event.name = name;
+        event.phase = phase;
+        event.detail.assign(detail);
+        ring.written.store(index + 1, std::memory_order_release);
+    }
+
+    void write_event(std::ostream &out, const Event &event, uint32_t tid) {
+        out << "{\"name\":";
+        write_json_string(out, event.name);
+        out << ",\"ph\":\"" << event.phase << "\",\"ts\":" << static_cast<double>(event.ts_ns) / 1e3
+            << ",\"pid\":1,\"tid\":" << tid;
+        if (!event.detail.empty()) {
+            out << ",\"args\":{\"detail\":";
+            write_json_string(out, event.detail);
+            out << "}";
+        }
+        out << "}";
+    }
+}
+
+void Trace::start(const std::string &path) {
+    std::lock_guard lock(registry_mutex);
+    rings.clear();
+    output_path = path;
+    epoch = std::chrono::steady_clock::now();
+    generation.fetch_add(1, std::memory_order_release);
+    recording.store(true, std::memory_order_relaxed);
+}
+
+bool Trace::stop() {
+    recording.store(false, std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_release);
+
+    std::lock_guard lock(registry_mutex);
+    std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\":[\n";
+
+    bool first = true;
+    uint64_t dropped = 0;
+    for (const auto &ring : rings) {
+        if (!first) out << ",\n";
+        first = false;
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->tid
+            << ",\"args\":{\"name\":\"thread " << ring->tid << "\"}}";
+
+        // A write still in flight can only go to the slot after the last one
+        // published, which once the ring has wrapped holds the oldest event
+        const uint64_t written = ring->written.load(std::memory_order_acquire);
+        const uint64_t kept = std::min<uint64_t>(written, RING_CAPACITY - 1);
+        dropped += written - kept;
+
+        // After a wrap the oldest surviving events may end scopes whose begin was overwritten
+        size_t depth = 0;
+        for (uint64_t i = written - kept; i < written; ++i) {
+            const Event &event = ring->events[i % RING_CAPACITY];
+            if (event.phase == 'E') {
+                if (depth == 0) continue;
+                --depth;
+            } else {
+                ++depth;
+            }
+            out << ",\n";
+            write_event(out, event, ring->tid);
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+    rings.clear();
+    slot = {}; // other threads let go of theirs when they exit or record again
+    return static_cast<bool>(out.flush());
+}
+
+void Trace::begin(const char *name, std::string_view detail) {
+    if (!enabled()) return;
+    record('B', name, detail);
+}
+
+void Trace::end(const char *name) {
+    if (!enabled()) return; // a scope still open when the trace stopped
+    record('E', name, {});
+}
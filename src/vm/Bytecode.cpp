@@ -0,0 +1,127 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/vm/Bytecode.h"
+
+#include <iomanip>
+
+#include "../../include/semantic/TypeTable.h"
+
+const char *opcode_name(OpCode op) {
+    static constexpr const char *NAMES[] = {
+#define SPARKC_OPCODE_NAME(name) #name,
+        SPARKC_OPCODES(SPARKC_OPCODE_NAME)
+#undef SPARKC_OPCODE_NAME
+    };
+    const auto index = static_cast<size_t>(op);
+    return index < OPCODE_COUNT ? NAMES[index] : "?";
+}
+
+OpCode typed_opcode(OpCode generic, uint32_t integer_type) {
+    static constexpr int OPS_PER_WIDTH = static_cast<int>(OpCode::ADD_I16) - static_cast<int>(OpCode::ADD_I8);
+    static_assert(TYPE_U64 - TYPE_I8 == 7);
+    static_assert(static_cast<int>(OpCode::NEG_U64) - static_cast<int>(OpCode::ADD_I8) + 1 == 8 * OPS_PER_WIDTH);
+
+    int offset;
+    switch (generic) {
+        case OpCode::ADD: offset = 0; break;
+        case OpCode::SUB: offset = 1; break;
+        case OpCode::MUL: offset = 2; break;
+        case OpCode::DIV: offset = 3; break;
+        case OpCode::MOD: offset = 4; break;
+        case OpCode::NEG: offset = 5; break;
+        default: return generic;
+    }
+    const auto width = static_cast<int>(integer_type - TYPE_I8);
+    return static_cast<OpCode>(static_cast<int>(OpCode::ADD_I8) + width * OPS_PER_WIDTH + offset);
+}
+
+namespace {
+    void print_operands(std::ostream &out, uint32_t word, size_t pc) {
+        const OpCode op = Instruction::op(word);
+        const int a = Instruction::a(word);
+
+        switch (op) {
+            case OpCode::LOADK:
+            case OpCode::GETGLOBAL:
+            case OpCode::SETGLOBAL:
+            case OpCode::CALL:
+            case OpCode::SPAWN:
+            case OpCode::THREAD:
+            case OpCode::ASYNC:
+            case OpCode::AWAITCALL:
+                out << a << ' ' << Instruction::bx(word);
+                break;
+            case OpCode::LOADI:
+                out << a << ' ' << Instruction::sbx(word);
+                break;
+            case OpCode::JMP:
+                out << "-> " << static_cast<int64_t>(pc) + 1 + Instruction::sbx(word);
+                break;
+            case OpCode::JMPIF:
+            case OpCode::JMPIFNOT:
+                out << a << " -> " << static_cast<int64_t>(pc) + 1 + Instruction::sbx(word);
+                break;
+            case OpCode::LOADNULL:
+            case OpCode::RETURN:
+                out << a;
+                break;
+            case OpCode::RETURNNULL:
+                break;
+            case OpCode::MOVE:
+            case OpCode::LOADBOOL:
+            case OpCode::NOT:
+            case OpCode::PRINT:
+            case OpCode::USTR:
+            case OpCode::JOIN:
+            case OpCode::SLEEP:
+            case OpCode::READABLE:
+            case OpCode::NEG:
+            case OpCode::NEG_I8:
+            case OpCode::NEG_I16:
+            case OpCode::NEG_I32:
+            case OpCode::NEG_I64:
+            case OpCode::NEG_U8:
+            case OpCode::NEG_U16:
+            case OpCode::NEG_U32:
+            case OpCode::NEG_U64:
+                out << a << ' ' << static_cast<int>(Instruction::b(word));
+                break;
+            default:
+                out << a << ' ' << static_cast<int>(Instruction::b(word)) << ' '
+                    << static_cast<int>(Instruction::c(word));
+                break;
+        }
+    }
+}
+
+void disassemble(const BytecodeModule &module, std::ostream &out) {
+    for (size_t f = 0; f < module.functions.size(); ++f) {
+        const BytecodeFunction &function = module.functions[f];
+        out << (function.is_async ? "async function " : "function ") << f << " " << function.name << " (arity "
+            << static_cast<int>(function.arity) << ", registers " << static_cast<int>(function.registers);
+        if (function.is_async) out << ", coroutine frame " << static_cast<int>(function.coroutine_frame);
+        out << ")\n";
+
+        for (size_t pc = 0; pc < function.code.size(); ++pc) {
+            const uint32_t word = function.code[pc];
+            out << "  " << std::setw(4) << pc << "  " << std::left << std::setw(11)
+                << opcode_name(Instruction::op(word)) << std::right;
+            print_operands(out, word, pc);
+            if (Instruction::op(word) == OpCode::LOADK) {
+                out << "    ; " << to_display(function.constants[Instruction::bx(word)]);
+            } else if (Instruction::op(word) == OpCode::CALL || Instruction::op(word) == OpCode::SPAWN ||
+                       Instruction::op(word) == OpCode::THREAD || Instruction::op(word) == OpCode::ASYNC ||
+                       Instruction::op(word) == OpCode::AWAITCALL) {
+                out << "    ; " << module.functions[Instruction::bx(word)].name;
+            } else if (Instruction::op(word) == OpCode::AWAIT && function.is_async) {
+                out << "    ; saves";
+                for (const uint8_t saved : function.awaits[Instruction::c(word)].saved) out << " r" << int{saved};
+            } else if (Instruction::op(word) == OpCode::GETGLOBAL || Instruction::op(word) == OpCode::SETGLOBAL) {
+                out << "    ; " << module.globals[Instruction::bx(word)];
+            }
+            out << "\n";
+        }
+    }
+}
@@ -0,0 +1,582 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/vm/BytecodeCompiler.h"
+
+#include <algorithm>
+#include <bitset>
+
+namespace {
+    bool defines_value(const IRInstruction &instruction) {
+        return !is_terminator(instruction.op) && instruction.op != IROp::SetGlobal && instruction.op != IROp::Print;
+    }
+
+    OpCode arithmetic_op(IROp op) {
+        switch (op) {
+            case IROp::Add: return OpCode::ADD;
+            case IROp::Sub: return OpCode::SUB;
+            case IROp::Mul: return OpCode::MUL;
+            case IROp::Div: return OpCode::DIV;
+            case IROp::Mod: return OpCode::MOD;
+            case IROp::Neg: // fallthrough
+            default: return OpCode::NEG;
+        }
+    }
+
+    // Calls place their arguments, and the callee its frame, above every value still live afterwards
+    bool is_call(IROp op) {
+        return op == IROp::Call || op == IROp::Async || op == IROp::AwaitCall;
+    }
+
+    // Operands a block passes to the phis of `successor`
+    void phi_uses(const BasicBlock &block, const BasicBlock &successor, std::vector<bool> &live) {
+        for (size_t i = 0; i < successor.predecessors.size(); ++i) {
+            if (successor.predecessors[i] != &block) continue;
+            for (size_t p = 0; p < successor.phi_count(); ++p) live[successor.instructions[p]->operands[i]->id] = true;
+        }
+    }
+}
+
+BytecodeCompiler::BytecodeCompiler(BytecodeModule &module, const TypeTable &types) : module(module), types(types) {
+}
+
+BytecodeModule BytecodeCompiler::compile(IRModule &module) {
+    BytecodeModule result;
+    if (module.functions.size() >= UINT16_MAX) throw CompileError(0, 0, "Too many functions in one module");
+
+    result.globals = module.globals;
+    result.entry = static_cast<uint16_t>(module.entry);
+    result.functions.resize(module.functions.size());
+
+    BytecodeCompiler compiler(result, *module.types);
+    for (size_t i = 0; i < module.functions.size(); ++i) {
+        compiler.function_ids.emplace(module.functions[i].get(), static_cast<uint16_t>(i));
+    }
+    for (size_t i = 0; i < module.functions.size(); ++i) {
+        compiler.function_id = static_cast<uint16_t>(i);
+        compiler.compile_function(*module.functions[i], result.functions[i]);
+    }
+    return result;
+}
+
+void BytecodeCompiler::compile_function(IRFunction &source, BytecodeFunction &function) {
+    this->function = &function;
+    function.name = source.name;
+    function.is_async = source.is_async;
+    constant_ids.clear();
+    block_starts.clear();
+    jumps.clear();
+
+    const IRInstruction &first = *source.blocks.front()->instructions.front();
+    if (source.parameters.size() > Instruction::MAX_REGISTERS) {
+        throw CompileError(first.line, first.column, "Function '" + source.name + "' has too many parameters");
+    }
+    function.arity = static_cast<uint8_t>(source.parameters.size());
+
+    split_critical_edges(source);
+    layout = reverse_postorder(source);
+    allocate_registers(source);
+    use_registers(std::max<int>(allocated, function.arity), first);
+
+    for (size_t i = 0; i < layout.size(); ++i) {
+        block_starts.emplace(layout[i], function.code.size());
+        for (size_t j = layout[i]->phi_count(); j < layout[i]->instructions.size(); ++j) {
+            const IRInstruction &instruction = *layout[i]->instructions[j];
+            is_terminator(instruction.op) ? terminator(instruction, i) : this->instruction(instruction);
+        }
+    }
+
+    for (const auto &[jump, target] : jumps) {
+        const auto offset = static_cast<int64_t>(block_starts.at(target)) - static_cast<int64_t>(jump) - 1;
+        if (offset < Instruction::SBX_MIN || offset > Instruction::SBX_MAX) {
+            const SourceLocation &at = function.locations[jump];
+            throw CompileError(at.line, at.column, "Jump too long in function '" + source.name + "'");
+        }
+        uint32_t &word = function.code[jump];
+        word = Instruction::asbx(Instruction::op(word), Instruction::a(word), static_cast<int16_t>(offset));
+    }
+}
+
+// ===== REGISTER ALLOCATION =====
+
+void BytecodeCompiler::allocate_registers(const IRFunction &source) {
+    const size_t values = source.value_count();
+    std::vector<const IRInstruction *> definitions(values);
+    used.assign(values, false);
+    for (const BasicBlock *block : layout) {
+        for (const auto &instruction : block->instructions) {
+            definitions[instruction->id] = instruction.get();
+            for (const IRInstruction *operand : instruction->operands) used[operand->id] = true;
+        }
+    }
+
+    // Liveness at block boundaries; a phi is defined at the top of its block and
+    // its operands are used at the end of the matching predecessors
+    live_in.assign(layout.size(), std::vector<bool>(values));
+    std::vector<std::vector<bool>> live_out = live_in;
+    std::unordered_map<const BasicBlock *, size_t> index;
+    for (size_t i = 0; i < layout.size(); ++i) index.emplace(layout[i], i);
+
+    auto transfer = [&](const BasicBlock &block, std::vector<bool> &live, auto &&visit) {
+        for (auto it = block.instructions.rbegin(); it != block.instructions.rend(); ++it) {
+            const IRInstruction &instruction = **it;
+            visit(instruction, live);
+            live[instruction.id] = false;
+            if (instruction.op == IROp::Phi) continue;
+            for (const IRInstruction *operand : instruction.operands) live[operand->id] = true;
+        }
+    };
+
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (size_t i = layout.size(); i-- > 0;) {
+            std::vector<bool> live(values);
+            for (const BasicBlock *successor : layout[i]->successors) {
+                const std::vector<bool> &in = live_in[index.at(successor)];
+                for (size_t v = 0; v < values; ++v) if (in[v]) live[v] = true;
+                phi_uses(*layout[i], *successor, live);
+            }
+            live_out[i] = live;
+            transfer(*layout[i], live, [](const IRInstruction &, const std::vector<bool> &) {});
+            if (live != live_in[i]) {
+                live_in[i] = std::move(live);
+                changed = true;
+            }
+        }
+    }
+
+    // A value interferes with everything live where it is defined. All phis of a
+    // block are written together, by the same parallel copy, so they interfere too.
+    std::vector<std::vector<uint32_t>> interference(values);
+    live_across.clear();
+    call_live.clear();
+    for (size_t i = 0; i < layout.size(); ++i) {
+        const BasicBlock &block = *layout[i];
+        std::vector<bool> live = live_out[i];
+        const size_t phis = block.phi_count();
+
+        transfer(block, live, [&](const IRInstruction &instruction, const std::vector<bool> &after) {
+            if (!defines_value(instruction)) return;
+            if (is_call(instruction.op) || instruction.op == IROp::Await || instruction.op == IROp::Join) {
+                const size_t from = live_across.size();
+                for (uint32_t v = 0; v < values; ++v) if (after[v] && v != instruction.id) live_across.push_back(v);
+                call_live.emplace(&instruction, std::pair{from, live_across.size()});
+            }
+            for (uint32_t v = 0; v < values; ++v) {
+                if (!after[v] || v == instruction.id) continue;
+                interference[instruction.id].push_back(v);
+                interference[v].push_back(instruction.id);
+            }
+            if (instruction.op == IROp::Phi) {
+                for (size_t p = 0; p < phis; ++p) {
+                    if (block.instructions[p].get() != &instruction) {
+                        interference[instruction.id].push_back(block.instructions[p]->id);
+                    }
+                }
+            }
+        });
+    }
+
+    // Which phis each value flows into, for the coloring preferences
+    std::vector<std::vector<const IRInstruction *>> phi_users(values);
+    for (const BasicBlock *block : layout) {
+        for (size_t p = 0; p < block->phi_count(); ++p) {
+            for (const IRInstruction *operand : block->instructions[p]->operands) {
+                phi_users[operand->id].push_back(block->instructions[p].get());
+            }
+        }
+    }
+
+    // Greedy coloring in dominance order, parameters pinned to where the caller put them
+    registers.assign(values, 0);
+    std::vector<bool> colored(values);
+    allocated = 0;
+
+    auto color = [&](const IRInstruction &value, int reg) {
+        registers[value.id] = static_cast<uint8_t>(reg);
+        colored[value.id] = true;
+        allocated = std::max(allocated, reg + 1);
+    };
+
+    for (const auto &instruction : source.blocks.front()->instructions) {
+        if (instruction->op == IROp::Param) color(*instruction, static_cast<int>(instruction->index));
+    }
+
+    for (const BasicBlock *block : layout) {
+        for (const auto &instruction : block->instructions) {
+            if (!defines_value(*instruction) || colored[instruction->id]) continue;
+
+            std::bitset<Instruction::MAX_REGISTERS> taken;
+            for (const uint32_t neighbour : interference[instruction->id]) {
+                if (colored[neighbour]) taken.set(registers[neighbour]);
+            }
+
+            std::vector<int> preferred;
+            if (instruction->op == IROp::Phi) {
+                for (const IRInstruction *operand : instruction->operands) {
+                    if (colored[operand->id]) preferred.push_back(registers[operand->id]);
+                }
+            }
+            for (const IRInstruction *phi : phi_users[instruction->id]) {
+                if (colored[phi->id]) preferred.push_back(registers[phi->id]);
+            }
+            if (is_call(instruction->op)) {
+                // Where the result arrives, making the copy out of it unnecessary
+                int base = 0;
+                const auto [from, to] = call_live.at(instruction.get());
+                for (size_t v = from; v < to; ++v) {
+                    if (colored[live_across[v]]) base = std::max(base, registers[live_across[v]] + 1);
+                }
+                preferred.push_back(base);
+            }
+
+            int reg = -1;
+            for (const int candidate : preferred) {
+                if (candidate < Instruction::MAX_REGISTERS && !taken[candidate]) {
+                    reg = candidate;
+                    break;
+                }
+            }
+            for (int candidate = 0; reg < 0 && candidate < Instruction::MAX_REGISTERS; ++candidate) {
+                if (!taken[candidate]) reg = candidate;
+            }
+            if (reg < 0) {
+                throw CompileError(instruction->line, instruction->column,
+                                   "Function '" + source.name + "' needs more than " +
+                                   std::to_string(Instruction::MAX_REGISTERS) + " registers");
+            }
+            color(*instruction, reg);
+        }
+    }
+}
+
+// ===== INSTRUCTIONS =====
+
+void BytecodeCompiler::instruction(const IRInstruction &instruction) {
+    const auto &operands = instruction.operands;
+
+    switch (instruction.op) {
+        case IROp::Const: {
+            const uint8_t dst = reg(instruction);
+            const Literal &value = instruction.constant;
+            if (const auto *i = std::get_if<int64_t>(&value)) {
+                if (*i >= Instruction::SBX_MIN && *i <= Instruction::SBX_MAX) {
+                    emit(Instruction::asbx(OpCode::LOADI, dst, static_cast<int16_t>(*i)), instruction);
+                } else {
+                    emit(Instruction::abx(OpCode::LOADK, dst, integer_constant(*i, instruction)), instruction);
+                }
+            } else if (const auto *b = std::get_if<bool>(&value)) {
+                emit(Instruction::abc(OpCode::LOADBOOL, dst, *b ? 1 : 0, 0), instruction);
+            } else if (const auto *d = std::get_if<double>(&value)) {
+                emit(Instruction::abx(OpCode::LOADK, dst, constant(Value::number(*d), instruction)), instruction);
+            } else if (const auto *f = std::get_if<float>(&value)) {
+                emit(Instruction::abx(OpCode::LOADK, dst, constant(Value::number(*f), instruction)), instruction);
+            } else if (const auto *c = std::get_if<char>(&value)) {
+                emit(Instruction::abx(OpCode::LOADK, dst, constant(Value::character(*c), instruction)), instruction);
+            } else if (const auto *s = std::get_if<std::string>(&value)) {
+                emit(Instruction::abx(OpCode::LOADK, dst, string_constant(*s, instruction)), instruction);
+            } else {
+                emit(Instruction::abc(OpCode::LOADNULL, dst, 0, 0), instruction);
+            }
+            break;
+        }
+        case IROp::Param:
+            break; // already in its register
+        case IROp::GetGlobal:
+            emit(Instruction::abx(OpCode::GETGLOBAL, reg(instruction), instruction.index), instruction);
+            break;
+        case IROp::SetGlobal:
+            emit(Instruction::abx(OpCode::SETGLOBAL, reg(*operands[0]), instruction.index), instruction);
+            break;
+        case IROp::Add:
+        case IROp::Sub:
+        case IROp::Mul:
+        case IROp::Div:
+        case IROp::Mod:
+        case IROp::Neg: {
+            OpCode op = arithmetic_op(instruction.op);
+            if (instruction.operation != TYPE_UNKNOWN) op = typed_opcode(op, instruction.operation);
+            const uint8_t right = operands.size() > 1 ? reg(*operands[1]) : 0;
+            emit(Instruction::abc(op, reg(instruction), reg(*operands[0]), right), instruction);
+            break;
+        }
+        case IROp::Not:
+            emit(Instruction::abc(OpCode::NOT, reg(instruction), reg(*operands[0]), 0), instruction);
+            break;
+        case IROp::Eq:
+        case IROp::Ne:
+        case IROp::Lt:
+        case IROp::Le: {
+            // Only u64 orders differently from the generic signed comparison
+            const bool is_unsigned = instruction.operation == TYPE_U64;
+            OpCode op;
+            switch (instruction.op) {
+                case IROp::Eq: op = OpCode::EQ; break;
+                case IROp::Ne: op = OpCode::NE; break;
+                case IROp::Lt: op = is_unsigned ? OpCode::LTU : OpCode::LT; break;
+                default: op = is_unsigned ? OpCode::LEU : OpCode::LE; break;
+            }
+            emit(Instruction::abc(op, reg(instruction), reg(*operands[0]), reg(*operands[1])), instruction);
+            break;
+        }
+        case IROp::Call:
+        case IROp::Async:
+        case IROp::AwaitCall:
+            call(instruction);
+            break;
+        case IROp::Print:
+            print(instruction);
+            break;
+        case IROp::Spawn:
+        case IROp::Thread:
+            spawn(instruction);
+            break;
+        case IROp::Join:
+        case IROp::Await: {
+            // Both run other code on top of the frame while their operand waits
+            const uint8_t point = instruction.op == IROp::Await ? await_point(instruction) : 0;
+            const OpCode op = instruction.op == IROp::Await ? OpCode::AWAIT : OpCode::JOIN;
+            std::vector<uint8_t> live = live_registers(instruction);
+            live.push_back(reg(*operands[0]));
+            stack_map(emit(Instruction::abc(op, reg(instruction), reg(*operands[0]), point), instruction), std::move(live));
+            break;
+        }
+        case IROp::Sleep:
+            emit(Instruction::abc(OpCode::SLEEP, reg(instruction), reg(*operands[0]), 0), instruction);
+            break;
+        case IROp::Readable:
+            emit(Instruction::abc(OpCode::READABLE, reg(instruction), reg(*operands[0]), 0), instruction);
+            break;
+        default:
+            throw CompileError(instruction.line, instruction.column, "Instruction is not supported by the bytecode compiler");
+    }
+}
+
+void BytecodeCompiler::terminator(const IRInstruction &instruction, size_t position) {
+    const BasicBlock &block = *instruction.block;
+    const BasicBlock *next = position + 1 < layout.size() ? layout[position + 1] : nullptr;
+
+    switch (instruction.op) {
+        case IROp::Jump: {
+            const BasicBlock *successor = block.successors[0];
+            const size_t index = std::ranges::find(successor->predecessors, &block) - successor->predecessors.begin();
+
+            std::vector<std::pair<uint8_t, uint8_t>> moves;
+            for (size_t p = 0; p < successor->phi_count(); ++p) {
+                const IRInstruction &phi = *successor->instructions[p];
+                if (used[phi.id]) moves.emplace_back(reg(phi), reg(*phi.operands[index]));
+            }
+            parallel_move(std::move(moves), static_cast<uint8_t>(allocated), instruction);
+
+            if (successor != next) emit_jump(OpCode::JMP, 0, successor, instruction);
+            if (block_starts.contains(successor)) {
+                // A loop's back edge: what the loop header needs, phis included
+                std::vector<uint8_t> live;
+                const std::vector<bool> &in = live_in[std::ranges::find(layout, successor) - layout.begin()];
+                for (size_t v = 0; v < in.size(); ++v) if (in[v]) live.push_back(registers[v]);
+                for (size_t p = 0; p < successor->phi_count(); ++p) {
+                    if (used[successor->instructions[p]->id]) live.push_back(reg(*successor->instructions[p]));
+                }
+                stack_map(function->code.size() - 1, std::move(live));
+            }
+            break;
+        }
+        case IROp::Branch: {
+            const uint8_t condition = reg(*instruction.operands[0]);
+            const BasicBlock *taken = block.successors[0], *not_taken = block.successors[1];
+            if (taken == next) {
+                emit_jump(OpCode::JMPIFNOT, condition, not_taken, instruction);
+            } else {
+                emit_jump(OpCode::JMPIF, condition, taken, instruction);
+                if (not_taken != next) emit_jump(OpCode::JMP, 0, not_taken, instruction);
+            }
+            break;
+        }
+        default:
+            if (instruction.operands.empty()) {
+                emit(Instruction::abc(OpCode::RETURNNULL, 0, 0, 0), instruction);
+            } else {
+                emit(Instruction::abc(OpCode::RETURN, reg(*instruction.operands[0]), 0, 0), instruction);
+            }
+            break;
+    }
+}
+
+void BytecodeCompiler::call(const IRInstruction &call) {
+    if (call.operands.size() > Instruction::MAX_REGISTERS) {
+        throw CompileError(call.line, call.column, "Too many arguments");
+    }
+
+    // The callee's frame starts above every value still needed afterwards
+    int base = 0;
+    const auto [from, to] = call_live.at(&call);
+    for (size_t v = from; v < to; ++v) base = std::max(base, registers[live_across[v]] + 1);
+    const auto count = static_cast<int>(call.operands.size());
+    use_registers(base + std::max(count, 1), call);
+
+    std::vector<std::pair<uint8_t, uint8_t>> moves;
+    for (int i = 0; i < count; ++i) moves.emplace_back(static_cast<uint8_t>(base + i), reg(*call.operands[i]));
+    parallel_move(std::move(moves), static_cast<uint8_t>(std::max(allocated, base + count)), call);
+
+    const OpCode op = call.op == IROp::Call    ? OpCode::CALL
+                      : call.op == IROp::Async ? OpCode::ASYNC
+                                               : OpCode::AWAITCALL;
+    std::vector<uint8_t> live = live_registers(call);
+    stack_map(emit(Instruction::abx(op, static_cast<uint8_t>(base), static_cast<uint16_t>(call.index)), call), live);
+    if (op == OpCode::AWAITCALL) {
+        const auto handle = static_cast<uint8_t>(base);
+        live.push_back(handle);
+        stack_map(emit(Instruction::abc(OpCode::AWAIT, handle, handle, await_point(call)), call), std::move(live));
+    }
+    if (used[call.id] && reg(call) != base) emit(Instruction::abc(OpCode::MOVE, reg(call), base, 0), call);
+}
+
+// The registers of the values live after `at`, which its coroutine keeps while suspended there
+uint8_t BytecodeCompiler::await_point(const IRInstruction &at) {
+    if (!function->is_async) return 0; // elsewhere an await waits where it is
+    if (function->awaits.size() > UINT8_MAX) {
+        throw CompileError(at.line, at.column, "Function '" + function->name + "' has too many awaits");
+    }
+
+    AwaitPoint point{live_registers(at)};
+    function->coroutine_frame = std::max(function->coroutine_frame, static_cast<uint8_t>(point.saved.size()));
+    function->awaits.push_back(std::move(point));
+    return static_cast<uint8_t>(function->awaits.size() - 1);
+}
+
+std::vector<uint8_t> BytecodeCompiler::live_registers(const IRInstruction &at) const {
+    std::vector<uint8_t> live;
+    const auto [from, to] = call_live.at(&at);
+    for (size_t v = from; v < to; ++v) live.push_back(registers[live_across[v]]);
+    std::ranges::sort(live);
+    return live;
+}
+
+void BytecodeCompiler::stack_map(size_t instruction, std::vector<uint8_t> live) {
+    std::ranges::sort(live);
+    live.erase(std::ranges::unique(live).begin(), live.end());
+    function->stack_maps.push_back({static_cast<uint32_t>(instruction), std::move(live)});
+}
+
+// Arguments are copied above every allocated register, where nothing lives
+// The arguments are copied into the task, so like print's they only need to be
+// consecutive for the instruction itself
+void BytecodeCompiler::spawn(const IRInstruction &spawn) {
+    if (spawn.operands.size() > Instruction::MAX_REGISTERS) {
+        throw CompileError(spawn.line, spawn.column, "Too many arguments");
+    }
+    const int base = allocated;
+    const auto count = static_cast<int>(spawn.operands.size());
+    use_registers(base + std::max(count, 1), spawn);
+
+    for (int i = 0; i < count; ++i) {
+        emit(Instruction::abc(OpCode::MOVE, static_cast<uint8_t>(base + i), reg(*spawn.operands[i]), 0), spawn);
+    }
+    const OpCode op = spawn.op == IROp::Spawn ? OpCode::SPAWN : OpCode::THREAD;
+    emit(Instruction::abx(op, static_cast<uint8_t>(base), static_cast<uint16_t>(spawn.index)), spawn);
+    if (used[spawn.id]) emit(Instruction::abc(OpCode::MOVE, reg(spawn), static_cast<uint8_t>(base), 0), spawn);
+}
+
+void BytecodeCompiler::print(const IRInstruction &print) {
+    if (print.operands.size() > Instruction::MAX_REGISTERS) {
+        throw CompileError(print.line, print.column, "Too many arguments");
+    }
+    const int base = allocated;
+    use_registers(base + static_cast<int>(print.operands.size()), print);
+
+    for (size_t i = 0; i < print.operands.size(); ++i) {
+        // Registers hold a u64 as its i64 bit pattern, so print needs to know it is unsigned
+        const IRInstruction &argument = *print.operands[i];
+        const OpCode op = argument.type == TYPE_U64 ? OpCode::USTR : OpCode::MOVE;
+        emit(Instruction::abc(op, static_cast<uint8_t>(base + i), reg(argument), 0), print);
+    }
+    emit(Instruction::abc(OpCode::PRINT, static_cast<uint8_t>(base), static_cast<uint8_t>(print.operands.size()), 0),
+         print);
+}
+
+// Moves with distinct destinations that read their sources as if all at once
+void BytecodeCompiler::parallel_move(std::vector<std::pair<uint8_t, uint8_t>> moves, uint8_t scratch,
+                                     const IRInstruction &at) {
+    std::erase_if(moves, [](const auto &move) { return move.first == move.second; });
+
+    while (!moves.empty()) {
+        // A destination no remaining move reads can be written now
+        const auto ready = std::ranges::find_if(moves, [&](const auto &move) {
+            return std::ranges::none_of(moves, [&](const auto &other) { return other.second == move.first; });
+        });
+        if (ready != moves.end()) {
+            emit(Instruction::abc(OpCode::MOVE, ready->first, ready->second, 0), at);
+            moves.erase(ready);
+            continue;
+        }
+
+        // Only cycles are left; save one destination so it can be overwritten
+        const uint8_t saved = moves.front().first;
+        use_registers(scratch + 1, at);
+        emit(Instruction::abc(OpCode::MOVE, scratch, saved, 0), at);
+        for (auto &move : moves) {
+            if (move.second == saved) move.second = scratch;
+        }
+    }
+}
+
+// ===== EMISSION =====
+
+void BytecodeCompiler::use_registers(int count, const IRInstruction &at) {
+    if (count > Instruction::MAX_REGISTERS) {
+        throw CompileError(at.line, at.column, "Function '" + function->name + "' needs more than " +
+                                                   std::to_string(Instruction::MAX_REGISTERS) + " registers");
+    }
+    function->registers = std::max<uint8_t>(function->registers, static_cast<uint8_t>(count));
+}
+
+uint16_t BytecodeCompiler::constant(const Value &value, const IRInstruction &at) {
+    std::string key(1, static_cast<char>(value.kind()));
+    if (value.is_string()) {
+        key += value.as_string();
+    } else {
+        // Bit patterns, so 0.0 and -0.0 stay distinct constants
+        const uint64_t bits = value.is_int() ? static_cast<uint64_t>(value.as_int()) : value.raw();
+        key.append(reinterpret_cast<const char *>(&bits), sizeof(bits));
+    }
+
+    if (const auto it = constant_ids.find(key); it != constant_ids.end()) return it->second;
+    if (function->constants.size() > UINT16_MAX) {
+        throw CompileError(at.line, at.column, "Function '" + function->name + "' has too many constants");
+    }
+
+    const auto id = static_cast<uint16_t>(function->constants.size());
+    function->constants.push_back(value);
+    constant_ids.emplace(std::move(key), id);
+    return id;
+}
+
+uint16_t BytecodeCompiler::string_constant(const std::string &text, const IRInstruction &at) {
+    const auto key = std::string(1, static_cast<char>(ValueKind::Object)) + text;
+    if (const auto it = constant_ids.find(key); it != constant_ids.end()) return it->second;
+
+    module.objects.push_back(std::make_unique<StringObject>(text));
+    return constant(Value::object(module.objects.back().get()), at);
+}
+
+uint16_t BytecodeCompiler::integer_constant(int64_t value, const IRInstruction &at) {
+    if (Value::fits_inline(value)) return constant(Value::small_integer(value), at);
+
+    std::string key(1, static_cast<char>(ValueKind::Int));
+    key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    if (const auto it = constant_ids.find(key); it != constant_ids.end()) return it->second;
+
+    module.objects.push_back(std::make_unique<IntegerObject>(value));
+    return constant(Value::object(module.objects.back().get()), at);
+}
+
+size_t BytecodeCompiler::emit(uint32_t word, const IRInstruction &at) {
+    function->code.push_back(word);
+    function->locations.push_back({at.line, at.column, at.origin ? function_ids.at(at.origin) : function_id});
+    return function->code.size() - 1;
+}
+
+void BytecodeCompiler::emit_jump(OpCode op, uint8_t a, const BasicBlock *target, const IRInstruction &at) {
+    jumps.emplace_back(emit(Instruction::asbx(op, a, 0), at), target);
+}
@@ -0,0 +1,143 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/vm/EventLoop.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#endif
+
+EventLoop::~EventLoop() {
+#ifdef __linux__
+    if (poller >= 0) close(poller);
+#endif
+}
+
+void EventLoop::complete(PromiseObject &promise, Value result, std::exception_ptr error) {
+    promise.result = result;
+    promise.error = std::move(error);
+    promise.done = true;
+    if (promise.error) failures.push_back(&promise);
+
+    for (CoroutineObject *waiter : promise.waiters) ready.push_back(waiter);
+    promise.waiters.clear();
+}
+
+void EventLoop::add_timer(PromiseObject *timer, int64_t milliseconds) {
+    const auto delay = std::chrono::milliseconds(std::max<int64_t>(milliseconds, 0));
+    timers.push_back({Clock::now() + delay, timers_added++, timer});
+    std::ranges::push_heap(timers, std::greater<>());
+}
+
+bool EventLoop::watch_readable(PromiseObject *promise, int fd) {
+    std::vector<PromiseObject *> &waiting = readers[fd];
+    if (!waiting.empty()) {
+        waiting.push_back(promise);
+        return true;
+    }
+
+#ifdef __linux__
+    if (poller < 0) poller = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (poller < 0 || epoll_ctl(poller, EPOLL_CTL_ADD, fd, &event) != 0) {
+        const int error = errno;
+        readers.erase(fd);
+        if (poller < 0 || error != EPERM) return false;
+
+        // epoll refuses regular files, which are always readable
+        complete(*promise, Value::small_integer(fd));
+        return true;
+    }
+#else
+    if (fcntl(fd, F_GETFD) == -1) {
+        readers.erase(fd);
+        return false;
+    }
+#endif
+
+    waiting.push_back(promise);
+    return true;
+}
+
+CoroutineObject *EventLoop::next() {
+    while (ready.empty()) {
+        if (timers.empty() && readers.empty()) return nullptr;
+        wait();
+    }
+
+    CoroutineObject *coroutine = ready.front();
+    ready.pop_front();
+    return coroutine;
+}
+
+std::exception_ptr EventLoop::take_unawaited_failure() {
+    const auto failure = std::ranges::find_if(failures, [](const PromiseObject *promise) { return !promise->awaited; });
+    std::exception_ptr error = failure == failures.end() ? nullptr : (*failure)->error;
+    failures.clear();
+    return error;
+}
+
+void EventLoop::visit(const std::function<void(Object *)> &visitor) const {
+    for (const Timer &timer : timers) visitor(timer.promise);
+    for (const auto &[fd, waiting] : readers) {
+        for (PromiseObject *promise : waiting) visitor(promise);
+    }
+    for (CoroutineObject *coroutine : ready) visitor(coroutine);
+    for (PromiseObject *failure : failures) visitor(failure);
+}
+
+// Blocks until the earliest timer is due or a watched descriptor is readable,
+// then completes everything that is
+void EventLoop::wait() {
+    int timeout = -1;
+    if (!timers.empty()) {
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(timers.front().deadline - Clock::now());
+        timeout = static_cast<int>(std::clamp<int64_t>(remaining.count(), 0, INT_MAX));
+    }
+
+    std::vector<int> readable;
+#ifdef __linux__
+    if (poller < 0) poller = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event events[64];
+    const int count = poller < 0 ? 0 : epoll_wait(poller, events, 64, timeout);
+    for (int i = 0; i < count; ++i) {
+        readable.push_back(events[i].data.fd);
+        epoll_ctl(poller, EPOLL_CTL_DEL, events[i].data.fd, nullptr);
+    }
+#else
+    std::vector<pollfd> watched;
+    for (const auto &[fd, waiting] : readers) watched.push_back({fd, POLLIN, 0});
+    if (poll(watched.data(), watched.size(), timeout) > 0) {
+        for (const pollfd &entry : watched) {
+            if (entry.revents != 0) readable.push_back(entry.fd);
+        }
+    }
+#endif
+
+    for (const int fd : readable) {
+        const auto it = readers.find(fd);
+        if (it == readers.end()) continue;
+        const std::vector<PromiseObject *> waiting = std::move(it->second);
+        readers.erase(it);
+        for (PromiseObject *promise : waiting) complete(*promise, Value::small_integer(fd));
+    }
+
+    const Clock::time_point now = Clock::now();
+    while (!timers.empty() && timers.front().deadline <= now) {
+        PromiseObject *timer = timers.front().promise;
+        std::ranges::pop_heap(timers, std::greater<>());
+        timers.pop_back();
+        complete(*timer, Value::null());
+    }
+}
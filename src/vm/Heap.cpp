@@ -0,0 +1,238 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/vm/Heap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+#include "../../include/vm/EventLoop.h"
+#include "../../include/vm/Scheduler.h"
+
+namespace {
+    size_t size_of(const Object &object) {
+        switch (object.kind) {
+            case ObjectKind::String: return sizeof(StringObject) + static_cast<const StringObject &>(object).text.capacity();
+            case ObjectKind::Integer: return sizeof(IntegerObject);
+            case ObjectKind::Task:
+                return sizeof(TaskObject) + static_cast<const TaskObject &>(object).arguments.capacity() * sizeof(Value);
+            case ObjectKind::Coroutine: return sizeof(CoroutineObject);
+            case ObjectKind::Event: return sizeof(PromiseObject);
+        }
+        return sizeof(Object);
+    }
+
+    uint64_t percentile(std::vector<uint64_t> sorted, double fraction) {
+        if (sorted.empty()) return 0;
+        std::ranges::sort(sorted);
+        const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    double microseconds(uint64_t nanoseconds) {
+        return static_cast<double>(nanoseconds) / 1e3;
+    }
+
+    double kibibytes(uint64_t bytes) {
+        return static_cast<double>(bytes) / 1024;
+    }
+
+    // Calls `visit` with every object `object` points at
+    template <typename Visit>
+    void for_each_child(Object &object, Visit &&visit) {
+        const auto visit_value = [&](const Value &value) {
+            if (value.is_pointer()) visit(value.as_object());
+        };
+        switch (object.kind) {
+            case ObjectKind::Task: {
+                const auto &task = static_cast<TaskObject &>(object);
+                for (const Value &argument : task.arguments) visit_value(argument);
+                if (task.done.load(std::memory_order_acquire)) visit_value(task.result); // written by its worker until then
+                break;
+            }
+            case ObjectKind::Coroutine: {
+                const auto &coroutine = static_cast<CoroutineObject &>(object);
+                for (uint8_t i = 0; i < coroutine.saved; ++i) visit_value(coroutine.frame[i]);
+                if (coroutine.awaiting) visit(coroutine.awaiting);
+                [[fallthrough]];
+            }
+            case ObjectKind::Event: {
+                const auto &promise = static_cast<PromiseObject &>(object);
+                visit_value(promise.result);
+                for (CoroutineObject *waiter : promise.waiters) visit(waiter);
+                break;
+            }
+            case ObjectKind::String:
+            case ObjectKind::Integer:
+                break;
+        }
+    }
+}
+
+// ===== STATISTICS =====
+
+void GcStats::merge(const GcStats &other) {
+    allocated += other.allocated;
+    allocated_bytes += other.allocated_bytes;
+    promoted += other.promoted;
+    freed += other.freed;
+    live += other.live;
+    live_bytes += other.live_bytes;
+    minor_pauses.insert(minor_pauses.end(), other.minor_pauses.begin(), other.minor_pauses.end());
+    major_pauses.insert(major_pauses.end(), other.major_pauses.begin(), other.major_pauses.end());
+}
+
+void GcStats::report(std::ostream &out) const {
+    out << "GC statistics:\n" << std::fixed << std::setprecision(1);
+    out << "  allocated  " << std::setw(10) << allocated << " objects  " << std::setw(10) << kibibytes(allocated_bytes)
+        << " KiB\n";
+    out << "  promoted   " << std::setw(10) << promoted << " objects\n";
+    out << "  freed      " << std::setw(10) << freed << " objects\n";
+    out << "  live       " << std::setw(10) << live << " objects  " << std::setw(10) << kibibytes(live_bytes)
+        << " KiB\n";
+
+    for (const auto &[name, pauses] : {std::pair{"minor", &minor_pauses}, std::pair{"major", &major_pauses}}) {
+        out << "  " << name << "      " << std::setw(10) << pauses->size() << " collections";
+        if (!pauses->empty()) {
+            out << "  p50 " << microseconds(percentile(*pauses, 0.5)) << " us  p99 "
+                << microseconds(percentile(*pauses, 0.99)) << " us  max "
+                << microseconds(*std::ranges::max_element(*pauses)) << " us";
+        }
+        out << "\n";
+    }
+    if (minor_pauses.empty() && major_pauses.empty()) return;
+
+    // Pauses by power-of-two bucket of microseconds, from the shortest to the longest
+    uint64_t shortest = UINT64_MAX, longest = 0;
+    for (const auto *pauses : {&minor_pauses, &major_pauses}) {
+        for (const uint64_t pause : *pauses) {
+            shortest = std::min(shortest, pause / 1000);
+            longest = std::max(longest, pause / 1000);
+        }
+    }
+    out << "  pauses          minor      major\n";
+    uint64_t limit = 1;
+    while (limit <= shortest) limit *= 2;
+    for (;; limit *= 2) {
+        auto count = [&](const std::vector<uint64_t> &pauses) {
+            return std::ranges::count_if(pauses, [&](uint64_t pause) {
+                return pause / 1000 < limit && (limit == 1 || pause / 1000 >= limit / 2);
+            });
+        };
+        out << "    < " << std::setw(7) << limit << " us" << std::setw(9) << count(minor_pauses) << std::setw(11)
+            << count(major_pauses) << "\n";
+        if (longest < limit) break;
+    }
+}
+
+// ===== HEAP =====
+
+Heap::~Heap() {
+    for (const auto *objects : {&young, &old, &shared}) {
+        for (const Object *object : *objects) delete object;
+    }
+}
+
+void Heap::adopt(Object *object) {
+    young.push_back(object);
+    object->space = Space::Young;
+    const size_t size = size_of(*object);
+    young_bytes += size;
+    ++stats.allocated;
+    stats.allocated_bytes += size;
+}
+
+void Heap::share(const Value &value) {
+    if (!value.is_pointer()) return;
+    std::vector<Object *> pending{value.as_object()};
+    while (!pending.empty()) {
+        Object &object = *pending.back();
+        pending.pop_back();
+        if (object.space != Space::Young && object.space != Space::Old) continue; // static, or shared already
+
+        // Swept into `shared` by the next collection, and never traced
+        object.space = Space::Shared;
+        for_each_child(object, [&](Object *child) { pending.push_back(child); });
+    }
+}
+
+// A shared object was made to point at something else; that is shared too
+void Heap::share_contents(Object &object) {
+    for_each_child(object, [this](Object *child) { share(Value::object(child)); });
+}
+
+void Heap::collect(const std::function<void()> &roots) {
+    const auto start = std::chrono::steady_clock::now();
+    full = old_bytes >= old_limit;
+
+    roots();
+    for (Object *object : remembered) {
+        if (object->space != Space::Shared) trace(*object); // shared since it was remembered
+    }
+    while (!gray.empty()) {
+        Object *object = gray.back();
+        gray.pop_back();
+        trace(*object);
+    }
+
+    // Nothing young is left to point at afterwards
+    for (Object *object : remembered) object->remembered = false;
+    remembered.clear();
+
+    if (full) {
+        std::vector<Object *> previous;
+        previous.swap(old);
+        old_bytes = 0;
+        sweep(previous);
+    }
+    sweep(young);
+    young.clear();
+    young_bytes = 0;
+    if (full) old_limit = std::max(MIN_OLD_BYTES, 2 * old_bytes);
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto nanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    (full ? stats.major_pauses : stats.minor_pauses).push_back(nanoseconds);
+}
+
+void Heap::mark(Object *object) {
+    if (object->space != Space::Young && (!full || object->space != Space::Old)) return; // maybe another heap's
+    if (object->marked) return;
+    object->marked = true;
+    gray.push_back(object);
+}
+
+GcStats Heap::statistics() const {
+    GcStats result = stats;
+    result.live = young.size() + old.size() + shared.size();
+    result.live_bytes = young_bytes + old_bytes + shared_bytes;
+    return result;
+}
+
+void Heap::trace(Object &object) {
+    for_each_child(object, [this](Object *child) { mark(child); });
+}
+
+// Frees what was not marked and moves the rest to `old`, or to `shared` if it was shared meanwhile
+void Heap::sweep(std::vector<Object *> &objects) {
+    for (Object *object : objects) {
+        if (object->space == Space::Shared) {
+            shared.push_back(object); // never marked, so left alone while other threads use it
+            shared_bytes += size_of(*object);
+        } else if (object->marked) {
+            object->marked = false;
+            if (object->space == Space::Young) {
+                object->space = Space::Old;
+                ++stats.promoted;
+            }
+            old.push_back(object);
+            old_bytes += size_of(*object);
+        } else {
+            delete object;
+            ++stats.freed;
+        }
+    }
+}
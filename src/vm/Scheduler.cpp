@@ -0,0 +1,216 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/vm/Scheduler.h"
+
+#include <algorithm>
+#include <random>
+
+#include "../../include/vm/VirtualMachine.h"
+
+namespace {
+    // Index of the scheduler worker running on this thread, -1 elsewhere
+    thread_local int current_worker = -1;
+    thread_local const Scheduler *current_scheduler = nullptr;
+
+    // Rounds of yielding before an idle thread parks
+    constexpr unsigned SPINS = 64;
+}
+
+Scheduler::Scheduler(const VirtualMachine &root, unsigned workers) : root(root) {
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 0; i < workers; ++i) {
+        deques.push_back(std::make_unique<ChaseLevDeque<TaskObject *>>());
+    }
+    current_worker = 0;
+    current_scheduler = this;
+
+    for (unsigned i = 1; i < workers; ++i) {
+        executors.push_back(root.executor());
+        VirtualMachine &executor = *executors.back();
+        worker_threads.emplace_back([this, i, &executor] { worker_loop(i, executor); });
+    }
+}
+
+Scheduler::~Scheduler() {
+    stopping.store(true);
+    {
+        std::lock_guard lock(park_mutex);
+    }
+    parked.notify_all();
+
+    for (auto &thread : worker_threads) thread.join();
+
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard lock(state_mutex);
+        threads.swap(dedicated);
+    }
+    for (auto &thread : threads) thread.join();
+
+    if (current_scheduler == this) {
+        current_worker = -1;
+        current_scheduler = nullptr;
+    }
+}
+
+void Scheduler::spawn(TaskObject *task) {
+    pending.fetch_add(1);
+
+    // Tasks spawned by a worker go to the bottom of its own deque, the rest to the injection queue
+    if (current_scheduler == this && current_worker >= 0) {
+        deques[current_worker]->push(task);
+    } else {
+        std::lock_guard lock(injected_mutex);
+        injected.push_back(task);
+        injected_count.fetch_add(1, std::memory_order_release);
+    }
+
+    epoch.fetch_add(1);
+    wake();
+}
+
+void Scheduler::start_thread(TaskObject *task) {
+    pending.fetch_add(1);
+
+    std::lock_guard lock(state_mutex);
+    executors.push_back(root.executor());
+    VirtualMachine &executor = *executors.back();
+    dedicated.emplace_back([this, task, &executor] { run(*task, executor); });
+}
+
+void Scheduler::join(TaskObject &task, VirtualMachine &self) {
+    unsigned idle = 0;
+    while (!task.done.load(std::memory_order_acquire)) {
+        if (stopping.load()) {
+            const std::vector<BytecodeFunction> &functions = root.shared->module->functions;
+            throw RuntimeError(task.site, "The program ended before task '" + functions[task.function].name +
+                                              "' finished in '" + functions[task.site.function].name + "'");
+        }
+
+        const uint64_t seen = epoch.load();
+        if (TaskObject *other = find_task()) {
+            run(*other, self);
+            idle = 0;
+        } else if (++idle < SPINS) {
+            std::this_thread::yield();
+        } else {
+            idle = 0;
+            park(seen);
+        }
+    }
+}
+
+void Scheduler::wait_all(VirtualMachine &self) {
+    unsigned idle = 0;
+    while (pending.load(std::memory_order_acquire) > 0) {
+        const uint64_t seen = epoch.load();
+        if (TaskObject *task = find_task()) {
+            run(*task, self);
+            idle = 0;
+        } else if (++idle < SPINS) {
+            std::this_thread::yield();
+        } else {
+            idle = 0;
+            park(seen);
+        }
+    }
+
+    // Every `thread` task is done, but its thread may not have returned yet
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard lock(state_mutex);
+        threads.swap(dedicated);
+    }
+    for (auto &thread : threads) thread.join();
+
+    std::lock_guard lock(state_mutex);
+    for (const TaskObject *task : failed) {
+        if (!task->joined.load(std::memory_order_relaxed)) std::rethrow_exception(task->error);
+    }
+}
+
+uint64_t Scheduler::instructions() const {
+    uint64_t total = 0;
+    for (const auto &executor : executors) total += executor->executed;
+    return total;
+}
+
+GcStats Scheduler::gc_statistics() const {
+    GcStats total;
+    for (const auto &executor : executors) total.merge(executor->heap.statistics());
+    return total;
+}
+
+TaskObject *Scheduler::find_task() {
+    const int self = current_scheduler == this ? current_worker : -1;
+    if (self >= 0) {
+        if (const std::optional<TaskObject *> task = deques[self]->pop()) return *task;
+    }
+
+    thread_local std::minstd_rand rng(std::random_device{}());
+    const auto count = static_cast<unsigned>(deques.size());
+    const unsigned offset = rng() % count;
+    for (unsigned i = 0; i < count; ++i) {
+        const unsigned victim = (offset + i) % count;
+        if (static_cast<int>(victim) == self) continue;
+        if (const std::optional<TaskObject *> task = deques[victim]->steal()) return *task;
+    }
+
+    if (injected_count.load(std::memory_order_acquire) == 0) return nullptr;
+    std::lock_guard lock(injected_mutex);
+    if (injected.empty()) return nullptr;
+    TaskObject *task = injected.front();
+    injected.pop_front();
+    injected_count.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+}
+
+void Scheduler::run(TaskObject &task, VirtualMachine &executor) {
+    try {
+        task.result = executor.run_task(task);
+    } catch (...) {
+        task.error = std::current_exception();
+        std::lock_guard lock(state_mutex);
+        failed.push_back(&task);
+    }
+
+    task.done.store(true, std::memory_order_release);
+    pending.fetch_sub(1, std::memory_order_acq_rel);
+    epoch.fetch_add(1);
+    wake();
+}
+
+void Scheduler::worker_loop(unsigned index, VirtualMachine &executor) {
+    current_worker = static_cast<int>(index);
+    current_scheduler = this;
+
+    unsigned idle = 0;
+    while (!stopping.load()) {
+        const uint64_t seen = epoch.load();
+        if (TaskObject *task = find_task()) {
+            run(*task, executor);
+            idle = 0;
+        } else if (++idle < SPINS) {
+            std::this_thread::yield();
+        } else {
+            idle = 0;
+            park(seen);
+        }
+    }
+}
+
+void Scheduler::park(uint64_t seen) {
+    std::unique_lock lock(park_mutex);
+    sleeping.fetch_add(1);
+    parked.wait(lock, [this, seen] { return epoch.load() != seen || stopping.load(); });
+    sleeping.fetch_sub(1);
+}
+
+void Scheduler::wake() {
+    if (sleeping.load() == 0) return;
+    std::lock_guard lock(park_mutex);
+    parked.notify_all();
+}
@@ -0,0 +1,67 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/vm/Value.h"
+
+#include <charconv>
+
+namespace {
+    const char *object_name(const Object &object) {
+        switch (object.kind) {
+            case ObjectKind::String: return "string";
+            case ObjectKind::Task: return "task";
+            case ObjectKind::Coroutine: return "coroutine";
+            case ObjectKind::Event: return "event";
+            default: return "object";
+        }
+    }
+}
+
+const char *kind_name(const Value &value) {
+    switch (value.kind()) {
+        case ValueKind::Null: return "null";
+        case ValueKind::Bool: return "bool";
+        case ValueKind::Int: return "integer";
+        case ValueKind::Double: return "floating-point";
+        case ValueKind::Char: return "char";
+        case ValueKind::Object: return object_name(*value.as_object());
+    }
+    return "value";
+}
+
+std::string to_display(const Value &value) {
+    switch (value.kind()) {
+        case ValueKind::Null: return "null";
+        case ValueKind::Bool: return value.as_bool() ? "true" : "false";
+        case ValueKind::Int: return std::to_string(value.as_int());
+        case ValueKind::Double: {
+            // Shortest text that reads back as the same double
+            char buffer[32];
+            const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value.as_double());
+            return std::string(buffer, end);
+        }
+        case ValueKind::Char: return std::string(1, value.as_char());
+        case ValueKind::Object:
+            return value.is_string() ? value.as_string() : std::string("<") + object_name(*value.as_object()) + ">";
+    }
+    return "";
+}
+
+bool values_equal(const Value &a, const Value &b) {
+    if (a.is_number() && b.is_number()) {
+        if (a.is_int() && b.is_int()) return a.as_int() == b.as_int();
+        return a.as_number() == b.as_number();
+    }
+    if (a.kind() != b.kind()) return false;
+
+    switch (a.kind()) {
+        case ValueKind::Null: return true;
+        case ValueKind::Bool: return a.as_bool() == b.as_bool();
+        case ValueKind::Char: return a.as_char() == b.as_char();
+        case ValueKind::Object:
+            if (a.is_string() && b.is_string()) return a.as_string() == b.as_string();
+            return a.as_object() == b.as_object();
+        default: return false;
+    }
+}
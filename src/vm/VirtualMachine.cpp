@@ -0,0 +1,878 @@
+//
+// Created on 10/19/2026.
+//
+
+#include "../../include/vm/VirtualMachine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace {
+    // Two's-complement wrap-around without signed-overflow UB
+    int64_t wrap_add(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b)); }
+    int64_t wrap_sub(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b)); }
+    int64_t wrap_mul(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) * static_cast<uint64_t>(b)); }
+
+    // Reduce to T's width and sign-extend back, so every register holds a T as its i64 value
+    template <typename T>
+    int64_t wrap(int64_t value) { return static_cast<int64_t>(static_cast<T>(value)); }
+
+    // Immutable, so a task gets a copy of its own instead of sharing the original
+    bool copied_for_tasks(const Value &value) {
+        return value.is_pointer() &&
+               (value.as_object()->kind == ObjectKind::String || value.as_object()->kind == ObjectKind::Integer);
+    }
+
+    std::unique_ptr<Object> copy_of(const Value &value) {
+        if (value.as_object()->kind == ObjectKind::String) return std::make_unique<StringObject>(value.as_string());
+        return std::make_unique<IntegerObject>(value.as_int());
+    }
+
+    const char *symbol_of(OpCode op) {
+        switch (op) {
+            case OpCode::ADD: return "+";
+            case OpCode::SUB:
+            case OpCode::NEG: return "-";
+            case OpCode::MUL: return "*";
+            case OpCode::DIV: return "/";
+            case OpCode::MOD: return "%";
+            case OpCode::LT:
+            case OpCode::LTU: return "<";
+            case OpCode::LE:
+            case OpCode::LEU: return "<=";
+            default: return opcode_name(op);
+        }
+    }
+}
+
+// Shared by the typed instructions and the generic ones' integer slow path.
+// Operands of a typed instruction are integers of width T unless a function
+// fell off its end without returning one, which is reported as a type error.
+template <typename T>
+Value VirtualMachine::typed_arithmetic(OpCode op, const Value &left, const Value &right, const uint32_t *pc) {
+    if (!(left.is_small_int() && right.is_small_int()) && !(left.is_int() && right.is_int())) {
+        operand_error(op, left, right, pc);
+    }
+    const int64_t a = left.as_int(), b = right.as_int();
+
+    int64_t result;
+    switch (op) {
+        case OpCode::ADD: result = wrap_add(a, b); break;
+        case OpCode::SUB: result = wrap_sub(a, b); break;
+        case OpCode::MUL: result = wrap_mul(a, b); break;
+        case OpCode::DIV:
+        case OpCode::MOD:
+            if (b == 0) fail(pc, "Division by zero");
+            if constexpr (std::is_unsigned_v<T>) {
+                const auto x = static_cast<T>(a), y = static_cast<T>(b);
+                result = static_cast<int64_t>(op == OpCode::DIV ? x / y : x % y);
+            } else if (b == -1) {
+                result = op == OpCode::DIV ? wrap_sub(0, a) : 0; // MIN / -1 wraps like the other operators
+            } else {
+                result = op == OpCode::DIV ? a / b : a % b;
+            }
+            break;
+        default: result = wrap_sub(0, a); break;
+    }
+
+    return typed_result<T>(result);
+}
+
+template <typename T>
+Value VirtualMachine::typed_result(int64_t value) {
+    if constexpr (sizeof(T) < sizeof(int64_t)) {
+        return Value::small_integer(wrap<T>(value)); // 32 bits or fewer always fit inline
+    } else {
+        return integer(value);
+    }
+}
+
+VirtualMachine::VirtualMachine(std::ostream &out, bool jit, unsigned workers)
+    : owned(std::make_unique<Shared>(out, workers)), shared(owned.get()), stack(STACK_SIZE) {
+#ifdef SPARKC_JIT_SUPPORTED
+    if (jit) this->jit = std::make_unique<JitCompiler>();
+#else
+    (void) jit;
+#endif
+}
+
+VirtualMachine::VirtualMachine(Shared &shared, bool jit) : shared(&shared), stack(STACK_SIZE) {
+#ifdef SPARKC_JIT_SUPPORTED
+    if (jit) this->jit = std::make_unique<JitCompiler>();
+#else
+    (void) jit;
+#endif
+    tiers.assign(shared.module->functions.size(), Tier{});
+}
+
+VirtualMachine::~VirtualMachine() {
+    if (owned) owned->scheduler.reset();
+}
+
+std::unique_ptr<VirtualMachine> VirtualMachine::executor() const {
+    return std::unique_ptr<VirtualMachine>(new VirtualMachine(*shared, jit != nullptr));
+}
+
+uint64_t VirtualMachine::instructions() const {
+    return executed;
+}
+
+GcStats VirtualMachine::gc_statistics() const {
+    GcStats stats = heap.statistics();
+    stats.merge(executor_gc);
+    return stats;
+}
+
+void VirtualMachine::run(const BytecodeModule &module) {
+    shared->scheduler.reset();
+    shared->module = &module;
+    shared->globals.assign(module.globals.size(), Value::null());
+    frames.clear();
+    spawned.clear(); // queued tasks of an earlier run that never started
+    tiers.assign(module.functions.size(), Tier{});
+    executor_gc = {};
+
+    try {
+        const BytecodeFunction &entry = module.functions[module.entry];
+        execute(entry, stack.data(), entry.code.data(), nullptr);
+        drain();
+        if (shared->scheduler) {
+            shared->scheduler->wait_all(*this);
+            executed += shared->scheduler->instructions();
+            executor_gc = shared->scheduler->gc_statistics();
+        }
+    } catch (...) {
+        shared->scheduler.reset();
+        throw;
+    }
+    shared->scheduler.reset();
+}
+
+CoroutineObject *VirtualMachine::execute(const BytecodeFunction &entry, Value *base, const uint32_t *pc,
+                                         CoroutineObject *coroutine) {
+    const std::vector<BytecodeFunction> &functions = shared->module->functions;
+    Value *const globals = shared->globals.data();
+    const Value *const stack_end = stack.data() + stack.size();
+    const size_t outer = frames.size(); // frames below belong to whoever called execute
+
+    Value *R = base;
+    const Value *K = entry.constants.data();
+    frames.push_back({&entry, pc, R});
+
+    uint32_t word;
+
+#define A Instruction::a(word)
+#define B Instruction::b(word)
+#define C Instruction::c(word)
+#define BX Instruction::bx(word)
+#define SBX Instruction::sbx(word)
+
+// Functions that stay interpreted for good only pay for this check
+#define TIER_UP(function_id)                                    \
+    do {                                                        \
+        Tier &tier = tiers[function_id];                        \
+        if (jit && !tier.rejected) pc = tier_up(pc, R, tier);   \
+    } while (0)
+
+#ifdef SPARKC_TIME_INSTRUMENT
+#define COUNT_INSTRUCTION() (++executed)
+#else
+#define COUNT_INSTRUCTION() ((void) 0)
+#endif
+
+    TIER_UP(&entry - functions.data());
+
+#ifdef SPARKC_THREADED_DISPATCH
+    static const void *const LABELS[] = {
+#define SPARKC_OPCODE_LABEL(name) &&op_##name,
+        SPARKC_OPCODES(SPARKC_OPCODE_LABEL)
+#undef SPARKC_OPCODE_LABEL
+    };
+    static_assert(std::size(LABELS) == OPCODE_COUNT);
+
+#define CASE(name) op_##name:
+#define DISPATCH()                       \
+    do {                                 \
+        word = *pc++;                    \
+        COUNT_INSTRUCTION();             \
+        goto *LABELS[word & 0xff];       \
+    } while (0)
+
+    DISPATCH();
+#else
+#define CASE(name) case OpCode::name:
+#define DISPATCH() break
+
+    for (;;) {
+        word = *pc++;
+        COUNT_INSTRUCTION();
+        switch (Instruction::op(word)) {
+#endif
+
+    CASE(MOVE) {
+        R[A] = R[B];
+        DISPATCH();
+    }
+    CASE(LOADK) {
+        R[A] = K[BX];
+        DISPATCH();
+    }
+    CASE(LOADI) {
+        R[A] = Value::small_integer(SBX);
+        DISPATCH();
+    }
+    CASE(LOADBOOL) {
+        R[A] = Value::boolean(B != 0);
+        DISPATCH();
+    }
+    CASE(LOADNULL) {
+        R[A] = Value::null();
+        DISPATCH();
+    }
+    CASE(GETGLOBAL) {
+        R[A] = globals[BX];
+        DISPATCH();
+    }
+    CASE(SETGLOBAL) {
+        if (R[A].is_pointer()) heap.share(R[A]);
+        globals[BX] = R[A];
+        DISPATCH();
+    }
+    CASE(ADD) {
+        const Value &x = R[B], &y = R[C];
+        R[A] = x.is_small_int() && y.is_small_int() ? integer(x.as_small_int() + y.as_small_int())
+                                                    : arithmetic(OpCode::ADD, x, y, pc);
+        DISPATCH();
+    }
+    CASE(SUB) {
+        const Value &x = R[B], &y = R[C];
+        R[A] = x.is_small_int() && y.is_small_int() ? integer(x.as_small_int() - y.as_small_int())
+                                                    : arithmetic(OpCode::SUB, x, y, pc);
+        DISPATCH();
+    }
+    CASE(MUL) {
+        const Value &x = R[B], &y = R[C];
+        R[A] = x.is_small_int() && y.is_small_int() ? integer(wrap_mul(x.as_small_int(), y.as_small_int()))
+                                                    : arithmetic(OpCode::MUL, x, y, pc);
+        DISPATCH();
+    }
+    CASE(DIV) {
+        R[A] = arithmetic(OpCode::DIV, R[B], R[C], pc);
+        DISPATCH();
+    }
+    CASE(MOD) {
+        R[A] = arithmetic(OpCode::MOD, R[B], R[C], pc);
+        DISPATCH();
+    }
+    CASE(EQ) {
+        const Value &x = R[B], &y = R[C];
+        R[A] = Value::boolean(x.is_small_int() && y.is_small_int() ? x.raw() == y.raw() : values_equal(x, y));
+        DISPATCH();
+    }
+    CASE(NE) {
+        const Value &x = R[B], &y = R[C];
+        R[A] = Value::boolean(x.is_small_int() && y.is_small_int() ? x.raw() != y.raw() : !values_equal(x, y));
+        DISPATCH();
+    }
+    CASE(LT) {
+        const Value &x = R[B], &y = R[C];
+        R[A] = Value::boolean(x.is_small_int() && y.is_small_int() ? x.as_small_int() < y.as_small_int()
+                                                                   : less(OpCode::LT, x, y, pc));
+        DISPATCH();
+    }
+    CASE(LE) {
+        const Value &x = R[B], &y = R[C];
+        R[A] = Value::boolean(x.is_small_int() && y.is_small_int() ? x.as_small_int() <= y.as_small_int()
+                                                                   : less(OpCode::LE, x, y, pc));
+        DISPATCH();
+    }
+    CASE(LTU) {
+        const Value &x = R[B], &y = R[C];
+        R[A] = Value::boolean(x.is_small_int() && y.is_small_int()
+                                  ? static_cast<uint64_t>(x.as_small_int()) < static_cast<uint64_t>(y.as_small_int())
+                                  : less(OpCode::LTU, x, y, pc));
+        DISPATCH();
+    }
+    CASE(LEU) {
+        const Value &x = R[B], &y = R[C];
+        R[A] = Value::boolean(x.is_small_int() && y.is_small_int()
+                                  ? static_cast<uint64_t>(x.as_small_int()) <= static_cast<uint64_t>(y.as_small_int())
+                                  : less(OpCode::LEU, x, y, pc));
+        DISPATCH();
+    }
+    CASE(NEG) {
+        const Value &x = R[B];
+        if (x.is_int()) {
+            R[A] = integer(wrap_sub(0, x.as_int()));
+        } else if (x.is_double()) {
+            R[A] = Value::number(-x.as_double());
+        } else {
+            fail(pc, std::string("Operator '-' cannot be applied to ") + kind_name(x));
+        }
+        DISPATCH();
+    }
+    CASE(NOT) {
+        R[A] = Value::boolean(!truthy(R[B], pc));
+        DISPATCH();
+    }
+    CASE(JMP) {
+        if (SBX < 0 && heap.collection_due()) {
+            frames.back().pc = pc;
+            collect_garbage();
+        }
+        pc += SBX;
+        if (SBX < 0) TIER_UP(frames.back().function - functions.data());
+        DISPATCH();
+    }
+    CASE(JMPIF) {
+        if (truthy(R[A], pc)) pc += SBX;
+        DISPATCH();
+    }
+    CASE(JMPIFNOT) {
+        if (!truthy(R[A], pc)) pc += SBX;
+        DISPATCH();
+    }
+    CASE(CALL) {
+        const BytecodeFunction *callee = &functions[BX];
+        Value *base = R + A;
+        if (base + callee->registers > stack_end || frames.size() >= MAX_FRAMES) {
+            fail(pc, "Stack overflow calling '" + callee->name + "'");
+        }
+
+        frames.back().pc = pc;
+        frames.push_back({callee, callee->code.data(), base});
+        R = base;
+        pc = callee->code.data();
+        K = callee->constants.data();
+        if (heap.collection_due()) collect_garbage();
+        TIER_UP(BX);
+        DISPATCH();
+    }
+    CASE(PRINT) {
+        print(R + A, B);
+        DISPATCH();
+    }
+    CASE(RETURN) {
+        R[0] = R[A];
+        frames.pop_back();
+        if (frames.size() == outer) return nullptr;
+
+        const Frame &caller = frames.back();
+        R = caller.base;
+        pc = caller.pc;
+        K = caller.function->constants.data();
+        TIER_UP(caller.function - functions.data());
+        DISPATCH();
+    }
+    CASE(RETURNNULL) {
+        R[0] = Value::null();
+        frames.pop_back();
+        if (frames.size() == outer) return nullptr;
+
+        const Frame &caller = frames.back();
+        R = caller.base;
+        pc = caller.pc;
+        K = caller.function->constants.data();
+        TIER_UP(caller.function - functions.data());
+        DISPATCH();
+    }
+    CASE(USTR) {
+        const Value &x = R[B];
+        R[A] = x.is_int() ? Value::object(allocate_string(std::to_string(static_cast<uint64_t>(x.as_int())))) : x;
+        DISPATCH();
+    }
+    CASE(SPAWN) {
+        R[A] = Value::object(start_task(BX, R + A, pc, false));
+        DISPATCH();
+    }
+    CASE(THREAD) {
+        R[A] = Value::object(start_task(BX, R + A, pc, true));
+        DISPATCH();
+    }
+    CASE(JOIN) {
+        frames.back().pc = pc;
+        R[A] = join(R[B], pc);
+        DISPATCH();
+    }
+    CASE(ASYNC) {
+        frames.back().pc = pc;
+        R[A] = Value::object(start_coroutine(BX, R + A, pc));
+        DISPATCH();
+    }
+    CASE(AWAITCALL) {
+        const BytecodeFunction &callee = functions[BX];
+        Value *base = R + A;
+        if (base + callee.registers > stack_end || frames.size() >= MAX_FRAMES || nested_runs >= MAX_NESTED_RUNS) {
+            fail(pc, "Stack overflow calling '" + callee.name + "'");
+        }
+
+        frames.back().pc = pc;
+        if (CoroutineObject *suspended = await_call(callee, base)) {
+            R[A] = Value::object(suspended);
+        } else {
+            ++pc; // finished without suspending, so there is nothing to await
+        }
+        DISPATCH();
+    }
+    CASE(AWAIT) {
+        PromiseObject &promise = awaitable(R[B], pc);
+        if (!promise.done && frames.size() == outer + 1 && frames.back().function->is_async) {
+            coroutine = suspend(coroutine, R, pc, C, promise);
+            frames.pop_back();
+            return coroutine;
+        }
+        frames.back().pc = pc;
+        R[A] = await(promise, pc);
+        DISPATCH();
+    }
+    CASE(SLEEP) {
+        R[A] = Value::object(event(R[B], true, pc));
+        DISPATCH();
+    }
+    CASE(READABLE) {
+        R[A] = Value::object(event(R[B], false, pc));
+        DISPATCH();
+    }
+
+// Inline operands take the fast path; anything else, and division by zero, the slow one
+#define SPARKC_INT_HANDLERS(W, T)                                                                            \
+    CASE(ADD_##W) {                                                                                          \
+        const Value &x = R[B], &y = R[C];                                                                    \
+        R[A] = x.is_small_int() && y.is_small_int() ? typed_result<T>(x.as_small_int() + y.as_small_int())  \
+                                                    : typed_arithmetic<T>(OpCode::ADD, x, y, pc);            \
+        DISPATCH();                                                                                          \
+    }                                                                                                        \
+    CASE(SUB_##W) {                                                                                          \
+        const Value &x = R[B], &y = R[C];                                                                    \
+        R[A] = x.is_small_int() && y.is_small_int() ? typed_result<T>(x.as_small_int() - y.as_small_int())  \
+                                                    : typed_arithmetic<T>(OpCode::SUB, x, y, pc);            \
+        DISPATCH();                                                                                          \
+    }                                                                                                        \
+    CASE(MUL_##W) {                                                                                          \
+        const Value &x = R[B], &y = R[C];                                                                    \
+        R[A] = x.is_small_int() && y.is_small_int()                                                          \
+                   ? typed_result<T>(wrap_mul(x.as_small_int(), y.as_small_int()))                           \
+                   : typed_arithmetic<T>(OpCode::MUL, x, y, pc);                                             \
+        DISPATCH();                                                                                          \
+    }                                                                                                        \
+    CASE(DIV_##W) {                                                                                          \
+        const Value &x = R[B], &y = R[C];                                                                    \
+        R[A] = x.is_small_int() && y.is_small_int() && y.as_small_int() > 0                                  \
+                   ? typed_result<T>(static_cast<T>(x.as_small_int()) / static_cast<T>(y.as_small_int()))    \
+                   : typed_arithmetic<T>(OpCode::DIV, x, y, pc);                                             \
+        DISPATCH();                                                                                          \
+    }                                                                                                        \
+    CASE(MOD_##W) {                                                                                          \
+        const Value &x = R[B], &y = R[C];                                                                    \
+        R[A] = x.is_small_int() && y.is_small_int() && y.as_small_int() > 0                                  \
+                   ? typed_result<T>(static_cast<T>(x.as_small_int()) % static_cast<T>(y.as_small_int()))    \
+                   : typed_arithmetic<T>(OpCode::MOD, x, y, pc);                                             \
+        DISPATCH();                                                                                          \
+    }                                                                                                        \
+    CASE(NEG_##W) {                                                                                          \
+        R[A] = typed_arithmetic<T>(OpCode::NEG, R[B], R[B], pc);                                             \
+        DISPATCH();                                                                                          \
+    }
+
+    SPARKC_INT_HANDLERS(I8, int8_t)
+    SPARKC_INT_HANDLERS(I16, int16_t)
+    SPARKC_INT_HANDLERS(I32, int32_t)
+    SPARKC_INT_HANDLERS(I64, int64_t)
+    SPARKC_INT_HANDLERS(U8, uint8_t)
+    SPARKC_INT_HANDLERS(U16, uint16_t)
+    SPARKC_INT_HANDLERS(U32, uint32_t)
+    SPARKC_INT_HANDLERS(U64, uint64_t)
+#undef SPARKC_INT_HANDLERS
+
+#ifndef SPARKC_THREADED_DISPATCH
+        }
+    }
+#endif
+
+#undef A
+#undef B
+#undef C
+#undef BX
+#undef SBX
+#undef COUNT_INSTRUCTION
+#undef TIER_UP
+#undef CASE
+#undef DISPATCH
+}
+
+// ===== TIERS =====
+
+const uint32_t *VirtualMachine::tier_up(const uint32_t *pc, Value *R, Tier &tier) {
+    const BytecodeFunction &function = *frames.back().function;
+
+    if (!tier.native.run) {
+        if (tier.rejected || ++tier.hotness < JIT_THRESHOLD) return pc;
+        tier.native = jit->compile(function);
+        if (!tier.native.run) {
+            tier.rejected = true;
+            return pc;
+        }
+    }
+
+    const auto entry = static_cast<uint32_t>(pc - function.code.data());
+    if (!tier.native.entries[entry]) return pc;
+
+    const uint32_t exit = tier.native.run(R, shared->globals.data(), entry);
+    if ((exit & JitCompiler::DEOPT) != 0 && ++tier.deopts >= DEOPT_LIMIT) {
+        tier.native.run = nullptr;
+        tier.rejected = true;
+    }
+    return function.code.data() + (exit & ~JitCompiler::DEOPT);
+}
+
+// ===== TASKS =====
+
+TaskObject *VirtualMachine::start_task(uint16_t function, const Value *arguments, const uint32_t *pc, bool dedicated) {
+    const BytecodeFunction &caller = *frames.back().function;
+    const BytecodeFunction &callee = shared->module->functions[function];
+    const auto index = static_cast<size_t>(pc - caller.code.data()) - 1;
+
+    // Whichever thread runs it copies or shares its arguments; the task stays here until it is done
+    for (uint8_t i = 0; i < callee.arity; ++i) {
+        if (!copied_for_tasks(arguments[i])) heap.share(arguments[i]);
+    }
+    TaskObject *task = heap.allocate<TaskObject>(function, std::vector<Value>(arguments, arguments + callee.arity),
+                                                 caller.locations[index]);
+    spawned.push_back(task);
+
+    // Only the thread that started the run gets here without a scheduler
+    if (!shared->scheduler) shared->scheduler = std::make_unique<Scheduler>(*this, shared->workers);
+    if (dedicated) {
+        shared->scheduler->start_thread(task);
+    } else {
+        shared->scheduler->spawn(task);
+    }
+    return task;
+}
+
+Value VirtualMachine::join(const Value &handle, const uint32_t *pc) {
+    if (!handle.is_task()) fail(pc, std::string("Expected a task but found ") + kind_name(handle));
+
+    auto &task = static_cast<TaskObject &>(*handle.as_object());
+    if (!task.done.load(std::memory_order_acquire)) shared->scheduler->join(task, *this);
+    task.joined.store(true, std::memory_order_relaxed);
+    if (task.error) std::rethrow_exception(task.error);
+    receive(task);
+    return task.result;
+}
+
+// Only the spawning executor can reach a task that is not shared
+void VirtualMachine::receive(TaskObject &task) {
+    if (!task.transit || task.space == Space::Shared) return;
+    heap.adopt(task.transit.release());
+    heap.remember(task);
+}
+
+Value VirtualMachine::run_task(TaskObject &task) {
+    const BytecodeFunction &function = shared->module->functions[task.function];
+    Value *base = stack_top();
+    if (base + function.registers > stack.data() + stack.size() || frames.size() >= MAX_FRAMES ||
+        nested_runs >= MAX_NESTED_RUNS) {
+        throw RuntimeError(task.site, "Stack overflow running task '" + function.name + "' in '" +
+                                          shared->module->functions[task.site.function].name + "'");
+    }
+
+    for (size_t i = 0; i < task.arguments.size(); ++i) {
+        const Value &argument = task.arguments[i];
+        if (!copied_for_tasks(argument)) {
+            base[i] = argument;
+        } else if (argument.is_string()) {
+            base[i] = Value::object(allocate_string(argument.as_string()));
+        } else {
+            base[i] = box_integer(argument.as_int());
+        }
+    }
+    // Outermost tasks also finish what they left on this executor's event loop
+    const size_t depth = frames.size();
+    Value result;
+    ++nested_runs;
+    try {
+        execute(function, base, function.code.data(), nullptr);
+        result = base[0];
+        if (copied_for_tasks(result)) {
+            task.transit = copy_of(result); // owned by the task until its spawner adopts it
+            result = Value::object(task.transit.get());
+        } else {
+            heap.share(result); // for the joining thread
+        }
+        if (depth == 0) drain();
+    } catch (...) {
+        frames.resize(depth);
+        --nested_runs;
+        throw;
+    }
+    --nested_runs;
+    return result;
+}
+
+Value *VirtualMachine::stack_top() {
+    return frames.empty() ? stack.data() : frames.back().base + frames.back().function->registers;
+}
+
+// Every frame is stopped at a safepoint, or has only just been called
+void VirtualMachine::collect_garbage() {
+    // Tasks spawned here are roots until they are done. Failed ones stay for Scheduler::wait_all.
+    std::erase_if(spawned, [this](TaskObject *task) {
+        if (task->space == Space::Shared) return true; // kept for the run anyway
+        if (!task->done.load(std::memory_order_acquire)) return false;
+        receive(*task);
+        task->arguments = {};
+        return !task->error;
+    });
+
+    heap.collect([this] {
+        for (const Frame &frame : frames) {
+            const BytecodeFunction &function = *frame.function;
+            if (frame.pc == function.code.data()) {
+                for (uint8_t i = 0; i < function.arity; ++i) heap.mark(frame.base[i]);
+                continue;
+            }
+
+            const auto index = static_cast<uint32_t>(frame.pc - function.code.data() - 1);
+            const auto map = std::ranges::lower_bound(function.stack_maps, index, {}, &StackMap::instruction);
+            if (map == function.stack_maps.end() || map->instruction != index) {
+                throw std::logic_error("No stack map for instruction " + std::to_string(index) + " of '" +
+                                       function.name + "'");
+            }
+            for (const uint8_t reg : map->live) heap.mark(frame.base[reg]);
+        }
+        for (CoroutineObject *coroutine : running) heap.mark(coroutine);
+        for (TaskObject *task : spawned) heap.mark(task);
+        loop.visit([this](Object *object) { heap.mark(object); });
+    });
+}
+
+void VirtualMachine::print(const Value *values, int count) {
+    std::string line;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) line += ' ';
+        line += to_display(values[i]);
+    }
+    line += '\n';
+
+    if (!shared->scheduler) {
+        shared->out << line;
+        return;
+    }
+    const std::lock_guard lock(shared->output);
+    shared->out << line;
+}
+
+// ===== COROUTINES =====
+
+CoroutineObject *VirtualMachine::allocate_coroutine(uint16_t function) {
+    return heap.allocate<CoroutineObject>(loop, function, shared->module->functions[function].coroutine_frame);
+}
+
+// Runs the callee's frame at `base` until it returns or first suspends; R[A] is its handle either way
+CoroutineObject *VirtualMachine::start_coroutine(uint16_t function, Value *base, const uint32_t *pc) {
+    const BytecodeFunction &callee = shared->module->functions[function];
+    if (base + callee.registers > stack.data() + stack.size() || frames.size() >= MAX_FRAMES ||
+        nested_runs >= MAX_NESTED_RUNS) {
+        fail(pc, "Stack overflow calling '" + callee.name + "'");
+    }
+
+    CoroutineObject *coroutine = allocate_coroutine(function);
+    run_coroutine(*coroutine, callee, base, callee.code.data());
+    return coroutine;
+}
+
+// Unlike a started coroutine, errors reach the awaiting caller directly
+CoroutineObject *VirtualMachine::await_call(const BytecodeFunction &callee, Value *base) {
+    CoroutineObject *suspended;
+    ++nested_runs;
+    try {
+        suspended = execute(callee, base, callee.code.data(), nullptr);
+    } catch (...) {
+        --nested_runs;
+        throw;
+    }
+    --nested_runs;
+    return suspended;
+}
+
+void VirtualMachine::run_coroutine(CoroutineObject &coroutine, const BytecodeFunction &function, Value *base,
+                                   const uint32_t *pc) {
+    const size_t depth = frames.size();
+    ++nested_runs;
+    running.push_back(&coroutine);
+    try {
+        if (!execute(function, base, pc, &coroutine)) {
+            loop.complete(coroutine, base[0]);
+            heap.remember(coroutine);
+        }
+    } catch (...) {
+        frames.resize(depth);
+        loop.complete(coroutine, Value::null(), std::current_exception());
+    }
+    running.pop_back();
+    --nested_runs;
+}
+
+CoroutineObject *VirtualMachine::suspend(CoroutineObject *coroutine, const Value *R, const uint32_t *pc,
+                                         uint8_t point, PromiseObject &awaited) {
+    const BytecodeFunction &function = *frames.back().function;
+    if (!coroutine) coroutine = allocate_coroutine(static_cast<uint16_t>(&function - shared->module->functions.data()));
+
+    const std::vector<uint8_t> &saved = function.awaits[point].saved;
+    for (size_t i = 0; i < saved.size(); ++i) coroutine->frame[i] = R[saved[i]];
+    coroutine->saved = static_cast<uint8_t>(saved.size());
+    coroutine->state = point;
+    coroutine->resume = pc;
+    coroutine->awaiting = &awaited;
+    awaited.waiters.push_back(coroutine);
+    heap.remember(*coroutine);
+    heap.remember(awaited);
+    return coroutine;
+}
+
+// Rebuilds the frame on top of the stack, with the await's result in its destination
+void VirtualMachine::resume(CoroutineObject &coroutine) {
+    PromiseObject &awaited = *coroutine.awaiting;
+    coroutine.awaiting = nullptr;
+    awaited.awaited = true;
+    if (awaited.error) {
+        loop.complete(coroutine, Value::null(), awaited.error); // as if it was thrown at the await
+        return;
+    }
+
+    const std::vector<BytecodeFunction> &functions = shared->module->functions;
+    const BytecodeFunction &function = functions[coroutine.function];
+    Value *base = stack_top();
+    if (base + function.registers > stack.data() + stack.size() || frames.size() >= MAX_FRAMES ||
+        nested_runs >= MAX_NESTED_RUNS) {
+        const SourceLocation &site = function.locations[coroutine.resume - function.code.data() - 1];
+        const RuntimeError overflow(site, "Stack overflow resuming '" + function.name + "' in '" +
+                                              functions[site.function].name + "'");
+        loop.complete(coroutine, Value::null(), std::make_exception_ptr(overflow));
+        return;
+    }
+
+    const std::vector<uint8_t> &saved = function.awaits[coroutine.state].saved;
+    for (size_t i = 0; i < saved.size(); ++i) base[saved[i]] = coroutine.frame[i];
+    coroutine.saved = 0;
+    base[Instruction::a(coroutine.resume[-1])] = awaited.result;
+    run_coroutine(coroutine, function, base, coroutine.resume);
+}
+
+PromiseObject &VirtualMachine::awaitable(const Value &value, const uint32_t *pc) const {
+    if (!value.is_awaitable()) fail(pc, std::string("Expected a coroutine or event but found ") + kind_name(value));
+
+    auto &promise = static_cast<PromiseObject &>(*value.as_object());
+    if (promise.loop != &loop) fail(pc, "Coroutines and events can only be awaited on the thread that created them");
+    return promise;
+}
+
+Value VirtualMachine::await(PromiseObject &promise, const uint32_t *pc) {
+    while (!promise.done) {
+        CoroutineObject *next = loop.next();
+        if (!next) fail(pc, "Awaiting something that can never finish");
+        resume(*next);
+    }
+    return settle(promise);
+}
+
+Value VirtualMachine::settle(PromiseObject &promise) {
+    promise.awaited = true;
+    if (promise.error) std::rethrow_exception(promise.error);
+    return promise.result;
+}
+
+PromiseObject *VirtualMachine::event(const Value &argument, bool timer, const uint32_t *pc) {
+    if (!argument.is_int()) fail(pc, std::string("Expected an integer but found ") + kind_name(argument));
+
+    PromiseObject *promise = heap.allocate<PromiseObject>(ObjectKind::Event, loop);
+
+    const int64_t value = argument.as_int();
+    if (timer) {
+        loop.add_timer(promise, value);
+    } else if (value < 0 || value > INT32_MAX || !loop.watch_readable(promise, static_cast<int>(value))) {
+        fail(pc, "Cannot wait for file descriptor " + std::to_string(value));
+    }
+    return promise;
+}
+
+// Resumes coroutines until nothing is left to wait for
+void VirtualMachine::drain() {
+    while (CoroutineObject *coroutine = loop.next()) resume(*coroutine);
+    if (const std::exception_ptr error = loop.take_unawaited_failure()) std::rethrow_exception(error);
+}
+
+// ===== SLOW PATHS =====
+
+Value VirtualMachine::arithmetic(OpCode op, const Value &left, const Value &right, const uint32_t *pc) {
+    if (left.is_int() && right.is_int()) return typed_arithmetic<int64_t>(op, left, right, pc);
+
+    if (left.is_number() && right.is_number()) {
+        const double a = left.as_number(), b = right.as_number();
+        switch (op) {
+            case OpCode::ADD: return Value::number(a + b);
+            case OpCode::SUB: return Value::number(a - b);
+            case OpCode::MUL: return Value::number(a * b);
+            case OpCode::DIV: return Value::number(a / b);
+            default: return Value::number(std::fmod(a, b));
+        }
+    }
+
+    if (op == OpCode::ADD && left.is_string() && right.is_string()) {
+        return Value::object(allocate_string(left.as_string() + right.as_string()));
+    }
+
+    operand_error(op, left, right, pc);
+}
+
+bool VirtualMachine::less(OpCode op, const Value &left, const Value &right, const uint32_t *pc) const {
+    const bool or_equal = op == OpCode::LE || op == OpCode::LEU;
+
+    if (left.is_int() && right.is_int()) {
+        const int64_t a = left.as_int(), b = right.as_int();
+        if (op == OpCode::LTU || op == OpCode::LEU) {
+            const auto x = static_cast<uint64_t>(a), y = static_cast<uint64_t>(b);
+            return or_equal ? x <= y : x < y;
+        }
+        return or_equal ? a <= b : a < b;
+    }
+    if (left.is_number() && right.is_number()) {
+        return or_equal ? left.as_number() <= right.as_number() : left.as_number() < right.as_number();
+    }
+    if (left.is_char() && right.is_char()) {
+        return or_equal ? left.as_char() <= right.as_char() : left.as_char() < right.as_char();
+    }
+    if (left.is_string() && right.is_string()) {
+        return or_equal ? left.as_string() <= right.as_string() : left.as_string() < right.as_string();
+    }
+
+    operand_error(op, left, right, pc);
+}
+
+bool VirtualMachine::truthy(const Value &value, const uint32_t *pc) const {
+    if (!value.is_bool()) fail(pc, std::string("Expected a bool but found ") + kind_name(value));
+    return value.as_bool();
+}
+
+Value VirtualMachine::box_integer(int64_t value) {
+    return Value::object(heap.allocate<IntegerObject>(value));
+}
+
+StringObject *VirtualMachine::allocate_string(std::string text) {
+    return heap.allocate<StringObject>(std::move(text));
+}
+
+void VirtualMachine::operand_error(OpCode op, const Value &left, const Value &right, const uint32_t *pc) const {
+    if (op == OpCode::NEG) fail(pc, std::string("Operator '-' cannot be applied to ") + kind_name(left));
+    fail(pc, std::string("Operator '") + symbol_of(op) + "' cannot be applied to " + kind_name(left) + " and " +
+             kind_name(right));
+}
+
+void VirtualMachine::fail(const uint32_t *pc, const std::string &message) const {
+    const BytecodeFunction &function = *frames.back().function;
+    const auto index = static_cast<size_t>(pc - function.code.data()) - 1;
+    const SourceLocation &location = function.locations[index];
+    throw RuntimeError(location, message + " in '" + shared->module->functions[location.function].name + "'");
+}